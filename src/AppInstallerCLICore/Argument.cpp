@@ -62,6 +62,8 @@ namespace AppInstaller::CLI
             return Argument{ "msix", 'm', Args::Type::Msix, Resource::String::MsixArgumentDescription, ArgumentType::Flag };
         case Args::Type::ListVersions:
             return Argument{ "versions", NoAlias, Args::Type::ListVersions, Resource::String::VersionsArgumentDescription, ArgumentType::Flag };
+        case Args::Type::Resume:
+            return Argument{ "resume", NoAlias, Args::Type::Resume, Resource::String::ResumeArgumentDescription, ArgumentType::Flag };
         case Args::Type::Help:
             return Argument{ "help", APPINSTALLER_CLI_HELP_ARGUMENT_TEXT_CHAR, Args::Type::Help, Resource::String::HelpArgumentDescription, ArgumentType::Flag };
         case Args::Type::SourceName:
@@ -82,6 +84,12 @@ namespace AppInstaller::CLI
             return Argument{ "verbose-logs", NoAlias, Args::Type::VerboseLogs, Resource::String::VerboseLogsArgumentDescription, ArgumentType::Flag };
         case Args::Type::CustomHeader:
             return Argument{ "header", NoAlias, Args::Type::CustomHeader, Resource::String::HeaderArgumentDescription, ArgumentType::Standard, Argument::Visibility::Help };
+        case Args::Type::SourceMirror:
+            return Argument{ "mirror", NoAlias, Args::Type::SourceMirror, Resource::String::SourceMirrorArgumentDescription, ArgumentType::Standard, Argument::Visibility::Help };
+        case Args::Type::SourceScopeNamespace:
+            return Argument{ "scope-namespace", NoAlias, Args::Type::SourceScopeNamespace, Resource::String::SourceScopeNamespaceArgumentDescription, ArgumentType::Standard, Argument::Visibility::Help };
+        case Args::Type::SourceScopePublisher:
+            return Argument{ "scope-publisher", NoAlias, Args::Type::SourceScopePublisher, Resource::String::SourceScopePublisherArgumentDescription, ArgumentType::Standard, Argument::Visibility::Help };
         case Args::Type::AcceptSourceAgreements:
             return Argument{ "accept-source-agreements", NoAlias, Args::Type::AcceptSourceAgreements, Resource::String::AcceptSourceAgreementsArgumentDescription, ArgumentType::Flag };
         case Args::Type::ExperimentalArg:
@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "Command.h"
 #include "Resources.h"
+#include <winget/OperationArena.h>
 #include <winget/UserSettings.h>
 
 using namespace std::string_view_literals;
@@ -868,6 +869,11 @@ namespace AppInstaller::CLI
 
     int Execute(Execution::Context& context, std::unique_ptr<Command>& command)
     {
+        // Identical searches made during the command (correlation, upgrade all, import, dependencies) are only executed once
+        Repository::SearchMemoScope searchMemoScope;
+        // The searches and parses of the command do not check the settings for their arenas each time
+        Memory::OperationArenaSettingScope arenaSettingScope;
+
         try
         {
             if (!Settings::User().GetWarnings().empty())
@@ -882,6 +888,12 @@ namespace AppInstaller::CLI
             context.SetTerminationHR(Workflow::HandleException(context, std::current_exception()));
         }
 
+        try
+        {
+            Repository::SaveSourceLocationStatistics();
+        }
+        CATCH_LOG();
+
         if (SUCCEEDED(context.GetTerminationHR()))
         {
             Logging::Telemetry().LogCommandSuccess(command->FullName());
@@ -71,8 +71,9 @@ namespace AppInstaller::CLI
         context.SetFlags(Execution::ContextFlag::TreatSourceFailuresAsWarning);
 
         context <<
+            Workflow::WarmUpSourceIndexes <<
             Workflow::OpenSource() <<
-            Workflow::SearchSourceForMany <<
+            Workflow::SearchSourceForManyToReport <<
             Workflow::HandleSearchResultFailures <<
             Workflow::EnsureMatchesFromSearchResult(false) <<
             Workflow::ReportSearchResult;
@@ -53,6 +53,9 @@ namespace AppInstaller::CLI
             Argument::ForType(Args::Type::SourceArg),
             Argument::ForType(Args::Type::SourceType),
             Argument::ForType(Args::Type::CustomHeader),
+            Argument::ForType(Args::Type::SourceMirror).SetCountLimit(16),
+            Argument::ForType(Args::Type::SourceScopeNamespace).SetCountLimit(64),
+            Argument::ForType(Args::Type::SourceScopePublisher).SetCountLimit(64),
             Argument::ForType(Args::Type::AcceptSourceAgreements),
         };
     }
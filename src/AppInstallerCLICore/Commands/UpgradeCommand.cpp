@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "UpgradeCommand.h"
+#include "Workflows/CheckpointFlow.h"
 #include "Workflows/CompletionFlow.h"
 #include "Workflows/InstallFlow.h"
 #include "Workflows/UpdateFlow.h"
@@ -46,6 +47,7 @@ namespace AppInstaller::CLI
             Argument::ForType(Args::Type::AcceptSourceAgreements),
             Argument::ForType(Execution::Args::Type::CustomHeader),
             Argument{ "all", Argument::NoAlias, Args::Type::All, Resource::String::UpdateAllArgumentDescription, ArgumentType::Flag },
+            Argument::ForType(Args::Type::Resume),
         };
     }
 
@@ -114,11 +116,17 @@ namespace AppInstaller::CLI
         {
             throw CommandException(Resource::String::BothManifestAndSearchQueryProvided, "");
         }
+
+        if (execArgs.Contains(Execution::Args::Type::Resume) && !execArgs.Contains(Execution::Args::Type::All))
+        {
+            throw CommandException(Resource::String::ResumeRequiresAllArgument, "");
+        }
     }
 
     void UpgradeCommand::ExecuteInternal(Execution::Context& context) const
     {
         context.SetFlags(Execution::ContextFlag::InstallerExecutionUseUpdate);
+        context << Workflow::WarmUpSourceIndexes;
 
         // Only allow for source failures when doing a list of available upgrades.
         // We have to set it now to allow for source open failures to also just warn.
@@ -126,6 +134,11 @@ namespace AppInstaller::CLI
         {
             context.SetFlags(Execution::ContextFlag::TreatSourceFailuresAsWarning);
         }
+        else
+        {
+            // Upgrading downloads from the sources
+            context << Workflow::WarmUpSourceConnections;
+        }
 
         context <<
             Workflow::ReportExecutionStage(ExecutionStage::Discovery) <<
@@ -143,12 +156,18 @@ namespace AppInstaller::CLI
         }
         else if (context.Args.Contains(Execution::Args::Type::All))
         {
-            // --all switch updates all packages found
-            context <<
-                SearchSourceForMany <<
-                HandleSearchResultFailures <<
-                EnsureMatchesFromSearchResult(true) <<
-                UpdateAllApplicable;
+            // --all switch updates all packages found; with --resume, the packages of an interrupted run
+            context << ResumeFromCheckpoint;
+
+            if (!context.Contains(Execution::Data::PackagesToInstall))
+            {
+                context <<
+                    SearchSourceForMany <<
+                    HandleSearchResultFailures <<
+                    EnsureMatchesFromSearchResult(true);
+            }
+
+            context << UpdateAllApplicable;
         }
         else if (context.Args.Contains(Execution::Args::Type::Manifest))
         {
@@ -75,6 +75,7 @@ namespace AppInstaller::CLI::Execution
 
             // Other
             All, // Used in Update command to update all installed packages to latest
+            Resume, // Used in Update and Import commands to continue an interrupted run
             ListVersions, // Used in Show command to list all available versions of an app
             NoVT, // Disable VirtualTerminal outputs
             RetroStyle, // Makes progress display as retro
@@ -84,6 +85,9 @@ namespace AppInstaller::CLI::Execution
             VerboseLogs, // Increases winget logging level to verbose
             DependencySource, // Index source to be queried against for finding dependencies
             CustomHeader, // Optional Rest source header
+            SourceMirror, // Additional locations of the source data, ranked against the source arg
+            SourceScopeNamespace, // Package identifier namespace that the source contains
+            SourceScopePublisher, // Publisher of the packages that the source contains
             AcceptSourceAgreements, // Accept all source agreements
 
             // Used for demonstration purposes
@@ -175,10 +175,15 @@ namespace AppInstaller::CLI::Execution
             }
         }
 
-        Logging::Telemetry().LogCommandTermination(hr, file, line);
+        if (!m_deferTerminationTelemetry)
+        {
+            Logging::Telemetry().LogCommandTermination(hr, file, line);
+        }
 
         m_isTerminated = true;
         m_terminationHR = hr;
+        m_terminationFile = file;
+        m_terminationLine = line;
     }
 
     void Context::SetTerminationHR(HRESULT hr)
@@ -186,6 +191,14 @@ namespace AppInstaller::CLI::Execution
         m_terminationHR = hr;
     }
 
+    void Context::ApplyTermination(Context& other) const
+    {
+        if (m_isTerminated)
+        {
+            other.Terminate(m_terminationHR, m_terminationFile, m_terminationLine);
+        }
+    }
+
     void Context::Cancel(bool exitIfStuck, bool bypassUser)
     {
         Terminate(exitIfStuck ? APPINSTALLER_CLI_ERROR_CTRL_SIGNAL_RECEIVED : E_ABORT);
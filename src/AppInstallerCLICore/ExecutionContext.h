@@ -102,6 +102,13 @@ namespace AppInstaller::CLI::Execution
         // Set the termination hr of the context.
         void SetTerminationHR(HRESULT hr);
 
+        // Stops logging the termination of the context when it happens, for a context whose termination is only
+        // used if it is applied to another with ApplyTermination.
+        void DeferTerminationTelemetry() { m_deferTerminationTelemetry = true; }
+
+        // Terminates the other context as this one was terminated, logging it with the location of this termination.
+        void ApplyTermination(Context& other) const;
+
         // Cancel the context; this terminates it as well as informing any in progress task to stop cooperatively.
         // Multiple attempts with exitIfStuck == true may cause the process to simply exit.
         // The bypassUser indicates whether the user should be asked for cancellation (does not currently have any effect).
@@ -145,6 +152,9 @@ namespace AppInstaller::CLI::Execution
         DestructionToken m_disableCtrlHandlerOnExit = false;
         bool m_isTerminated = false;
         HRESULT m_terminationHR = S_OK;
+        std::string_view m_terminationFile;
+        size_t m_terminationLine = 0;
+        bool m_deferTerminationTelemetry = false;
         size_t m_CtrlSignalCount = 0;
         ContextFlag m_flags = ContextFlag::None;
         Workflow::ExecutionStage m_executionStage = Workflow::ExecutionStage::Initial;
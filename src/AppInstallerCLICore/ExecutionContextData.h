@@ -4,6 +4,7 @@
 #include <winget/RepositorySource.h>
 #include <winget/Manifest.h>
 #include "CompletionData.h"
+#include "OperationCheckpoint.h"
 #include "PackageCollection.h"
 #include "Workflows/WorkflowBase.h"
 
@@ -50,6 +51,8 @@ namespace AppInstaller::CLI::Execution
         Dependencies,
         DependencySource,
         AllowedArchitectures,
+        // On import and upgrade all: The progress that is saved to resume an interrupted run
+        OperationCheckpoint,
         Max
     };
 
@@ -236,5 +239,11 @@ namespace AppInstaller::CLI::Execution
         {
             using value_t = std::vector<Utility::Architecture>;
         };
+
+        template <>
+        struct DataMapping<Data::OperationCheckpoint>
+        {
+            using value_t = CLI::OperationCheckpoint;
+        };
     }
 }
@@ -45,10 +45,22 @@ namespace AppInstaller::CLI::Execution
         {
             SetStyle(*other.m_style);
         }
+
+        if (other.m_capturedOutput)
+        {
+            m_capturedOutput = other.m_capturedOutput;
+            m_spinner.reset();
+            m_progressBar.reset();
+        }
     }
 
     OutputStream Reporter::GetOutputStream(Level level)
     {
+        if (m_capturedOutput)
+        {
+            m_capturedOutput->SetLevel(level);
+        }
+
         OutputStream result = GetBasicOutputStream();
 
         switch (level)
@@ -106,6 +118,46 @@ namespace AppInstaller::CLI::Execution
         }
     }
 
+    void Reporter::CaptureOutput()
+    {
+        m_spinner.reset();
+        m_progressBar.reset();
+        m_capturedOutput = std::make_shared<CapturedOutput>();
+        m_out = std::make_shared<BaseStream>(m_capturedOutput->Stream, true, IsVTEnabled());
+    }
+
+    std::vector<std::pair<Reporter::Level, std::string>> Reporter::TakeCapturedOutput()
+    {
+        if (!m_capturedOutput)
+        {
+            return {};
+        }
+
+        m_capturedOutput->EndPart();
+        std::vector<std::pair<Level, std::string>> result = std::move(m_capturedOutput->Parts);
+        m_capturedOutput->Parts.clear();
+        return result;
+    }
+
+    void Reporter::CapturedOutput::SetLevel(Level level)
+    {
+        if (level != CurrentLevel)
+        {
+            EndPart();
+            CurrentLevel = level;
+        }
+    }
+
+    void Reporter::CapturedOutput::EndPart()
+    {
+        std::string part = Stream.str();
+        if (!part.empty())
+        {
+            Parts.emplace_back(CurrentLevel, std::move(part));
+            Stream.str(std::string{});
+        }
+    }
+
     bool Reporter::PromptForBoolResponse(Resource::LocString message, Level level)
     {
         const std::vector<BoolPromptOption> options
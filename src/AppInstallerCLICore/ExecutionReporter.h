@@ -13,9 +13,13 @@
 #include <atomic>
 #include <iomanip>
 #include <istream>
+#include <memory>
 #include <optional>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
 
 namespace AppInstaller::CLI::Execution
@@ -95,6 +99,13 @@ namespace AppInstaller::CLI::Execution
         // Sets the visual style (mostly for progress currently)
         void SetStyle(AppInstaller::Settings::VisualStyle style);
 
+        // Captures all further output, along with the level that it was written at, so that it can be shown later.
+        // Progress is not shown once the output is captured. Clones of the reporter share the captured output.
+        void CaptureOutput();
+
+        // Gets the output captured since the last call, in parts that were each written at a single level.
+        std::vector<std::pair<Level, std::string>> TakeCapturedOutput();
+
         // Prompts the user, return true if they consented.
         bool PromptForBoolResponse(Resource::LocString message, Level level = Level::Info);
 
@@ -146,7 +157,23 @@ namespace AppInstaller::CLI::Execution
         // Gets a stream for output for internal use.
         OutputStream GetBasicOutputStream();
 
+        // Output that is captured rather than shown.
+        struct CapturedOutput
+        {
+            // Ends the current part if the level is changing.
+            void SetLevel(Level level);
+
+            // Ends the current part.
+            void EndPart();
+
+            std::ostringstream Stream;
+            Level CurrentLevel = Level::Info;
+            std::vector<std::pair<Level, std::string>> Parts;
+        };
+
         Channel m_channel = Channel::Output;
+        // Declared before the stream that may write to it, so that it is destroyed after it.
+        std::shared_ptr<CapturedOutput> m_capturedOutput;
         std::shared_ptr<BaseStream> m_out;
         std::istream& m_in;
         bool m_isVTEnabled = true;
@@ -0,0 +1,278 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "OperationCheckpoint.h"
+#include <winget/Yaml.h>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::CLI
+{
+    namespace
+    {
+        constexpr std::string_view s_CheckpointYaml_Operations = "Operations"sv;
+        constexpr std::string_view s_CheckpointYaml_Operation = "Operation"sv;
+        constexpr std::string_view s_CheckpointYaml_Packages = "Packages"sv;
+        constexpr std::string_view s_CheckpointYaml_SourceIdentifier = "SourceIdentifier"sv;
+        constexpr std::string_view s_CheckpointYaml_Id = "Id"sv;
+        constexpr std::string_view s_CheckpointYaml_Version = "Version"sv;
+        constexpr std::string_view s_CheckpointYaml_Channel = "Channel"sv;
+        constexpr std::string_view s_CheckpointYaml_InstallerUrl = "InstallerUrl"sv;
+        constexpr std::string_view s_CheckpointYaml_InstallerSha256 = "InstallerSha256"sv;
+        constexpr std::string_view s_CheckpointYaml_Scope = "Scope"sv;
+        constexpr std::string_view s_CheckpointYaml_InstallerPath = "InstallerPath"sv;
+        constexpr std::string_view s_CheckpointYaml_InstallerSize = "InstallerSize"sv;
+        constexpr std::string_view s_CheckpointYaml_InstallerLastWriteTime = "InstallerLastWriteTime"sv;
+        constexpr std::string_view s_CheckpointYaml_State = "State"sv;
+
+        constexpr std::string_view s_State_Pending = "Pending"sv;
+        constexpr std::string_view s_State_Downloaded = "Downloaded"sv;
+        constexpr std::string_view s_State_Completed = "Completed"sv;
+
+        // The number of interrupted operations that are kept; past it, the oldest are dropped.
+        constexpr size_t s_MaxOperations = 8;
+
+        constexpr size_t s_MaxSaveAttempts = 10;
+
+        std::string_view ToString(OperationCheckpoint::PackageState state)
+        {
+            switch (state)
+            {
+            case OperationCheckpoint::PackageState::Downloaded: return s_State_Downloaded;
+            case OperationCheckpoint::PackageState::Completed: return s_State_Completed;
+            default: return s_State_Pending;
+            }
+        }
+
+        OperationCheckpoint::PackageState ConvertToPackageState(std::string_view value)
+        {
+            if (value == s_State_Downloaded)
+            {
+                return OperationCheckpoint::PackageState::Downloaded;
+            }
+            else if (value == s_State_Completed)
+            {
+                return OperationCheckpoint::PackageState::Completed;
+            }
+
+            return OperationCheckpoint::PackageState::Pending;
+        }
+
+        std::string GetScalar(const YAML::Node& node, std::string_view name)
+        {
+            const YAML::Node& value = node[name];
+            return (value && value.IsScalar() ? value.as<std::string>() : std::string{});
+        }
+
+        int64_t GetInteger(const YAML::Node& node, std::string_view name)
+        {
+            const YAML::Node& value = node[name];
+            return (value && value.IsScalar() ? value.as<int64_t>() : 0);
+        }
+
+        // Reads every saved checkpoint, in the order that they were saved.
+        std::vector<OperationCheckpoint> ReadCheckpoints(Settings::Stream& stream)
+        {
+            std::vector<OperationCheckpoint> result;
+
+            auto contents = stream.Get();
+            if (!contents)
+            {
+                return result;
+            }
+
+            std::string value = Utility::ReadEntireStream(*contents);
+
+            try
+            {
+                YAML::Node document = YAML::Load(value);
+                YAML::Node operations = document[s_CheckpointYaml_Operations];
+
+                if (!operations || !operations.IsSequence())
+                {
+                    return result;
+                }
+
+                for (const auto& operation : operations.Sequence())
+                {
+                    const YAML::Node& packages = operation[s_CheckpointYaml_Packages];
+                    std::string name = GetScalar(operation, s_CheckpointYaml_Operation);
+
+                    if (name.empty() || !packages || !packages.IsSequence())
+                    {
+                        continue;
+                    }
+
+                    OperationCheckpoint& checkpoint = result.emplace_back(std::move(name), stream.Definition());
+
+                    for (const auto& packageNode : packages.Sequence())
+                    {
+                        OperationCheckpoint::Package package;
+                        package.SourceIdentifier = GetScalar(packageNode, s_CheckpointYaml_SourceIdentifier);
+                        package.Id = GetScalar(packageNode, s_CheckpointYaml_Id);
+                        package.Version = GetScalar(packageNode, s_CheckpointYaml_Version);
+                        package.Channel = GetScalar(packageNode, s_CheckpointYaml_Channel);
+                        package.InstallerUrl = GetScalar(packageNode, s_CheckpointYaml_InstallerUrl);
+                        package.InstallerSha256 = GetScalar(packageNode, s_CheckpointYaml_InstallerSha256);
+                        package.Scope = Manifest::ConvertToScopeEnum(GetScalar(packageNode, s_CheckpointYaml_Scope));
+                        package.InstallerPath = Utility::ConvertToUTF16(GetScalar(packageNode, s_CheckpointYaml_InstallerPath));
+                        package.InstallerSize = GetInteger(packageNode, s_CheckpointYaml_InstallerSize);
+                        package.InstallerLastWriteTime = GetInteger(packageNode, s_CheckpointYaml_InstallerLastWriteTime);
+                        package.State = ConvertToPackageState(GetScalar(packageNode, s_CheckpointYaml_State));
+
+                        if (!package.Id.empty())
+                        {
+                            checkpoint.Packages.emplace_back(std::move(package));
+                        }
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // A checkpoint only avoids repeating work; start over rather than fail.
+                AICLI_LOG(CLI, Warning, << "Ignoring invalid operation checkpoints (" << e.what() << ")");
+                result.clear();
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool WriteCheckpoints(Settings::Stream& stream, const std::vector<OperationCheckpoint>& checkpoints)
+        {
+            YAML::Emitter out;
+            out << YAML::BeginMap;
+            out << YAML::Key << s_CheckpointYaml_Operations;
+            out << YAML::BeginSeq;
+
+            for (const auto& checkpoint : checkpoints)
+            {
+                out << YAML::BeginMap;
+                out << YAML::Key << s_CheckpointYaml_Operation << YAML::Value << checkpoint.Operation;
+                out << YAML::Key << s_CheckpointYaml_Packages;
+                out << YAML::BeginSeq;
+
+                for (const auto& package : checkpoint.Packages)
+                {
+                    out << YAML::BeginMap;
+                    out << YAML::Key << s_CheckpointYaml_SourceIdentifier << YAML::Value << package.SourceIdentifier;
+                    out << YAML::Key << s_CheckpointYaml_Id << YAML::Value << package.Id;
+                    out << YAML::Key << s_CheckpointYaml_Version << YAML::Value << package.Version;
+                    out << YAML::Key << s_CheckpointYaml_Channel << YAML::Value << package.Channel;
+                    out << YAML::Key << s_CheckpointYaml_InstallerUrl << YAML::Value << package.InstallerUrl;
+                    out << YAML::Key << s_CheckpointYaml_InstallerSha256 << YAML::Value << package.InstallerSha256;
+                    out << YAML::Key << s_CheckpointYaml_Scope << YAML::Value << Manifest::ScopeToString(package.Scope);
+                    if (!package.InstallerPath.empty())
+                    {
+                        out << YAML::Key << s_CheckpointYaml_InstallerPath << YAML::Value << package.InstallerPath.u8string();
+                        out << YAML::Key << s_CheckpointYaml_InstallerSize << YAML::Value << package.InstallerSize;
+                        out << YAML::Key << s_CheckpointYaml_InstallerLastWriteTime << YAML::Value << package.InstallerLastWriteTime;
+                    }
+                    out << YAML::Key << s_CheckpointYaml_State << YAML::Value << ToString(package.State);
+                    out << YAML::EndMap;
+                }
+
+                out << YAML::EndSeq;
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            return stream.Set(out.str());
+        }
+
+        // Replaces the checkpoint for the operation with the given one, or removes it if none is given.
+        void UpdateCheckpoints(const Settings::StreamDefinition& definition, std::string_view operation, const OperationCheckpoint* checkpoint)
+        {
+            try
+            {
+                Settings::Stream stream{ definition };
+
+                for (size_t i = 0; i < s_MaxSaveAttempts; ++i)
+                {
+                    std::vector<OperationCheckpoint> checkpoints = ReadCheckpoints(stream);
+
+                    auto existing = std::find_if(checkpoints.begin(), checkpoints.end(), [&](const OperationCheckpoint& c) { return c.Operation == operation; });
+                    if (existing != checkpoints.end())
+                    {
+                        checkpoints.erase(existing);
+                    }
+                    else if (!checkpoint)
+                    {
+                        return;
+                    }
+
+                    if (checkpoint)
+                    {
+                        checkpoints.emplace_back(*checkpoint);
+
+                        if (checkpoints.size() > s_MaxOperations)
+                        {
+                            checkpoints.erase(checkpoints.begin(), checkpoints.begin() + (checkpoints.size() - s_MaxOperations));
+                        }
+                    }
+
+                    if (WriteCheckpoints(stream, checkpoints))
+                    {
+                        return;
+                    }
+                }
+
+                AICLI_LOG(CLI, Warning, << "Too many attempts at saving the operation checkpoints");
+            }
+            CATCH_LOG();
+        }
+    }
+
+    OperationCheckpoint::OperationCheckpoint(std::string operation, const Settings::StreamDefinition& stream) :
+        Operation(std::move(operation)), m_streamDefinition(stream)
+    {
+    }
+
+    std::optional<OperationCheckpoint> OperationCheckpoint::Load(std::string_view operation, const Settings::StreamDefinition& stream)
+    {
+        try
+        {
+            Settings::Stream checkpointStream{ stream };
+
+            for (auto& checkpoint : ReadCheckpoints(checkpointStream))
+            {
+                if (checkpoint.Operation == operation)
+                {
+                    return std::move(checkpoint);
+                }
+            }
+        }
+        CATCH_LOG();
+
+        return {};
+    }
+
+    OperationCheckpoint::Package* OperationCheckpoint::Find(std::string_view sourceIdentifier, std::string_view id, std::string_view version, std::string_view channel)
+    {
+        for (auto& package : Packages)
+        {
+            if (package.SourceIdentifier == sourceIdentifier && package.Id == id && package.Version == version && package.Channel == channel)
+            {
+                return &package;
+            }
+        }
+
+        return nullptr;
+    }
+
+    size_t OperationCheckpoint::GetCompletedCount() const
+    {
+        return static_cast<size_t>(std::count_if(Packages.begin(), Packages.end(), [](const Package& package) { return package.State == PackageState::Completed; }));
+    }
+
+    void OperationCheckpoint::Save() const
+    {
+        UpdateCheckpoints(m_streamDefinition, Operation, this);
+    }
+
+    void OperationCheckpoint::Remove() const
+    {
+        UpdateCheckpoints(m_streamDefinition, Operation, nullptr);
+    }
+}
@@ -0,0 +1,83 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/Manifest.h>
+#include <winget/Settings.h>
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::CLI
+{
+    // The progress of a command that installs multiple packages, such as upgrade --all or import.
+    // It is saved after each step, so that an interrupted run can be resumed without repeating
+    // the discovery of the packages, the downloads that were verified or the installs that completed.
+    struct OperationCheckpoint
+    {
+        // The progress of a single package.
+        enum class PackageState
+        {
+            // Nothing has been done for the package yet.
+            Pending,
+            // The installer was downloaded and its hash verified, but it did not complete.
+            Downloaded,
+            // The package was installed.
+            Completed,
+        };
+
+        // The package and installer that were selected, and the progress of installing them.
+        struct Package
+        {
+            // The identity of the resolved manifest.
+            std::string SourceIdentifier;
+            std::string Id;
+            std::string Version;
+            std::string Channel;
+
+            // The selected installer, identified by its location and hash.
+            std::string InstallerUrl;
+            std::string InstallerSha256;
+
+            // The scope requested for the package.
+            Manifest::ScopeEnum Scope = Manifest::ScopeEnum::Unknown;
+
+            // The location of the verified download of the installer; empty if it was not downloaded.
+            std::filesystem::path InstallerPath;
+
+            // The size and last write time of the download when it was verified, so that an unchanged
+            // file can be used again without hashing it.
+            int64_t InstallerSize = 0;
+            int64_t InstallerLastWriteTime = 0;
+
+            PackageState State = PackageState::Pending;
+        };
+
+        OperationCheckpoint(std::string operation, const Settings::StreamDefinition& stream = Settings::Stream::OperationCheckpoints);
+
+        // Loads the checkpoint of an earlier run of the operation that did not complete.
+        static std::optional<OperationCheckpoint> Load(std::string_view operation, const Settings::StreamDefinition& stream = Settings::Stream::OperationCheckpoints);
+
+        // Finds the package with the given manifest identity.
+        Package* Find(std::string_view sourceIdentifier, std::string_view id, std::string_view version, std::string_view channel);
+
+        // Gets the number of packages that were completed.
+        size_t GetCompletedCount() const;
+
+        // Saves the checkpoint, replacing the one saved earlier for the same operation.
+        void Save() const;
+
+        // Removes the checkpoint of the operation; used once every package is completed.
+        void Remove() const;
+
+        // Identifies the command and the arguments that determine its packages.
+        std::string Operation;
+
+        std::vector<Package> Packages;
+
+    private:
+        Settings::StreamDefinition m_streamDefinition;
+    };
+}
@@ -0,0 +1,265 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "CheckpointFlow.h"
+#include "Resources.h"
+
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Utility;
+using namespace std::string_view_literals;
+
+namespace AppInstaller::CLI::Workflow
+{
+    namespace
+    {
+        // The arguments that change which packages and installers are selected.
+        constexpr std::pair<Execution::Args::Type, std::string_view> s_SelectionArgs[] =
+        {
+            { Execution::Args::Type::Query, "query"sv },
+            { Execution::Args::Type::Id, "id"sv },
+            { Execution::Args::Type::Name, "name"sv },
+            { Execution::Args::Type::Moniker, "moniker"sv },
+            { Execution::Args::Type::Source, "source"sv },
+            { Execution::Args::Type::Exact, "exact"sv },
+            { Execution::Args::Type::IgnoreVersions, "ignore-versions"sv },
+        };
+
+        // Finds the package version and installer that were selected by the interrupted run.
+        // Returns false if they are no longer available. If the package no longer needs to be installed,
+        // it is marked as completed and nothing is added to the packages to install.
+        bool FindCheckpointPackage(
+            const Source& source,
+            OperationCheckpoint::Package& entry,
+            bool requireInstalled,
+            std::vector<Execution::PackageToInstall>& packagesToInstall)
+        {
+            SearchRequest request;
+            request.Inclusions.emplace_back(PackageMatchFilter(PackageMatchField::Id, MatchType::Exact, entry.Id));
+
+            SearchResult result = source.Search(request);
+            if (!result.Failures.empty())
+            {
+                return false;
+            }
+
+            for (const auto& match : result.Matches)
+            {
+                auto packageVersion = match.Package->GetAvailableVersion({ entry.SourceIdentifier, entry.Version, entry.Channel });
+                if (!packageVersion)
+                {
+                    continue;
+                }
+
+                auto installedVersion = match.Package->GetInstalledVersion();
+                Version version{ entry.Version };
+                if ((requireInstalled && !installedVersion) ||
+                    (installedVersion && !version.IsLatest() && Version{ installedVersion->GetProperty(PackageVersionProperty::Version) } >= version))
+                {
+                    // The package was installed or removed since the run was interrupted.
+                    AICLI_LOG(CLI, Info, << "Package no longer needs to be installed: " << entry.Id);
+                    entry.State = OperationCheckpoint::PackageState::Completed;
+                    return true;
+                }
+
+                auto manifest = packageVersion->GetManifest();
+                auto installer = std::find_if(manifest.Installers.begin(), manifest.Installers.end(),
+                    [&](const Manifest::ManifestInstaller& i) { return i.Url == entry.InstallerUrl && SHA256::ConvertToString(i.Sha256) == entry.InstallerSha256; });
+
+                if (installer == manifest.Installers.end())
+                {
+                    return false;
+                }
+
+                Manifest::ManifestInstaller selected = *installer;
+                manifest.ApplyLocale(selected.Locale);
+
+                packagesToInstall.emplace_back(
+                    std::move(packageVersion),
+                    std::move(installedVersion),
+                    std::move(manifest),
+                    std::move(selected),
+                    entry.Scope);
+                return true;
+            }
+
+            return false;
+        }
+    }
+
+    std::string GetCheckpointOperation(const Execution::Args& args)
+    {
+        std::ostringstream result;
+
+        if (args.Contains(Execution::Args::Type::ImportFile))
+        {
+            // The contents are included so that a changed import file is not resumed.
+            std::filesystem::path importFile = std::filesystem::absolute(ConvertToUTF16(args.GetArg(Execution::Args::Type::ImportFile)));
+            std::ifstream importStream{ importFile, std::ifstream::binary };
+            result << "import " << importFile.u8string() << ' ' << SHA256::ConvertToString(SHA256::ComputeHash(importStream));
+        }
+        else
+        {
+            result << "upgrade --all";
+        }
+
+        for (const auto& [type, name] : s_SelectionArgs)
+        {
+            const auto* values = args.GetArgs(type);
+            if (values)
+            {
+                result << " --" << name;
+                for (const auto& value : *values)
+                {
+                    result << ' ' << value;
+                }
+            }
+        }
+
+        return result.str();
+    }
+
+    void ResumeFromCheckpoint(Execution::Context& context)
+    {
+        if (!context.Args.Contains(Execution::Args::Type::Resume))
+        {
+            return;
+        }
+
+        std::string operation = GetCheckpointOperation(context.Args);
+        std::optional<OperationCheckpoint> checkpoint = OperationCheckpoint::Load(operation);
+        if (!checkpoint)
+        {
+            AICLI_LOG(CLI, Info, << "No checkpoint found for operation: " << operation);
+            context.Reporter.Warn() << Resource::String::CheckpointNotFound << std::endl;
+            return;
+        }
+
+        // Import installs packages from the sources listed in the file, while upgrade only updates installed packages.
+        bool isImport = context.Args.Contains(Execution::Args::Type::ImportFile);
+        std::vector<Execution::PackageToInstall> packagesToInstall;
+
+        for (auto& entry : checkpoint->Packages)
+        {
+            if (entry.State == OperationCheckpoint::PackageState::Completed)
+            {
+                continue;
+            }
+
+            Source source = context.Get<Execution::Data::Source>();
+            if (isImport)
+            {
+                const auto& sources = context.Get<Execution::Data::Sources>();
+                auto sourceItr = std::find_if(sources.begin(), sources.end(), [&](const Source& s) { return s.GetIdentifier() == entry.SourceIdentifier; });
+                if (sourceItr == sources.end())
+                {
+                    AICLI_LOG(CLI, Info, << "The source of the checkpoint package is no longer used: " << entry.SourceIdentifier);
+                    context.Reporter.Warn() << Resource::String::CheckpointOutOfDate << std::endl;
+                    return;
+                }
+
+                source = Source{ context.Get<Execution::Data::Source>(), *sourceItr, CompositeSearchBehavior::AllPackages };
+            }
+
+            if (!FindCheckpointPackage(source, entry, !isImport, packagesToInstall))
+            {
+                AICLI_LOG(CLI, Info, << "The checkpoint package is no longer available: " << entry.Id << " " << entry.Version);
+                context.Reporter.Warn() << Resource::String::CheckpointOutOfDate << std::endl;
+                return;
+            }
+        }
+
+        AICLI_LOG(CLI, Info, << "Resuming operation [" << operation << "] with " << packagesToInstall.size() << " packages remaining");
+        context.Reporter.Info() << Resource::String::CheckpointResumed << ' ' << checkpoint->GetCompletedCount() << std::endl;
+
+        context.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
+        context.Add<Execution::Data::OperationCheckpoint>(std::move(checkpoint).value());
+    }
+
+    void BeginCheckpoint(Execution::Context& context)
+    {
+        if (context.Contains(Execution::Data::OperationCheckpoint))
+        {
+            // Resumed from an existing checkpoint
+            return;
+        }
+
+        OperationCheckpoint checkpoint{ GetCheckpointOperation(context.Args) };
+
+        for (const auto& package : context.Get<Execution::Data::PackagesToInstall>())
+        {
+            OperationCheckpoint::Package& entry = checkpoint.Packages.emplace_back();
+            entry.SourceIdentifier = package.PackageVersion->GetProperty(PackageVersionProperty::SourceIdentifier);
+            entry.Id = package.Manifest.Id;
+            entry.Version = package.Manifest.Version;
+            entry.Channel = package.Manifest.Channel;
+            entry.InstallerUrl = package.Installer.Url;
+            entry.InstallerSha256 = SHA256::ConvertToString(package.Installer.Sha256);
+            entry.Scope = package.Scope;
+        }
+
+        checkpoint.Save();
+        context.Add<Execution::Data::OperationCheckpoint>(std::move(checkpoint));
+    }
+
+    void RecordCheckpointDownload(OperationCheckpoint::Package& package, const std::filesystem::path& installerPath)
+    {
+        package.State = OperationCheckpoint::PackageState::Downloaded;
+        package.InstallerPath = installerPath;
+
+        // If either cannot be read, the download is hashed again when it is used.
+        std::error_code sizeError;
+        std::error_code timeError;
+        auto size = std::filesystem::file_size(installerPath, sizeError);
+        auto lastWriteTime = std::filesystem::last_write_time(installerPath, timeError);
+        bool hasStatistics = !sizeError && !timeError;
+        package.InstallerSize = (hasStatistics ? static_cast<int64_t>(size) : 0);
+        package.InstallerLastWriteTime = (hasStatistics ? lastWriteTime.time_since_epoch().count() : 0);
+    }
+
+    void UseCheckpointDownload::operator()(Execution::Context& context) const
+    {
+        const std::filesystem::path& installerPath = m_package.InstallerPath;
+        std::error_code error;
+        if (installerPath.empty() || !std::filesystem::is_regular_file(installerPath, error))
+        {
+            return;
+        }
+
+        // The download was verified against the hash recorded with it, which must still be the one expected.
+        const auto& installer = context.Get<Execution::Data::Installer>().value();
+        if (m_package.InstallerSha256 != SHA256::ConvertToString(installer.Sha256))
+        {
+            AICLI_LOG(CLI, Info, << "Installer downloaded by the interrupted run was verified against a different hash: " << installerPath);
+            return;
+        }
+
+        // A file with the same size and last write time has not changed since it was verified.
+        std::error_code sizeError;
+        std::error_code timeError;
+        auto size = std::filesystem::file_size(installerPath, sizeError);
+        auto lastWriteTime = std::filesystem::last_write_time(installerPath, timeError);
+        if (!sizeError && !timeError && m_package.InstallerSize != 0 &&
+            static_cast<int64_t>(size) == m_package.InstallerSize &&
+            lastWriteTime.time_since_epoch().count() == m_package.InstallerLastWriteTime)
+        {
+            AICLI_LOG(CLI, Info, << "Using the unchanged installer downloaded by the interrupted run: " << installerPath);
+            context.Add<Execution::Data::InstallerPath>(installerPath);
+            context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, installer.Sha256));
+            return;
+        }
+
+        // Otherwise the file is hashed again in case it changed after the interrupted run verified it.
+        std::ifstream inStream{ installerPath, std::ifstream::binary };
+        SHA256::HashBuffer fileHash = SHA256::ComputeHash(inStream);
+
+        if (!SHA256::AreEqual(installer.Sha256, fileHash))
+        {
+            AICLI_LOG(CLI, Info, << "Installer downloaded by the interrupted run no longer matches its hash: " << installerPath);
+            return;
+        }
+
+        AICLI_LOG(CLI, Info, << "Using the installer downloaded by the interrupted run: " << installerPath);
+        context.Add<Execution::Data::InstallerPath>(installerPath);
+        context.Add<Execution::Data::HashPair>(std::make_pair(installer.Sha256, fileHash));
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ExecutionContext.h"
+#include "WorkflowBase.h"
+
+#include <filesystem>
+#include <string>
+
+namespace AppInstaller::CLI::Workflow
+{
+    // Gets the name of the checkpoint for the command; it identifies the command and the arguments
+    // that determine which packages it installs, so that only a matching run is resumed.
+    std::string GetCheckpointOperation(const Execution::Args& args);
+
+    // Loads the checkpoint of an interrupted run and finds the packages that it did not complete, so that
+    // they do not need to be discovered again. Does nothing if the Resume arg is not present; if there is no
+    // checkpoint or its packages are no longer available, the command continues as if it was not resumed.
+    // Required Args: None
+    // Inputs: Source, Sources?
+    // Outputs: PackagesToInstall, OperationCheckpoint (only if the run is resumed)
+    void ResumeFromCheckpoint(Execution::Context& context);
+
+    // Saves a checkpoint with the packages to install, unless the run was resumed from one.
+    // Required Args: None
+    // Inputs: PackagesToInstall
+    // Outputs: OperationCheckpoint
+    void BeginCheckpoint(Execution::Context& context);
+
+    // Records the verified download of the installer for the package, along with its size and last write time.
+    void RecordCheckpointDownload(OperationCheckpoint::Package& package, const std::filesystem::path& installerPath);
+
+    // Uses the installer that was downloaded by an interrupted run if it is still present and matches the expected hash.
+    // The file is only hashed again if its size or last write time changed since it was verified.
+    // Required Args: the checkpoint of the package
+    // Inputs: Installer
+    // Outputs: InstallerPath, HashPair (only if the download is used)
+    struct UseCheckpointDownload : public WorkflowTask
+    {
+        UseCheckpointDownload(OperationCheckpoint::Package package) :
+            WorkflowTask("UseCheckpointDownload"), m_package(std::move(package)) {}
+
+        void operator()(Execution::Context& context) const override;
+
+    private:
+        OperationCheckpoint::Package m_package;
+    };
+}
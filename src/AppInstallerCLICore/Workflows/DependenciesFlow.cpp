@@ -181,6 +181,16 @@ namespace AppInstaller::CLI::Workflow
         if (dependencyGraph.HasLoop())
         {
             context.Reporter.Warn() << Resource::String::DependenciesFlowContainsLoop;
+
+            for (const auto& loop : dependencyGraph.GetLoops())
+            {
+                std::ostringstream loopStream;
+                for (const auto& node : loop)
+                {
+                    loopStream << ' ' << node.Id;
+                }
+                AICLI_LOG(CLI, Warning, << "Dependency loop between:" << loopStream.str());
+            }
         }
 
         const auto& installationOrder = dependencyGraph.GetInstallationOrder();
@@ -4,6 +4,8 @@
 #include "DownloadFlow.h"
 
 #include <AppInstallerMsixInfo.h>
+#include <AppInstallerSynchronization.h>
+#include <winget/ConnectionWarmup.h>
 
 namespace AppInstaller::CLI::Workflow
 {
@@ -153,6 +155,17 @@ namespace AppInstaller::CLI::Workflow
         }
     }
 
+    void WarmUpInstallerConnection(Execution::Context& context)
+    {
+        const auto& installer = context.Get<Execution::Data::Installer>();
+
+        // Store installs are not downloaded by us
+        if (installer && installer->InstallerType != InstallerTypeEnum::MSStore)
+        {
+            Network::ConnectionWarmup::Instance().WarmUp(installer->Url);
+        }
+    }
+
     void DownloadInstaller(Execution::Context& context)
     {
         // Check if file was already downloaded.
@@ -207,6 +220,12 @@ namespace AppInstaller::CLI::Workflow
 
     void CheckForExistingInstaller(Execution::Context& context)
     {
+        if (context.Contains(Execution::Data::InstallerPath))
+        {
+            // The installer was already found and verified, such as the one downloaded by an interrupted run.
+            return;
+        }
+
         const auto& installer = context.Get<Execution::Data::Installer>().value();
         if (installer.InstallerType == InstallerTypeEnum::MSStore)
         {
@@ -262,40 +281,35 @@ namespace AppInstaller::CLI::Workflow
 
         std::optional<std::vector<BYTE>> hash;
 
-        const int MaxRetryCount = 2;
-        for (int retryCount = 0; retryCount < MaxRetryCount; ++retryCount)
-        {
-            bool success = false;
-            try
-            {
-                hash = context.Reporter.ExecuteWithProgress(std::bind(Utility::Download,
-                    installer.Url,
-                    installerPath,
-                    Utility::DownloadType::Installer,
-                    std::placeholders::_1,
-                    true,
-                    downloadInfo));
-
-                success = true;
-            }
-            catch (...)
+        // The retry wait is done under the same progress as the downloads so that cancelling ends it immediately.
+        hash = context.Reporter.ExecuteWithProgress([&](IProgressCallback& progress) -> std::optional<std::vector<BYTE>>
             {
-                if (retryCount < MaxRetryCount - 1)
+                const int MaxRetryCount = 2;
+                for (int retryCount = 0; retryCount < MaxRetryCount; ++retryCount)
                 {
-                    AICLI_LOG(CLI, Info, << "Failed to download, waiting a bit and retry. Url: " << installer.Url);
-                    Sleep(500);
-                }
-                else
-                {
-                    throw;
+                    try
+                    {
+                        return Utility::Download(installer.Url, installerPath, Utility::DownloadType::Installer, progress, true, downloadInfo);
+                    }
+                    catch (...)
+                    {
+                        if (retryCount < MaxRetryCount - 1)
+                        {
+                            AICLI_LOG(CLI, Info, << "Failed to download, waiting a bit and retry. Url: " << installer.Url);
+                            if (!Synchronization::SleepUnlessCancelled(500ms, progress))
+                            {
+                                return {};
+                            }
+                        }
+                        else
+                        {
+                            throw;
+                        }
+                    }
                 }
-            }
 
-            if (success)
-            {
-                break;
-            }
-        }
+                return {};
+            });
 
         if (!hash)
         {
@@ -11,9 +11,16 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void DownloadInstaller(Execution::Context& context);
 
-    // Check if the desired installer has already been downloaded.
+    // Starts connecting to the host of the installer if warming up connections is enabled,
+    // so that the download does not have to wait on it.
     // Required Args: None
-    // Inputs: Manifest, Installer
+    // Inputs: Installer
+    // Outputs: None
+    void WarmUpInstallerConnection(Execution::Context& context);
+
+    // Check if the desired installer has already been downloaded. Does nothing if the InstallerPath was already determined.
+    // Required Args: None
+    // Inputs: Manifest, Installer, InstallerPath?
     // Outputs: HashPair, InstallerPath (only if found)
     void CheckForExistingInstaller(Execution::Context& context);
 
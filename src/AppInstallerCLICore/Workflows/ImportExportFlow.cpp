@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #include "pch.h"
+#include "CheckpointFlow.h"
 #include "InstallFlow.h"
 #include "ImportExportFlow.h"
 #include "UpdateFlow.h"
@@ -245,6 +246,12 @@ namespace AppInstaller::CLI::Workflow
 
     void SearchPackagesForImport(Execution::Context& context)
     {
+        if (context.Contains(Execution::Data::PackagesToInstall))
+        {
+            // The packages were already found by the interrupted run that is being resumed
+            return;
+        }
+
         const auto& sources = context.Get<Execution::Data::Sources>();
         std::vector<Execution::PackageToInstall> packagesToInstall = {};
         bool foundAll = true;
@@ -348,8 +355,10 @@ namespace AppInstaller::CLI::Workflow
 
     void InstallImportedPackages(Execution::Context& context)
     {
-        context << Workflow::InstallMultiplePackages(
-            Resource::String::ImportCommandReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, true, true);
+        context <<
+            Workflow::BeginCheckpoint <<
+            Workflow::InstallMultiplePackages(
+                Resource::String::ImportCommandReportDependencies, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED, {}, true, true);
 
         if (context.GetTerminationHR() == APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED)
         {
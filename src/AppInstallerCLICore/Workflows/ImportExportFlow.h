@@ -31,6 +31,7 @@ namespace AppInstaller::CLI::Workflow
 
     // Finds the package versions to install matching their descriptions
     // Needs the sources for all packages and the installed source
+    // Does nothing if the packages were already found by resuming an interrupted run
     // Required Args: None
     // Inputs: PackageCollection, Sources, Source
     // Outputs: PackagesToInstall
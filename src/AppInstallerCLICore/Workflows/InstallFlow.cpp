@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "InstallFlow.h"
+#include "CheckpointFlow.h"
 #include "DownloadFlow.h"
 #include "UninstallFlow.h"
 #include "ShowFlow.h"
@@ -9,6 +10,7 @@
 #include "ShellExecuteInstallerHandler.h"
 #include "MSStoreInstallerHandler.h"
 #include "MsiInstallFlow.h"
+#include "OverlappedExecution.h"
 #include "WorkflowBase.h"
 #include "Workflows/DependenciesFlow.h"
 #include <AppInstallerDeployment.h>
@@ -376,22 +378,43 @@ namespace AppInstaller::CLI::Workflow
             Workflow::RemoveInstaller;
     }
 
-    void DownloadSinglePackage(Execution::Context& context)
+    void PrepareToDownloadSinglePackage(Execution::Context& context)
     {
         context <<
+            Workflow::WarmUpInstallerConnection <<
             Workflow::ReportIdentityAndInstallationDisclaimer <<
             Workflow::ShowPackageAgreements(/* ensureAcceptance */ true) <<
             Workflow::GetDependenciesFromInstaller <<
             Workflow::ReportDependencies(Resource::String::InstallAndUpgradeCommandsReportDependencies) <<
-            Workflow::ManagePackageDependencies(Resource::String::InstallAndUpgradeCommandsReportDependencies) <<
+            Workflow::ManagePackageDependencies(Resource::String::InstallAndUpgradeCommandsReportDependencies);
+    }
+
+    void DownloadSinglePackage(Execution::Context& context)
+    {
+        context <<
+            Workflow::PrepareToDownloadSinglePackage <<
             Workflow::DownloadInstaller;
     }
 
     void InstallSinglePackage(Execution::Context& context)
     {
-        context <<
-            Workflow::DownloadSinglePackage <<
-            Workflow::InstallPackageInstaller;
+        if (ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::OverlappedWorkflowTasks))
+        {
+            // Take the snapshot of the installed packages while the installer is downloaded;
+            // InstallPackageInstaller keeps the snapshot rather than taking it again.
+            context <<
+                Workflow::PrepareToDownloadSinglePackage <<
+                Workflow::ExecuteOverlapped(
+                    WorkflowTask{ Workflow::DownloadInstaller, { Data::Manifest, Data::Installer, Data::PackageVersion, Data::InstallerPath }, { Data::InstallerPath, Data::HashPair } },
+                    WorkflowTask{ Workflow::SnapshotARPEntries, { Data::Installer }, { Data::ARPSnapshot } }) <<
+                Workflow::InstallPackageInstaller;
+        }
+        else
+        {
+            context <<
+                Workflow::DownloadSinglePackage <<
+                Workflow::InstallPackageInstaller;
+        }
     }
 
     void InstallMultiplePackages::operator()(Execution::Context& context) const
@@ -423,9 +446,19 @@ namespace AppInstaller::CLI::Workflow
         bool allSucceeded = true;
         size_t packagesCount = context.Get<Execution::Data::PackagesToInstall>().size();
         size_t packagesProgress = 0;
+
+        // The progress of each package is saved to the checkpoint, if there is one, so that an interrupted run can be resumed.
+        OperationCheckpoint* checkpoint = (context.Contains(Execution::Data::OperationCheckpoint) ? &context.Get<Execution::Data::OperationCheckpoint>() : nullptr);
         
         for (auto package : context.Get<Execution::Data::PackagesToInstall>())
         {
+            OperationCheckpoint::Package* checkpointPackage = nullptr;
+            if (checkpoint)
+            {
+                checkpointPackage = checkpoint->Find(
+                    package.PackageVersion->GetProperty(PackageVersionProperty::SourceIdentifier).get(), package.Manifest.Id, package.Manifest.Version, package.Manifest.Channel);
+            }
+
             Logging::SubExecutionTelemetryScope subExecution{ package.PackageSubExecutionId };
 
             packagesProgress++;
@@ -446,11 +479,23 @@ namespace AppInstaller::CLI::Workflow
             {
                 installContext << Workflow::ManagePackageDependencies(m_dependenciesReportMessage);
             }
+            if (checkpointPackage && checkpointPackage->State == OperationCheckpoint::PackageState::Downloaded)
+            {
+                installContext << Workflow::UseCheckpointDownload(*checkpointPackage);
+            }
             installContext << Workflow::DownloadInstaller;
+
+            if (checkpointPackage && !installContext.IsTerminated() && installContext.Contains(Execution::Data::InstallerPath))
+            {
+                RecordCheckpointDownload(*checkpointPackage, installContext.Get<Execution::Data::InstallerPath>());
+                checkpoint->Save();
+            }
+
             installContext << Workflow::InstallPackageInstaller;
 
             installContext.Reporter.Info() << std::endl;
 
+            bool succeeded = true;
             if (installContext.IsTerminated())
             {
                 if (context.IsTerminated() && context.GetTerminationHR() == E_ABORT)
@@ -463,8 +508,21 @@ namespace AppInstaller::CLI::Workflow
                 if (m_ignorableInstallResults.end() == std::find(m_ignorableInstallResults.begin(), m_ignorableInstallResults.end(), installContext.GetTerminationHR()))
                 {
                     allSucceeded = false;
+                    succeeded = false;
                 }
             }
+
+            if (checkpointPackage && succeeded)
+            {
+                checkpointPackage->State = OperationCheckpoint::PackageState::Completed;
+                checkpoint->Save();
+            }
+        }
+
+        if (checkpoint && allSucceeded)
+        {
+            // Nothing is left to resume
+            checkpoint->Remove();
         }
 
         if (!allSucceeded)
@@ -475,6 +533,12 @@ namespace AppInstaller::CLI::Workflow
 
     void SnapshotARPEntries(Execution::Context& context) try
     {
+        // The snapshot may have been taken already, while the installer was downloaded
+        if (context.Contains(Execution::Data::ARPSnapshot))
+        {
+            return;
+        }
+
         // Ensure that installer type might actually write to ARP, otherwise this is a waste of time
         auto installer = context.Get<Execution::Data::Installer>();
 
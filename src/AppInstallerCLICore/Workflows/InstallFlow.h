@@ -119,6 +119,12 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void InstallPackageInstaller(Execution::Context& context);
 
+    // Does the reporting and user interaction needed before downloading the installer for a single package.
+    // Required Args: None
+    // Inputs: Manifest, Installer
+    // Outputs: None
+    void PrepareToDownloadSinglePackage(Execution::Context& context);
+
     // Downloads the installer for a single package. This also does all the reporting and user interaction needed.
     // Required Args: None
     // Inputs: Manifest, Installer
@@ -133,8 +139,9 @@ namespace AppInstaller::CLI::Workflow
     void InstallSinglePackage(Execution::Context& context);
 
     // Installs multiple packages. This also does the reporting and user interaction needed.
+    // The progress of each package is saved to the OperationCheckpoint if one is present.
     // Required Args: None
-    // Inputs: PackagesToInstall
+    // Inputs: PackagesToInstall, OperationCheckpoint?
     // Outputs: None
     struct InstallMultiplePackages : public WorkflowTask
     {
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "MSStoreInstallerHandler.h"
+#include <AppInstallerSynchronization.h>
 
 
 namespace AppInstaller::CLI::Workflow
@@ -30,6 +31,20 @@ namespace AppInstaller::CLI::Workflow
                     // Averaging every progress for now until we have a better way to find overall progress.
                     uint64_t overallProgressMax = 100 * static_cast<uint64_t>(installItems.Size());
                     uint64_t currentProgress = 0;
+                    bool cancelRequested = false;
+
+                    // Status is re-read when an item reports a change rather than on a fixed interval.
+                    // The timeout only guards against a change that is not reported.
+                    constexpr std::chrono::milliseconds StatusWaitTimeout = 1s;
+                    wil::unique_event statusChanged{ wil::EventOptions::None };
+                    std::vector<AppInstallItem::StatusChanged_revoker> statusChangedRevokers;
+                    std::vector<AppInstallItem::Completed_revoker> completedRevokers;
+
+                    for (auto const& installItem : installItems)
+                    {
+                        statusChangedRevokers.emplace_back(installItem.StatusChanged(winrt::auto_revoke, [&statusChanged](const AppInstallItem&, const IInspectable&) { statusChanged.SetEvent(); }));
+                        completedRevokers.emplace_back(installItem.Completed(winrt::auto_revoke, [&statusChanged](const AppInstallItem&, const IInspectable&) { statusChanged.SetEvent(); }));
+                    }
 
                     while (currentProgress < overallProgressMax)
                     {
@@ -55,15 +70,25 @@ namespace AppInstaller::CLI::Workflow
                             progress.OnProgress(currentProgress, overallProgressMax, ProgressType::Percent);
                         }
 
-                        if (progress.IsCancelled())
+                        if (!cancelRequested && progress.IsCancelled())
                         {
                             for (auto const& installItem : installItems)
                             {
                                 installItem.Cancel();
                             }
+
+                            cancelRequested = true;
                         }
 
-                        Sleep(100);
+                        if (cancelRequested)
+                        {
+                            // Wait for the items to report the cancellation.
+                            statusChanged.wait(static_cast<DWORD>(StatusWaitTimeout.count()));
+                        }
+                        else
+                        {
+                            Synchronization::WaitForSingleObjectOrCancellation(statusChanged.get(), progress, StatusWaitTimeout);
+                        }
                     }
                 });
 
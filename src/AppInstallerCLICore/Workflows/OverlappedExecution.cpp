@@ -0,0 +1,165 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "OverlappedExecution.h"
+#include <winget/ExperimentalFeature.h>
+
+using namespace AppInstaller::CLI::Execution;
+
+namespace AppInstaller::CLI::Workflow
+{
+    namespace
+    {
+        bool ContainsAny(const std::vector<Data>& values, const std::vector<Data>& search)
+        {
+            return std::any_of(search.begin(), search.end(), [&](Data data) { return std::find(values.begin(), values.end(), data) != values.end(); });
+        }
+
+        // Determines if the later task must not start until the earlier one has completed.
+        bool MustFollow(const WorkflowTask& earlier, const WorkflowTask& later)
+        {
+            if (!earlier.HasDeclaredDataAccess() || !later.HasDeclaredDataAccess())
+            {
+                return true;
+            }
+
+            return
+                ContainsAny(earlier.GetDataWrites(), later.GetDataReads()) ||
+                ContainsAny(earlier.GetDataWrites(), later.GetDataWrites()) ||
+                ContainsAny(earlier.GetDataReads(), later.GetDataWrites());
+        }
+
+        // A task running in the background on a clone of the context.
+        // Its results are only applied to the context when it is completed.
+        struct BackgroundTask
+        {
+            BackgroundTask(Context& context, const WorkflowTask& task) :
+                m_task(task), m_context(context.Clone())
+            {
+                m_context->Args = context.Args;
+                m_context->Reporter.CaptureOutput();
+
+                // The termination is only logged if it is applied to the context.
+                m_context->DeferTerminationTelemetry();
+
+                for (Data data : m_task.GetDataReads())
+                {
+                    if (context.Contains(data))
+                    {
+                        m_context->Copy(context, data);
+                    }
+                }
+
+                ThreadLocalStorage::ThreadGlobals* threadGlobals = ThreadLocalStorage::ThreadGlobals::GetForCurrentThread();
+
+                m_result = std::async(std::launch::async, [this, threadGlobals]()
+                    {
+                        std::unique_ptr<ThreadLocalStorage::PreviousThreadGlobals> previousThreadGlobals;
+                        if (threadGlobals)
+                        {
+                            previousThreadGlobals = threadGlobals->SetForCurrentThread();
+                        }
+
+                        *m_context << m_task;
+                    });
+            }
+
+            BackgroundTask(const BackgroundTask&) = delete;
+            BackgroundTask& operator=(const BackgroundTask&) = delete;
+
+            BackgroundTask(BackgroundTask&&) = delete;
+            BackgroundTask& operator=(BackgroundTask&&) = delete;
+
+            ~BackgroundTask()
+            {
+                if (m_result.valid())
+                {
+                    // The results will not be used, so stop anything in progress rather than waiting on it.
+                    m_context->Reporter.CancelInProgressTask(false);
+                    m_result.wait();
+                }
+            }
+
+            // Waits for the task and applies its results to the context, as if it had run on it.
+            void Complete(Context& context)
+            {
+                m_result.wait();
+
+                for (const auto& [level, output] : m_context->Reporter.TakeCapturedOutput())
+                {
+                    context.Reporter.GetOutputStream(level) << output;
+                }
+
+                // Rethrows anything thrown by the task.
+                m_result.get();
+
+                for (Data data : m_task.GetDataWrites())
+                {
+                    if (m_context->Contains(data))
+                    {
+                        context.Move(*m_context, data);
+                    }
+                }
+
+                context.SetFlags(m_context->GetFlags());
+
+                m_context->ApplyTermination(context);
+            }
+
+        private:
+            const WorkflowTask& m_task;
+            std::unique_ptr<Context> m_context;
+            std::future<void> m_result;
+        };
+    }
+
+    void ExecuteOverlapped::operator()(Execution::Context& context) const
+    {
+        if (!Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::OverlappedWorkflowTasks))
+        {
+            for (const auto& task : m_tasks)
+            {
+                context << *task;
+            }
+
+            return;
+        }
+
+        // The tasks that were started in the background, by their index.
+        // Any that remain when leaving, because the context was terminated, are discarded.
+        std::vector<std::unique_ptr<BackgroundTask>> background(m_tasks.size());
+
+        for (size_t current = 0; current < m_tasks.size() && !context.IsTerminated(); ++current)
+        {
+            for (size_t later = current + 1; later < m_tasks.size(); ++later)
+            {
+                if (background[later])
+                {
+                    continue;
+                }
+
+                bool canStart = true;
+                for (size_t earlier = current; canStart && earlier < later; ++earlier)
+                {
+                    canStart = !MustFollow(*m_tasks[earlier], *m_tasks[later]);
+                }
+
+                if (canStart)
+                {
+                    AICLI_LOG(CLI, Verbose, << "Starting task " << later << " of " << m_tasks.size() << " in the background");
+                    background[later] = std::make_unique<BackgroundTask>(context, *m_tasks[later]);
+                }
+            }
+
+            if (background[current])
+            {
+                background[current]->Complete(context);
+                background[current].reset();
+            }
+            else
+            {
+                context << *m_tasks[current];
+            }
+        }
+    }
+}
@@ -0,0 +1,46 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ExecutionContext.h"
+
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace AppInstaller::CLI::Workflow
+{
+    // Runs the given tasks in order, as if each was given to the context with operator<<.
+    // With the OverlappedWorkflowTasks experimental feature, a task that has declared its data access is started in the
+    // background as soon as no earlier task that has not completed must precede it. A task must precede another if either
+    // did not declare its data access, or if one of them writes data that the other reads or writes.
+    // The output, data, flags and termination of each task are applied to the context in the order of the tasks,
+    // and the tasks after one that terminated the context have no effect. A task that does not run in the background
+    // runs on the context itself, so only it can interact with the user.
+    // Required Args: None
+    // Inputs: Those of the tasks
+    // Outputs: Those of the tasks
+    struct ExecuteOverlapped : public WorkflowTask
+    {
+        template <typename... Tasks, std::enable_if_t<(sizeof...(Tasks) > 1), int> = 0>
+        ExecuteOverlapped(Tasks&&... tasks) : WorkflowTask("ExecuteOverlapped")
+        {
+            (m_tasks.emplace_back(MakeTask(std::forward<Tasks>(tasks))), ...);
+        }
+
+        void operator()(Execution::Context& context) const override;
+
+    private:
+        static std::shared_ptr<const WorkflowTask> MakeTask(WorkflowTask::Func f)
+        {
+            return std::make_shared<WorkflowTask>(f);
+        }
+
+        template <typename T, std::enable_if_t<std::is_base_of_v<WorkflowTask, std::decay_t<T>>, int> = 0>
+        static std::shared_ptr<const WorkflowTask> MakeTask(T&& task)
+        {
+            return std::make_shared<std::decay_t<T>>(std::forward<T>(task));
+        }
+
+        std::vector<std::shared_ptr<const WorkflowTask>> m_tasks;
+    };
+}
@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "ShellExecuteInstallerHandler.h"
 #include "AppInstallerFileLogger.h"
+#include <AppInstallerSynchronization.h>
 
 using namespace AppInstaller::CLI;
 using namespace AppInstaller::Utility;
@@ -32,21 +33,8 @@ namespace AppInstaller::CLI::Workflow
 
             wil::unique_process_handle process{ execInfo.hProcess };
 
-            // Wait for installation to finish
-            while (!progress.IsCancelled())
-            {
-                DWORD waitResult = WaitForSingleObject(process.get(), 250);
-                if (waitResult == WAIT_OBJECT_0)
-                {
-                    break;
-                }
-                if (waitResult != WAIT_TIMEOUT)
-                {
-                    THROW_LAST_ERROR_MSG("Unexpected WaitForSingleObjectResult: %lu", waitResult);
-                }
-            }
-
-            if (progress.IsCancelled())
+            // Wait for installation to finish, or cancellation
+            if (Synchronization::WaitForSingleObjectOrCancellation(process.get(), progress) == Synchronization::WaitResult::Cancelled)
             {
                 return {};
             }
@@ -118,6 +118,25 @@ namespace AppInstaller::CLI::Workflow
                 }
             }
 
+            if (context.Args.Contains(Execution::Args::Type::SourceMirror))
+            {
+                sourceToAdd.SetMirrors(*context.Args.GetArgs(Execution::Args::Type::SourceMirror));
+            }
+
+            if (context.Args.Contains(Execution::Args::Type::SourceScopeNamespace) || context.Args.Contains(Execution::Args::Type::SourceScopePublisher))
+            {
+                Repository::SourceScope scope;
+                if (context.Args.Contains(Execution::Args::Type::SourceScopeNamespace))
+                {
+                    scope.IdentifierNamespaces = *context.Args.GetArgs(Execution::Args::Type::SourceScopeNamespace);
+                }
+                if (context.Args.Contains(Execution::Args::Type::SourceScopePublisher))
+                {
+                    scope.Publishers = *context.Args.GetArgs(Execution::Args::Type::SourceScopePublisher);
+                }
+                sourceToAdd.SetScope(std::move(scope));
+            }
+
             context << Workflow::HandleSourceAgreements(sourceToAdd);
             if (context.IsTerminated())
             {
@@ -147,6 +166,18 @@ namespace AppInstaller::CLI::Workflow
             table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListName), source.Name });
             table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListType), source.Type });
             table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListArg), source.Arg });
+            for (const auto& mirror : source.Mirrors)
+            {
+                table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListMirror), mirror });
+            }
+            for (const auto& identifierNamespace : source.Scope.IdentifierNamespaces)
+            {
+                table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListScopeNamespace), identifierNamespace });
+            }
+            for (const auto& publisher : source.Scope.Publishers)
+            {
+                table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListScopePublisher), publisher });
+            }
             table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListData), source.Data });
             table.OutputLine({ Resource::Loader::Instance().ResolveString(Resource::String::SourceListIdentifier), source.Identifier });
 
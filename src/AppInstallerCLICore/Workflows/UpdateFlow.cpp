@@ -3,6 +3,7 @@
 
 #include "pch.h"
 #include "WorkflowBase.h"
+#include "CheckpointFlow.h"
 #include "DependenciesFlow.h"
 #include "InstallFlow.h"
 #include "UpdateFlow.h"
@@ -19,6 +20,16 @@ namespace AppInstaller::CLI::Workflow
             return (installedVersion < updateVersion || updateVersion.IsLatest());
         }
 
+        void InstallUpdates(Execution::Context& context)
+        {
+            context <<
+                BeginCheckpoint <<
+                InstallMultiplePackages(
+                    Resource::String::InstallAndUpgradeCommandsReportDependencies,
+                    APPINSTALLER_CLI_ERROR_UPDATE_ALL_HAS_FAILURE,
+                    { APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE });
+        }
+
         void AddToPackagesToInstallIfNotPresent(std::vector<Execution::PackageToInstall>& packagesToInstall, Execution::PackageToInstall&& package)
         {
             for (auto const& existing : packagesToInstall)
@@ -117,6 +128,13 @@ namespace AppInstaller::CLI::Workflow
 
     void UpdateAllApplicable(Execution::Context& context)
     {
+        if (context.Contains(Execution::Data::PackagesToInstall))
+        {
+            // The updates were already found by the interrupted run that is being resumed
+            context << InstallUpdates;
+            return;
+        }
+
         const auto& matches = context.Get<Execution::Data::SearchResult>().Matches;
         std::vector<Execution::PackageToInstall> packagesToInstall;
         bool updateAllFoundUpdate = false;
@@ -160,10 +178,6 @@ namespace AppInstaller::CLI::Workflow
         }
 
         context.Add<Execution::Data::PackagesToInstall>(std::move(packagesToInstall));
-        context <<
-            InstallMultiplePackages(
-                Resource::String::InstallAndUpgradeCommandsReportDependencies,
-                APPINSTALLER_CLI_ERROR_UPDATE_ALL_HAS_FAILURE,
-                { APPINSTALLER_CLI_ERROR_UPDATE_NOT_APPLICABLE });
+        context << InstallUpdates;
     }
 }
\ No newline at end of file
@@ -27,9 +27,9 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void EnsureUpdateVersionApplicable(Execution::Context& context);
 
-    // Update all packages from SearchResult to latest if applicable
+    // Update all packages from SearchResult to latest if applicable, or the PackagesToInstall of a resumed run
     // Required Args: None
-    // Inputs: SearchResult
+    // Inputs: SearchResult, PackagesToInstall?
     // Outputs: None
     void UpdateAllApplicable(Execution::Context& context);
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include "ExecutionContext.h"
 #include "ManifestComparator.h"
 #include "TableOutput.h"
+#include <winget/ConnectionWarmup.h>
 #include <winget/ManifestYamlParser.h>
 
 
@@ -149,6 +150,40 @@ namespace AppInstaller::CLI::Workflow
             }
         }
 
+        // Performs a search with the semantics of targeting many packages, where only the given fields are needed from the sources.
+        void SearchSourceForManyWithFields(Execution::Context& context, SearchResultFields fields)
+        {
+            const auto& args = context.Args;
+
+            MatchType matchType = MatchType::Substring;
+            if (args.Contains(Execution::Args::Type::Exact))
+            {
+                matchType = MatchType::Exact;
+            }
+
+            SearchRequest searchRequest;
+            if (args.Contains(Execution::Args::Type::Query))
+            {
+                searchRequest.Query.emplace(RequestMatch(matchType, args.GetArg(Execution::Args::Type::Query)));
+            }
+
+            SearchSourceApplyFilters(context, searchRequest, matchType);
+            searchRequest.Fields = fields;
+
+            Logging::Telemetry().LogSearchRequest(
+                "many",
+                args.GetArg(Execution::Args::Type::Query),
+                args.GetArg(Execution::Args::Type::Id),
+                args.GetArg(Execution::Args::Type::Name),
+                args.GetArg(Execution::Args::Type::Moniker),
+                args.GetArg(Execution::Args::Type::Tag),
+                args.GetArg(Execution::Args::Type::Command),
+                searchRequest.MaximumResults,
+                searchRequest.ToString());
+
+            context.Add<Execution::Data::SearchResult>(context.Get<Execution::Data::Source>().Search(searchRequest));
+        }
+
         bool HandleSourceAgreementsForOneSource(Execution::Context& context, const Source& source)
         {
             auto details = source.GetDetails();
@@ -431,34 +466,12 @@ namespace AppInstaller::CLI::Workflow
 
     void SearchSourceForMany(Execution::Context& context)
     {
-        const auto& args = context.Args;
-
-        MatchType matchType = MatchType::Substring;
-        if (args.Contains(Execution::Args::Type::Exact))
-        {
-            matchType = MatchType::Exact;
-        }
-
-        SearchRequest searchRequest;
-        if (args.Contains(Execution::Args::Type::Query))
-        {
-            searchRequest.Query.emplace(RequestMatch(matchType, args.GetArg(Execution::Args::Type::Query)));
-        }
-
-        SearchSourceApplyFilters(context, searchRequest, matchType);
-
-        Logging::Telemetry().LogSearchRequest(
-            "many",
-            args.GetArg(Execution::Args::Type::Query),
-            args.GetArg(Execution::Args::Type::Id),
-            args.GetArg(Execution::Args::Type::Name),
-            args.GetArg(Execution::Args::Type::Moniker),
-            args.GetArg(Execution::Args::Type::Tag),
-            args.GetArg(Execution::Args::Type::Command),
-            searchRequest.MaximumResults,
-            searchRequest.ToString());
+        SearchSourceForManyWithFields(context, SearchResultFields::All);
+    }
 
-        context.Add<Execution::Data::SearchResult>(context.Get<Execution::Data::Source>().Search(searchRequest));
+    void SearchSourceForManyToReport(Execution::Context& context)
+    {
+        SearchSourceForManyWithFields(context, SearchResultFields::LatestVersion);
     }
 
     void SearchSourceForSingle(Execution::Context& context)
@@ -511,6 +524,9 @@ namespace AppInstaller::CLI::Workflow
 
         SearchSourceApplyFilters(context, searchRequest, matchType);
 
+        // Completion only outputs the identifier or the matched value.
+        searchRequest.Fields = SearchResultFields::None;
+
         context.Add<Execution::Data::SearchResult>(context.Get<Execution::Data::Source>().Search(searchRequest));
     }
 
@@ -526,6 +542,9 @@ namespace AppInstaller::CLI::Workflow
 
         SearchSourceApplyFilters(context, searchRequest, matchType);
 
+        // Completion only outputs the identifier or the matched value.
+        searchRequest.Fields = SearchResultFields::None;
+
         context.Add<Execution::Data::SearchResult>(context.Get<Execution::Data::Source>().Search(searchRequest));
     }
 
@@ -539,6 +558,9 @@ namespace AppInstaller::CLI::Workflow
         // If filters are provided, be generous with the search no matter the intended result.
         SearchSourceApplyFilters(context, searchRequest, MatchType::Substring);
 
+        // Completion only outputs the identifier or the matched value.
+        searchRequest.Fields = SearchResultFields::None;
+
         context.Add<Execution::Data::SearchResult>(context.Get<Execution::Data::Source>().Search(searchRequest));
     }
 
@@ -939,6 +961,41 @@ namespace AppInstaller::CLI::Workflow
         ReportIdentity(context, manifest.CurrentLocalization.Get<Manifest::Localization::PackageName>(), manifest.Id, manifest.Version);
     }
 
+    void WarmUpSourceConnections(Execution::Context& context) try
+    {
+        if (!Network::IsConnectionWarmUpEnabled())
+        {
+            return;
+        }
+
+        std::string_view sourceName;
+        if (context.Args.Contains(Execution::Args::Type::Source))
+        {
+            sourceName = context.Args.GetArg(Execution::Args::Type::Source);
+        }
+
+        for (const auto& source : Source::GetCurrentSources())
+        {
+            if (sourceName.empty() || Utility::CaseInsensitiveEquals(source.Name, sourceName))
+            {
+                Network::ConnectionWarmup::Instance().WarmUp(source.Arg);
+            }
+        }
+    }
+    CATCH_LOG()
+
+    void WarmUpSourceIndexes(Execution::Context& context) try
+    {
+        std::string_view sourceName;
+        if (context.Args.Contains(Execution::Args::Type::Source))
+        {
+            sourceName = context.Args.GetArg(Execution::Args::Type::Source);
+        }
+
+        Source::WarmUp(sourceName);
+    }
+    CATCH_LOG()
+
     void GetManifest(Execution::Context& context)
     {
         if (context.Args.Contains(Execution::Args::Type::Manifest))
@@ -949,6 +1006,8 @@ namespace AppInstaller::CLI::Workflow
         else
         {
             context <<
+                WarmUpSourceIndexes <<
+                WarmUpSourceConnections <<
                 OpenSource() <<
                 SearchSourceForSingle <<
                 HandleSearchResultFailures <<
@@ -7,11 +7,13 @@
 
 #include <string>
 #include <string_view>
+#include <vector>
 
 
 namespace AppInstaller::CLI::Execution
 {
     struct Context;
+    enum class Data : size_t;
 }
 
 namespace AppInstaller::CLI::Workflow
@@ -36,6 +38,12 @@ namespace AppInstaller::CLI::Workflow
         WorkflowTask(Func f) : m_isFunc(true), m_func(f) {}
         WorkflowTask(std::string_view name) : m_name(name) {}
 
+        // Creates a task for the function that declares the context data it reads and writes; see DeclareDataAccess.
+        WorkflowTask(Func f, std::vector<Execution::Data> reads, std::vector<Execution::Data> writes) : m_isFunc(true), m_func(f)
+        {
+            DeclareDataAccess(std::move(reads), std::move(writes));
+        }
+
         virtual ~WorkflowTask() = default;
 
         WorkflowTask(const WorkflowTask&) = default;
@@ -50,10 +58,33 @@ namespace AppInstaller::CLI::Workflow
 
         const std::string& GetName() const { return m_name; }
 
+        // Gets whether the task has declared the context data that it reads and writes.
+        bool HasDeclaredDataAccess() const { return m_hasDeclaredDataAccess; }
+
+        // Gets the context data that the task declared that it reads.
+        const std::vector<Execution::Data>& GetDataReads() const { return m_dataReads; }
+
+        // Gets the context data that the task declared that it writes.
+        const std::vector<Execution::Data>& GetDataWrites() const { return m_dataWrites; }
+
+    protected:
+        // Declares all of the context data that the task reads and writes.
+        // This also declares that the task uses no other state of the context (beyond its args and flags)
+        // and does not prompt the user, so that it can be run alongside other tasks by ExecuteOverlapped.
+        void DeclareDataAccess(std::vector<Execution::Data> reads, std::vector<Execution::Data> writes)
+        {
+            m_hasDeclaredDataAccess = true;
+            m_dataReads = std::move(reads);
+            m_dataWrites = std::move(writes);
+        }
+
     private:
         bool m_isFunc = false;
         Func m_func = nullptr;
         std::string m_name;
+        bool m_hasDeclaredDataAccess = false;
+        std::vector<Execution::Data> m_dataReads;
+        std::vector<Execution::Data> m_dataWrites;
     };
 
     // Helper to report exceptions and return the HRESULT.
@@ -123,6 +154,12 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: SearchResult
     void SearchSourceForMany(Execution::Context& context);
 
+    // Performs a search on the source, where only the data that ReportSearchResult outputs is needed from the packages.
+    // Required Args: None
+    // Inputs: Source
+    // Outputs: SearchResult
+    void SearchSourceForManyToReport(Execution::Context& context);
+
     // Performs a search on the source with the semantics of targeting a single package.
     // Required Args: None
     // Inputs: Source
@@ -302,6 +339,21 @@ namespace AppInstaller::CLI::Workflow
     // Outputs: None
     void ReportManifestIdentityWithVersion(Execution::Context& context);
 
+    // Starts connecting to the sources that the command will use if warming up connections is enabled,
+    // so that downloading from them later does not have to wait on it.
+    // Required Args: None
+    // Inputs: None
+    // Outputs: None
+    void WarmUpSourceConnections(Execution::Context& context);
+
+    // Starts reading the indexes of the sources that the command will search if warming up indexes is enabled,
+    // so that the first searches of them do not have to wait on storage. Everything is done in the background,
+    // so this is the first task of the command, to overlap as much of the rest of the startup as possible.
+    // Required Args: None
+    // Inputs: None
+    // Outputs: None
+    void WarmUpSourceIndexes(Execution::Context& context);
+
     // Composite flow that produces a manifest; either from one given on the command line or by searching.
     // Required Args: None
     // Inputs: None
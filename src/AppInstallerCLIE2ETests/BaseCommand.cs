@@ -60,6 +60,11 @@ namespace AppInstallerCLIE2ETests
                     experimentalCmd = status,
                     dependencies = status,
                     directMSI = status,
+                    lazySourceOpen = status,
+                    overlappedWorkflowTasks = status,
+                    correlationMemo = status,
+                    operationArenas = status,
+                    searchMemo = status,
                 }
             };
 
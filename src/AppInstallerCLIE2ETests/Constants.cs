@@ -139,6 +139,9 @@ namespace AppInstallerCLIE2ETests
             public const int ERROR_MISSING_RESOURCE_FILE = unchecked((int)0x8A150048);
             public const int ERROR_MSI_INSTALL_FAILED = unchecked((int)0x8A150049);
             public const int ERROR_INVALID_MSIEXEC_ARGUMENT = unchecked((int)0x8A15004A);
+            public const int ERROR_FAILED_TO_OPEN_ALL_SOURCES = unchecked((int)0x8A15004B);
+            public const int ERROR_NETWORK_OFFLINE = unchecked((int)0x8A15004C);
+            public const int ERROR_HOST_UNREACHABLE = unchecked((int)0x8A15004D);
 
             public const int ERROR_INSTALL_PACKAGE_IN_USE = unchecked((int)0x8A150101);
             public const int ERROR_INSTALL_INSTALL_IN_PROGRESS = unchecked((int)0x8A150102);
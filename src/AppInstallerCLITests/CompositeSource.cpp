@@ -570,6 +570,65 @@ TEST_CASE("CompositePackage_AvailableVersions_NoChannelFilteredOut", "[Composite
     REQUIRE(result.Matches[0].Package->IsUpdateAvailable());
 }
 
+// A test package that counts the queries made against it.
+struct QueryCountingTestPackage : public TestPackage
+{
+    using TestPackage::TestPackage;
+
+    std::vector<PackageVersionKey> GetAvailableVersionKeys() const override
+    {
+        ++AvailableVersionKeysCount;
+        return TestPackage::GetAvailableVersionKeys();
+    }
+
+    std::shared_ptr<IPackageVersion> GetAvailableVersion(const PackageVersionKey& versionKey) const override
+    {
+        ++AvailableVersionCount;
+        return TestPackage::GetAvailableVersion(versionKey);
+    }
+
+    mutable size_t AvailableVersionKeysCount = 0;
+    mutable size_t AvailableVersionCount = 0;
+};
+
+TEST_CASE("CompositePackage_DerivedStateCached", "[CompositeSource]")
+{
+    std::string pfn = "sortof_apfn";
+
+    Manifest::Manifest available = MakeDefaultManifest();
+    available.Version = "2.0";
+    auto availablePackage = std::make_shared<QueryCountingTestPackage>(std::vector<Manifest::Manifest>{ available });
+
+    CompositeTestSetup setup;
+    setup.Installed->Everything.Matches.emplace_back(MakeInstalled().WithPFN(pfn), Criteria());
+    setup.Available->SearchFunction = [&](const SearchRequest&)
+    {
+        SearchResult result;
+        result.Matches.emplace_back(availablePackage, Criteria());
+        return result;
+    };
+
+    SearchResult result = setup.Search();
+    REQUIRE(result.Matches.size() == 1);
+
+    size_t availableVersionKeysBaseline = availablePackage->AvailableVersionKeysCount;
+    size_t availableVersionBaseline = availablePackage->AvailableVersionCount;
+
+    // Simulate the accesses made for each row of list and upgrade output.
+    auto& package = result.Matches[0].Package;
+    for (size_t i = 0; i < 3; ++i)
+    {
+        REQUIRE(package->GetProperty(PackageProperty::Id) == "Id");
+        REQUIRE(package->GetProperty(PackageProperty::Name) == "Name");
+        REQUIRE(package->GetLatestAvailableVersion());
+        REQUIRE(package->GetAvailableVersionKeys().size() == 1);
+        REQUIRE(package->IsUpdateAvailable());
+    }
+
+    REQUIRE(availablePackage->AvailableVersionKeysCount - availableVersionKeysBaseline <= 1);
+    REQUIRE(availablePackage->AvailableVersionCount - availableVersionBaseline <= 1);
+}
+
 TEST_CASE("CompositeSource_MultipleAvailableSources_MatchFirst", "[CompositeSource]")
 {
     std::string pfn = "sortof_apfn";
@@ -0,0 +1,275 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <AppInstallerDownloader.h>
+#include <winget/ConnectionWarmup.h>
+
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#include <mutex>
+#include <thread>
+
+#pragma comment(lib, "Ws2_32.lib")
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Network;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    constexpr std::string_view ResponseBody = "Warm";
+
+    // A local HTTP server that waits before serving each new connection. This stands in for the name resolution
+    // and TLS handshake of a remote host, so that only requests that open a new connection pay for it.
+    struct SlowConnectionServer
+    {
+        SlowConnectionServer(std::chrono::milliseconds connectionLatency) : m_connectionLatency(connectionLatency)
+        {
+            WSADATA wsaData{};
+            REQUIRE(WSAStartup(MAKEWORD(2, 2), &wsaData) == 0);
+
+            m_listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+            REQUIRE(m_listener != INVALID_SOCKET);
+
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_port = 0;
+            REQUIRE(inet_pton(AF_INET, "127.0.0.1", &address.sin_addr) == 1);
+            REQUIRE(bind(m_listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+            REQUIRE(listen(m_listener, SOMAXCONN) == 0);
+
+            int addressLength = sizeof(address);
+            REQUIRE(getsockname(m_listener, reinterpret_cast<sockaddr*>(&address), &addressLength) == 0);
+            m_port = ntohs(address.sin_port);
+
+            m_acceptThread = std::thread([this]() { AcceptConnections(); });
+        }
+
+        ~SlowConnectionServer()
+        {
+            closesocket(m_listener);
+            m_acceptThread.join();
+
+            {
+                // Connections kept alive by the client would otherwise be served forever.
+                std::lock_guard<std::mutex> lock{ m_lock };
+                for (SOCKET connection : m_connections)
+                {
+                    shutdown(connection, SD_BOTH);
+                }
+            }
+
+            for (auto& thread : m_connectionThreads)
+            {
+                thread.join();
+            }
+
+            WSACleanup();
+        }
+
+        std::string GetUrl(std::string_view path) const
+        {
+            return "http://127.0.0.1:" + std::to_string(m_port) + "/" + std::string{ path };
+        }
+
+        size_t GetConnectionCount()
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            return m_connections.size();
+        }
+
+    private:
+        void AcceptConnections()
+        {
+            for (;;)
+            {
+                SOCKET connection = accept(m_listener, nullptr, nullptr);
+                if (connection == INVALID_SOCKET)
+                {
+                    return;
+                }
+
+                std::lock_guard<std::mutex> lock{ m_lock };
+                m_connections.emplace_back(connection);
+                m_connectionThreads.emplace_back([this, connection]() { Serve(connection); });
+            }
+        }
+
+        void Serve(SOCKET connection)
+        {
+            auto closeConnection = wil::scope_exit([connection]() { closesocket(connection); });
+
+            std::this_thread::sleep_for(m_connectionLatency);
+
+            std::string received;
+            char buffer[4096];
+
+            for (;;)
+            {
+                size_t headersEnd = received.find("\r\n\r\n");
+                if (headersEnd == std::string::npos)
+                {
+                    int bytesRead = recv(connection, buffer, sizeof(buffer), 0);
+                    if (bytesRead <= 0)
+                    {
+                        return;
+                    }
+
+                    received.append(buffer, bytesRead);
+                    continue;
+                }
+
+                bool isHead = received.rfind("HEAD ", 0) == 0;
+                received.erase(0, headersEnd + 4);
+
+                std::string response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(ResponseBody.size()) + "\r\nConnection: keep-alive\r\n\r\n";
+                if (!isHead)
+                {
+                    response += ResponseBody;
+                }
+
+                if (send(connection, response.c_str(), static_cast<int>(response.size()), 0) != static_cast<int>(response.size()))
+                {
+                    return;
+                }
+            }
+        }
+
+        std::chrono::milliseconds m_connectionLatency;
+        SOCKET m_listener = INVALID_SOCKET;
+        uint16_t m_port = 0;
+        std::thread m_acceptThread;
+        std::mutex m_lock;
+        std::vector<SOCKET> m_connections;
+        std::vector<std::thread> m_connectionThreads;
+    };
+
+    std::chrono::milliseconds MeasureDownload(const std::string& url)
+    {
+        std::ostringstream stream;
+        ProgressCallback progress;
+        auto start = std::chrono::steady_clock::now();
+
+        Utility::DownloadToStream(url, stream, Utility::DownloadType::Manifest, progress);
+        REQUIRE(stream.str() == ResponseBody);
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+}
+
+TEST_CASE("ConnectionWarmup_DownloadUsesWarmConnection", "[network]")
+{
+    constexpr auto latency = 500ms;
+    SlowConnectionServer server{ latency };
+    TestUserSettings settings;
+    settings.Set<Setting::NetworkWarmUpConnections>(true);
+
+    std::string url = server.GetUrl("warm.yaml");
+    ConnectionWarmup::Instance().WarmUp(url);
+
+    // Stands in for the local work of the command.
+    std::this_thread::sleep_for(2 * latency);
+
+    REQUIRE(MeasureDownload(url) < latency);
+    REQUIRE(server.GetConnectionCount() == 1);
+}
+
+TEST_CASE("ConnectionWarmup_DownloadWaitsForWarmUp", "[network]")
+{
+    SlowConnectionServer server{ 300ms };
+    TestUserSettings settings;
+    settings.Set<Setting::NetworkWarmUpConnections>(true);
+
+    std::string url = server.GetUrl("waiting.yaml");
+    ConnectionWarmup::Instance().WarmUp(url);
+    MeasureDownload(url);
+
+    // The download used the connection being warmed up, rather than opening its own.
+    REQUIRE(server.GetConnectionCount() == 1);
+}
+
+TEST_CASE("ConnectionWarmup_Disabled", "[network]")
+{
+    constexpr auto latency = 300ms;
+    SlowConnectionServer server{ latency };
+    TestUserSettings settings;
+
+    std::string url = server.GetUrl("cold.yaml");
+    ConnectionWarmup::Instance().WarmUp(url);
+    std::this_thread::sleep_for(latency);
+    REQUIRE(server.GetConnectionCount() == 0);
+
+    REQUIRE(MeasureDownload(url) >= latency);
+    REQUIRE(server.GetConnectionCount() == 1);
+}
+
+TEST_CASE("ConnectionWarmup_Offline", "[network]")
+{
+    SlowConnectionServer server{ 0ms };
+    TestUserSettings settings;
+    settings.Set<Setting::NetworkWarmUpConnections>(true);
+    settings.Set<Setting::NetworkOffline>(true);
+
+    ConnectionWarmup::Instance().WarmUp(server.GetUrl("offline.yaml"));
+    ConnectionWarmup::Instance().WaitFor(server.GetUrl("offline.yaml"));
+    REQUIRE(server.GetConnectionCount() == 0);
+}
+
+TEST_CASE("ConnectionWarmup_DestroyedWhileWarmingUp", "[network]")
+{
+    constexpr auto latency = 3s;
+    SlowConnectionServer server{ latency };
+    TestUserSettings settings;
+    settings.Set<Setting::NetworkWarmUpConnections>(true);
+
+    auto start = std::chrono::steady_clock::now();
+
+    {
+        ConnectionWarmup warmup;
+        warmup.WarmUp(server.GetUrl("teardown.yaml"));
+        std::this_thread::sleep_for(100ms);
+    }
+
+    // Closing the session ends the warm up rather than waiting out the response
+    REQUIRE(std::chrono::steady_clock::now() - start < latency);
+}
+
+TEST_CASE("ConnectionWarmup_Benchmark", "[.]")
+{
+    constexpr size_t iterations = 10;
+    constexpr auto latency = 300ms;
+    constexpr auto localWork = 500ms;
+
+    std::chrono::milliseconds cold{};
+    std::chrono::milliseconds warm{};
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        // A separate host (port) is needed for each iteration so that no connection is kept from the previous one.
+        {
+            SlowConnectionServer coldServer{ latency };
+            TestUserSettings settings;
+            std::this_thread::sleep_for(localWork);
+            cold += MeasureDownload(coldServer.GetUrl("cold.yaml"));
+        }
+
+        {
+            SlowConnectionServer warmServer{ latency };
+            TestUserSettings settings;
+            settings.Set<Setting::NetworkWarmUpConnections>(true);
+
+            std::string url = warmServer.GetUrl("warm.yaml");
+            ConnectionWarmup::Instance().WarmUp(url);
+            std::this_thread::sleep_for(localWork);
+            warm += MeasureDownload(url);
+        }
+    }
+
+    WARN("Time to first byte after " << localWork.count() << " ms of local work, with " << latency.count() << " ms of connection setup\n" <<
+        "Without warm up: " << (cold / iterations).count() << " ms\n" <<
+        "With warm up: " << (warm / iterations).count() << " ms");
+}
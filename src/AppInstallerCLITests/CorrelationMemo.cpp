@@ -0,0 +1,445 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include "TestSource.h"
+#include "TestHooks.h"
+#include <CompositeSource.h>
+#include <CorrelationMemo.h>
+#include <Microsoft/SQLiteIndexSource.h>
+#include <PackageTrackingCatalogSourceFactory.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(std::string_view id, std::string_view productCode)
+    {
+        Manifest::Manifest result;
+
+        result.Id = id;
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Name of " + result.Id);
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>("Publisher");
+        result.Version = "1.0";
+        result.Installers.push_back({});
+        result.Installers[0].ProductCode = productCode;
+
+        return result;
+    }
+
+    SearchRequest MakeCorrelation(std::string_view productCode, std::string_view name, std::string_view publisher)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, productCode);
+        result.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, name, publisher);
+        return result;
+    }
+
+    // A stand-in for an available source with a data version, which counts the correlation searches and
+    // identifier lookups that it receives and can take time to respond.
+    struct MemoTestSource : public TestSource
+    {
+        MemoTestSource(std::string_view name, std::vector<Manifest::Manifest> manifests, std::chrono::milliseconds latency = {}) :
+            Manifests(std::move(manifests)), Latency(latency)
+        {
+            Details.Name = name;
+            Details.Identifier = "*"s + std::string{ name };
+        }
+
+        std::string GetDataVersion() const override { return DataVersion; }
+
+        SearchResult Search(const SearchRequest& request) const override
+        {
+            std::this_thread::sleep_for(Latency);
+
+            SearchResult result;
+
+            if (request.Inclusions.empty())
+            {
+                ++LookupCount;
+
+                for (const auto& manifest : Manifests)
+                {
+                    if (!request.Filters.empty() && request.Filters[0].Field == PackageMatchField::Id && Utility::CaseInsensitiveEquals(request.Filters[0].Value, manifest.Id))
+                    {
+                        result.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }, shared_from_this()), request.Filters[0]);
+                    }
+                }
+
+                return result;
+            }
+
+            ++CorrelationCount;
+
+            for (const auto& manifest : Manifests)
+            {
+                for (const auto& inclusion : request.Inclusions)
+                {
+                    if (inclusion.Field == PackageMatchField::ProductCode && Utility::CaseInsensitiveEquals(inclusion.Value, manifest.Installers[0].ProductCode))
+                    {
+                        result.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }, shared_from_this()), inclusion);
+                        break;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<Manifest::Manifest> Manifests;
+        std::chrono::milliseconds Latency;
+        std::string DataVersion = "1";
+        mutable size_t CorrelationCount = 0;
+        mutable size_t LookupCount = 0;
+    };
+
+    // The installed packages, as the installed source would report them.
+    struct InstalledMemoTestSource : public TestSource
+    {
+        SearchResult Search(const SearchRequest&) const override
+        {
+            SearchResult result;
+
+            for (const auto& manifest : Manifests)
+            {
+                result.Matches.emplace_back(
+                    TestPackage::Make(manifest, TestPackage::MetadataMap{}, std::vector<Manifest::Manifest>{}, shared_from_this()),
+                    PackageMatchFilter{ PackageMatchField::Id, MatchType::Wildcard, manifest.Id });
+            }
+
+            return result;
+        }
+
+        std::vector<Manifest::Manifest> Manifests;
+    };
+
+    // Two available sources, each with some of the installed packages, and installed packages from neither.
+    struct MemoTestSetup
+    {
+        MemoTestSetup(size_t packageCount, std::chrono::milliseconds latency = {}) : TrackingFactory([&](const SourceDetails&) { return Tracking; })
+        {
+            Tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+            TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, TrackingFactory);
+            RemoveSetting(Stream::CorrelationMemo);
+
+            std::vector<Manifest::Manifest> first;
+            std::vector<Manifest::Manifest> second;
+            Installed = std::make_shared<InstalledMemoTestSource>();
+
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                std::string index = std::to_string(i);
+                first.emplace_back(MakeManifest("First.Package" + index, "{first-" + index + "}"));
+                second.emplace_back(MakeManifest("Second.Package" + index, "{second-" + index + "}"));
+
+                Installed->Manifests.emplace_back(first.back());
+                Installed->Manifests.emplace_back(second.back());
+                Installed->Manifests.emplace_back(MakeManifest("ARP.Local" + index, "{local-" + index + "}"));
+            }
+
+            Available.emplace_back(std::make_shared<MemoTestSource>("First", first, latency));
+            Available.emplace_back(std::make_shared<MemoTestSource>("Second", second, latency));
+        }
+
+        ~MemoTestSetup()
+        {
+            TestHook_ClearSourceFactoryOverrides();
+            RemoveSetting(Stream::CorrelationMemo);
+        }
+
+        // Searches for everything installed, as upgrade does.
+        SearchResult Search() const
+        {
+            CompositeSource composite{ "*MemoTests" };
+            for (const auto& source : Available)
+            {
+                composite.AddAvailableSource(Source{ source });
+            }
+            composite.SetInstalledSource(Source{ Installed }, CompositeSearchBehavior::Installed);
+
+            return composite.Search({});
+        }
+
+        size_t CorrelationCount() const
+        {
+            size_t result = 0;
+            for (const auto& source : Available)
+            {
+                result += source->CorrelationCount;
+            }
+            return result;
+        }
+
+        size_t LookupCount() const
+        {
+            size_t result = 0;
+            for (const auto& source : Available)
+            {
+                result += source->LookupCount;
+            }
+            return result;
+        }
+
+        void ResetCounts()
+        {
+            for (const auto& source : Available)
+            {
+                source->CorrelationCount = 0;
+                source->LookupCount = 0;
+            }
+        }
+
+        TestSourceFactory TrackingFactory;
+        std::shared_ptr<SQLiteIndexSource> Tracking;
+        std::shared_ptr<InstalledMemoTestSource> Installed;
+        std::vector<std::shared_ptr<MemoTestSource>> Available;
+    };
+
+    // Describes each result as its installed and available identifiers.
+    std::vector<std::string> Describe(const SearchResult& result)
+    {
+        std::vector<std::string> descriptions;
+
+        for (const auto& match : result.Matches)
+        {
+            std::string description = match.Package->GetInstalledVersion()->GetProperty(PackageVersionProperty::Id);
+            description += " -> ";
+
+            auto available = match.Package->GetLatestAvailableVersion();
+            if (available)
+            {
+                description += available->GetProperty(PackageVersionProperty::Id);
+            }
+
+            descriptions.emplace_back(std::move(description));
+        }
+
+        std::sort(descriptions.begin(), descriptions.end());
+        return descriptions;
+    }
+}
+
+TEST_CASE("CorrelationMemo_Fingerprint", "[CorrelationMemo]")
+{
+    std::string fingerprint = CorrelationMemo::GetFingerprint(MakeCorrelation("{guid}", "Name", "Publisher"));
+
+    SearchRequest reordered;
+    reordered.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "NAME"sv, "publisher"sv);
+    reordered.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{GUID}"sv);
+
+    REQUIRE(CorrelationMemo::GetFingerprint(reordered) == fingerprint);
+    REQUIRE(CorrelationMemo::GetFingerprint(MakeCorrelation("{other}", "Name", "Publisher")) != fingerprint);
+    REQUIRE(CorrelationMemo::GetFingerprint(MakeCorrelation("{guid}", "Name", "Other")) != fingerprint);
+
+    SearchRequest packageFamilyName;
+    packageFamilyName.Inclusions.emplace_back(PackageMatchField::PackageFamilyName, MatchType::Exact, "{guid}"sv);
+    SearchRequest productCode;
+    productCode.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{guid}"sv);
+    REQUIRE(CorrelationMemo::GetFingerprint(packageFamilyName) != CorrelationMemo::GetFingerprint(productCode));
+}
+
+TEST_CASE("CorrelationMemo_PersistedByDataVersion", "[CorrelationMemo]")
+{
+    RemoveSetting(Stream::CorrelationMemo);
+
+    {
+        CorrelationMemo memo;
+        REQUIRE(!memo.Get("*Source", "1", "found"));
+        memo.Record("*Source", "1", "found", { "Package.Id" });
+        memo.Record("*Source", "1", "none", {});
+        memo.Save();
+    }
+
+    {
+        CorrelationMemo memo;
+
+        auto found = memo.Get("*Source", "1", "found");
+        REQUIRE(found);
+        REQUIRE(found->PackageId == "Package.Id");
+
+        auto none = memo.Get("*Source", "1", "none");
+        REQUIRE(none);
+        REQUIRE(none->PackageId.empty());
+
+        REQUIRE(!memo.Get("*Source", "1", "other"));
+        REQUIRE(!memo.Get("*Other", "1", "found"));
+
+        // A new data version discards everything remembered for the source.
+        REQUIRE(!memo.Get("*Source", "2", "found"));
+        memo.Record("*Source", "2", "none", {});
+        memo.Save();
+
+        REQUIRE(memo.GetHitCount() == 2);
+        REQUIRE(memo.GetMissCount() == 3);
+    }
+
+    {
+        CorrelationMemo memo;
+        REQUIRE(!memo.Get("*Source", "1", "found"));
+        REQUIRE(!memo.Get("*Source", "2", "found"));
+        REQUIRE(memo.Get("*Source", "2", "none"));
+    }
+
+    RemoveSetting(Stream::CorrelationMemo);
+}
+
+TEST_CASE("CorrelationMemo_MergedAcrossInstances", "[CorrelationMemo]")
+{
+    RemoveSetting(Stream::CorrelationMemo);
+
+    CorrelationMemo first;
+    CorrelationMemo second;
+
+    first.Record("*Source", "1", "first", { "First.Id" });
+    second.Record("*Source", "1", "second", { "Second.Id" });
+    second.Record("*Other", "1", "second", {});
+    first.Save();
+    second.Save();
+
+    CorrelationMemo memo;
+    REQUIRE(memo.Get("*Source", "1", "first"));
+    REQUIRE(memo.Get("*Source", "1", "second"));
+    REQUIRE(memo.Get("*Other", "1", "second"));
+
+    RemoveSetting(Stream::CorrelationMemo);
+}
+
+TEST_CASE("CorrelationMemo_InvalidState", "[CorrelationMemo]")
+{
+    SetSetting(Stream::CorrelationMemo, "Sources: Value : BAD");
+
+    CorrelationMemo memo;
+    REQUIRE(!memo.Get("*Source", "1", "found"));
+    memo.Record("*Source", "1", "found", {});
+    memo.Save();
+
+    REQUIRE(CorrelationMemo{}.Get("*Source", "1", "found"));
+
+    RemoveSetting(Stream::CorrelationMemo);
+}
+
+TEST_CASE("CorrelationMemo_CompositeSkipsRememberedCorrelations", "[CorrelationMemo]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFCorrelationMemo>(true);
+
+    MemoTestSetup setup{ 5 };
+
+    auto expected = Describe(setup.Search());
+    size_t firstCorrelationCount = setup.CorrelationCount();
+    REQUIRE(firstCorrelationCount > 0);
+    REQUIRE(setup.LookupCount() == 0);
+
+    // The same search again only looks up the packages that were found.
+    setup.ResetCounts();
+    REQUIRE(Describe(setup.Search()) == expected);
+    REQUIRE(setup.CorrelationCount() == 0);
+    REQUIRE(setup.LookupCount() == 10);
+
+    // A change to the data of one source only repeats the correlations with that source.
+    setup.ResetCounts();
+    setup.Available[1]->DataVersion = "2";
+    REQUIRE(Describe(setup.Search()) == expected);
+    REQUIRE(setup.Available[0]->CorrelationCount == 0);
+    REQUIRE(setup.Available[1]->CorrelationCount == 10);
+
+    // A new installed package is correlated with the sources.
+    setup.ResetCounts();
+    setup.Installed->Manifests.emplace_back(MakeManifest("ARP.New", "{new}"));
+    setup.Search();
+    REQUIRE(setup.CorrelationCount() == 2);
+}
+
+TEST_CASE("CorrelationMemo_CompositeNotUsedWhenDisabled", "[CorrelationMemo]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFCorrelationMemo>(false);
+
+    MemoTestSetup setup{ 5 };
+
+    setup.Search();
+    size_t firstCorrelationCount = setup.CorrelationCount();
+
+    setup.ResetCounts();
+    setup.Search();
+    REQUIRE(setup.CorrelationCount() == firstCorrelationCount);
+    REQUIRE(setup.LookupCount() == 0);
+}
+
+TEST_CASE("CorrelationMemo_CompositeUnversionedSource", "[CorrelationMemo]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFCorrelationMemo>(true);
+
+    MemoTestSetup setup{ 5 };
+    setup.Available[0]->DataVersion.clear();
+
+    setup.Search();
+    size_t firstCorrelationCount = setup.Available[0]->CorrelationCount;
+
+    // A source without a data version is always searched.
+    setup.ResetCounts();
+    setup.Search();
+    REQUIRE(setup.Available[0]->CorrelationCount == firstCorrelationCount);
+    REQUIRE(setup.Available[1]->CorrelationCount == 0);
+}
+
+TEST_CASE("CorrelationMemo_Benchmark", "[.]")
+{
+    constexpr size_t packageCount = 50;
+    constexpr auto latency = 5ms;
+
+    MemoTestSetup setup{ packageCount, latency };
+
+    auto measure = [&](bool enabled)
+    {
+        TestUserSettings settings;
+        settings.Set<Setting::EFCorrelationMemo>(enabled);
+        setup.ResetCounts();
+
+        auto start = std::chrono::steady_clock::now();
+        setup.Search();
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    auto disabled = measure(false);
+    size_t disabledCorrelations = setup.CorrelationCount();
+
+    RemoveSetting(Stream::CorrelationMemo);
+    auto firstRun = measure(true);
+    size_t firstRunCorrelations = setup.CorrelationCount();
+
+    auto secondRun = measure(true);
+    size_t secondRunCorrelations = setup.CorrelationCount();
+    size_t secondRunLookups = setup.LookupCount();
+
+    // Every remembered correlation is a hit on the second run.
+    CorrelationMemo memo;
+    size_t remembered = 0;
+    for (const auto& manifest : setup.Installed->Manifests)
+    {
+        std::string fingerprint = CorrelationMemo::GetFingerprint(MakeCorrelation(
+            Utility::FoldCase(manifest.Installers[0].ProductCode),
+            manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>(),
+            manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>()));
+
+        for (const auto& source : setup.Available)
+        {
+            remembered += (memo.Get(source->GetIdentifier(), source->DataVersion, fingerprint) ? 1 : 0);
+        }
+    }
+
+    WARN(setup.Installed->Manifests.size() << " installed packages, " << setup.Available.size() << " sources, " << latency.count() << " ms per source request\n" <<
+        "  Without memo: " << disabledCorrelations << " correlation searches, " << disabled.count() << " ms\n" <<
+        "  First run with memo: " << firstRunCorrelations << " correlation searches, " << firstRun.count() << " ms\n" <<
+        "  Second run with memo: " << secondRunCorrelations << " correlation searches, " << secondRunLookups << " identifier lookups, " << secondRun.count() << " ms\n" <<
+        "  Remembered correlations: " << remembered << " (" << memo.GetHitCount() << " hits, " << memo.GetMissCount() << " misses)");
+}
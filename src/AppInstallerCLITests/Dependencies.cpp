@@ -205,4 +205,144 @@ TEST_CASE("DependencyNodeProcessor_NoMatches", "[dependencies]")
     REQUIRE(dependencyList.Size() == 0);
     REQUIRE(installOutput.str().find(Resource::LocString(Resource::String::DependenciesFlowNoMatches)) != std::string::npos);
     REQUIRE(result == DependencyNodeProcessorResult::Error);
-}
\ No newline at end of file
+}
+namespace
+{
+    using GeneratedGraph = std::map<std::string, std::vector<std::string>>;
+
+    // Builds layers of diamonds: the root and both nodes of each layer depend on both nodes of the next layer.
+    GeneratedGraph GenerateDeepDiamondGraph(size_t depth)
+    {
+        GeneratedGraph graph;
+        std::string previous[2] = { "root", "root" };
+
+        for (size_t layer = 0; layer < depth; ++layer)
+        {
+            std::string current[2] = { "L" + std::to_string(layer) + "a", "L" + std::to_string(layer) + "b" };
+            for (const auto& node : previous)
+            {
+                graph[node] = { current[0], current[1] };
+            }
+            previous[0] = current[0];
+            previous[1] = current[1];
+        }
+
+        return graph;
+    }
+
+    DependencyGraph CreateGraphFromGenerated(const Dependency& root, const GeneratedGraph& generated)
+    {
+        return DependencyGraph(root, [&](const Dependency& node)
+            {
+                DependencyList dependencyList;
+                auto itr = generated.find(node.Id);
+                if (itr != generated.end())
+                {
+                    for (const auto& adjacent : itr->second)
+                    {
+                        dependencyList.Add(Dependency(DependencyType::Package, adjacent));
+                    }
+                }
+                return dependencyList;
+            });
+    }
+
+    void RequireDependenciesFirst(const std::vector<Dependency>& installationOrder, const GeneratedGraph& generated)
+    {
+        std::map<std::string, size_t> positions;
+        for (size_t i = 0; i < installationOrder.size(); ++i)
+        {
+            REQUIRE(positions.emplace(installationOrder[i].Id, i).second);
+        }
+
+        for (const auto& node : generated)
+        {
+            for (const auto& adjacent : node.second)
+            {
+                INFO(node.first << " -> " << adjacent);
+                REQUIRE(positions.at(adjacent) < positions.at(node.first));
+            }
+        }
+    }
+}
+
+TEST_CASE("DependencyGraph_DeepDiamonds", "[dependencyGraph][dependencies]")
+{
+    // Exploring every path through this graph would take 2^200 steps.
+    constexpr size_t Depth = 200;
+    GeneratedGraph generated = GenerateDeepDiamondGraph(Depth);
+
+    Dependency rootAsDependency(DependencyType::Package, "root");
+    DependencyGraph graph = CreateGraphFromGenerated(rootAsDependency, generated);
+    graph.BuildGraph();
+
+    REQUIRE(!graph.HasLoop());
+    REQUIRE(graph.GetLoops().empty());
+
+    std::vector<Dependency> installationOrder = graph.GetInstallationOrder();
+    REQUIRE(installationOrder.size() == 2 * Depth + 1);
+    REQUIRE(installationOrder.front().Id == "L" + std::to_string(Depth - 1) + "a");
+    REQUIRE(installationOrder.back().Id == "root");
+    RequireDependenciesFirst(installationOrder, generated);
+
+    // The order is deterministic.
+    DependencyGraph otherGraph = CreateGraphFromGenerated(rootAsDependency, generated);
+    otherGraph.BuildGraph();
+    std::vector<Dependency> otherOrder = otherGraph.GetInstallationOrder();
+    REQUIRE(std::equal(installationOrder.begin(), installationOrder.end(), otherOrder.begin(), otherOrder.end(),
+        [](const Dependency& a, const Dependency& b) { return a.Id == b.Id; }));
+}
+
+TEST_CASE("DependencyGraph_ReportsAllLoops", "[dependencyGraph][dependencies]")
+{
+    GeneratedGraph generated;
+    generated["root"] = { "A", "B", "F", "G" };
+    generated["A"] = { "C" };
+    generated["C"] = { "A" };
+    generated["B"] = { "D" };
+    generated["D"] = { "E" };
+    generated["E"] = { "B", "G" };
+    generated["F"] = { "F" };
+
+    Dependency rootAsDependency(DependencyType::Package, "root");
+    DependencyGraph graph = CreateGraphFromGenerated(rootAsDependency, generated);
+    graph.BuildGraph();
+
+    REQUIRE(graph.HasLoop());
+
+    std::set<std::set<std::string>> loops;
+    for (const auto& loop : graph.GetLoops())
+    {
+        std::set<std::string> members;
+        for (const auto& node : loop)
+        {
+            members.emplace(node.Id);
+        }
+        loops.emplace(std::move(members));
+    }
+
+    REQUIRE(loops == std::set<std::set<std::string>>{ { "A", "C" }, { "B", "D", "E" }, { "F" } });
+
+    // Every node still gets a place in the order.
+    std::vector<Dependency> installationOrder = graph.GetInstallationOrder();
+    REQUIRE(installationOrder.size() == 8);
+    REQUIRE(installationOrder.back().Id == "root");
+}
+
+// Reports the time to build and order generated graphs of increasing size.
+TEST_CASE("DependencyGraph_DeepDiamondsBenchmark", "[.]")
+{
+    for (size_t depth : { 1000, 10000, 50000 })
+    {
+        GeneratedGraph generated = GenerateDeepDiamondGraph(depth);
+        Dependency rootAsDependency(DependencyType::Package, "root");
+        DependencyGraph graph = CreateGraphFromGenerated(rootAsDependency, generated);
+
+        auto start = std::chrono::steady_clock::now();
+        graph.BuildGraph();
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        REQUIRE(graph.GetInstallationOrder().size() == 2 * depth + 1);
+        WARN("Depth " << depth << " (" << 2 * depth + 1 << " nodes, " << 2 + 4 * (depth - 1) << " edges): " << elapsed.count() << "ms");
+    }
+}
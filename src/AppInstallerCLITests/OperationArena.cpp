@@ -0,0 +1,284 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestHooks.h"
+#include <Microsoft/SQLiteIndexSource.h>
+#include <PackageTrackingCatalogSourceFactory.h>
+#include <winget/ManifestYamlParser.h>
+#include <winget/OperationArena.h>
+#include <winget/RepositorySource.h>
+#include <psapi.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Memory;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(size_t i)
+    {
+        Manifest::Manifest result;
+
+        result.Id = "Arena.Package" + std::to_string(i);
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Arena Package " + std::to_string(i));
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>("Publisher " + std::to_string(i % 10));
+        result.Version = "1.0";
+        result.Installers.push_back({});
+        result.Installers[0].ProductCode = "{Arena-" + std::to_string(i) + "}";
+
+        return result;
+    }
+
+    // Installed and available in memory indexes of the same packages, combined so that searches correlate them.
+    struct ArenaTestSetup
+    {
+        ArenaTestSetup(size_t packageCount) : TrackingFactory([&](const SourceDetails&) { return Tracking; })
+        {
+            Tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+            TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, TrackingFactory);
+
+            SourceDetails installedDetails;
+            installedDetails.Identifier = "*ArenaInstalled";
+            auto installed = std::make_shared<SQLiteIndexSource>(installedDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET), Synchronization::CrossProcessReaderWriteLock{}, true);
+
+            SourceDetails availableDetails;
+            availableDetails.Name = "ArenaAvailable";
+            availableDetails.Identifier = "*ArenaAvailable";
+            auto available = std::make_shared<SQLiteIndexSource>(availableDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                Manifest::Manifest manifest = MakeManifest(i);
+                installed->GetIndex().AddManifest(manifest);
+                available->GetIndex().AddManifest(manifest);
+            }
+
+            Composite = Source{ Source{ installed }, Source{ available }, CompositeSearchBehavior::Installed };
+        }
+
+        ~ArenaTestSetup()
+        {
+            TestHook_ClearSourceFactoryOverrides();
+        }
+
+        TestSourceFactory TrackingFactory;
+        std::shared_ptr<SQLiteIndexSource> Tracking;
+        Source Composite;
+    };
+
+    std::vector<std::string> GetIds(const SearchResult& result)
+    {
+        std::vector<std::string> ids;
+        for (const auto& match : result.Matches)
+        {
+            ids.emplace_back(match.Package->GetProperty(PackageProperty::Id).get());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+
+    std::vector<std::string> ReadManifestCorpus()
+    {
+        std::vector<std::string> result;
+
+        for (const auto& entry : std::filesystem::directory_iterator(TestDataFile{ "." }.GetPath()))
+        {
+            std::string fileName = entry.path().filename().u8string();
+            if (entry.is_regular_file() && entry.path().extension() == ".yaml" && fileName.find("Manifest") == 0)
+            {
+                std::ifstream stream{ entry.path(), std::ios::binary };
+                result.emplace_back(Utility::ReadEntireStream(stream));
+            }
+        }
+
+        return result;
+    }
+
+    struct MemoryUsage
+    {
+        size_t WorkingSet = 0;
+        size_t PrivateBytes = 0;
+    };
+
+    MemoryUsage GetMemoryUsage()
+    {
+        PROCESS_MEMORY_COUNTERS_EX counters{};
+        MemoryUsage result;
+
+        if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters)))
+        {
+            result.WorkingSet = counters.WorkingSetSize;
+            result.PrivateBytes = counters.PrivateUsage;
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("OperationArena_DisabledByDefault", "[OperationArena]")
+{
+    TestUserSettings settings;
+
+    OperationArenaScope scope;
+    REQUIRE(GetCurrentArena() == nullptr);
+    REQUIRE(GetScratchResource() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("OperationArena_ScopeInstallsArena", "[OperationArena]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOperationArenas>(true);
+
+    {
+        OperationArenaScope scope;
+        OperationArena* arena = GetCurrentArena();
+        REQUIRE(arena != nullptr);
+        REQUIRE(GetScratchResource() == arena);
+
+        std::pmr::vector<int> values{ GetScratchResource() };
+        values.resize(100);
+
+        REQUIRE(arena->GetAllocationCount() == 1);
+        REQUIRE(arena->GetBytesAllocated() >= 100 * sizeof(int));
+    }
+
+    REQUIRE(GetCurrentArena() == nullptr);
+    REQUIRE(GetScratchResource() == std::pmr::get_default_resource());
+}
+
+TEST_CASE("OperationArena_SettingScopeDecidesOnce", "[OperationArena]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOperationArenas>(true);
+
+    OperationArenaSettingScope settingScope;
+
+    // Changes to the settings are not seen until the outermost setting scope ends
+    settings.Set<Setting::EFOperationArenas>(false);
+    {
+        OperationArenaSettingScope innerSettingScope{ false };
+        OperationArenaScope scope;
+        REQUIRE(GetCurrentArena() != nullptr);
+    }
+
+    REQUIRE(GetCurrentArena() == nullptr);
+}
+
+TEST_CASE("OperationArena_SettingScopeDisabled", "[OperationArena]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOperationArenas>(true);
+
+    OperationArenaSettingScope settingScope{ false };
+    OperationArenaScope scope;
+    REQUIRE(GetCurrentArena() == nullptr);
+}
+
+TEST_CASE("OperationArena_NestedScopesShareArena", "[OperationArena]")
+{
+    OperationArenaScope outer{ true };
+    OperationArena* arena = GetCurrentArena();
+    REQUIRE(arena != nullptr);
+
+    {
+        OperationArenaScope inner{ true };
+        REQUIRE(GetCurrentArena() == arena);
+    }
+
+    // The outer arena remains after the inner scope ends
+    REQUIRE(GetCurrentArena() == arena);
+}
+
+TEST_CASE("OperationArena_PerThread", "[OperationArena]")
+{
+    OperationArenaScope scope{ true };
+    REQUIRE(GetCurrentArena() != nullptr);
+
+    OperationArena* otherThreadArena = GetCurrentArena();
+    std::thread([&]() { otherThreadArena = GetCurrentArena(); }).join();
+    REQUIRE(otherThreadArena == nullptr);
+}
+
+TEST_CASE("OperationArena_ManifestParse", "[OperationArena]")
+{
+    auto expected = Manifest::YamlParser::CreateFromPath(TestDataFile("ManifestV1_1-Singleton.yaml"));
+
+    OperationArenaScope scope{ true };
+    auto manifest = Manifest::YamlParser::CreateFromPath(TestDataFile("ManifestV1_1-Singleton.yaml"));
+
+    // The temporary data of the parse came from the arena
+    REQUIRE(GetCurrentArena()->GetAllocationCount() > 0);
+    REQUIRE(manifest.Id == expected.Id);
+    REQUIRE(manifest.Installers.size() == expected.Installers.size());
+    REQUIRE(manifest.Localizations.size() == expected.Localizations.size());
+}
+
+TEST_CASE("OperationArena_CorrelatingSearch", "[OperationArena]")
+{
+    ArenaTestSetup setup{ 20 };
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "Arena"sv);
+
+    auto expected = setup.Composite.Search(request);
+
+    OperationArenaScope scope{ true };
+    auto result = setup.Composite.Search(request);
+
+    REQUIRE(GetCurrentArena()->GetAllocationCount() > 0);
+    REQUIRE(GetIds(result) == GetIds(expected));
+
+    for (const auto& match : result.Matches)
+    {
+        REQUIRE(match.Package->GetAvailableVersionKeys().size() == 1);
+    }
+}
+
+TEST_CASE("OperationArena_Soak", "[.]")
+{
+    // Repeats the parse and search workloads, as a long running COM server does, and reports throughput and memory use.
+    constexpr size_t rounds = 200;
+    auto corpus = ReadManifestCorpus();
+    ArenaTestSetup setup{ 1000 };
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "Package1"sv);
+
+    auto runWorkload = [&](bool useArenas)
+    {
+        TestUserSettings settings;
+        settings.Set<Setting::EFOperationArenas>(useArenas);
+
+        auto start = std::chrono::steady_clock::now();
+
+        for (size_t round = 0; round < rounds; ++round)
+        {
+            for (const auto& manifest : corpus)
+            {
+                try
+                {
+                    Manifest::YamlParser::Create(manifest);
+                }
+                catch (...) {}
+            }
+
+            setup.Composite.Search(request);
+        }
+
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        MemoryUsage usage = GetMemoryUsage();
+
+        WARN((useArenas ? "Operation arenas" : "Process heap only") << ": " << rounds << " rounds in " << time.count() << " ms\n" <<
+            "Working set: " << (usage.WorkingSet / 1024) << " KB, private bytes: " << (usage.PrivateBytes / 1024) << " KB");
+    };
+
+    runWorkload(false);
+    runWorkload(true);
+    runWorkload(false);
+}
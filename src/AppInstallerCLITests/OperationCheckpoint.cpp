@@ -0,0 +1,258 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <OperationCheckpoint.h>
+#include <Workflows/CheckpointFlow.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::CLI;
+using namespace AppInstaller::CLI::Workflow;
+using namespace AppInstaller::Settings;
+using namespace AppInstaller::Utility;
+
+namespace
+{
+    OperationCheckpoint::Package MakePackage(std::string_view id, OperationCheckpoint::PackageState state = OperationCheckpoint::PackageState::Pending)
+    {
+        OperationCheckpoint::Package result;
+        result.SourceIdentifier = "*TestSource";
+        result.Id = id;
+        result.Version = "1.0";
+        result.InstallerUrl = "https://test/" + result.Id;
+        result.InstallerSha256 = "0123456789abcdef";
+        result.State = state;
+        return result;
+    }
+
+    std::string WriteTestFile(const TempFile& file, std::string_view contents)
+    {
+        std::ofstream stream{ file.GetPath(), std::ios::binary };
+        stream << contents;
+        return SHA256::ConvertToString(SHA256::ComputeHash(contents));
+    }
+
+    // Runs UseCheckpointDownload for an installer with the given hash, returning whether the download was used.
+    bool UseDownload(const OperationCheckpoint::Package& package, std::string_view expectedHash)
+    {
+        std::ostringstream output;
+        Execution::Context context{ output, std::cin };
+        Manifest::ManifestInstaller manifestInstaller;
+        manifestInstaller.Sha256 = SHA256::ConvertToBytes(expectedHash);
+        context.Add<Execution::Data::Installer>(manifestInstaller);
+
+        context << UseCheckpointDownload(package);
+
+        if (!context.Contains(Execution::Data::InstallerPath))
+        {
+            REQUIRE(!context.Contains(Execution::Data::HashPair));
+            return false;
+        }
+
+        REQUIRE(context.Get<Execution::Data::InstallerPath>() == package.InstallerPath);
+        REQUIRE(context.Contains(Execution::Data::HashPair));
+        REQUIRE(SHA256::AreEqual(context.Get<Execution::Data::HashPair>().first, context.Get<Execution::Data::HashPair>().second));
+        return true;
+    }
+}
+
+TEST_CASE("OperationCheckpoint_SaveAndLoad", "[OperationCheckpoint]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+
+    OperationCheckpoint checkpoint{ "upgrade --all" };
+    checkpoint.Packages.emplace_back(MakePackage("Test.Completed", OperationCheckpoint::PackageState::Completed));
+    checkpoint.Packages.emplace_back(MakePackage("Test.Downloaded", OperationCheckpoint::PackageState::Downloaded));
+    checkpoint.Packages.back().InstallerPath = L"C:\\Temp\\Test.Downloaded.1.0.exe";
+    checkpoint.Packages.back().InstallerSize = 1234;
+    checkpoint.Packages.back().InstallerLastWriteTime = 132000000000000000;
+    checkpoint.Packages.back().Scope = Manifest::ScopeEnum::Machine;
+    checkpoint.Packages.emplace_back(MakePackage("Test.Pending"));
+    checkpoint.Packages.back().Channel = "beta";
+    checkpoint.Save();
+
+    REQUIRE(!OperationCheckpoint::Load("import"));
+
+    auto loaded = OperationCheckpoint::Load("upgrade --all");
+    REQUIRE(loaded);
+    REQUIRE(loaded->Packages.size() == 3);
+    REQUIRE(loaded->GetCompletedCount() == 1);
+
+    auto downloaded = loaded->Find("*TestSource", "Test.Downloaded", "1.0", "");
+    REQUIRE(downloaded);
+    REQUIRE(downloaded->State == OperationCheckpoint::PackageState::Downloaded);
+    REQUIRE(downloaded->InstallerPath == L"C:\\Temp\\Test.Downloaded.1.0.exe");
+    REQUIRE(downloaded->InstallerSize == 1234);
+    REQUIRE(downloaded->InstallerLastWriteTime == 132000000000000000);
+    REQUIRE(downloaded->InstallerUrl == "https://test/Test.Downloaded");
+    REQUIRE(downloaded->InstallerSha256 == "0123456789abcdef");
+    REQUIRE(downloaded->Scope == Manifest::ScopeEnum::Machine);
+
+    REQUIRE(!loaded->Find("*TestSource", "Test.Pending", "1.0", ""));
+    auto pending = loaded->Find("*TestSource", "Test.Pending", "1.0", "beta");
+    REQUIRE(pending);
+    REQUIRE(pending->State == OperationCheckpoint::PackageState::Pending);
+    REQUIRE(pending->InstallerPath.empty());
+
+    RemoveSetting(Stream::OperationCheckpoints);
+}
+
+TEST_CASE("OperationCheckpoint_ReplaceAndRemove", "[OperationCheckpoint]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+
+    OperationCheckpoint upgrade{ "upgrade --all" };
+    upgrade.Packages.emplace_back(MakePackage("Test.One"));
+    upgrade.Save();
+
+    OperationCheckpoint importCheckpoint{ "import file" };
+    importCheckpoint.Packages.emplace_back(MakePackage("Test.Two"));
+    importCheckpoint.Save();
+
+    upgrade.Packages[0].State = OperationCheckpoint::PackageState::Completed;
+    upgrade.Save();
+
+    auto loaded = OperationCheckpoint::Load("upgrade --all");
+    REQUIRE(loaded);
+    REQUIRE(loaded->Packages.size() == 1);
+    REQUIRE(loaded->GetCompletedCount() == 1);
+
+    upgrade.Remove();
+    REQUIRE(!OperationCheckpoint::Load("upgrade --all"));
+    REQUIRE(OperationCheckpoint::Load("import file"));
+
+    RemoveSetting(Stream::OperationCheckpoints);
+}
+
+TEST_CASE("OperationCheckpoint_OldestDropped", "[OperationCheckpoint]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        OperationCheckpoint checkpoint{ "import " + std::to_string(i) };
+        checkpoint.Packages.emplace_back(MakePackage("Test.Package"));
+        checkpoint.Save();
+    }
+
+    REQUIRE(!OperationCheckpoint::Load("import 0"));
+    REQUIRE(!OperationCheckpoint::Load("import 1"));
+    REQUIRE(OperationCheckpoint::Load("import 2"));
+    REQUIRE(OperationCheckpoint::Load("import 9"));
+
+    RemoveSetting(Stream::OperationCheckpoints);
+}
+
+TEST_CASE("OperationCheckpoint_InvalidStream", "[OperationCheckpoint]")
+{
+    SetSetting(Stream::OperationCheckpoints, "Operations: [ BAD");
+    REQUIRE(!OperationCheckpoint::Load("upgrade --all"));
+
+    // Saving replaces the invalid contents
+    OperationCheckpoint checkpoint{ "upgrade --all" };
+    checkpoint.Packages.emplace_back(MakePackage("Test.Package"));
+    checkpoint.Save();
+    REQUIRE(OperationCheckpoint::Load("upgrade --all"));
+
+    RemoveSetting(Stream::OperationCheckpoints);
+}
+
+TEST_CASE("OperationCheckpoint_OperationFromArgs", "[OperationCheckpoint]")
+{
+    Execution::Args upgrade;
+    upgrade.AddArg(Execution::Args::Type::All);
+    REQUIRE(GetCheckpointOperation(upgrade) == "upgrade --all");
+
+    upgrade.AddArg(Execution::Args::Type::Source, "winget"sv);
+    upgrade.AddArg(Execution::Args::Type::Resume);
+    REQUIRE(GetCheckpointOperation(upgrade) == "upgrade --all --source winget");
+
+    TempFile importFile{ "ImportFile", ".json" };
+    WriteTestFile(importFile, "{ \"Sources\": [] }");
+
+    Execution::Args importArgs;
+    importArgs.AddArg(Execution::Args::Type::ImportFile, importFile.GetPath().u8string());
+    std::string operation = GetCheckpointOperation(importArgs);
+    REQUIRE(operation.find("import ") == 0);
+
+    // A changed file is a different operation
+    WriteTestFile(importFile, "{ \"Sources\": [ ] }");
+    REQUIRE(GetCheckpointOperation(importArgs) != operation);
+}
+
+TEST_CASE("UseCheckpointDownload_Unchanged", "[OperationCheckpoint]")
+{
+    TempFile installer{ "CheckpointInstaller", ".exe" };
+    std::string hash = WriteTestFile(installer, "Installer contents");
+
+    OperationCheckpoint::Package package = MakePackage("Test.Downloaded");
+    package.InstallerSha256 = hash;
+    RecordCheckpointDownload(package, installer.GetPath());
+    REQUIRE(package.State == OperationCheckpoint::PackageState::Downloaded);
+    REQUIRE(package.InstallerSize == static_cast<int64_t>(std::string_view{ "Installer contents" }.size()));
+
+    REQUIRE(UseDownload(package, hash));
+
+    // A file with the recorded size and last write time is not hashed again.
+    auto lastWriteTime = std::filesystem::last_write_time(installer.GetPath());
+    WriteTestFile(installer, "Installer CONTENTS");
+    std::filesystem::last_write_time(installer.GetPath(), lastWriteTime);
+    REQUIRE(UseDownload(package, hash));
+}
+
+TEST_CASE("UseCheckpointDownload_ChangedButHashMatches", "[OperationCheckpoint]")
+{
+    TempFile installer{ "CheckpointInstaller", ".exe" };
+    std::string hash = WriteTestFile(installer, "Installer contents");
+
+    OperationCheckpoint::Package package = MakePackage("Test.Downloaded");
+    package.InstallerSha256 = hash;
+    RecordCheckpointDownload(package, installer.GetPath());
+
+    // A different last write time falls back to hashing the file.
+    std::filesystem::last_write_time(installer.GetPath(), std::filesystem::last_write_time(installer.GetPath()) - std::chrono::hours{ 1 });
+    REQUIRE(UseDownload(package, hash));
+}
+
+TEST_CASE("UseCheckpointDownload_HashChanged", "[OperationCheckpoint]")
+{
+    TempFile installer{ "CheckpointInstaller", ".exe" };
+    std::string hash = WriteTestFile(installer, "Installer contents");
+
+    OperationCheckpoint::Package package = MakePackage("Test.Downloaded");
+    package.InstallerSha256 = hash;
+    RecordCheckpointDownload(package, installer.GetPath());
+
+    WriteTestFile(installer, "Changed installer contents");
+
+    // The installer is downloaded again
+    REQUIRE(!UseDownload(package, hash));
+}
+
+TEST_CASE("UseCheckpointDownload_ExpectedHashChanged", "[OperationCheckpoint]")
+{
+    TempFile installer{ "CheckpointInstaller", ".exe" };
+    std::string hash = WriteTestFile(installer, "Installer contents");
+
+    OperationCheckpoint::Package package = MakePackage("Test.Downloaded");
+    package.InstallerSha256 = hash;
+    RecordCheckpointDownload(package, installer.GetPath());
+
+    // The download was verified against another hash than the one now expected.
+    REQUIRE(!UseDownload(package, SHA256::ConvertToString(SHA256::ComputeHash("Other installer contents"))));
+}
+
+TEST_CASE("UseCheckpointDownload_Missing", "[OperationCheckpoint]")
+{
+    TempFile installer{ "CheckpointInstaller", ".exe" };
+
+    OperationCheckpoint::Package package = MakePackage("Test.Downloaded", OperationCheckpoint::PackageState::Downloaded);
+    package.InstallerPath = installer.GetPath();
+    package.InstallerSha256 = SHA256::ConvertToString(SHA256::ComputeHash("Installer contents"));
+
+    REQUIRE(!UseDownload(package, package.InstallerSha256));
+}
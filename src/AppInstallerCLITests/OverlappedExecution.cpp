@@ -0,0 +1,248 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <AppInstallerErrors.h>
+#include <ExecutionContext.h>
+#include <Workflows/OverlappedExecution.h>
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller::CLI;
+using namespace AppInstaller::CLI::Execution;
+using namespace AppInstaller::CLI::Workflow;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    constexpr auto TaskLatency = 200ms;
+
+    void WriteInstallerArgs(Context& context)
+    {
+        std::this_thread::sleep_for(TaskLatency);
+        context.Reporter.Info() << "InstallerArgs" << std::endl;
+        context.Add<Data::InstallerArgs>("args");
+    }
+
+    void WriteUninstallString(Context& context)
+    {
+        std::this_thread::sleep_for(TaskLatency);
+        context.Reporter.Info() << "UninstallString" << std::endl;
+        context.Add<Data::UninstallString>("uninstall");
+    }
+
+    void WriteReturnCode(Context& context)
+    {
+        std::this_thread::sleep_for(TaskLatency);
+        context.Reporter.Info() << "ReturnCode" << std::endl;
+        context.Add<Data::InstallerReturnCode>(42);
+        context.SetFlags(ContextFlag::InstallerHashMatched);
+    }
+
+    void AppendToInstallerArgs(Context& context)
+    {
+        std::string value = context.Contains(Data::InstallerArgs) ? context.Get<Data::InstallerArgs>() : std::string{};
+        context.Add<Data::InstallerArgs>(value + "+");
+    }
+
+    void CopyUninstallStringToInstallerArgs(Context& context)
+    {
+        context.Add<Data::InstallerArgs>(context.Get<Data::UninstallString>());
+    }
+
+    void TerminateWithFailure(Context& context)
+    {
+        AICLI_TERMINATE_CONTEXT(E_FAIL);
+    }
+
+    void ThrowFailure(Context&)
+    {
+        THROW_HR(E_UNEXPECTED);
+    }
+
+    WorkflowTask Declared(WorkflowTask::Func f, std::vector<Data> reads, std::vector<Data> writes)
+    {
+        return WorkflowTask{ f, std::move(reads), std::move(writes) };
+    }
+
+    std::chrono::milliseconds Measure(Context& context, const WorkflowTask& task)
+    {
+        auto start = std::chrono::steady_clock::now();
+        context << task;
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    }
+
+    ExecuteOverlapped IndependentTasks()
+    {
+        return ExecuteOverlapped(
+            Declared(WriteInstallerArgs, {}, { Data::InstallerArgs }),
+            Declared(WriteUninstallString, {}, { Data::UninstallString }),
+            Declared(WriteReturnCode, {}, { Data::InstallerReturnCode }));
+    }
+
+    void RequireIndependentTasksResults(Context& context, const std::string& output)
+    {
+        REQUIRE(!context.IsTerminated());
+        REQUIRE(context.Get<Data::InstallerArgs>() == "args");
+        REQUIRE(context.Get<Data::UninstallString>() == "uninstall");
+        REQUIRE(context.Get<Data::InstallerReturnCode>() == 42);
+        REQUIRE(WI_IsFlagSet(context.GetFlags(), ContextFlag::InstallerHashMatched));
+
+        size_t args = output.find("InstallerArgs");
+        size_t uninstall = output.find("UninstallString");
+        size_t returnCode = output.find("ReturnCode");
+        REQUIRE(args != std::string::npos);
+        REQUIRE(uninstall != std::string::npos);
+        REQUIRE(returnCode != std::string::npos);
+        REQUIRE(args < uninstall);
+        REQUIRE(uninstall < returnCode);
+    }
+}
+
+TEST_CASE("ExecuteOverlapped_DisabledRunsInSequence", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(false);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    auto duration = Measure(context, IndependentTasks());
+
+    RequireIndependentTasksResults(context, output.str());
+    REQUIRE(duration >= 3 * TaskLatency);
+}
+
+TEST_CASE("ExecuteOverlapped_IndependentTasksOverlap", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    auto duration = Measure(context, IndependentTasks());
+
+    RequireIndependentTasksResults(context, output.str());
+    REQUIRE(duration < 2 * TaskLatency);
+}
+
+TEST_CASE("ExecuteOverlapped_ConflictingTasksInOrder", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    context << ExecuteOverlapped(
+        Declared(WriteInstallerArgs, {}, { Data::InstallerArgs }),
+        Declared(AppendToInstallerArgs, { Data::InstallerArgs }, { Data::InstallerArgs }),
+        Declared(AppendToInstallerArgs, { Data::InstallerArgs }, { Data::InstallerArgs }));
+
+    REQUIRE(context.Get<Data::InstallerArgs>() == "args++");
+}
+
+TEST_CASE("ExecuteOverlapped_UndeclaredTaskIsBarrier", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    // Nothing is known of the data used by the second task, so the third cannot start before it completes.
+    context << ExecuteOverlapped(
+        Declared(WriteUninstallString, {}, { Data::UninstallString }),
+        CopyUninstallStringToInstallerArgs,
+        Declared(AppendToInstallerArgs, { Data::InstallerArgs }, { Data::InstallerArgs }));
+
+    REQUIRE(context.Get<Data::InstallerArgs>() == "uninstall+");
+}
+
+TEST_CASE("ExecuteOverlapped_TerminationDiscardsLaterTasks", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    SECTION("Inline")
+    {
+        context << ExecuteOverlapped(
+            Declared(TerminateWithFailure, {}, {}),
+            Declared(WriteInstallerArgs, {}, { Data::InstallerArgs }));
+    }
+    SECTION("Background")
+    {
+        context << ExecuteOverlapped(
+            Declared(WriteUninstallString, {}, { Data::UninstallString }),
+            Declared(TerminateWithFailure, {}, {}),
+            Declared(WriteInstallerArgs, {}, { Data::InstallerArgs }));
+
+        REQUIRE(context.Get<Data::UninstallString>() == "uninstall");
+    }
+
+    REQUIRE(context.IsTerminated());
+    REQUIRE(context.GetTerminationHR() == E_FAIL);
+    REQUIRE(!context.Contains(Data::InstallerArgs));
+    REQUIRE(output.str().find("InstallerArgs") == std::string::npos);
+}
+
+TEST_CASE("ExecuteOverlapped_ExceptionsInOrder", "[workflow][overlapped]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::ostringstream output;
+    Context context{ output, std::cin };
+
+    SECTION("Inline")
+    {
+        REQUIRE_THROWS_HR(context << ExecuteOverlapped(
+            Declared(ThrowFailure, {}, {}),
+            Declared(WriteInstallerArgs, {}, { Data::InstallerArgs })), E_UNEXPECTED);
+
+        REQUIRE(!context.Contains(Data::InstallerArgs));
+    }
+    SECTION("Background")
+    {
+        REQUIRE_THROWS_HR(context << ExecuteOverlapped(
+            Declared(WriteInstallerArgs, {}, { Data::InstallerArgs }),
+            Declared(ThrowFailure, {}, {}),
+            Declared(WriteUninstallString, {}, { Data::UninstallString })), E_UNEXPECTED);
+
+        REQUIRE(context.Get<Data::InstallerArgs>() == "args");
+        REQUIRE(!context.Contains(Data::UninstallString));
+    }
+}
+
+TEST_CASE("ExecuteOverlapped_CapturedOutputKeepsLevel", "[workflow][overlapped]")
+{
+    std::ostringstream output;
+    Context context{ output, std::cin };
+    context.Reporter.CaptureOutput();
+
+    context.Reporter.Warn() << "Warning" << std::endl;
+    context.Reporter.Warn() << "Another warning" << std::endl;
+    context.Reporter.Info() << "Info" << std::endl;
+
+    // Clones of the context write to the same captured output.
+    auto clone = context.Clone();
+    clone->Reporter.Error() << "Error" << std::endl;
+
+    auto captured = context.Reporter.TakeCapturedOutput();
+    REQUIRE(output.str().empty());
+    REQUIRE(captured.size() == 3);
+    REQUIRE(captured[0].first == Reporter::Level::Warning);
+    REQUIRE(captured[0].second.find("Warning") != std::string::npos);
+    REQUIRE(captured[0].second.find("Another warning") != std::string::npos);
+    REQUIRE(captured[1].first == Reporter::Level::Info);
+    REQUIRE(captured[1].second.find("Info") != std::string::npos);
+    REQUIRE(captured[2].first == Reporter::Level::Error);
+    REQUIRE(captured[2].second.find("Error") != std::string::npos);
+
+    REQUIRE(context.Reporter.TakeCapturedOutput().empty());
+}
@@ -4,6 +4,7 @@
 #include "TestSource.h"
 #include "TestCommon.h"
 #include "TestSettings.h"
+#include "TestHooks.h"
 #include <winget/RepositorySource.h>
 #include <AppInstallerRuntime.h>
 #include <AppInstallerStrings.h>
@@ -192,3 +193,178 @@ TEST_CASE("PIPS_Remove", "[pips]")
     RemoveSource(details.Name, callback);
     REQUIRE(!fs::exists(state));
 }
+
+namespace
+{
+    // Simulates the users of a machine, each with their own local state, updating and opening the same source.
+    struct SharedSourceDataSimulation
+    {
+        SharedSourceDataSimulation(PolicyState sharedDataPolicy) :
+            m_sourceDirectory("pipssource"), m_usersDirectory("pipsusers"), m_sharedDirectory("pipsshared"), m_originalLocalState(GetPathTo(PathName::LocalState)), m_originalSharedState(GetPathTo(PathName::SharedState))
+        {
+            m_policies.SetState(TogglePolicy::Policy::SharedSourceData, sharedDataPolicy);
+            TestHook_SetPathOverride(PathName::SharedState, m_sharedDirectory.GetPath());
+            Repository::Microsoft::TestHook_SetSharedSourceDataTrusted(true);
+
+            m_details.Name = "TestName";
+            m_details.Type = Repository::Microsoft::PreIndexedPackageSourceFactory::Type();
+            m_details.Arg = m_sourceDirectory.GetPath().u8string();
+        }
+
+        ~SharedSourceDataSimulation()
+        {
+            Repository::Microsoft::TestHook_SetSharedSourceDataTrusted(false);
+            TestHook_SetPathOverride(PathName::LocalState, m_originalLocalState);
+            TestHook_SetPathOverride(PathName::SharedState, m_originalSharedState);
+        }
+
+        void SetSourcePackage(std::string_view package)
+        {
+            CopyIndexFileToDirectory(TestDataFile{ package }, m_sourceDirectory);
+        }
+
+        // Updates the source for each user, as the first user to do so would add it, and opens it.
+        void UpdateAndOpenForAllUsers(size_t userCount)
+        {
+            auto factory = Repository::Microsoft::PreIndexedPackageSourceFactory::Create();
+            ProgressCallback callback;
+
+            for (size_t i = 0; i < userCount; ++i)
+            {
+                TestHook_SetPathOverride(PathName::LocalState, GetUserDirectory(i));
+
+                if (m_details.Data.empty())
+                {
+                    REQUIRE(factory->Add(m_details, callback));
+                }
+                else
+                {
+                    REQUIRE(factory->Update(m_details, callback));
+                }
+
+                auto source = factory->Create(m_details)->Open(callback);
+                REQUIRE(source);
+                REQUIRE_NOTHROW(source->Search({}));
+            }
+        }
+
+        fs::path GetUserDirectory(size_t user) const
+        {
+            return m_usersDirectory.GetPath() / std::to_string(user);
+        }
+
+        uint64_t GetUsersSize() const { return GetDirectorySize(m_usersDirectory.GetPath()); }
+
+        uint64_t GetSharedSize() const { return GetDirectorySize(m_sharedDirectory.GetPath()); }
+
+        fs::path GetSharedSourceDirectory() const
+        {
+            return m_sharedDirectory.GetPath() / Repository::Microsoft::PreIndexedPackageSourceFactory::Type() / s_Msix_FamilyName;
+        }
+
+    private:
+        static uint64_t GetDirectorySize(const fs::path& directory)
+        {
+            uint64_t result = 0;
+
+            for (const auto& entry : fs::recursive_directory_iterator(directory))
+            {
+                if (entry.is_regular_file())
+                {
+                    result += entry.file_size();
+                }
+            }
+
+            return result;
+        }
+
+        GroupPolicyTestOverride m_policies;
+        TempDirectory m_sourceDirectory;
+        TempDirectory m_usersDirectory;
+        TempDirectory m_sharedDirectory;
+        fs::path m_originalLocalState;
+        fs::path m_originalSharedState;
+        SourceDetails m_details;
+    };
+
+    size_t CountSharedVersions(const fs::path& sharedSourceDirectory)
+    {
+        size_t result = 0;
+
+        for (const auto& entry : fs::directory_iterator(sharedSourceDirectory))
+        {
+            if (entry.is_directory())
+            {
+                ++result;
+            }
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("PIPS_SharedSourceData", "[pips]")
+{
+    SharedSourceDataSimulation simulation{ PolicyState::Enabled };
+    simulation.SetSourcePackage(s_MsixFile_1);
+
+    simulation.UpdateAndOpenForAllUsers(4);
+
+    // The data is only written once, and no user has their own copy.
+    fs::path sharedSourceDirectory = simulation.GetSharedSourceDirectory();
+    REQUIRE(CountSharedVersions(sharedSourceDirectory) == 1);
+    REQUIRE(fs::exists(sharedSourceDirectory / "current"));
+
+    for (size_t i = 0; i < 4; ++i)
+    {
+        fs::path userState = simulation.GetUserDirectory(i) / AppInstaller::Repository::Microsoft::PreIndexedPackageSourceFactory::Type() / s_Msix_FamilyName;
+        REQUIRE(!fs::exists(userState / s_IndexFileName));
+        REQUIRE(!fs::exists(userState / s_IndexMsixName));
+        REQUIRE(!fs::exists(userState / s_AppxManifestFileName));
+    }
+
+    // A new version replaces the old one, which is removed as it is no longer open.
+    std::string currentVersion = GetContents(sharedSourceDirectory / "current");
+    simulation.SetSourcePackage(s_MsixFile_2);
+    simulation.UpdateAndOpenForAllUsers(4);
+
+    REQUIRE(CountSharedVersions(sharedSourceDirectory) == 1);
+    REQUIRE(GetContents(sharedSourceDirectory / "current") != currentVersion);
+}
+
+TEST_CASE("PIPS_SharedSourceData_Disabled", "[pips]")
+{
+    SharedSourceDataSimulation simulation{ PolicyState::NotConfigured };
+    simulation.SetSourcePackage(s_MsixFile_1);
+
+    simulation.UpdateAndOpenForAllUsers(2);
+
+    REQUIRE(simulation.GetSharedSize() == 0);
+    REQUIRE(fs::exists(simulation.GetUserDirectory(1) / AppInstaller::Repository::Microsoft::PreIndexedPackageSourceFactory::Type() / s_Msix_FamilyName / s_AppxManifestFileName));
+}
+
+TEST_CASE("PIPS_SharedSourceData_Benchmark", "[.]")
+{
+    constexpr size_t userCount = 32;
+
+    auto simulate = [](PolicyState sharedDataPolicy)
+    {
+        SharedSourceDataSimulation simulation{ sharedDataPolicy };
+        simulation.SetSourcePackage(s_MsixFile_1);
+
+        auto start = std::chrono::steady_clock::now();
+        simulation.UpdateAndOpenForAllUsers(userCount);
+        simulation.SetSourcePackage(s_MsixFile_2);
+        simulation.UpdateAndOpenForAllUsers(userCount);
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::ostringstream result;
+        result << time.count() << "ms, " << (simulation.GetUsersSize() + simulation.GetSharedSize()) << " bytes on disk";
+        return result.str();
+    };
+
+    std::string perUser = simulate(PolicyState::NotConfigured);
+    std::string shared = simulate(PolicyState::Enabled);
+
+    WARN(userCount << " users adding and updating once; per user data: " << perUser << ", shared data: " << shared);
+}
@@ -7,6 +7,7 @@
 #include <AppInstallerStrings.h>
 #include <Microsoft/PredefinedInstalledSourceFactory.h>
 #include <Microsoft/ARPHelper.h>
+#include <Microsoft/InstalledPackageFilter.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -20,6 +21,9 @@ using namespace AppInstaller::Utility;
 using SQLiteIndex = AppInstaller::Repository::Microsoft::SQLiteIndex;
 using Factory = AppInstaller::Repository::Microsoft::PredefinedInstalledSourceFactory;
 using ARPHelper = AppInstaller::Repository::Microsoft::ARPHelper;
+using InstalledPackageFilter = AppInstaller::Repository::Microsoft::InstalledPackageFilter;
+using InstalledPackageEntry = AppInstaller::Repository::Microsoft::InstalledPackageEntry;
+using InstalledEntryTracker = AppInstaller::Repository::Microsoft::InstalledEntryTracker;
 
 constexpr std::string_view s_TestScope = "TestScope"sv;
 
@@ -145,6 +149,73 @@ std::shared_ptr<ISource> CreatePredefinedInstalledSource(Factory::Filter filter
     return factory->Create(details)->Open(progress);
 }
 
+InstalledPackageEntry CreateARPFilterEntry(std::string_view productCode, std::optional<std::string_view> name = {}, std::optional<std::string_view> publisher = {})
+{
+    InstalledPackageEntry result;
+    result.Id = productCode;
+    result.Tag = "ARP"sv;
+    result.ProductCode = productCode;
+    result.Name = name;
+    result.Publisher = publisher;
+    return result;
+}
+
+std::vector<ARPEntry> CreateFilterTestEntries(size_t count)
+{
+    std::vector<ARPEntry> result;
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string number = std::to_string(i);
+        ARPEntry entry{ "{Product-" + number + "}", "Test Name " + number, "1." + number };
+        entry.Publisher = "Publisher " + std::to_string(i % 10);
+        result.emplace_back(std::move(entry));
+    }
+
+    return result;
+}
+
+std::set<std::string> GetSearchResultIds(const SQLiteIndex& index, const SearchRequest& request)
+{
+    std::set<std::string> result;
+
+    for (const auto& match : index.Search(request).Matches)
+    {
+        result.emplace(index.GetPropertyByManifestId(match.first, PackageVersionProperty::Id).value());
+    }
+
+    return result;
+}
+
+std::vector<SearchRequest> CreateFilterTestRequests()
+{
+    std::vector<SearchRequest> result;
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "name 12"sv);
+    result.emplace_back(request);
+
+    request = {};
+    request.Query = RequestMatch(MatchType::Exact, "{product-7}"sv);
+    result.emplace_back(request);
+
+    request = {};
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{PRODUCT-42}"sv);
+    request.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Test Name 17"sv, "Publisher 7"sv);
+    result.emplace_back(request);
+
+    request = {};
+    request.Filters.emplace_back(PackageMatchField::Name, MatchType::StartsWith, "test name 9"sv);
+    request.Filters.emplace_back(PackageMatchField::Id, MatchType::Substring, "5"sv);
+    result.emplace_back(request);
+
+    request = {};
+    request.Query = RequestMatch(MatchType::Exact, "arp"sv);
+    result.emplace_back(request);
+
+    return result;
+}
+
 TEST_CASE("ARPHelper_GetARPForArchitecture", "[arphelper][list]")
 {
     auto systemArch = GetSystemArchitecture();
@@ -400,3 +471,186 @@ TEST_CASE("PredefinedInstalledSource_Search", "[installed][list]")
 
     REQUIRE_FALSE(results.Matches.empty());
 }
+
+TEST_CASE("InstalledPackageFilter_Everything", "[installed][list]")
+{
+    InstalledPackageFilter filter{ SearchRequest{} };
+
+    REQUIRE(filter.IsForEverything());
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("AnyCode")));
+}
+
+TEST_CASE("InstalledPackageFilter_Query", "[installed][list]")
+{
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "contoso"sv);
+    InstalledPackageFilter filter{ request };
+
+    REQUIRE_FALSE(filter.IsForEverything());
+
+    // The name is not known yet, so the entry could still match
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{Code}")));
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Contoso App"sv)));
+    REQUIRE_FALSE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Fabrikam App"sv)));
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{CONTOSO-Code}", "Fabrikam App"sv)));
+
+    // The query also matches the tag
+    request.Query = RequestMatch(MatchType::Exact, "ARP"sv);
+    REQUIRE(InstalledPackageFilter{ request }.CouldMatch(CreateARPFilterEntry("{Code}", "Fabrikam App"sv)));
+}
+
+TEST_CASE("InstalledPackageFilter_ProductCode", "[installed][list]")
+{
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{ABC}"sv);
+    InstalledPackageFilter filter{ request };
+
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{abc}")));
+    REQUIRE_FALSE(filter.CouldMatch(CreateARPFilterEntry("{def}")));
+
+    InstalledPackageEntry msixEntry;
+    msixEntry.Id = "{abc}";
+    msixEntry.Tag = "msix";
+    msixEntry.PackageFamilyName = "{abc}";
+    REQUIRE_FALSE(filter.CouldMatch(msixEntry));
+}
+
+TEST_CASE("InstalledPackageFilter_NormalizedNameAndPublisher", "[installed][list]")
+{
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Contoso App"sv, "Contoso"sv);
+    InstalledPackageFilter filter{ request };
+
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{Code}")));
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "CONTOSO APP"sv, "contoso"sv)));
+    REQUIRE_FALSE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Fabrikam App"sv, "Contoso"sv)));
+}
+
+TEST_CASE("InstalledPackageFilter_Filters", "[installed][list]")
+{
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "app"sv);
+    request.Filters.emplace_back(PackageMatchField::Name, MatchType::StartsWith, "contoso"sv);
+    InstalledPackageFilter filter{ request };
+
+    REQUIRE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Contoso App"sv)));
+    REQUIRE_FALSE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Fabrikam App"sv)));
+    REQUIRE_FALSE(filter.CouldMatch(CreateARPFilterEntry("{Code}", "Contoso Tool"sv)));
+
+    // Match types that are not evaluated never exclude an entry
+    request.Filters.emplace_back(PackageMatchField::Name, MatchType::Fuzzy, "something else"sv);
+    REQUIRE(InstalledPackageFilter{ request }.CouldMatch(CreateARPFilterEntry("{Code}", "Contoso App"sv)));
+}
+
+TEST_CASE("ARPHelper_PopulateIndexFromKey_FilteredMatchesFull", "[arphelper][list]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+    AddARPEntriesToKey(root.get(), helper, CreateFilterTestEntries(200));
+
+    auto fullIndex = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    helper.PopulateIndexFromKey(fullIndex, key, s_TestScope, "TestArchitecture");
+    REQUIRE(fullIndex.Search({}).Matches.size() == 200);
+
+    for (const auto& request : CreateFilterTestRequests())
+    {
+        INFO(request.ToString());
+
+        auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+        InstalledEntryTracker tracker;
+        helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", InstalledPackageFilter{ request }, tracker);
+
+        REQUIRE(GetSearchResultIds(index, request) == GetSearchResultIds(fullIndex, request));
+    }
+}
+
+TEST_CASE("ARPHelper_PopulateIndexFromKey_FilteredSkipsEntries", "[arphelper][list]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+    AddARPEntriesToKey(root.get(), helper, CreateFilterTestEntries(100));
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    InstalledEntryTracker tracker;
+
+    SearchRequest request;
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{Product-42}"sv);
+    helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", InstalledPackageFilter{ request }, tracker);
+
+    REQUIRE(index.Search({}).Matches.size() == 1);
+
+    // Populating again adds only the new entries
+    request.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{Product-43}"sv);
+    helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", InstalledPackageFilter{ request }, tracker);
+
+    REQUIRE(index.Search({}).Matches.size() == 2);
+
+    helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", {}, tracker);
+
+    REQUIRE(index.Search({}).Matches.size() == 100);
+}
+
+TEST_CASE("ARPHelper_PopulateIndexFromKey_FilteredDuplicates", "[arphelper][list]")
+{
+    auto root1 = RegCreateVolatileTestRoot();
+    Registry::Key key1(root1.get());
+    auto root2 = RegCreateVolatileTestRoot();
+    Registry::Key key2(root2.get());
+
+    ARPHelper helper;
+    AddARPEntriesToKey(root1.get(), helper, { { "SameCode", "First Name", "1.0" } });
+    AddARPEntriesToKey(root2.get(), helper, { { "SameCode", "Second Name", "2.0" } });
+
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    InstalledEntryTracker tracker;
+
+    // The entry from the first location owns the product code, even when it does not match
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Substring, "Second"sv);
+    helper.PopulateIndexFromKey(index, key1, s_TestScope, "First", InstalledPackageFilter{ request }, tracker);
+    helper.PopulateIndexFromKey(index, key2, s_TestScope, "Second", InstalledPackageFilter{ request }, tracker);
+
+    REQUIRE(index.Search(request).Matches.empty());
+
+    helper.PopulateIndexFromKey(index, key1, s_TestScope, "First", {}, tracker);
+    helper.PopulateIndexFromKey(index, key2, s_TestScope, "Second", {}, tracker);
+
+    auto result = index.Search({});
+    REQUIRE(result.Matches.size() == 1);
+    REQUIRE(index.GetPropertyByManifestId(result.Matches[0].first, PackageVersionProperty::Name) == "First Name");
+}
+
+TEST_CASE("ARPHelper_PopulateIndexFromKey_FilteredBenchmark", "[.]")
+{
+    auto root = RegCreateVolatileTestRoot();
+    Registry::Key key(root.get());
+
+    ARPHelper helper;
+    AddARPEntriesToKey(root.get(), helper, CreateFilterTestEntries(5000));
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, "{Product-4321}"sv);
+
+    auto start = std::chrono::steady_clock::now();
+    auto fullIndex = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    helper.PopulateIndexFromKey(fullIndex, key, s_TestScope, "TestArchitecture");
+    auto fullResult = fullIndex.Search(request);
+    auto fullTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    auto index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+    InstalledEntryTracker tracker;
+    helper.PopulateIndexFromKey(index, key, s_TestScope, "TestArchitecture", InstalledPackageFilter{ request }, tracker);
+    auto filteredResult = index.Search(request);
+    auto filteredTime = std::chrono::steady_clock::now() - start;
+
+    REQUIRE(fullResult.Matches.size() == 1);
+    REQUIRE(filteredResult.Matches.size() == 1);
+
+    WARN("Full: " << std::chrono::duration_cast<std::chrono::milliseconds>(fullTime).count() << "ms, filtered: " <<
+        std::chrono::duration_cast<std::chrono::milliseconds>(filteredTime).count() << "ms");
+}
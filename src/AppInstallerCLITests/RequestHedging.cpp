@@ -0,0 +1,194 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestRestRequestHandler.h"
+#include <Rest/Schema/HttpClientHelper.h>
+#include <Rest/Schema/RequestHedging.h>
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Repository::Rest::Schema;
+
+namespace
+{
+    const utility::string_t TestRestUri = L"http://restsource.net/packageManifests/Foo.Bar";
+    const utility::string_t TestResponse = L"{ \"Data\": \"Value\" }";
+
+    web::http::http_response CreateTestResponse()
+    {
+        web::http::http_response response;
+        response.set_body(web::json::value::parse(TestResponse));
+        response.headers().set_content_type(web::http::details::mime_types::application_json);
+        response.set_status_code(web::http::status_codes::OK);
+        return response;
+    }
+
+    // Responds after the delay returned by the given function, which is called with the zero based request number.
+    std::shared_ptr<TestRestRequestHandler> GetDelayedRequestHandler(std::function<std::chrono::milliseconds(size_t)> getDelay, std::shared_ptr<std::atomic<size_t>> requestCount)
+    {
+        return std::make_shared<TestRestRequestHandler>([getDelay, requestCount](web::http::http_request) ->
+            pplx::task<web::http::http_response>
+            {
+                std::chrono::milliseconds delay = getDelay((*requestCount)++);
+                return pplx::create_task([delay]()
+                    {
+                        std::this_thread::sleep_for(delay);
+                        return CreateTestResponse();
+                    });
+            });
+    }
+
+    RequestHedgingPolicy::Options GetTestOptions()
+    {
+        RequestHedgingPolicy::Options options;
+        options.InitialDelay = 50ms;
+        options.MinimumDelay = 10ms;
+        options.MinimumSamples = 4;
+        return options;
+    }
+
+    std::chrono::milliseconds TimedGet(const HttpClientHelper& helper)
+    {
+        auto start = std::chrono::steady_clock::now();
+        auto result = helper.HandleGet(TestRestUri);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        REQUIRE(result);
+        REQUIRE(result->at(L"Data").as_string() == L"Value");
+        return elapsed;
+    }
+
+    std::chrono::milliseconds GetPercentile(std::vector<std::chrono::milliseconds> values, double percentile)
+    {
+        std::sort(values.begin(), values.end());
+        return values[std::min(static_cast<size_t>(percentile * values.size()), values.size() - 1)];
+    }
+}
+
+TEST_CASE("RequestHedgingPolicy_DelayFromLatency", "[RestSource][RequestHedging]")
+{
+    RequestHedgingPolicy policy{ GetTestOptions() };
+    utility::string_t endpoint = L"http://restsource.net/manifestSearch";
+
+    REQUIRE(policy.GetHedgeDelay(endpoint) == 50ms);
+
+    for (int i = 1; i <= 100; ++i)
+    {
+        policy.RecordLatency(endpoint, std::chrono::milliseconds{ i });
+    }
+
+    // The window keeps the last 64 samples (37-100ms); the 95th percentile of those is 97ms.
+    REQUIRE(policy.GetHedgeDelay(endpoint) == 97ms);
+
+    // Other endpoints are not affected.
+    REQUIRE(policy.GetHedgeDelay(L"http://restsource.net/information") == 50ms);
+
+    // The delay is clamped.
+    for (int i = 0; i < 64; ++i)
+    {
+        policy.RecordLatency(endpoint, 1ms);
+    }
+
+    REQUIRE(policy.GetHedgeDelay(endpoint) == 10ms);
+}
+
+TEST_CASE("RequestHedgingPolicy_Budget", "[RestSource][RequestHedging]")
+{
+    RequestHedgingPolicy::Options options = GetTestOptions();
+    options.BudgetBurst = 1;
+    options.BudgetRatio = 0.5;
+    RequestHedgingPolicy policy{ options };
+
+    REQUIRE(policy.TryAcquireHedge());
+    REQUIRE(!policy.TryAcquireHedge());
+
+    policy.RecordRequest();
+    REQUIRE(!policy.TryAcquireHedge());
+
+    policy.RecordRequest();
+    REQUIRE(policy.TryAcquireHedge());
+    REQUIRE(!policy.TryAcquireHedge());
+}
+
+TEST_CASE("HttpClientHelper_Hedging_SlowRequestHedged", "[RestSource][RequestHedging]")
+{
+    auto requestCount = std::make_shared<std::atomic<size_t>>(0);
+    auto policy = std::make_shared<RequestHedgingPolicy>(GetTestOptions());
+    HttpClientHelper helper{ GetDelayedRequestHandler([](size_t request) { return request == 0 ? 5000ms : 0ms; }, requestCount), policy };
+
+    REQUIRE(TimedGet(helper) < 2500ms);
+    REQUIRE(*requestCount == 2);
+}
+
+TEST_CASE("HttpClientHelper_Hedging_FastRequestNotHedged", "[RestSource][RequestHedging]")
+{
+    auto requestCount = std::make_shared<std::atomic<size_t>>(0);
+    RequestHedgingPolicy::Options options = GetTestOptions();
+    options.InitialDelay = 2000ms;
+    auto policy = std::make_shared<RequestHedgingPolicy>(options);
+    HttpClientHelper helper{ GetDelayedRequestHandler([](size_t) { return 0ms; }, requestCount), policy };
+
+    TimedGet(helper);
+    REQUIRE(*requestCount == 1);
+}
+
+TEST_CASE("HttpClientHelper_Hedging_BudgetExhausted", "[RestSource][RequestHedging]")
+{
+    auto requestCount = std::make_shared<std::atomic<size_t>>(0);
+    RequestHedgingPolicy::Options options = GetTestOptions();
+    options.BudgetBurst = 0;
+    options.BudgetRatio = 0;
+    auto policy = std::make_shared<RequestHedgingPolicy>(options);
+    HttpClientHelper helper{ GetDelayedRequestHandler([](size_t) { return 200ms; }, requestCount), policy };
+
+    TimedGet(helper);
+    REQUIRE(*requestCount == 1);
+}
+
+TEST_CASE("HttpClientHelper_Hedging_NotEnabled", "[RestSource][RequestHedging]")
+{
+    TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkRestRequestHedging>(false);
+
+    auto requestCount = std::make_shared<std::atomic<size_t>>(0);
+    HttpClientHelper helper{ GetDelayedRequestHandler([](size_t) { return 200ms; }, requestCount) };
+
+    TimedGet(helper);
+    REQUIRE(*requestCount == 1);
+}
+
+// Compares the latency distribution with and without hedging against a handler where one in ten requests is slow.
+TEST_CASE("HttpClientHelper_Hedging_LatencyDistribution", "[.]")
+{
+    constexpr size_t RequestCount = 100;
+    auto getDelay = [](size_t request) { return (request % 10 == 3) ? 1000ms : std::chrono::milliseconds{ 20 + request % 7 }; };
+
+    auto measure = [&](std::shared_ptr<RequestHedgingPolicy> policy)
+    {
+        auto requestCount = std::make_shared<std::atomic<size_t>>(0);
+        HttpClientHelper helper{ GetDelayedRequestHandler(getDelay, requestCount), std::move(policy) };
+
+        std::vector<std::chrono::milliseconds> latencies;
+        for (size_t i = 0; i < RequestCount; ++i)
+        {
+            latencies.emplace_back(TimedGet(helper));
+        }
+        return latencies;
+    };
+
+    TestUserSettings settings;
+    settings.Set<AppInstaller::Settings::Setting::NetworkRestRequestHedging>(false);
+
+    auto baseline = measure({});
+
+    RequestHedgingPolicy::Options options;
+    options.InitialDelay = 100ms;
+    options.BudgetRatio = 0.2;
+    auto hedged = measure(std::make_shared<RequestHedgingPolicy>(options));
+
+    WARN("Without hedging: p50 " << GetPercentile(baseline, 0.5).count() << "ms, p99 " << GetPercentile(baseline, 0.99).count() << "ms");
+    WARN("With hedging: p50 " << GetPercentile(hedged, 0.5).count() << "ms, p99 " << GetPercentile(hedged, 0.99).count() << "ms");
+
+    REQUIRE(GetPercentile(hedged, 0.99) < GetPercentile(baseline, 0.99));
+}
@@ -104,6 +104,50 @@ TEST_CASE("GetInformation_Success", "[RestSource]")
     REQUIRE(information.UnsupportedQueryParameters.at(0) == "Moniker");
     REQUIRE(information.UnsupportedPackageMatchFields.size() == 1);
     REQUIRE(information.UnsupportedPackageMatchFields.at(0) == "Moniker");
+    REQUIRE(information.IdentifierNamespaces.empty());
+    REQUIRE(information.Publishers.empty());
+}
+
+TEST_CASE("GetInformation_Success_Scope", "[RestSource]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : {
+              "SourceIdentifier": "Source123",
+              "ServerSupportedVersions": [
+                "1.0.0",
+                "1.1.0"],
+              "IdentifierNamespaces": [
+                "Contoso",
+                "Fabrikam"
+              ],
+              "Publishers": [
+                "Contoso Ltd."
+              ]
+        }})delimiter");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, sample) };
+    IRestClient::Information information = RestClient::GetInformation(TestRestUri, {}, std::move(helper));
+    REQUIRE(information.IdentifierNamespaces == std::vector<std::string>{ "Contoso", "Fabrikam" });
+    REQUIRE(information.Publishers == std::vector<std::string>{ "Contoso Ltd." });
+}
+
+TEST_CASE("GetInformation_Success_SupportedExtensions", "[RestSource]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : {
+              "SourceIdentifier": "Source123",
+              "ServerSupportedVersions": [
+                "1.1.0"],
+              "SupportedExtensions": [
+                "SearchResponseFields"
+              ]
+        }})delimiter");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, sample) };
+    IRestClient::Information information = RestClient::GetInformation(TestRestUri, {}, std::move(helper));
+    REQUIRE(information.SupportedExtensions == std::vector<std::string>{ "SearchResponseFields" });
 }
 
 TEST_CASE("GetInformation_Fail_AgreementsWithoutIdentifier", "[RestSource]")
@@ -0,0 +1,427 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestRestRequestHandler.h"
+#include <Rest/RestClient.h>
+#include <Rest/RestSource.h>
+#include <Rest/Schema/1_1/Interface.h>
+#include <Rest/Schema/IRestClient.h>
+#include <Rest/Schema/RestHelper.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Rest;
+using namespace AppInstaller::Repository::Rest::Schema;
+
+namespace
+{
+    const std::string TestRestUriString = "http://restsource.com/api";
+
+    std::string GetString(const web::json::value& node, std::wstring_view name)
+    {
+        return node.has_field(std::wstring{ name }) ? utility::conversions::to_utf8string(node.at(std::wstring{ name }).as_string()) : std::string{};
+    }
+
+    // A local REST source with packages that each have many versions, which counts the requests that it receives
+    // and the size of its responses. It applies the response fields of search requests if it supports the extension.
+    struct ResponseFieldsTestServer
+    {
+        ResponseFieldsTestServer(size_t packageCount, size_t versionCount, bool supportsExtension) :
+            PackageCount(packageCount), VersionCount(versionCount), SupportsExtension(supportsExtension) {}
+
+        std::shared_ptr<TestRestRequestHandler> GetHandler()
+        {
+            return std::make_shared<TestRestRequestHandler>([this](web::http::http_request request) -> pplx::task<web::http::http_response>
+                {
+                    web::json::value body;
+                    std::wstring path = request.request_uri().path();
+
+                    if (path.find(L"/information") != std::wstring::npos)
+                    {
+                        body = GetInformation();
+                    }
+                    else
+                    {
+                        ++SearchCount;
+                        SearchRequests.emplace_back(web::json::value::parse(request.extract_utf16string(true).get()));
+                        body = Search(SearchRequests.back());
+                        ResponseBytes += body.serialize().size();
+                    }
+
+                    web::http::http_response response;
+                    response.set_body(body);
+                    response.headers().set_content_type(web::http::details::mime_types::application_json);
+                    response.set_status_code(web::http::status_codes::OK);
+                    return pplx::task_from_result(response);
+                });
+        }
+
+        std::string GetId(size_t i) const
+        {
+            return "Fields.Package" + std::to_string(i);
+        }
+
+        size_t PackageCount;
+        size_t VersionCount;
+        bool SupportsExtension;
+        size_t SearchCount = 0;
+        size_t ResponseBytes = 0;
+        std::vector<web::json::value> SearchRequests;
+
+    private:
+        web::json::value GetInformation() const
+        {
+            web::json::value data;
+            data[L"SourceIdentifier"] = web::json::value::string(L"ResponseFieldsTest");
+            data[L"ServerSupportedVersions"] = web::json::value::array({ web::json::value::string(L"1.1.0") });
+
+            if (SupportsExtension)
+            {
+                data[L"SupportedExtensions"] = web::json::value::array({ web::json::value::string(L"SearchResponseFields") });
+            }
+
+            web::json::value result;
+            result[L"Data"] = std::move(data);
+            return result;
+        }
+
+        web::json::value Search(const web::json::value& request) const
+        {
+            // The tests search by a query, or by an identifier inclusion.
+            const web::json::value* match = nullptr;
+            if (request.has_field(L"Query"))
+            {
+                match = &request.at(L"Query");
+            }
+            else if (request.has_field(L"Inclusions"))
+            {
+                match = &request.at(L"Inclusions").at(0).at(L"RequestMatch");
+            }
+
+            std::string keyWord = match ? GetString(*match, L"KeyWord") : std::string{};
+            bool exact = match && (GetString(*match, L"MatchType") == "Exact" || GetString(*match, L"MatchType") == "CaseInsensitive");
+
+            SearchResultFields fields = SearchResultFields::All;
+            if (SupportsExtension && request.has_field(L"ResponseFields"))
+            {
+                fields = RestHelper::GetResponseFields(request);
+            }
+
+            std::vector<web::json::value> packages;
+            for (size_t i = 0; i < PackageCount; ++i)
+            {
+                std::string id = GetId(i);
+                if (exact ? Utility::CaseInsensitiveEquals(id, keyWord) : Utility::CaseInsensitiveStartsWith(id, keyWord))
+                {
+                    packages.emplace_back(MakePackage(i, fields));
+                }
+            }
+
+            web::json::value result;
+            result[L"Data"] = web::json::value::array(std::move(packages));
+
+            if (fields != SearchResultFields::All)
+            {
+                RestHelper::SetResponseFields(result, fields);
+            }
+
+            return result;
+        }
+
+        web::json::value MakePackage(size_t i, SearchResultFields fields) const
+        {
+            std::wstring id = utility::conversions::to_string_t(GetId(i));
+
+            web::json::value package;
+            package[L"PackageIdentifier"] = web::json::value::string(id);
+            package[L"PackageName"] = web::json::value::string(L"Name of " + id);
+            package[L"Publisher"] = web::json::value::string(L"Publisher");
+
+            std::vector<web::json::value> versions;
+            for (size_t v = VersionCount; v > 0; --v)
+            {
+                // The versions are listed latest first.
+                if (v < VersionCount && !WI_AreAllFlagsSet(fields, SearchResultFields::Versions))
+                {
+                    break;
+                }
+
+                if (!WI_IsAnyFlagSet(fields, SearchResultFields::LatestVersion))
+                {
+                    break;
+                }
+
+                web::json::value version;
+                version[L"PackageVersion"] = web::json::value::string(std::to_wstring(v) + L".0");
+
+                if (WI_IsFlagSet(fields, SearchResultFields::CorrelationKeys))
+                {
+                    version[L"PackageFamilyNames"] = web::json::value::array({ web::json::value::string(id + L"_" + std::to_wstring(v) + L"_8wekyb3d8bbwe") });
+                    version[L"ProductCodes"] = web::json::value::array({ web::json::value::string(L"{" + id + L"-" + std::to_wstring(v) + L"}") });
+                }
+
+                versions.emplace_back(std::move(version));
+            }
+
+            if (!versions.empty())
+            {
+                package[L"Versions"] = web::json::value::array(std::move(versions));
+            }
+
+            return package;
+        }
+    };
+
+    std::shared_ptr<RestSource> CreateSource(ResponseFieldsTestServer& server)
+    {
+        SourceDetails details;
+        details.Name = "ResponseFieldsTest";
+        details.Identifier = "*ResponseFieldsTest";
+
+        HttpClientHelper helper{ server.GetHandler() };
+        RestClient client = RestClient::Create(TestRestUriString, {}, std::move(helper));
+        return std::make_shared<RestSource>(details, SourceInformation{}, std::move(client));
+    }
+
+    SearchRequest MakeQuery(std::string_view query, SearchResultFields fields)
+    {
+        SearchRequest result;
+        result.Query.emplace(MatchType::StartsWith, query);
+        result.Fields = fields;
+        return result;
+    }
+}
+
+TEST_CASE("RestResponseFields_RoundTrip", "[RestResponseFields]")
+{
+    for (SearchResultFields fields : { SearchResultFields::None, SearchResultFields::LatestVersion, SearchResultFields::Versions,
+        SearchResultFields::LatestVersion | SearchResultFields::CorrelationKeys })
+    {
+        web::json::value body;
+        RestHelper::SetResponseFields(body, fields);
+        REQUIRE(body.has_field(L"ResponseFields"));
+        REQUIRE(RestHelper::GetResponseFields(body) == fields);
+    }
+
+    // All of the data is the same as not listing any.
+    web::json::value body = web::json::value::object();
+    RestHelper::SetResponseFields(body, SearchResultFields::All);
+    REQUIRE(!body.has_field(L"ResponseFields"));
+    REQUIRE(RestHelper::GetResponseFields(body) == SearchResultFields::All);
+}
+
+TEST_CASE("RestResponseFields_OnlyRequestedWhenSupported", "[RestResponseFields]")
+{
+    bool supportsExtension = GENERATE(true, false);
+    ResponseFieldsTestServer server{ 3, 5, supportsExtension };
+
+    HttpClientHelper helper{ server.GetHandler() };
+    RestClient client = RestClient::Create(TestRestUriString, {}, std::move(helper));
+
+    IRestClient::SearchResult result = client.Search(MakeQuery("Fields.", SearchResultFields::LatestVersion));
+    REQUIRE(server.SearchRequests.size() == 1);
+    REQUIRE(server.SearchRequests[0].has_field(L"ResponseFields") == supportsExtension);
+
+    REQUIRE(result.Matches.size() == 3);
+    for (const auto& package : result.Matches)
+    {
+        if (supportsExtension)
+        {
+            REQUIRE(package.Fields == SearchResultFields::LatestVersion);
+            REQUIRE(package.Versions.size() == 1);
+            REQUIRE(package.Versions[0].PackageFamilyNames.empty());
+        }
+        else
+        {
+            // A source without the extension returns all of the data, as before.
+            REQUIRE(package.Fields == SearchResultFields::All);
+            REQUIRE(package.Versions.size() == 5);
+            REQUIRE(!package.Versions[0].PackageFamilyNames.empty());
+        }
+    }
+
+    // Requests for all of the data never list the fields.
+    client.Search(MakeQuery("Fields.", SearchResultFields::All));
+    REQUIRE(!server.SearchRequests.back().has_field(L"ResponseFields"));
+}
+
+TEST_CASE("RestResponseFields_IgnoredByServer", "[RestResponseFields]")
+{
+    // A response without response fields includes all of the data, even if only some was requested.
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : [
+               {
+              "PackageIdentifier": "git.package",
+              "PackageName": "package",
+              "Publisher": "git",
+              "Versions": [
+                {   "PackageVersion": "1.0.0", "ProductCodes": [ "{git}" ] },
+                {   "PackageVersion": "2.0.0" }]
+            }]
+        })delimiter");
+
+    IRestClient::Information information;
+    information.SupportedExtensions.emplace_back("SearchResponseFields");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, std::move(sample)) };
+    V1_1::Interface v1_1{ TestRestUriString, std::move(information), {}, std::move(helper) };
+
+    IRestClient::SearchResult result = v1_1.Search(MakeQuery("git", SearchResultFields::None));
+    REQUIRE(result.Matches.size() == 1);
+    REQUIRE(result.Matches[0].Fields == SearchResultFields::All);
+    REQUIRE(result.Matches[0].Versions.size() == 2);
+}
+
+TEST_CASE("RestResponseFields_NoVersions", "[RestResponseFields]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : [
+               {
+              "PackageIdentifier": "git.package",
+              "PackageName": "package",
+              "Publisher": "git"
+            }],
+            "ResponseFields": []
+        })delimiter");
+
+    IRestClient::Information information;
+    information.SupportedExtensions.emplace_back("SearchResponseFields");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, std::move(sample)) };
+    V1_1::Interface v1_1{ TestRestUriString, std::move(information), {}, std::move(helper) };
+
+    IRestClient::SearchResult result = v1_1.Search(MakeQuery("git", SearchResultFields::None));
+    REQUIRE(result.Matches.size() == 1);
+    REQUIRE(result.Matches[0].Fields == SearchResultFields::None);
+    REQUIRE(result.Matches[0].Versions.empty());
+}
+
+TEST_CASE("RestResponseFields_VersionsRequiredWhenRequested", "[RestResponseFields]")
+{
+    utility::string_t sample = _XPLATSTR(
+        R"delimiter({
+            "Data" : [
+               {
+              "PackageIdentifier": "git.package",
+              "PackageName": "package",
+              "Publisher": "git"
+            }],
+            "ResponseFields": [ "LatestVersion" ]
+        })delimiter");
+
+    IRestClient::Information information;
+    information.SupportedExtensions.emplace_back("SearchResponseFields");
+
+    HttpClientHelper helper{ GetTestRestRequestHandler(web::http::status_codes::OK, std::move(sample)) };
+    V1_1::Interface v1_1{ TestRestUriString, std::move(information), {}, std::move(helper) };
+
+    REQUIRE_THROWS_HR(v1_1.Search(MakeQuery("git", SearchResultFields::LatestVersion)), APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA);
+}
+
+TEST_CASE("RestResponseFields_IdentityOnly", "[RestResponseFields]")
+{
+    ResponseFieldsTestServer server{ 10, 5, true };
+    auto source = CreateSource(server);
+
+    SearchResult result = source->Search(MakeQuery("Fields.Package", SearchResultFields::None));
+    REQUIRE(result.Matches.size() == 10);
+    REQUIRE(server.SearchCount == 1);
+
+    // The identifier and name are present without another request.
+    for (const auto& match : result.Matches)
+    {
+        REQUIRE(!match.Package->GetProperty(PackageProperty::Id).get().empty());
+        REQUIRE(!match.Package->GetProperty(PackageProperty::Name).get().empty());
+    }
+    REQUIRE(server.SearchCount == 1);
+
+    // The versions of a package are retrieved when they are used, once.
+    auto versionKeys = result.Matches[3].Package->GetAvailableVersionKeys();
+    REQUIRE(versionKeys.size() == 5);
+    REQUIRE(server.SearchCount == 2);
+    REQUIRE(!server.SearchRequests.back().has_field(L"ResponseFields"));
+
+    auto latest = result.Matches[3].Package->GetLatestAvailableVersion();
+    REQUIRE(latest->GetProperty(PackageVersionProperty::Version) == "5.0");
+    REQUIRE(latest->GetMultiProperty(PackageVersionMultiProperty::ProductCode).size() == 1);
+    REQUIRE(server.SearchCount == 2);
+}
+
+TEST_CASE("RestResponseFields_LatestVersion", "[RestResponseFields]")
+{
+    ResponseFieldsTestServer server{ 10, 5, true };
+    auto source = CreateSource(server);
+
+    SearchResult result = source->Search(MakeQuery("Fields.Package", SearchResultFields::LatestVersion));
+    REQUIRE(result.Matches.size() == 10);
+
+    // What the search command shows needs no more requests.
+    for (const auto& match : result.Matches)
+    {
+        auto latest = match.Package->GetLatestAvailableVersion();
+        REQUIRE(latest->GetProperty(PackageVersionProperty::Version) == "5.0");
+        REQUIRE(!latest->GetProperty(PackageVersionProperty::Name).get().empty());
+    }
+    REQUIRE(server.SearchCount == 1);
+
+    // Correlation keys are retrieved for the package that needs them.
+    auto latest = result.Matches[0].Package->GetLatestAvailableVersion();
+    auto productCodes = latest->GetMultiProperty(PackageVersionMultiProperty::ProductCode);
+    REQUIRE(productCodes.size() == 1);
+    REQUIRE(productCodes[0] == "{" + server.GetId(0) + "-5}");
+    REQUIRE(latest->GetMultiProperty(PackageVersionMultiProperty::PackageFamilyName).size() == 1);
+    REQUIRE(server.SearchCount == 2);
+
+    // As are other versions.
+    auto older = result.Matches[1].Package->GetAvailableVersion({ "", "2.0", "" });
+    REQUIRE(older);
+    REQUIRE(older->GetProperty(PackageVersionProperty::Version) == "2.0");
+    REQUIRE(server.SearchCount == 3);
+}
+
+TEST_CASE("RestResponseFields_ServerWithoutExtension", "[RestResponseFields]")
+{
+    ResponseFieldsTestServer server{ 10, 5, false };
+    auto source = CreateSource(server);
+
+    SearchResult result = source->Search(MakeQuery("Fields.Package", SearchResultFields::None));
+    REQUIRE(result.Matches.size() == 10);
+
+    for (const auto& match : result.Matches)
+    {
+        REQUIRE(match.Package->GetAvailableVersionKeys().size() == 5);
+        REQUIRE(match.Package->GetLatestAvailableVersion()->GetMultiProperty(PackageVersionMultiProperty::ProductCode).size() == 1);
+    }
+
+    REQUIRE(server.SearchCount == 1);
+}
+
+// Not a test; compares the size of search responses and the time to search with and without response fields.
+TEST_CASE("RestResponseFields_Benchmark", "[RestResponseFields][.]")
+{
+    constexpr size_t packageCount = 500;
+    constexpr size_t versionCount = 40;
+    constexpr size_t iterations = 10;
+
+    for (SearchResultFields fields : { SearchResultFields::All, SearchResultFields::LatestVersion, SearchResultFields::None })
+    {
+        ResponseFieldsTestServer server{ packageCount, versionCount, true };
+        auto source = CreateSource(server);
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            SearchResult result = source->Search(MakeQuery("Fields.Package", fields));
+            REQUIRE(result.Matches.size() == packageCount);
+        }
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        WARN("Fields " << static_cast<uint32_t>(fields) << ": " << (server.ResponseBytes / iterations) << " response bytes, " << (duration / iterations) << " us per search");
+    }
+}
@@ -343,6 +343,25 @@ TEST_CASE("SQLiteIndexCreateAndAddManifest", "[sqliteindex]")
     SQLiteIndex index = SimpleTestSetup(tempFile, manifest, relativePath);
 }
 
+TEST_CASE("SQLiteIndex_MoveAssignmentCallsOnClose", "[sqliteindex]")
+{
+    std::vector<std::string> closed;
+
+    {
+        SQLiteIndex index = CreateTestIndex(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+        index.OnClose([&](SQLiteIndex&) { closed.emplace_back("replaced"); });
+
+        SQLiteIndex other = CreateTestIndex(SQLITE_MEMORY_DB_CONNECTION_TARGET);
+        other.OnClose([&](SQLiteIndex&) { closed.emplace_back("moved"); });
+
+        // The replaced index is closed right away, while the functions of the other move along with it.
+        index = std::move(other);
+        REQUIRE(closed == std::vector<std::string>{ "replaced" });
+    }
+
+    REQUIRE(closed == std::vector<std::string>{ "replaced", "moved" });
+}
+
 TEST_CASE("SQLiteIndexCreateAndAddManifestFile", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -1073,6 +1092,227 @@ TEST_CASE("SQLiteIndex_PrepareForPackaging", "[sqliteindex]")
     index.PrepareForPackaging();
 }
 
+// Gets the schema and the rows of every table in the database, in a form that can be compared across databases.
+std::vector<std::string> GetDatabaseContents(const std::filesystem::path& filePath)
+{
+    Connection connection = Connection::Create(filePath.u8string(), Connection::OpenDisposition::ReadOnly);
+    std::vector<std::string> result;
+    std::vector<std::string> tables;
+
+    Statement schema = Statement::Create(connection, "select [type], [name], ifnull([sql], '') from [sqlite_master] order by [name]");
+    while (schema.Step())
+    {
+        auto [type, name, sql] = schema.GetRow<std::string, std::string, std::string>();
+        result.emplace_back(type + '|' + name + '|' + sql);
+
+        if (type == "table")
+        {
+            tables.emplace_back(std::move(name));
+        }
+    }
+
+    for (const auto& table : tables)
+    {
+        std::string columns = "quote([rowid])";
+
+        Statement tableInfo = Statement::Create(connection, "pragma table_info([" + table + "])");
+        while (tableInfo.Step())
+        {
+            columns += " || '|' || quote([" + tableInfo.GetColumn<std::string>(1) + "])";
+        }
+
+        Statement rows = Statement::Create(connection, "select " + columns + " from [" + table + "] order by [rowid]");
+        while (rows.Step())
+        {
+            result.emplace_back(table + '|' + rows.GetColumn<std::string>(0));
+        }
+    }
+
+    return result;
+}
+
+int GetFreePageCount(const std::filesystem::path& filePath)
+{
+    Connection connection = Connection::Create(filePath.u8string(), Connection::OpenDisposition::ReadOnly);
+    Statement freelistCount = Statement::Create(connection, "pragma freelist_count");
+    REQUIRE(freelistCount.Step());
+    return freelistCount.GetColumn<int>(0);
+}
+
+std::string ReadFileContents(const std::filesystem::path& filePath)
+{
+    std::ifstream stream{ filePath, std::ios::binary };
+    return ReadEntireStream(stream);
+}
+
+Manifest CreatePackagingTestManifest(size_t i)
+{
+    Manifest manifest;
+    manifest.Installers.push_back({});
+    manifest.Id = "Publisher" + std::to_string(i % 100) + ".Package" + std::to_string(i);
+    manifest.DefaultLocalization.Add<Localization::PackageName>("Package Name " + std::to_string(i));
+    manifest.DefaultLocalization.Add<Localization::Publisher>("Publisher " + std::to_string(i % 100));
+    manifest.Moniker = "package" + std::to_string(i);
+    manifest.Version = std::to_string(i % 7) + ".0." + std::to_string(i);
+    manifest.DefaultLocalization.Add<Localization::Tags>({ "tag" + std::to_string(i % 13), "tag" + std::to_string(i % 29) });
+    manifest.Installers[0].Commands = { "command" + std::to_string(i) };
+    manifest.Installers[0].PackageFamilyName = "Publisher.Package" + std::to_string(i) + "_8wekyb3d8bbwe";
+    manifest.Installers[0].ProductCode = "{" + std::to_string(i) + "}";
+    return manifest;
+}
+
+std::string GetPackagingTestManifestPath(size_t i)
+{
+    return "publisher/package" + std::to_string(i) + "/manifest.yaml";
+}
+
+TEST_CASE("SQLiteIndex_ExportForPackaging", "[sqliteindex]")
+{
+    TempFile workingFile{ "repolibtest_tempdb"s, ".db"s };
+    TempFile preparedFile{ "repolibtest_tempdb_prepared"s, ".db"s };
+    TempFile exportedFile{ "repolibtest_tempdb_exported"s, ".db"s };
+    INFO("Using temporary file named: " << workingFile.GetPath());
+
+    Schema::Version version = GENERATE(Schema::Version{ 1, 0 }, Schema::Version{ 1, 1 }, Schema::Version{ 1, 2 }, Schema::Version::Latest());
+    SQLiteIndex index = CreateTestIndex(workingFile, version);
+
+    for (size_t i = 0; i < 10; ++i)
+    {
+        index.AddManifest(CreatePackagingTestManifest(i), GetPackagingTestManifestPath(i));
+    }
+
+    // Leave gaps in the rowids and free pages in the working index
+    for (size_t i = 0; i < 10; i += 3)
+    {
+        index.RemoveManifest(CreatePackagingTestManifest(i), GetPackagingTestManifestPath(i));
+    }
+
+    std::string workingContents = ReadFileContents(workingFile);
+
+    index.ExportForPackaging(exportedFile);
+
+    // The working index is not modified, and an existing file is not overwritten
+    REQUIRE(ReadFileContents(workingFile) == workingContents);
+    REQUIRE_THROWS_HR(index.ExportForPackaging(exportedFile), HRESULT_FROM_WIN32(ERROR_FILE_EXISTS));
+
+    std::filesystem::copy_file(workingFile, preparedFile);
+    {
+        SQLiteIndex prepared = SQLiteIndex::Open(preparedFile, SQLiteIndex::OpenDisposition::ReadWrite);
+        prepared.PrepareForPackaging();
+    }
+
+    // The result is the same as preparing in place, without any free pages left to vacuum
+    REQUIRE(GetDatabaseContents(exportedFile) == GetDatabaseContents(preparedFile));
+    REQUIRE(GetFreePageCount(exportedFile) == 0);
+
+    SQLiteIndex exported = SQLiteIndex::Open(exportedFile, SQLiteIndex::OpenDisposition::Read);
+    REQUIRE(exported.GetVersion() == index.GetVersion());
+    REQUIRE(exported.CheckConsistency(true));
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, CreatePackagingTestManifest(4).Id);
+    auto results = exported.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    auto manifestId = exported.GetManifestIdByKey(results.Matches[0].first, {}, {});
+    REQUIRE(manifestId);
+    REQUIRE(exported.GetPropertyByManifestId(manifestId.value(), PackageVersionProperty::RelativePath) == GetPackagingTestManifestPath(4));
+}
+
+// Tracks the largest amount of disk space used on the volume of the temporary directory while it is alive.
+struct PeakDiskUsageMonitor
+{
+    PeakDiskUsageMonitor() : m_baseline(GetAvailable()), m_lowest(m_baseline)
+    {
+        m_thread = std::thread([this]()
+            {
+                while (!m_done)
+                {
+                    m_lowest = std::min(m_lowest.load(), GetAvailable());
+                    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                }
+            });
+    }
+
+    ~PeakDiskUsageMonitor()
+    {
+        Stop();
+    }
+
+    // Stops monitoring and returns the peak usage, in bytes, above the usage when monitoring started.
+    uintmax_t Stop()
+    {
+        if (m_thread.joinable())
+        {
+            m_done = true;
+            m_thread.join();
+            m_lowest = std::min(m_lowest.load(), GetAvailable());
+        }
+
+        return m_baseline - m_lowest;
+    }
+
+private:
+    static uintmax_t GetAvailable()
+    {
+        return std::filesystem::space(std::filesystem::temp_directory_path()).available;
+    }
+
+    uintmax_t m_baseline;
+    std::atomic<uintmax_t> m_lowest;
+    std::atomic_bool m_done = false;
+    std::thread m_thread;
+};
+
+TEST_CASE("SQLiteIndex_ExportForPackaging_Benchmark", "[.]")
+{
+    constexpr size_t manifestCount = 20000;
+
+    TempFile workingFile{ "repolibtest_tempdb"s, ".db"s };
+    TempFile preparedFile{ "repolibtest_tempdb_prepared"s, ".db"s };
+    TempFile exportedFile{ "repolibtest_tempdb_exported"s, ".db"s };
+
+    {
+        SQLiteIndex index = SQLiteIndex::CreateNew(workingFile, Schema::Version::Latest());
+        for (size_t i = 0; i < manifestCount; ++i)
+        {
+            index.AddManifest(CreatePackagingTestManifest(i), GetPackagingTestManifestPath(i));
+        }
+    }
+
+    std::filesystem::copy_file(workingFile, preparedFile);
+
+    std::chrono::milliseconds preparedTime{};
+    uintmax_t preparedPeak = 0;
+    {
+        PeakDiskUsageMonitor monitor;
+        auto start = std::chrono::steady_clock::now();
+        {
+            SQLiteIndex prepared = SQLiteIndex::Open(preparedFile, SQLiteIndex::OpenDisposition::ReadWrite);
+            prepared.PrepareForPackaging();
+        }
+        preparedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        preparedPeak = monitor.Stop();
+    }
+
+    std::chrono::milliseconds exportedTime{};
+    uintmax_t exportedPeak = 0;
+    {
+        SQLiteIndex working = SQLiteIndex::Open(workingFile, SQLiteIndex::OpenDisposition::Read);
+        PeakDiskUsageMonitor monitor;
+        auto start = std::chrono::steady_clock::now();
+        working.ExportForPackaging(exportedFile);
+        exportedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+        exportedPeak = monitor.Stop();
+    }
+
+    REQUIRE(GetDatabaseContents(exportedFile) == GetDatabaseContents(preparedFile));
+
+    // The in place preparation starts from a copy of the working index, so its final size is already in use before it starts.
+    WARN("Working index: " << manifestCount << " manifests, " << std::filesystem::file_size(workingFile) << " bytes\n" <<
+        "PrepareForPackaging: " << preparedTime.count() << " ms, peak additional disk usage " << preparedPeak << " bytes, result " << std::filesystem::file_size(preparedFile) << " bytes\n" <<
+        "ExportForPackaging: " << exportedTime.count() << " ms, peak additional disk usage " << exportedPeak << " bytes, result " << std::filesystem::file_size(exportedFile) << " bytes");
+}
+
 TEST_CASE("SQLiteIndex_Search_IdExactMatch", "[sqliteindex]")
 {
     TempFile tempFile{ "repolibtest_tempdb"s, ".db"s };
@@ -0,0 +1,298 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <Microsoft/SQLiteIndexWarmup.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(size_t i)
+    {
+        Manifest::Manifest result;
+
+        result.Id = "Warmup.Package" + std::to_string(i);
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Name " + result.Id);
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>("Publisher " + std::to_string(i % 100));
+        result.Moniker = "moniker" + std::to_string(i);
+        result.DefaultLocalization.Add<Manifest::Localization::Tags>({ "tag" + std::to_string(i % 50) });
+        result.Version = "1.0";
+        result.Installers.push_back({});
+
+        return result;
+    }
+
+    // Creates an index with enough packages that its tables and indexes have interior pages.
+    void CreateIndex(const TempFile& file, size_t packageCount)
+    {
+        SQLiteIndex index = SQLiteIndex::CreateNew(file, Schema::Version::Latest());
+
+        for (size_t i = 0; i < packageCount; ++i)
+        {
+            Manifest::Manifest manifest = MakeManifest(i);
+            index.AddManifest(manifest, "manifests/" + manifest.Id + ".yaml");
+        }
+    }
+
+    SearchResult FindId(const SQLiteIndex& index, size_t i)
+    {
+        SearchRequest request;
+        request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, MakeManifest(i).Id);
+        return index.Search(request);
+    }
+}
+
+TEST_CASE("SQLiteIndexWarmup_WarmUpIndex", "[SQLiteIndexWarmup]")
+{
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 2000);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndex index = location.Open();
+    const SQLite::Connection& connection = index.GetConnection();
+    size_t pageCount = static_cast<size_t>(connection.GetPageCount());
+    size_t rootCount = connection.GetRootPages().size() + 1;
+
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+    ProgressCallback progress;
+    size_t pagesRead = warmup.WarmUpIndex(location, progress);
+
+    // The interior pages are read, but not the leaves
+    REQUIRE(pagesRead > rootCount);
+    REQUIRE(pagesRead < pageCount);
+}
+
+TEST_CASE("SQLiteIndexWarmup_WarmUpIndex_Cancelled", "[SQLiteIndexWarmup]")
+{
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 2000);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+    ProgressCallback progress;
+    progress.Cancel();
+
+    REQUIRE(warmup.WarmUpIndex(location, progress) == 0);
+}
+
+TEST_CASE("SQLiteIndexWarmup_RecordPageReads", "[SQLiteIndexWarmup]")
+{
+    RemoveSetting(Stream::IndexWarmup);
+    TestUserSettings settings;
+    settings.Set<Setting::SourceWarmUpIndexes>(true);
+
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 500);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+    size_t pageCount = 0;
+
+    {
+        SQLiteIndex index = warmup.OpenIndex(location);
+        pageCount = static_cast<size_t>(index.GetConnection().GetPageCount());
+
+        REQUIRE(FindId(index, 250).Matches.size() == 1);
+        REQUIRE(!index.GetConnection().GetPagesRead().empty());
+        REQUIRE(warmup.GetRecordedPages(location).empty());
+    }
+
+    // The pages are saved when the index is closed
+    std::vector<uint32_t> pages = warmup.GetRecordedPages(location);
+    REQUIRE(!pages.empty());
+    for (uint32_t page : pages)
+    {
+        REQUIRE(page >= 1);
+        REQUIRE(page <= pageCount);
+    }
+
+    // Another location has nothing recorded
+    TempFile otherFile{ "warmup"s, ".db"s };
+    REQUIRE(warmup.GetRecordedPages(IndexDataLocation{ otherFile.GetPath() }).empty());
+
+    RemoveSetting(Stream::IndexWarmup);
+}
+
+TEST_CASE("SQLiteIndexWarmup_RecordPageReads_Disabled", "[SQLiteIndexWarmup]")
+{
+    RemoveSetting(Stream::IndexWarmup);
+    TestUserSettings settings;
+
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 100);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+
+    {
+        SQLiteIndex index = warmup.OpenIndex(location);
+        REQUIRE(FindId(index, 50).Matches.size() == 1);
+        REQUIRE(index.GetConnection().GetPagesRead().empty());
+    }
+
+    REQUIRE(warmup.GetRecordedPages(location).empty());
+}
+
+TEST_CASE("SQLiteIndexWarmup_RecordPageReads_Read", "[SQLiteIndexWarmup]")
+{
+    RemoveSetting(Stream::IndexWarmup);
+    TestUserSettings settings;
+    settings.Set<Setting::SourceWarmUpIndexes>(true);
+
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 100);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+
+    {
+        SQLiteIndex index = warmup.OpenIndex(location, SQLiteIndex::OpenDisposition::Read);
+        REQUIRE(FindId(index, 50).Matches.size() == 1);
+
+        // The header is the first read
+        std::vector<uint32_t> pages = index.GetConnection().GetPagesRead();
+        REQUIRE(!pages.empty());
+        REQUIRE(pages.front() == 1);
+    }
+
+    REQUIRE(!warmup.GetRecordedPages(location).empty());
+
+    RemoveSetting(Stream::IndexWarmup);
+}
+
+TEST_CASE("SQLiteIndexWarmup_InvalidStream", "[SQLiteIndexWarmup]")
+{
+    SetSetting(Stream::IndexWarmup, "Indexes: [ BAD");
+    TestUserSettings settings;
+    settings.Set<Setting::SourceWarmUpIndexes>(true);
+
+    TempFile tempFile{ "warmup"s, ".db"s };
+    INFO("Using temporary file named: " << tempFile.GetPath());
+    CreateIndex(tempFile, 100);
+
+    IndexDataLocation location{ tempFile.GetPath() };
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+    REQUIRE(warmup.GetRecordedPages(location).empty());
+
+    ProgressCallback progress;
+    REQUIRE(warmup.WarmUpIndex(location, progress) > 0);
+
+    // Recording replaces the invalid contents
+    {
+        SQLiteIndex index = warmup.OpenIndex(location);
+        REQUIRE(FindId(index, 50).Matches.size() == 1);
+    }
+
+    REQUIRE(!warmup.GetRecordedPages(location).empty());
+
+    RemoveSetting(Stream::IndexWarmup);
+}
+
+TEST_CASE("SQLiteIndexWarmup_WarmUpOncePerSource", "[SQLiteIndexWarmup]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::SourceWarmUpIndexes>(true);
+
+    std::atomic<int> calls = 0;
+    auto warmUp = [&](IProgressCallback&) { ++calls; };
+
+    {
+        SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+        warmup.WarmUp("Source1", warmUp);
+        warmup.WarmUp("Source1", warmUp);
+        warmup.WarmUp("Source2", warmUp);
+
+        // Errors are only logged
+        warmup.WarmUp("Source3", [](IProgressCallback&) { THROW_HR(E_UNEXPECTED); });
+    }
+
+    // The warm ups are waited for when the instance is destroyed
+    REQUIRE(calls == 2);
+}
+
+TEST_CASE("SQLiteIndexWarmup_WarmUp_Disabled", "[SQLiteIndexWarmup]")
+{
+    TestUserSettings settings;
+
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+    bool called = false;
+
+    warmup.WarmUp("Source1", [&](IProgressCallback&) { called = true; });
+
+    REQUIRE(!called);
+}
+
+// Not a test; measures the first searches of an index that is not in the file cache, with and without the warm up.
+TEST_CASE("SQLiteIndexWarmup_Benchmark", "[SQLiteIndexWarmup][.]")
+{
+    TempFile sourceFile{ "warmup"s, ".db"s };
+    CreateIndex(sourceFile, 20000);
+
+    // Copying the file without buffering leaves none of the copy in the file cache.
+    auto makeColdCopy = [&](const TempFile& target)
+    {
+        std::ifstream in{ sourceFile.GetPath(), std::ios::binary };
+        std::vector<char> contents{ std::istreambuf_iterator<char>{ in }, std::istreambuf_iterator<char>{} };
+
+        constexpr size_t alignment = 4096;
+        size_t alignedSize = (contents.size() + alignment - 1) / alignment * alignment;
+        char* buffer = static_cast<char*>(_aligned_malloc(alignedSize, alignment));
+        auto freeBuffer = wil::scope_exit([&]() { _aligned_free(buffer); });
+        std::memset(buffer, 0, alignedSize);
+        std::memcpy(buffer, contents.data(), contents.size());
+
+        {
+            wil::unique_hfile file{ CreateFileW(target.GetPath().c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH, nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+            DWORD written = 0;
+            THROW_IF_WIN32_BOOL_FALSE(WriteFile(file.get(), buffer, static_cast<DWORD>(alignedSize), &written, nullptr));
+        }
+
+        // Restore the actual size; the pages beyond it are not read.
+        std::filesystem::resize_file(target.GetPath(), contents.size());
+    };
+
+    auto searchIndex = [](const IndexDataLocation& location)
+    {
+        auto start = std::chrono::steady_clock::now();
+        SQLiteIndex index = location.Open();
+        for (size_t i = 0; i < 20000; i += 997)
+        {
+            FindId(index, i);
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    SQLiteIndexWarmup warmup{ Stream::IndexWarmup };
+
+    TempFile coldFile{ "warmup"s, ".db"s };
+    makeColdCopy(coldFile);
+    auto coldTime = searchIndex(IndexDataLocation{ coldFile.GetPath() });
+
+    TempFile warmFile{ "warmup"s, ".db"s };
+    makeColdCopy(warmFile);
+    IndexDataLocation warmLocation{ warmFile.GetPath() };
+    ProgressCallback progress;
+    auto warmUp = std::async(std::launch::async, [&]() { return warmup.WarmUpIndex(warmLocation, progress); });
+
+    // The rest of the command startup that the warm up overlaps with.
+    std::this_thread::sleep_for(50ms);
+    size_t pagesRead = warmUp.get();
+    auto warmTime = searchIndex(warmLocation);
+
+    WARN("Cold searches: " << coldTime << " us\nSearches after warm up of " << pagesRead << " pages: " << warmTime << " us");
+}
@@ -5,6 +5,10 @@
 #include <SQLiteWrapper.h>
 #include <SQLiteStatementBuilder.h>
 
+#ifdef _DEBUG
+#include <crtdbg.h>
+#endif
+
 using namespace AppInstaller::Repository::SQLite;
 using namespace std::string_literals;
 
@@ -286,6 +290,151 @@ TEST_CASE("SQLiteWrapper_EscapeStringForLike", "[sqlitewrapper]")
     REQUIRE(expected == output);
 }
 
+TEST_CASE("SQLiteWrapper_StringViewColumn", "[sqlitewrapper]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+
+    CreateSimpleTestTable(connection);
+
+    // Embedded nulls are only kept if the length of the value is used.
+    std::string secondVal = "test\0value"s;
+    InsertIntoSimpleTestTable(connection, 1, secondVal);
+    InsertIntoSimpleTestTableWithNull(connection, 2);
+
+    Statement select = Statement::Create(connection, s_selectFromSimpleTestTableSQL);
+
+    REQUIRE(select.Step());
+    REQUIRE(select.GetColumn<std::string_view>(1) == secondVal);
+    REQUIRE(select.GetColumn<std::string>(1) == secondVal);
+    REQUIRE(std::get<1>(select.GetRow<int, std::string_view>()) == secondVal);
+
+    REQUIRE(select.Step());
+    REQUIRE(select.GetColumnIsNull(1));
+    REQUIRE(select.GetColumn<std::string_view>(1).empty());
+    REQUIRE(select.GetColumn<std::string>(1).empty());
+
+    REQUIRE_FALSE(select.Step());
+    REQUIRE_THROWS_HR(select.GetColumn<std::string_view>(1), E_BOUNDS);
+}
+
+TEST_CASE("SQLiteWrapper_BindStatic", "[sqlitewrapper]")
+{
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+
+    CreateSimpleTestTable(connection);
+
+    std::string stringVal = "string";
+    std::string_view viewVal = "view";
+    std::string_view emptyVal;
+
+    Statement insert = Statement::Create(connection, s_insertToSimpleTestTableSQL);
+
+    insert.Bind(1, 1);
+    insert.BindStatic(2, stringVal);
+    insert.Execute();
+
+    insert.Reset();
+    insert.Bind(1, 2);
+    insert.BindStatic(2, viewVal);
+    insert.Execute();
+
+    insert.Reset();
+    insert.Bind(1, 3);
+    insert.BindStatic(2, emptyVal);
+    insert.Execute();
+
+    Statement select = Statement::Create(connection, s_selectFromSimpleTestTableSQL);
+
+    REQUIRE(select.Step());
+    REQUIRE(select.GetColumn<std::string>(1) == stringVal);
+    REQUIRE(select.Step());
+    REQUIRE(select.GetColumn<std::string>(1) == viewVal);
+    REQUIRE(select.Step());
+    REQUIRE_FALSE(select.GetColumnIsNull(1));
+    REQUIRE(select.GetColumn<std::string>(1).empty());
+    REQUIRE_FALSE(select.Step());
+}
+
+TEST_CASE("SQLiteWrapper_ColumnAndBindBenchmark", "[.]")
+{
+    constexpr int rowCount = 10000;
+    constexpr int iterations = 10;
+    std::string value(64, 'v');
+
+    Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
+    CreateSimpleTestTable(connection);
+
+    auto measure = [&](auto&& operation)
+    {
+#ifdef _DEBUG
+        _CrtMemState before;
+        _CrtMemCheckpoint(&before);
+#endif
+        auto start = std::chrono::steady_clock::now();
+        operation();
+        auto time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        std::ostringstream result;
+        result << time.count() << "ms";
+#ifdef _DEBUG
+        _CrtMemState after;
+        _CrtMemCheckpoint(&after);
+        result << ", " << (after.lTotalCount - before.lTotalCount) << " allocations";
+#endif
+        return result.str();
+    };
+
+    auto insertRows = [&](bool bindStatic)
+    {
+        Savepoint savepoint = Savepoint::Create(connection, s_savepoint);
+        Statement insert = Statement::Create(connection, s_insertToSimpleTestTableSQL);
+
+        for (int i = 0; i < rowCount; ++i)
+        {
+            insert.Reset();
+            insert.Bind(1, i);
+            if (bindStatic)
+            {
+                insert.BindStatic(2, value);
+            }
+            else
+            {
+                insert.Bind(2, value);
+            }
+            insert.Execute();
+        }
+
+        savepoint.Commit();
+    };
+
+    std::string transientBind = measure([&]() { insertRows(false); });
+    std::string staticBind = measure([&]() { insertRows(true); });
+
+    auto readRows = [&](auto type)
+    {
+        using Value = decltype(type);
+        size_t totalSize = 0;
+        Statement select = Statement::Create(connection, s_selectFromSimpleTestTableSQL);
+
+        for (int i = 0; i < iterations; ++i)
+        {
+            select.Reset();
+            while (select.Step())
+            {
+                totalSize += select.GetColumn<Value>(1).size();
+            }
+        }
+
+        REQUIRE(totalSize == value.size() * rowCount * 2 * iterations);
+    };
+
+    std::string stringColumn = measure([&]() { readRows(std::string{}); });
+    std::string viewColumn = measure([&]() { readRows(std::string_view{}); });
+
+    WARN("Bind " << rowCount << " rows: transient " << transientBind << ", static " << staticBind << "\n" <<
+        "Read " << rowCount * 2 * iterations << " values: std::string " << stringColumn << ", std::string_view " << viewColumn);
+}
+
 TEST_CASE("SQLBuilder_SimpleSelectBind", "[sqlbuilder]")
 {
     Connection connection = Connection::Create(SQLITE_MEMORY_DB_CONNECTION_TARGET, Connection::OpenDisposition::Create);
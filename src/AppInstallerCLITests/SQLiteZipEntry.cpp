@@ -0,0 +1,243 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <SQLiteZipEntry.h>
+#include <Microsoft/SQLiteIndex.h>
+#include <winget/Manifest.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Manifest;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Repository::SQLite;
+
+namespace
+{
+    constexpr std::string_view s_IndexEntryName = "Public/index.db"sv;
+    constexpr std::string_view s_OtherEntryName = "AppxManifest.xml"sv;
+    constexpr std::string_view s_OtherEntryContents = "<Package/>"sv;
+
+    constexpr uint16_t s_MethodStored = 0;
+    constexpr uint16_t s_MethodDeflated = 8;
+
+    uint32_t ComputeCRC32(const std::vector<uint8_t>& data)
+    {
+        uint32_t crc = 0xFFFFFFFF;
+        for (uint8_t byte : data)
+        {
+            crc ^= byte;
+            for (int bit = 0; bit < 8; ++bit)
+            {
+                crc = (crc & 1) ? (0xEDB88320 ^ (crc >> 1)) : (crc >> 1);
+            }
+        }
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    void Write16(std::vector<uint8_t>& out, uint16_t value)
+    {
+        out.push_back(static_cast<uint8_t>(value));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+    }
+
+    void Write32(std::vector<uint8_t>& out, uint32_t value)
+    {
+        Write16(out, static_cast<uint16_t>(value));
+        Write16(out, static_cast<uint16_t>(value >> 16));
+    }
+
+    void WriteBytes(std::vector<uint8_t>& out, const void* data, size_t size)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        out.insert(out.end(), bytes, bytes + size);
+    }
+
+    struct TestZipEntry
+    {
+        std::string Name;
+        std::vector<uint8_t> Data;
+        uint16_t Method = s_MethodStored;
+    };
+
+    // Writes a minimal ZIP file; the entry data is written as is, regardless of the method claimed.
+    // The central directory size can be skewed to create an invalid file.
+    void WriteTestZip(const std::filesystem::path& path, const std::vector<TestZipEntry>& entries, int64_t centralDirectorySizeSkew = 0)
+    {
+        std::vector<uint8_t> file;
+        std::vector<uint8_t> centralDirectory;
+
+        for (const auto& entry : entries)
+        {
+            uint32_t localHeaderOffset = static_cast<uint32_t>(file.size());
+            uint32_t crc = ComputeCRC32(entry.Data);
+            uint32_t size = static_cast<uint32_t>(entry.Data.size());
+            uint16_t nameLength = static_cast<uint16_t>(entry.Name.size());
+
+            Write32(file, 0x04034b50);
+            Write16(file, 20);
+            Write16(file, 0);
+            Write16(file, entry.Method);
+            Write32(file, 0);
+            Write32(file, crc);
+            Write32(file, size);
+            Write32(file, size);
+            Write16(file, nameLength);
+            Write16(file, 0);
+            WriteBytes(file, entry.Name.data(), entry.Name.size());
+            WriteBytes(file, entry.Data.data(), entry.Data.size());
+
+            Write32(centralDirectory, 0x02014b50);
+            Write16(centralDirectory, 20);
+            Write16(centralDirectory, 20);
+            Write16(centralDirectory, 0);
+            Write16(centralDirectory, entry.Method);
+            Write32(centralDirectory, 0);
+            Write32(centralDirectory, crc);
+            Write32(centralDirectory, size);
+            Write32(centralDirectory, size);
+            Write16(centralDirectory, nameLength);
+            Write16(centralDirectory, 0);
+            Write16(centralDirectory, 0);
+            Write16(centralDirectory, 0);
+            Write16(centralDirectory, 0);
+            Write32(centralDirectory, 0);
+            Write32(centralDirectory, localHeaderOffset);
+            WriteBytes(centralDirectory, entry.Name.data(), entry.Name.size());
+        }
+
+        uint32_t centralDirectoryOffset = static_cast<uint32_t>(file.size());
+        file.insert(file.end(), centralDirectory.begin(), centralDirectory.end());
+
+        Write32(file, 0x06054b50);
+        Write16(file, 0);
+        Write16(file, 0);
+        Write16(file, static_cast<uint16_t>(entries.size()));
+        Write16(file, static_cast<uint16_t>(entries.size()));
+        Write32(file, static_cast<uint32_t>(centralDirectory.size() + centralDirectorySizeSkew));
+        Write32(file, static_cast<uint32_t>(centralDirectoryOffset - centralDirectorySizeSkew));
+        Write16(file, 0);
+
+        std::ofstream stream{ path, std::ios_base::out | std::ios_base::binary | std::ios_base::trunc };
+        stream.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    }
+
+    std::vector<uint8_t> ReadFileBytes(const std::filesystem::path& path)
+    {
+        std::ifstream stream{ path, std::ios_base::in | std::ios_base::binary };
+        return { std::istreambuf_iterator<char>{ stream }, std::istreambuf_iterator<char>{} };
+    }
+
+    std::vector<uint8_t> CreateTestIndexBytes(const std::string& id)
+    {
+        TempFile indexFile{ "repolibtest_tempdb"s, ".db"s };
+
+        {
+            SQLiteIndex index = SQLiteIndex::CreateNew(indexFile, Schema::Version::Latest());
+
+            Manifest manifest;
+            manifest.Installers.push_back({});
+            manifest.Id = id;
+            manifest.DefaultLocalization.Add<Localization::PackageName>("Test Name");
+            manifest.Moniker = "testmoniker";
+            manifest.Version = "1.0.0";
+
+            index.AddManifest(manifest, "test/id/1.0.0.yaml");
+        }
+
+        return ReadFileBytes(indexFile);
+    }
+
+    std::vector<TestZipEntry> CreateTestEntries(const std::vector<uint8_t>& indexBytes, uint16_t indexMethod = s_MethodStored)
+    {
+        std::vector<TestZipEntry> result;
+        result.push_back({ std::string{ s_OtherEntryName }, { s_OtherEntryContents.begin(), s_OtherEntryContents.end() }, s_MethodDeflated });
+        result.push_back({ std::string{ s_IndexEntryName }, indexBytes, indexMethod });
+        return result;
+    }
+}
+
+TEST_CASE("SQLiteZipEntry_OpenStoredIndex", "[sqlitezipentry]")
+{
+    std::string id = "Test.Id";
+    std::vector<uint8_t> indexBytes = CreateTestIndexBytes(id);
+
+    TempFile zipFile{ "repolibtest_package"s, ".msix"s };
+    WriteTestZip(zipFile, CreateTestEntries(indexBytes));
+
+    auto entry = FindStoredZipEntry(zipFile, s_IndexEntryName);
+    REQUIRE(entry);
+    REQUIRE(entry->Size == indexBytes.size());
+
+    SQLiteIndex index = SQLiteIndex::Open(entry.value());
+    REQUIRE(index.GetVersion() == Schema::Version::Latest());
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, id);
+
+    auto results = index.Search(request);
+    REQUIRE(results.Matches.size() == 1);
+    REQUIRE(results.Matches[0].second.Value == id);
+}
+
+TEST_CASE("SQLiteZipEntry_OpenStoredIndex_RecordPageReads", "[sqlitezipentry]")
+{
+    std::string id = "Test.Id";
+    std::vector<uint8_t> indexBytes = CreateTestIndexBytes(id);
+
+    TempFile zipFile{ "repolibtest_package"s, ".msix"s };
+    WriteTestZip(zipFile, CreateTestEntries(indexBytes));
+
+    auto entry = FindStoredZipEntry(zipFile, s_IndexEntryName);
+    REQUIRE(entry);
+
+    // The pages are those of the entry, not of the ZIP file around it
+    SQLiteIndex index = SQLiteIndex::Open(entry.value(), SQLiteIndex::OpenOptions::RecordPageReads);
+    size_t pageCount = static_cast<size_t>(index.GetConnection().GetPageCount());
+
+    SearchRequest request;
+    request.Query = RequestMatch(MatchType::Exact, id);
+    REQUIRE(index.Search(request).Matches.size() == 1);
+
+    std::vector<uint32_t> pages = index.GetConnection().GetPagesRead();
+    REQUIRE(!pages.empty());
+    REQUIRE(pages.front() == 1);
+    for (uint32_t page : pages)
+    {
+        REQUIRE(page <= pageCount);
+    }
+}
+
+TEST_CASE("SQLiteZipEntry_MissingEntry", "[sqlitezipentry]")
+{
+    TempFile zipFile{ "repolibtest_package"s, ".msix"s };
+    WriteTestZip(zipFile, { { std::string{ s_OtherEntryName }, { s_OtherEntryContents.begin(), s_OtherEntryContents.end() }, s_MethodStored } });
+
+    REQUIRE(!FindStoredZipEntry(zipFile, s_IndexEntryName));
+}
+
+TEST_CASE("SQLiteZipEntry_CompressedEntry", "[sqlitezipentry]")
+{
+    TempFile zipFile{ "repolibtest_package"s, ".msix"s };
+    WriteTestZip(zipFile, CreateTestEntries(CreateTestIndexBytes("Test.Id"), s_MethodDeflated));
+
+    REQUIRE(!FindStoredZipEntry(zipFile, s_IndexEntryName));
+}
+
+TEST_CASE("SQLiteZipEntry_InvalidCentralDirectory", "[sqlitezipentry]")
+{
+    TempFile zipFile{ "repolibtest_package"s, ".msix"s };
+    WriteTestZip(zipFile, CreateTestEntries(CreateTestIndexBytes("Test.Id")), 64);
+
+    REQUIRE_THROWS_HR(FindStoredZipEntry(zipFile, s_IndexEntryName), HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT));
+}
+
+TEST_CASE("SQLiteZipEntry_NotAZip", "[sqlitezipentry]")
+{
+    TempFile notZipFile{ "repolibtest_package"s, ".msix"s };
+    std::ofstream{ notZipFile.GetPath(), std::ios_base::out | std::ios_base::binary } << "This is not a ZIP file, but it is longer than an end of central directory record.";
+
+    REQUIRE_THROWS_HR(FindStoredZipEntry(notZipFile, s_IndexEntryName), HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT));
+}
@@ -0,0 +1,336 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSource.h"
+#include "TestHooks.h"
+#include <Microsoft/SQLiteIndexSource.h>
+#include <PackageTrackingCatalogSourceFactory.h>
+#include <winget/RepositorySource.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(std::string_view id)
+    {
+        Manifest::Manifest result;
+
+        result.Id = id;
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Name " + result.Id);
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>("Publisher");
+        result.Version = "1.0";
+        result.Installers.push_back({});
+
+        return result;
+    }
+
+    std::string MakeId(size_t i)
+    {
+        return "Batch.Package" + std::to_string(i);
+    }
+
+    SearchRequest MakeLookup(std::string_view id, MatchType type = MatchType::Exact)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::Id, type, id);
+        return result;
+    }
+
+    // A test source that looks up the Id inclusions in a fixed set of packages, counting the searches.
+    struct LookupTestSource : public TestSource
+    {
+        LookupTestSource(std::initializer_list<std::string_view> ids)
+        {
+            for (std::string_view id : ids)
+            {
+                Manifests.emplace_back(MakeManifest(id));
+            }
+        }
+
+        SearchResult Search(const SearchRequest& request) const override
+        {
+            ++SearchCount;
+
+            if (Failure)
+            {
+                THROW_HR(Failure);
+            }
+
+            SearchResult result;
+
+            for (const auto& manifest : Manifests)
+            {
+                if (MaximumMatches && result.Matches.size() >= MaximumMatches)
+                {
+                    result.Truncated = true;
+                    break;
+                }
+
+                for (const auto& inclusion : request.Inclusions)
+                {
+                    if (inclusion.Field == PackageMatchField::Id &&
+                        (inclusion.Type == MatchType::Exact ? inclusion.Value == manifest.Id : Utility::CaseInsensitiveEquals(inclusion.Value, manifest.Id)))
+                    {
+                        result.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }, shared_from_this()), inclusion);
+                        break;
+                    }
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<Manifest::Manifest> Manifests;
+        HRESULT Failure = S_OK;
+        size_t MaximumMatches = 0;
+        mutable size_t SearchCount = 0;
+    };
+
+    // Installed and available in memory indexes of the same packages, combined like the sources used through the COM interface.
+    struct BatchTestSetup
+    {
+        BatchTestSetup(size_t packageCount) : TrackingFactory([&](const SourceDetails&) { return Tracking; })
+        {
+            Tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+            TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, TrackingFactory);
+
+            SourceDetails installedDetails;
+            installedDetails.Identifier = "*BatchInstalled";
+            auto installed = std::make_shared<SQLiteIndexSource>(installedDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET), Synchronization::CrossProcessReaderWriteLock{}, true);
+
+            SourceDetails availableDetails;
+            availableDetails.Name = "BatchAvailable";
+            availableDetails.Identifier = "*BatchAvailable";
+            auto available = std::make_shared<SQLiteIndexSource>(availableDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                Manifest::Manifest manifest = MakeManifest(MakeId(i));
+                available->GetIndex().AddManifest(manifest);
+
+                // Only some of the packages are installed, as on a managed device.
+                if (i % 4 == 0)
+                {
+                    installed->GetIndex().AddManifest(manifest);
+                }
+            }
+
+            Composite = Source{ Source{ installed }, Source{ available }, CompositeSearchBehavior::AllPackages };
+        }
+
+        ~BatchTestSetup()
+        {
+            TestHook_ClearSourceFactoryOverrides();
+        }
+
+        TestSourceFactory TrackingFactory;
+        std::shared_ptr<SQLiteIndexSource> Tracking;
+        Source Composite;
+    };
+
+    std::vector<std::string> GetIds(const SearchResult& result)
+    {
+        std::vector<std::string> ids;
+        for (const auto& match : result.Matches)
+        {
+            ids.emplace_back(match.Package->GetProperty(PackageProperty::Id).get());
+        }
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+}
+
+TEST_CASE("SearchBatch_IdentifierLookupsCombined", "[SearchBatch]")
+{
+    auto testSource = std::make_shared<LookupTestSource>(std::initializer_list<std::string_view>{ "Id.One", "Id.Two", "Id.Three" });
+    Source source{ testSource };
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("Id.Three"));
+    requests.emplace_back(MakeLookup("Id.Missing"));
+    requests.emplace_back(MakeLookup("id.one", MatchType::CaseInsensitive));
+    requests.emplace_back(MakeLookup("id.two"));
+    requests.emplace_back(MakeLookup("Id.Three"));
+
+    auto results = source.SearchBatch(requests);
+
+    REQUIRE(testSource->SearchCount == 1);
+    REQUIRE(results.size() == requests.size());
+
+    REQUIRE(results[0].Matches.size() == 1);
+    REQUIRE(results[0].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.Three");
+    REQUIRE(results[1].Matches.empty());
+    REQUIRE(results[2].Matches.size() == 1);
+    REQUIRE(results[2].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.One");
+    REQUIRE(results[3].Matches.empty());
+    REQUIRE(results[4].Matches.size() == 1);
+    REQUIRE(results[4].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.Three");
+
+    for (const auto& result : results)
+    {
+        REQUIRE(!result.Truncated);
+        REQUIRE(result.Failures.empty());
+    }
+}
+
+TEST_CASE("SearchBatch_OtherRequestsSearchedIndividually", "[SearchBatch]")
+{
+    auto testSource = std::make_shared<LookupTestSource>(std::initializer_list<std::string_view>{ "Id.One", "Id.Two" });
+    Source source{ testSource };
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("Id.One"));
+
+    SearchRequest query;
+    query.Query = RequestMatch(MatchType::Substring, "Id"sv);
+    requests.emplace_back(std::move(query));
+
+    SearchRequest name;
+    name.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Exact, "Name Id.Two"sv);
+    requests.emplace_back(std::move(name));
+
+    requests.emplace_back(MakeLookup("Id", MatchType::Substring));
+
+    auto results = source.SearchBatch(requests);
+
+    // The single identifier lookup is searched as is, along with each of the others.
+    REQUIRE(testSource->SearchCount == 4);
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0].Matches.size() == 1);
+}
+
+TEST_CASE("SearchBatch_MaximumResults", "[SearchBatch]")
+{
+    auto testSource = std::make_shared<LookupTestSource>(std::initializer_list<std::string_view>{ "Id.One", "ID.ONE", "Id.Two" });
+    Source source{ testSource };
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("id.one", MatchType::CaseInsensitive));
+    requests.back().MaximumResults = 1;
+    requests.emplace_back(MakeLookup("Id.One", MatchType::CaseInsensitive));
+    requests.emplace_back(MakeLookup("Id.Two"));
+    requests.back().MaximumResults = 1;
+
+    auto results = source.SearchBatch(requests);
+
+    REQUIRE(testSource->SearchCount == 1);
+    REQUIRE(results[0].Matches.size() == 1);
+    REQUIRE(results[0].Truncated);
+    REQUIRE(results[1].Matches.size() == 2);
+    REQUIRE(!results[1].Truncated);
+    REQUIRE(results[2].Matches.size() == 1);
+    REQUIRE(!results[2].Truncated);
+}
+
+TEST_CASE("SearchBatch_CombinedSearchTruncated", "[SearchBatch]")
+{
+    auto testSource = std::make_shared<LookupTestSource>(std::initializer_list<std::string_view>{ "Id.One", "Id.Two", "Id.Three" });
+    testSource->MaximumMatches = 1;
+    Source source{ testSource };
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("Id.Three"));
+    requests.emplace_back(MakeLookup("Id.One"));
+    requests.emplace_back(MakeLookup("Id.Two"));
+
+    auto results = source.SearchBatch(requests);
+
+    // The combined search only returns the first package, so the other identifiers are searched again.
+    REQUIRE(testSource->SearchCount == 3);
+    REQUIRE(results.size() == 3);
+
+    REQUIRE(results[0].Matches.size() == 1);
+    REQUIRE(results[0].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.Three");
+    REQUIRE(!results[0].Truncated);
+    REQUIRE(results[1].Matches.size() == 1);
+    REQUIRE(results[1].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.One");
+    REQUIRE(results[1].Truncated);
+    REQUIRE(results[2].Matches.size() == 1);
+    REQUIRE(results[2].Matches[0].Package->GetProperty(PackageProperty::Id) == "Id.Two");
+    REQUIRE(!results[2].Truncated);
+}
+
+TEST_CASE("SearchBatch_Failure", "[SearchBatch]")
+{
+    auto testSource = std::make_shared<LookupTestSource>(std::initializer_list<std::string_view>{ "Id.One" });
+    testSource->Failure = E_ACCESSDENIED;
+    Source source{ testSource };
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("Id.One"));
+    requests.emplace_back(MakeLookup("Id.Two"));
+
+    SearchRequest query;
+    query.Query = RequestMatch(MatchType::Substring, "Id"sv);
+    requests.emplace_back(std::move(query));
+
+    std::vector<SearchResult> results;
+    REQUIRE_NOTHROW(results = source.SearchBatch(requests));
+    REQUIRE(results.size() == 3);
+
+    for (const auto& result : results)
+    {
+        REQUIRE(result.Matches.empty());
+        REQUIRE(result.Failures.size() == 1);
+        REQUIRE(result.Failures[0].SourceName == testSource->Details.Name);
+        REQUIRE_THROWS_HR(std::rethrow_exception(result.Failures[0].Exception), E_ACCESSDENIED);
+    }
+}
+
+TEST_CASE("SearchBatch_SameAsIndividualSearches", "[SearchBatch]")
+{
+    BatchTestSetup setup{ 40 };
+
+    std::vector<SearchRequest> requests;
+    for (size_t i = 0; i < 50; i += 2)
+    {
+        requests.emplace_back(MakeLookup(MakeId(i), (i % 3 == 0 ? MatchType::CaseInsensitive : MatchType::Exact)));
+    }
+
+    auto results = setup.Composite.SearchBatch(requests);
+    REQUIRE(results.size() == requests.size());
+
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        INFO(requests[i].ToString());
+        auto expected = setup.Composite.Search(requests[i]);
+
+        REQUIRE(results[i].Failures.empty());
+        REQUIRE(GetIds(results[i]) == GetIds(expected));
+    }
+}
+
+TEST_CASE("SearchBatch_Benchmark", "[.]")
+{
+    for (size_t count : { size_t{ 100 }, size_t{ 1000 } })
+    {
+        BatchTestSetup setup{ count };
+
+        std::vector<SearchRequest> requests;
+        for (size_t i = 0; i < count; ++i)
+        {
+            requests.emplace_back(MakeLookup(MakeId(i)));
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& request : requests)
+        {
+            setup.Composite.Search(request);
+        }
+        auto repeated = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        start = std::chrono::steady_clock::now();
+        setup.Composite.SearchBatch(requests);
+        auto batch = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        WARN(count << " identifiers\n" <<
+            "Repeated searches: " << repeated.count() << " ms\n" <<
+            "Batch search: " << batch.count() << " ms");
+    }
+}
@@ -0,0 +1,427 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSource.h"
+#include "TestHooks.h"
+#include <Microsoft/SQLiteIndexSource.h>
+#include <PackageTrackingCatalogSourceFactory.h>
+#include <SearchMemo.h>
+#include <winget/RepositorySource.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(size_t i)
+    {
+        Manifest::Manifest result;
+
+        result.Id = "Memo.Package" + std::to_string(i);
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Memo Package " + std::to_string(i));
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>("Publisher " + std::to_string(i % 5));
+        result.Version = "1." + std::to_string(i % 3);
+        result.Installers.push_back({});
+        // Some of the packages share a product code, so that their correlation searches are identical
+        result.Installers[0].ProductCode = "{Memo-" + std::to_string(i / 2) + "}";
+
+        return result;
+    }
+
+    SearchRequest MakeLookup(std::string_view id)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, id);
+        return result;
+    }
+
+    // A test source that returns a package for every search, counting the searches.
+    std::shared_ptr<TestSource> MakeCountingSource(size_t& searchCount)
+    {
+        auto result = std::make_shared<TestSource>();
+        result->SearchFunction = [&searchCount, source = result.get()](const SearchRequest&)
+        {
+            ++searchCount;
+            Manifest::Manifest manifest = MakeManifest(searchCount);
+
+            SearchResult searchResult;
+            searchResult.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }, source->shared_from_this()), PackageMatchFilter(PackageMatchField::Id, MatchType::Exact, manifest.Id));
+            return searchResult;
+        };
+        return result;
+    }
+
+    // Installed and available in memory indexes, combined so that searches correlate the installed packages.
+    struct MemoTestSetup
+    {
+        MemoTestSetup(size_t packageCount) : TrackingFactory([&](const SourceDetails&) { return Tracking; })
+        {
+            Tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+            TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, TrackingFactory);
+
+            SourceDetails installedDetails;
+            installedDetails.Identifier = "*MemoInstalled";
+            auto installed = std::make_shared<SQLiteIndexSource>(installedDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET), Synchronization::CrossProcessReaderWriteLock{}, true);
+
+            SourceDetails availableDetails;
+            availableDetails.Name = "MemoAvailable";
+            availableDetails.Identifier = "*MemoAvailable";
+            auto available = std::make_shared<SQLiteIndexSource>(availableDetails, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                Manifest::Manifest manifest = MakeManifest(i);
+                available->GetIndex().AddManifest(manifest);
+
+                if (i % 3 != 0)
+                {
+                    installed->GetIndex().AddManifest(manifest);
+                }
+            }
+
+            Available = Source{ available };
+            Composite = Source{ Source{ installed }, Available, CompositeSearchBehavior::Installed };
+        }
+
+        ~MemoTestSetup()
+        {
+            TestHook_ClearSourceFactoryOverrides();
+        }
+
+        TestSourceFactory TrackingFactory;
+        std::shared_ptr<SQLiteIndexSource> Tracking;
+        Source Available;
+        Source Composite;
+    };
+
+    // The requests made during an upgrade of all packages, with the repeated searches that occur within a command.
+    std::vector<SearchRequest> MakeWorkload(size_t packageCount)
+    {
+        std::vector<SearchRequest> result;
+
+        result.emplace_back();
+
+        for (size_t repeat = 0; repeat < 2; ++repeat)
+        {
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                Manifest::Manifest manifest = MakeManifest(i);
+                result.emplace_back(MakeLookup(manifest.Id));
+
+                SearchRequest productCode;
+                productCode.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, manifest.Installers[0].ProductCode);
+                result.emplace_back(std::move(productCode));
+            }
+        }
+
+        SearchRequest query;
+        query.Query = RequestMatch(MatchType::Substring, "Memo"sv);
+        query.Filters.emplace_back(PackageMatchField::Name, MatchType::Substring, "Package 1"sv);
+        result.emplace_back(query);
+
+        query.MaximumResults = 2;
+        result.emplace_back(std::move(query));
+
+        return result;
+    }
+
+    // Describes everything about the result that a caller can observe.
+    std::vector<std::string> Describe(const SearchResult& result)
+    {
+        std::vector<std::string> descriptions;
+
+        for (const auto& match : result.Matches)
+        {
+            std::ostringstream description;
+            description << match.Package->GetProperty(PackageProperty::Id) << " by " << ToString(match.MatchCriteria.Field) << '=' << match.MatchCriteria.Value;
+
+            if (auto installed = match.Package->GetInstalledVersion())
+            {
+                description << " installed " << installed->GetProperty(PackageVersionProperty::Version);
+            }
+
+            for (const auto& key : match.Package->GetAvailableVersionKeys())
+            {
+                description << " available " << key.SourceId << ':' << key.Version;
+            }
+
+            descriptions.emplace_back(description.str());
+        }
+
+        descriptions.emplace_back(result.Truncated ? "Truncated" : "Complete");
+        descriptions.emplace_back("Failures " + std::to_string(result.Failures.size()));
+        return descriptions;
+    }
+}
+
+TEST_CASE("SearchMemo_CanonicalRequest", "[SearchMemo]")
+{
+    SearchRequest request = MakeLookup("Id.One");
+    REQUIRE(SearchMemo::GetCanonicalRequest(request) == SearchMemo::GetCanonicalRequest(MakeLookup("Id.One")));
+
+    std::vector<SearchRequest> different;
+    different.emplace_back(MakeLookup("Id.Two"));
+    different.emplace_back(MakeLookup("id.one"));
+
+    different.emplace_back();
+    different.back().Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, "Id.One"sv);
+
+    different.emplace_back();
+    different.back().Inclusions.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, "Id.One"sv);
+
+    different.emplace_back();
+    different.back().Inclusions.emplace_back(PackageMatchField::Name, MatchType::Exact, "Id.One"sv);
+
+    different.emplace_back();
+    different.back().Query = RequestMatch(MatchType::Exact, "Id.One"sv);
+
+    different.emplace_back(MakeLookup("Id.One"));
+    different.back().MaximumResults = 1;
+
+    // Values that contain the separators of another form
+    different.emplace_back(MakeLookup("Id.One2,3:Id"));
+    different.emplace_back();
+    different.back().Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Id.One"sv, "Pub"sv);
+    different.emplace_back();
+    different.back().Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, "Id.One+3:Pub"sv, ""sv);
+
+    std::set<std::string> forms{ SearchMemo::GetCanonicalRequest(request) };
+    for (const auto& other : different)
+    {
+        INFO(other.ToString());
+        REQUIRE(forms.emplace(SearchMemo::GetCanonicalRequest(other)).second);
+    }
+}
+
+TEST_CASE("SearchMemo_DisabledByDefault", "[SearchMemo]")
+{
+    TestUserSettings settings;
+
+    size_t searchCount = 0;
+    Source source{ MakeCountingSource(searchCount) };
+
+    SearchMemoScope scope;
+    REQUIRE(SearchMemo::Current() == nullptr);
+
+    source.Search(MakeLookup("Id.One"));
+    source.Search(MakeLookup("Id.One"));
+    REQUIRE(searchCount == 2);
+}
+
+TEST_CASE("SearchMemo_IdenticalSearchesExecutedOnce", "[SearchMemo]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFSearchMemo>(true);
+
+    size_t searchCount = 0;
+    Source source{ MakeCountingSource(searchCount) };
+
+    SearchMemoScope scope;
+    REQUIRE(SearchMemo::Current() != nullptr);
+
+    auto first = source.Search(MakeLookup("Id.One"));
+    auto second = source.Search(MakeLookup("Id.One"));
+    REQUIRE(searchCount == 1);
+    REQUIRE(first.Matches.size() == 1);
+    REQUIRE(second.Matches.size() == 1);
+    REQUIRE(first.Matches[0].Package == second.Matches[0].Package);
+
+    source.Search(MakeLookup("Id.Two"));
+    REQUIRE(searchCount == 2);
+
+    REQUIRE(SearchMemo::Current()->GetHitCount() == 1);
+    REQUIRE(SearchMemo::Current()->GetMissCount() == 2);
+}
+
+TEST_CASE("SearchMemo_DiscardedAfterScope", "[SearchMemo]")
+{
+    size_t searchCount = 0;
+    Source source{ MakeCountingSource(searchCount) };
+
+    {
+        SearchMemoScope scope{ true };
+        source.Search(MakeLookup("Id.One"));
+        source.Search(MakeLookup("Id.One"));
+    }
+
+    REQUIRE(SearchMemo::Current() == nullptr);
+
+    {
+        SearchMemoScope scope{ true };
+        source.Search(MakeLookup("Id.One"));
+    }
+
+    REQUIRE(searchCount == 2);
+}
+
+TEST_CASE("SearchMemo_NestedScopesShareMemo", "[SearchMemo]")
+{
+    size_t searchCount = 0;
+    Source source{ MakeCountingSource(searchCount) };
+
+    SearchMemoScope outer{ true };
+    SearchMemo* memo = SearchMemo::Current();
+
+    {
+        SearchMemoScope inner{ true };
+        REQUIRE(SearchMemo::Current() == memo);
+        source.Search(MakeLookup("Id.One"));
+    }
+
+    REQUIRE(SearchMemo::Current() == memo);
+    source.Search(MakeLookup("Id.One"));
+    REQUIRE(searchCount == 1);
+}
+
+TEST_CASE("SearchMemo_SourcesKeptSeparate", "[SearchMemo]")
+{
+    size_t firstCount = 0;
+    Source first{ MakeCountingSource(firstCount) };
+    size_t secondCount = 0;
+    Source second{ MakeCountingSource(secondCount) };
+
+    SearchMemoScope scope{ true };
+
+    first.Search(MakeLookup("Id.One"));
+    second.Search(MakeLookup("Id.One"));
+    first.Search(MakeLookup("Id.One"));
+    second.Search(MakeLookup("Id.One"));
+
+    REQUIRE(firstCount == 1);
+    REQUIRE(secondCount == 1);
+}
+
+TEST_CASE("SearchMemo_FailuresNotRemembered", "[SearchMemo]")
+{
+    size_t searchCount = 0;
+    auto testSource = std::make_shared<TestSource>();
+    Source source{ testSource };
+
+    SearchMemoScope scope{ true };
+
+    SECTION("Thrown")
+    {
+        testSource->SearchFunction = [&](const SearchRequest&) -> SearchResult
+        {
+            ++searchCount;
+            THROW_HR(E_ACCESSDENIED);
+        };
+
+        REQUIRE_THROWS_HR(source.Search(MakeLookup("Id.One")), E_ACCESSDENIED);
+        REQUIRE_THROWS_HR(source.Search(MakeLookup("Id.One")), E_ACCESSDENIED);
+    }
+    SECTION("In result")
+    {
+        testSource->SearchFunction = [&](const SearchRequest&)
+        {
+            ++searchCount;
+
+            SearchResult result;
+            result.Failures.emplace_back(SearchResult::Failure{ "Failed", std::make_exception_ptr(wil::ResultException(E_ACCESSDENIED)) });
+            return result;
+        };
+
+        REQUIRE(source.Search(MakeLookup("Id.One")).Failures.size() == 1);
+        REQUIRE(source.Search(MakeLookup("Id.One")).Failures.size() == 1);
+    }
+
+    REQUIRE(searchCount == 2);
+}
+
+TEST_CASE("SearchMemo_Invalidate", "[SearchMemo]")
+{
+    size_t searchCount = 0;
+    Source source{ MakeCountingSource(searchCount) };
+
+    SearchMemoScope scope{ true };
+
+    source.Search(MakeLookup("Id.One"));
+    InvalidateSearchMemo();
+    auto result = source.Search(MakeLookup("Id.One"));
+
+    REQUIRE(searchCount == 2);
+    REQUIRE(result.Matches[0].Package->GetProperty(PackageProperty::Id) == "Memo.Package2");
+}
+
+TEST_CASE("SearchMemo_TrackingWriteInvalidates", "[SearchMemo]")
+{
+    MemoTestSetup setup{ 6 };
+    Manifest::Manifest manifest = MakeManifest(1);
+
+    SearchMemoScope scope{ true };
+
+    auto before = setup.Composite.Search(MakeLookup(manifest.Id));
+    setup.Available.GetTrackingCatalog().RecordInstall(manifest, manifest.Installers[0], false);
+    size_t missCount = SearchMemo::Current()->GetMissCount();
+
+    auto after = setup.Composite.Search(MakeLookup(manifest.Id));
+
+    REQUIRE(SearchMemo::Current()->GetMissCount() > missCount);
+    REQUIRE(after.Matches.size() == before.Matches.size());
+}
+
+TEST_CASE("SearchMemo_SameAsUnmemoized", "[SearchMemo]")
+{
+    constexpr size_t packageCount = 12;
+    MemoTestSetup setup{ packageCount };
+    auto requests = MakeWorkload(packageCount);
+
+    std::vector<std::vector<std::string>> expected;
+    for (const auto& request : requests)
+    {
+        expected.emplace_back(Describe(setup.Composite.Search(request)));
+    }
+
+    SearchMemoScope scope{ true };
+
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        INFO(requests[i].ToString());
+        REQUIRE(Describe(setup.Composite.Search(requests[i])) == expected[i]);
+    }
+
+    REQUIRE(SearchMemo::Current()->GetHitCount() > 0);
+
+    // Batches combine the lookups, but each result still matches the individual search
+    auto batchResults = setup.Composite.SearchBatch(requests);
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        INFO(requests[i].ToString());
+        REQUIRE(Describe(batchResults[i]) == expected[i]);
+    }
+}
+
+TEST_CASE("SearchMemo_Benchmark", "[.]")
+{
+    for (size_t count : { size_t{ 100 }, size_t{ 1000 } })
+    {
+        MemoTestSetup setup{ count };
+        auto requests = MakeWorkload(count);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& request : requests)
+        {
+            setup.Composite.Search(request);
+        }
+        auto unmemoized = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        SearchMemoScope scope{ true };
+
+        start = std::chrono::steady_clock::now();
+        for (const auto& request : requests)
+        {
+            setup.Composite.Search(request);
+        }
+        auto memoized = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        WARN(count << " packages, " << requests.size() << " searches\n" <<
+            "Without memo: " << unmemoized.count() << " ms\n" <<
+            "With memo: " << memoized.count() << " ms (" << SearchMemo::Current()->GetHitCount() << " hits)");
+    }
+}
@@ -0,0 +1,210 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSettings.h"
+#include <SourceMirrors.h>
+
+using namespace std::chrono_literals;
+using namespace TestCommon;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Settings;
+
+namespace
+{
+    SourceDetails GetTestSourceDetails()
+    {
+        SourceDetails details;
+        details.Name = "testName";
+        details.Type = "testType";
+        details.Arg = "https://primary";
+        details.Mirrors = { "https://mirror1", "https://mirror2" };
+        return details;
+    }
+}
+
+TEST_CASE("SourceLocationTracker_ConfiguredOrderWithoutStatistics", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+    SourceLocationTracker tracker;
+
+    std::vector<std::string> ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked == std::vector<std::string>{ "https://primary", "https://mirror1", "https://mirror2" });
+}
+
+TEST_CASE("SourceLocationTracker_RankedByLatency", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+    SourceLocationTracker tracker;
+
+    tracker.RecordSuccess("https://primary", 300ms);
+    tracker.RecordSuccess("https://mirror1", 200ms);
+    tracker.RecordSuccess("https://mirror2", 100ms);
+
+    std::vector<std::string> ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked == std::vector<std::string>{ "https://mirror2", "https://mirror1", "https://primary" });
+
+    // A single slow sample is smoothed rather than taken as is.
+    tracker.RecordSuccess("https://mirror2", 400ms);
+    REQUIRE(tracker.GetStatistics("https://mirror2").Latency == 190ms);
+
+    ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked == std::vector<std::string>{ "https://mirror2", "https://mirror1", "https://primary" });
+}
+
+TEST_CASE("SourceLocationTracker_FailuresRankedLast", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+    SourceLocationTracker tracker;
+
+    tracker.RecordSuccess("https://primary", 10ms);
+    tracker.RecordSuccess("https://mirror1", 200ms);
+    tracker.RecordSuccess("https://mirror2", 100ms);
+    tracker.RecordFailure("https://primary");
+
+    std::vector<std::string> ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked == std::vector<std::string>{ "https://mirror2", "https://mirror1", "https://primary" });
+    REQUIRE(tracker.GetStatistics("https://primary").ConsecutiveFailures == 1);
+
+    // A success clears the failures.
+    tracker.RecordSuccess("https://primary", 10ms);
+    REQUIRE(tracker.GetStatistics("https://primary").ConsecutiveFailures == 0);
+
+    ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked[0] == "https://primary");
+}
+
+TEST_CASE("SourceLocationTracker_Persisted", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    {
+        SourceLocationTracker tracker;
+        tracker.RecordFailure("https://mirror2");
+        tracker.RecordSuccess("https://mirror1", 50ms);
+
+        // A failure is saved right away, but latency is only saved when requested.
+        SourceLocationTracker other;
+        REQUIRE(!other.GetStatistics("https://mirror1").Latency);
+        REQUIRE(other.GetStatistics("https://mirror2").ConsecutiveFailures == 1);
+
+        tracker.Save();
+    }
+
+    SourceLocationTracker tracker;
+
+    SourceLocationStatistics statistics = tracker.GetStatistics("https://mirror1");
+    REQUIRE(statistics.Latency == 50ms);
+    REQUIRE(statistics.ConsecutiveFailures == 0);
+
+    statistics = tracker.GetStatistics("https://mirror2");
+    REQUIRE(!statistics.Latency);
+    REQUIRE(statistics.ConsecutiveFailures == 1);
+
+    REQUIRE(!tracker.GetStatistics("https://primary").Latency);
+}
+
+TEST_CASE("SourceLocationTracker_InvalidStatisticsIgnored", "[sources][sourceMirrors]")
+{
+    SetSetting(Stream::SourceLocationStatistics, "Locations: Value : BAD");
+    SourceLocationTracker tracker;
+
+    std::vector<std::string> ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked.size() == 3);
+
+    tracker.RecordSuccess("https://mirror1", 50ms);
+    REQUIRE(tracker.GetStatistics("https://mirror1").Latency == 50ms);
+}
+
+TEST_CASE("ExecuteWithSourceLocations_NoMirrors", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    SourceDetails details = GetTestSourceDetails();
+    details.Mirrors.clear();
+
+    std::vector<std::string> attempted;
+    REQUIRE_THROWS_HR(ExecuteWithSourceLocations(details, [&](const std::string& location) -> int
+        {
+            attempted.emplace_back(location);
+            THROW_HR(E_FAIL);
+        }), E_FAIL);
+
+    REQUIRE(attempted == std::vector<std::string>{ "https://primary" });
+
+    // Nothing is tracked for sources without mirrors.
+    REQUIRE(SourceLocationTracker{}.GetStatistics("https://primary").ConsecutiveFailures == 0);
+}
+
+TEST_CASE("ExecuteWithSourceLocations_FallsOver", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    std::vector<std::string> attempted;
+    std::string result = ExecuteWithSourceLocations(GetTestSourceDetails(), [&](const std::string& location)
+        {
+            attempted.emplace_back(location);
+            THROW_HR_IF(E_FAIL, location != "https://mirror2");
+            return location;
+        });
+
+    REQUIRE(result == "https://mirror2");
+    REQUIRE(attempted == std::vector<std::string>{ "https://primary", "https://mirror1", "https://mirror2" });
+
+    // The failed locations are ranked after the one that succeeded.
+    SourceLocationTracker tracker;
+    std::vector<std::string> ranked = tracker.GetRankedLocations(GetTestSourceDetails());
+    REQUIRE(ranked[0] == "https://mirror2");
+    REQUIRE(tracker.GetStatistics("https://primary").ConsecutiveFailures == 1);
+    REQUIRE(tracker.GetStatistics("https://mirror1").ConsecutiveFailures == 1);
+}
+
+TEST_CASE("ExecuteWithSourceLocations_AllFail", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    size_t attempts = 0;
+    REQUIRE_THROWS_HR(ExecuteWithSourceLocations(GetTestSourceDetails(), [&](const std::string&) -> int
+        {
+            ++attempts;
+            THROW_HR(E_FAIL);
+        }), E_FAIL);
+
+    REQUIRE(attempts == 3);
+}
+
+TEST_CASE("ExecuteWithSourceLocations_NotCompleted", "[sources][sourceMirrors]")
+{
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    // An operation that returns false (as when a lock is not acquired) is neither a success nor a failure.
+    std::vector<std::string> attempted;
+    REQUIRE(!ExecuteWithSourceLocations(GetTestSourceDetails(), [&](const std::string& location)
+        {
+            attempted.emplace_back(location);
+            return false;
+        }));
+
+    REQUIRE(attempted == std::vector<std::string>{ "https://primary" });
+
+    SourceLocationTracker tracker;
+    REQUIRE(!tracker.GetStatistics("https://primary").Latency);
+    REQUIRE(tracker.GetStatistics("https://primary").ConsecutiveFailures == 0);
+}
+
+TEST_CASE("ExecuteWithSourceLocations_Cancelled", "[sources][sourceMirrors]")
+{
+    HRESULT cancellation = GENERATE(E_ABORT, APPINSTALLER_CLI_ERROR_CTRL_SIGNAL_RECEIVED);
+    RemoveSetting(Stream::SourceLocationStatistics);
+
+    size_t attempts = 0;
+    REQUIRE_THROWS_HR(ExecuteWithSourceLocations(GetTestSourceDetails(), [&](const std::string&) -> int
+        {
+            ++attempts;
+            THROW_HR(cancellation);
+        }), cancellation);
+
+    // The cancellation is not held against the location, and no other location is tried.
+    REQUIRE(attempts == 1);
+    REQUIRE(SourceLocationTracker{}.GetStatistics("https://primary").ConsecutiveFailures == 0);
+}
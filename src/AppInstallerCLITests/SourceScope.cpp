@@ -0,0 +1,488 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include "TestSource.h"
+#include "TestHooks.h"
+#include <CompositeSource.h>
+#include <SourceScope.h>
+#include <Microsoft/SQLiteIndexSource.h>
+#include <PackageTrackingCatalogSourceFactory.h>
+
+using namespace std::string_literals;
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller;
+using namespace AppInstaller::Repository;
+using namespace AppInstaller::Repository::Microsoft;
+
+namespace
+{
+    Manifest::Manifest MakeManifest(std::string_view id, std::string_view publisher, std::string_view productCode = {})
+    {
+        Manifest::Manifest result;
+
+        result.Id = id;
+        result.DefaultLocalization.Add<Manifest::Localization::PackageName>("Name of " + result.Id);
+        result.DefaultLocalization.Add<Manifest::Localization::Publisher>(std::string{ publisher });
+        result.Version = "1.0";
+        result.Installers.push_back({});
+        result.Installers[0].ProductCode = productCode;
+
+        return result;
+    }
+
+    SearchRequest MakeLookup(std::string_view id, MatchType type = MatchType::Exact)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::Id, type, id);
+        return result;
+    }
+
+    SearchRequest MakeCorrelation(std::string_view productCode, std::string_view name, std::string_view publisher)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, productCode);
+        result.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, name, publisher);
+        return result;
+    }
+
+    SearchRequest MakeNameAndPublisher(std::string_view name, std::string_view publisher)
+    {
+        SearchRequest result;
+        result.Inclusions.emplace_back(PackageMatchField::NormalizedNameAndPublisher, MatchType::Exact, name, publisher);
+        return result;
+    }
+
+    bool IsMatch(const RequestMatch& match, std::string_view value)
+    {
+        switch (match.Type)
+        {
+        case MatchType::Exact:
+            return match.Value == value;
+        case MatchType::StartsWith:
+            return Utility::CaseInsensitiveStartsWith(value, match.Value);
+        case MatchType::Substring:
+            return Utility::ToLower(value).find(Utility::ToLower(match.Value)) != std::string::npos;
+        default:
+            return Utility::CaseInsensitiveEquals(value, match.Value);
+        }
+    }
+
+    // A local stand-in for a remote source, which counts the searches that it receives and can take time to respond.
+    struct ScopeTestSource : public TestSource
+    {
+        ScopeTestSource(std::string_view name, std::vector<Manifest::Manifest> manifests, SourceScope scope = {}, std::chrono::milliseconds latency = {}) :
+            Manifests(std::move(manifests)), Latency(latency)
+        {
+            Details.Name = name;
+            Details.Identifier = "*"s + std::string{ name };
+            Details.Scope = std::move(scope);
+        }
+
+        SearchResult Search(const SearchRequest& request) const override
+        {
+            ++SearchCount;
+            std::this_thread::sleep_for(Latency);
+
+            SearchResult result;
+
+            for (const auto& manifest : Manifests)
+            {
+                std::optional<PackageMatchFilter> criteria;
+
+                if (request.Query && (IsMatch(request.Query.value(), manifest.Id) || IsMatch(request.Query.value(), manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>())))
+                {
+                    criteria = PackageMatchFilter{ PackageMatchField::Id, request.Query->Type, request.Query->Value };
+                }
+
+                for (const auto& inclusion : request.Inclusions)
+                {
+                    if (!criteria && Matches(inclusion, manifest))
+                    {
+                        criteria = inclusion;
+                    }
+                }
+
+                if (!request.Query && request.Inclusions.empty())
+                {
+                    criteria = PackageMatchFilter{ PackageMatchField::Id, MatchType::Wildcard, manifest.Id };
+                }
+
+                if (criteria && std::all_of(request.Filters.begin(), request.Filters.end(), [&](const PackageMatchFilter& filter) { return Matches(filter, manifest); }))
+                {
+                    result.Matches.emplace_back(TestPackage::Make(std::vector<Manifest::Manifest>{ manifest }, shared_from_this()), criteria.value());
+                }
+            }
+
+            return result;
+        }
+
+        static bool Matches(const PackageMatchFilter& filter, const Manifest::Manifest& manifest)
+        {
+            switch (filter.Field)
+            {
+            case PackageMatchField::Id:
+                return IsMatch(filter, manifest.Id);
+            case PackageMatchField::ProductCode:
+                return Utility::CaseInsensitiveEquals(filter.Value, manifest.Installers[0].ProductCode);
+            case PackageMatchField::NormalizedNameAndPublisher:
+                return
+                    Utility::CaseInsensitiveEquals(filter.Value, manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>()) &&
+                    Utility::CaseInsensitiveEquals(filter.Additional.value(), manifest.DefaultLocalization.Get<Manifest::Localization::Publisher>());
+            default:
+                return false;
+            }
+        }
+
+        std::vector<Manifest::Manifest> Manifests;
+        std::chrono::milliseconds Latency;
+        mutable size_t SearchCount = 0;
+    };
+
+    // The installed packages, as the installed source would report them.
+    struct InstalledScopeTestSource : public TestSource
+    {
+        SearchResult Search(const SearchRequest& request) const override
+        {
+            SearchResult result;
+
+            for (const auto& manifest : Manifests)
+            {
+                bool isMatch = request.IsForEverything() ||
+                    std::any_of(request.Inclusions.begin(), request.Inclusions.end(), [&](const PackageMatchFilter& inclusion) { return ScopeTestSource::Matches(inclusion, manifest); });
+
+                if (isMatch)
+                {
+                    result.Matches.emplace_back(
+                        TestPackage::Make(manifest, TestPackage::MetadataMap{}, std::vector<Manifest::Manifest>{}, shared_from_this()),
+                        PackageMatchFilter{ PackageMatchField::Id, MatchType::Wildcard, manifest.Id });
+                }
+            }
+
+            return result;
+        }
+
+        std::vector<Manifest::Manifest> Manifests;
+    };
+
+    // Composite sources over the stand-ins, with and without their scopes.
+    struct ScopeTestSetup
+    {
+        ScopeTestSetup(size_t packageCount, std::chrono::milliseconds latency = {}) : TrackingFactory([&](const SourceDetails&) { return Tracking; })
+        {
+            Tracking = std::make_shared<SQLiteIndexSource>(SourceDetails{}, SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET));
+            TestHook_SetSourceFactoryOverride(std::string{ PackageTrackingCatalogSourceFactory::Type() }, TrackingFactory);
+
+            std::vector<Manifest::Manifest> contoso;
+            std::vector<Manifest::Manifest> fabrikam;
+            std::vector<Manifest::Manifest> community;
+            Installed = std::make_shared<InstalledScopeTestSource>();
+
+            for (size_t i = 0; i < packageCount; ++i)
+            {
+                std::string index = std::to_string(i);
+                contoso.emplace_back(MakeManifest("Contoso.App" + index, "Contoso Ltd.", "{contoso-" + index + "}"));
+                fabrikam.emplace_back(MakeManifest("Fabrikam.Tool" + index, "Fabrikam", "{fabrikam-" + index + "}"));
+                community.emplace_back(MakeManifest("Community.Package" + index, "Community", "{community-" + index + "}"));
+
+                // Some of each are installed, along with packages from no source.
+                if (i % 2 == 0)
+                {
+                    Installed->Manifests.emplace_back(contoso.back());
+                    Installed->Manifests.emplace_back(fabrikam.back());
+                    Installed->Manifests.emplace_back(community.back());
+                    Installed->Manifests.emplace_back(MakeManifest("ARP.Local" + index, "Local Publisher", "{local-" + index + "}"));
+                }
+            }
+
+            Scoped.emplace_back(std::make_shared<ScopeTestSource>("Contoso", contoso, SourceScope{ { "Contoso" }, { "Contoso Ltd." } }, latency));
+            Scoped.emplace_back(std::make_shared<ScopeTestSource>("Fabrikam", fabrikam, SourceScope{ { "Fabrikam" }, { "Fabrikam" } }, latency));
+            Scoped.emplace_back(std::make_shared<ScopeTestSource>("Community", community, SourceScope{}, latency));
+
+            Unscoped.emplace_back(std::make_shared<ScopeTestSource>("Contoso", contoso, SourceScope{}, latency));
+            Unscoped.emplace_back(std::make_shared<ScopeTestSource>("Fabrikam", fabrikam, SourceScope{}, latency));
+            Unscoped.emplace_back(std::make_shared<ScopeTestSource>("Community", community, SourceScope{}, latency));
+        }
+
+        ~ScopeTestSetup()
+        {
+            TestHook_ClearSourceFactoryOverrides();
+        }
+
+        std::shared_ptr<CompositeSource> MakeComposite(const std::vector<std::shared_ptr<ScopeTestSource>>& sources, bool withInstalled) const
+        {
+            auto result = std::make_shared<CompositeSource>("*ScopeTests");
+            for (const auto& source : sources)
+            {
+                result->AddAvailableSource(Source{ source });
+            }
+            if (withInstalled)
+            {
+                result->SetInstalledSource(Source{ Installed }, CompositeSearchBehavior::Installed);
+            }
+            return result;
+        }
+
+        static size_t SearchCount(const std::vector<std::shared_ptr<ScopeTestSource>>& sources)
+        {
+            size_t result = 0;
+            for (const auto& source : sources)
+            {
+                result += source->SearchCount;
+            }
+            return result;
+        }
+
+        static void ResetSearchCount(const std::vector<std::shared_ptr<ScopeTestSource>>& sources)
+        {
+            for (const auto& source : sources)
+            {
+                source->SearchCount = 0;
+            }
+        }
+
+        TestSourceFactory TrackingFactory;
+        std::shared_ptr<SQLiteIndexSource> Tracking;
+        std::shared_ptr<InstalledScopeTestSource> Installed;
+        std::vector<std::shared_ptr<ScopeTestSource>> Scoped;
+        std::vector<std::shared_ptr<ScopeTestSource>> Unscoped;
+    };
+
+    // Describes each result as its installed and available identifiers.
+    std::vector<std::string> Describe(const SearchResult& result)
+    {
+        std::vector<std::string> descriptions;
+
+        for (const auto& match : result.Matches)
+        {
+            std::string description;
+
+            auto installed = match.Package->GetInstalledVersion();
+            if (installed)
+            {
+                description += installed->GetProperty(PackageVersionProperty::Id);
+            }
+
+            description += " -> ";
+
+            auto available = match.Package->GetLatestAvailableVersion();
+            if (available)
+            {
+                description += available->GetProperty(PackageVersionProperty::Id);
+            }
+
+            descriptions.emplace_back(std::move(description));
+        }
+
+        std::sort(descriptions.begin(), descriptions.end());
+        return descriptions;
+    }
+}
+
+TEST_CASE("SourceScope_IdentifierNamespaces", "[SourceScope]")
+{
+    SourceScopeFilter filter{ SourceScope{ { "Contoso", "Fabrikam.Tools." }, {} } };
+    REQUIRE(filter.IsLimited());
+
+    REQUIRE(filter.CanMatch(MakeLookup("Contoso.App")));
+    REQUIRE(filter.CanMatch(MakeLookup("contoso.app", MatchType::CaseInsensitive)));
+    REQUIRE(filter.CanMatch(MakeLookup("Contoso")));
+    REQUIRE(filter.CanMatch(MakeLookup("Fabrikam.Tools.Editor")));
+    REQUIRE(!filter.CanMatch(MakeLookup("ContosoApp")));
+    REQUIRE(!filter.CanMatch(MakeLookup("Fabrikam.Editor")));
+    REQUIRE(!filter.CanMatch(MakeLookup("Other.App")));
+
+    // A prefix could be extended into the namespace.
+    REQUIRE(filter.CanMatch(MakeLookup("Cont", MatchType::StartsWith)));
+    REQUIRE(filter.CanMatch(MakeLookup("Contoso.A", MatchType::StartsWith)));
+    REQUIRE(!filter.CanMatch(MakeLookup("Other", MatchType::StartsWith)));
+
+    // Other kinds of matches could match any identifier.
+    REQUIRE(filter.CanMatch(MakeLookup("Other", MatchType::Substring)));
+    REQUIRE(filter.CanMatch(MakeLookup("Other", MatchType::Fuzzy)));
+
+    // Any inclusion in the scope is enough.
+    SearchRequest multiple = MakeLookup("Other.App");
+    multiple.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, "Contoso.App"sv);
+    REQUIRE(filter.CanMatch(multiple));
+
+    // Inclusions on other fields could match anything.
+    SearchRequest name = MakeLookup("Other.App");
+    name.Inclusions.emplace_back(PackageMatchField::Name, MatchType::Exact, "Other"sv);
+    REQUIRE(filter.CanMatch(name));
+}
+
+TEST_CASE("SourceScope_QueriesAndFilters", "[SourceScope]")
+{
+    SourceScopeFilter filter{ SourceScope{ { "Contoso" }, {} } };
+
+    SearchRequest query;
+    query.Query = RequestMatch(MatchType::Substring, "Other"sv);
+    REQUIRE(!SourceScopeFilter::IsLimitable(query));
+    REQUIRE(filter.CanMatch(query));
+
+    SearchRequest everything;
+    REQUIRE(!SourceScopeFilter::IsLimitable(everything));
+    REQUIRE(filter.CanMatch(everything));
+
+    // Filters must all match, even with a query.
+    SearchRequest filtered = query;
+    filtered.Filters.emplace_back(PackageMatchField::Id, MatchType::CaseInsensitive, "Other.App"sv);
+    REQUIRE(SourceScopeFilter::IsLimitable(filtered));
+    REQUIRE(!filter.CanMatch(filtered));
+
+    filtered.Filters[0].Value = "Contoso.App";
+    REQUIRE(filter.CanMatch(filtered));
+}
+
+TEST_CASE("SourceScope_Publishers", "[SourceScope]")
+{
+    SourceScopeFilter filter{ SourceScope{ {}, { "Contoso Ltd." } } };
+
+    // Publishers are compared after normalization, as the index does.
+    REQUIRE(filter.CanMatch(MakeNameAndPublisher("App", "Contoso Ltd.")));
+    REQUIRE(filter.CanMatch(MakeNameAndPublisher("App", "CONTOSO LTD.")));
+    REQUIRE(!filter.CanMatch(MakeNameAndPublisher("App", "Fabrikam")));
+
+    // The publisher of an installed package may not match its manifests, so a system reference is always searched.
+    REQUIRE(filter.CanMatch(MakeCorrelation("{guid}", "App", "Contoso Ltd.")));
+    REQUIRE(filter.CanMatch(MakeCorrelation("{guid}", "App", "Fabrikam")));
+
+    // System references alone cannot be placed outside of the scope.
+    SearchRequest productCode;
+    productCode.Inclusions.emplace_back(PackageMatchField::ProductCode, MatchType::Exact, "{guid}"sv);
+    REQUIRE(filter.CanMatch(productCode));
+
+    // Identifiers are not limited by publishers.
+    REQUIRE(filter.CanMatch(MakeLookup("Other.App")));
+}
+
+TEST_CASE("SourceScope_DeclaredAndAdvertised", "[SourceScope]")
+{
+    SourceScope declared{ { "Contoso" }, {} };
+    SourceScope advertised{ { "Fabrikam" }, { "Fabrikam" } };
+    SourceScopeFilter filter{ declared, advertised };
+
+    // The declared namespaces take precedence, while the advertised publishers fill in those not declared.
+    REQUIRE(filter.CanMatch(MakeLookup("Contoso.App")));
+    REQUIRE(!filter.CanMatch(MakeLookup("Fabrikam.App")));
+    REQUIRE(!filter.CanMatch(MakeNameAndPublisher("App", "Contoso Ltd.")));
+
+    REQUIRE(!SourceScopeFilter{}.IsLimited());
+    REQUIRE(SourceScopeFilter{ SourceScope{}, advertised }.IsLimited());
+}
+
+TEST_CASE("SourceScope_CompositeAvailableSearch", "[SourceScope]")
+{
+    ScopeTestSetup setup{ 4 };
+    auto scoped = setup.MakeComposite(setup.Scoped, false);
+    auto unscoped = setup.MakeComposite(setup.Unscoped, false);
+
+    std::vector<SearchRequest> requests;
+    requests.emplace_back(MakeLookup("Contoso.App1"));
+    requests.emplace_back(MakeLookup("fabrikam.tool2", MatchType::CaseInsensitive));
+    requests.emplace_back(MakeLookup("Community.Package3"));
+    requests.emplace_back(MakeLookup("Missing.Package"));
+    requests.emplace_back(MakeLookup("Contoso.", MatchType::StartsWith));
+    requests.emplace_back(MakeLookup("App", MatchType::Substring));
+
+    SearchRequest query;
+    query.Query = RequestMatch(MatchType::Substring, "1"sv);
+    requests.emplace_back(std::move(query));
+
+    for (const auto& request : requests)
+    {
+        INFO(request.ToString());
+        REQUIRE(Describe(scoped->Search(request)) == Describe(unscoped->Search(request)));
+    }
+
+    // Only the lookups were routed.
+    REQUIRE(ScopeTestSetup::SearchCount(setup.Unscoped) == requests.size() * 3);
+    REQUIRE(ScopeTestSetup::SearchCount(setup.Scoped) == 2 + 2 + 1 + 1 + 2 + 3 + 3);
+    REQUIRE(setup.Scoped[2]->SearchCount == requests.size());
+}
+
+TEST_CASE("SourceScope_CompositeInstalledSearch", "[SourceScope]")
+{
+    ScopeTestSetup setup{ 6 };
+    auto scoped = setup.MakeComposite(setup.Scoped, true);
+    auto unscoped = setup.MakeComposite(setup.Unscoped, true);
+
+    SearchRequest everything;
+    auto scopedResult = scoped->Search(everything);
+    auto unscopedResult = unscoped->Search(everything);
+
+    REQUIRE(scopedResult.Matches.size() == setup.Installed->Manifests.size());
+    REQUIRE(Describe(scopedResult) == Describe(unscopedResult));
+    REQUIRE(std::count_if(scopedResult.Matches.begin(), scopedResult.Matches.end(), [](const ResultMatch& match) { return match.Package->GetLatestAvailableVersion() != nullptr; }) == 9);
+
+    // The installed packages have product codes, which could match a package of any publisher.
+    REQUIRE(ScopeTestSetup::SearchCount(setup.Scoped) == ScopeTestSetup::SearchCount(setup.Unscoped));
+}
+
+TEST_CASE("SourceScope_CompositeInstalledSearch_PublisherMismatch", "[SourceScope]")
+{
+    ScopeTestSetup setup{ 2 };
+
+    // Installed under a publisher that the Contoso source does not declare, but with the product code from its manifest.
+    setup.Installed->Manifests.clear();
+    setup.Installed->Manifests.emplace_back(MakeManifest("ARP.Contoso", "Contoso Corporation", "{contoso-1}"));
+
+    auto scoped = setup.MakeComposite(setup.Scoped, true);
+    auto unscoped = setup.MakeComposite(setup.Unscoped, true);
+
+    SearchRequest everything;
+    auto scopedResult = scoped->Search(everything);
+    REQUIRE(Describe(scopedResult) == std::vector<std::string>{ "ARP.Contoso -> Contoso.App1" });
+    REQUIRE(Describe(scopedResult) == Describe(unscoped->Search(everything)));
+}
+
+TEST_CASE("SourceScope_Benchmark", "[.]")
+{
+    constexpr size_t packageCount = 40;
+    constexpr auto latency = 5ms;
+
+    ScopeTestSetup setup{ packageCount, latency };
+
+    auto measure = [&](const std::vector<std::shared_ptr<ScopeTestSource>>& sources, bool withInstalled, const std::vector<SearchRequest>& requests, size_t& searchCount)
+    {
+        auto composite = setup.MakeComposite(sources, withInstalled);
+        ScopeTestSetup::ResetSearchCount(sources);
+
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& request : requests)
+        {
+            composite->Search(request);
+        }
+        auto result = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        searchCount = ScopeTestSetup::SearchCount(sources);
+        return result;
+    };
+
+    std::vector<SearchRequest> lookups;
+    for (size_t i = 0; i < packageCount; ++i)
+    {
+        lookups.emplace_back(MakeLookup("Contoso.App" + std::to_string(i)));
+    }
+
+    std::vector<SearchRequest> installed{ SearchRequest{} };
+
+    size_t unscopedLookupCount = 0;
+    size_t scopedLookupCount = 0;
+    size_t unscopedInstalledCount = 0;
+    size_t scopedInstalledCount = 0;
+
+    auto unscopedLookups = measure(setup.Unscoped, false, lookups, unscopedLookupCount);
+    auto scopedLookups = measure(setup.Scoped, false, lookups, scopedLookupCount);
+    auto unscopedInstalled = measure(setup.Unscoped, true, installed, unscopedInstalledCount);
+    auto scopedInstalled = measure(setup.Scoped, true, installed, scopedInstalledCount);
+
+    WARN(packageCount << " identifier lookups, " << latency.count() << " ms per source request\n" <<
+        "  Without scopes: " << unscopedLookupCount << " requests, " << unscopedLookups.count() << " ms\n" <<
+        "  With scopes: " << scopedLookupCount << " requests, " << scopedLookups.count() << " ms\n" <<
+        "Correlation of " << setup.Installed->Manifests.size() << " installed packages\n" <<
+        "  Without scopes: " << unscopedInstalledCount << " requests, " << unscopedInstalled.count() << " ms\n" <<
+        "  With scopes: " << scopedInstalledCount << " requests, " << scopedInstalled.count() << " ms");
+}
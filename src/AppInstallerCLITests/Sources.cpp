@@ -59,6 +59,32 @@ Sources:
     IsTombstone: false
 )"sv;
 
+constexpr std::string_view s_SingleSourceWithMirrors = R"(
+Sources:
+  - Name: testName
+    Type: testType
+    Arg: testArg
+    Mirrors:
+      - testMirror1
+      - testMirror2
+    Data: testData
+    IsTombstone: false
+)"sv;
+
+constexpr std::string_view s_SingleSourceWithScope = R"(
+Sources:
+  - Name: testName
+    Type: testType
+    Arg: testArg
+    IdentifierNamespaces:
+      - Contoso
+      - Fabrikam.Tools
+    Publishers:
+      - Contoso Ltd.
+    Data: testData
+    IsTombstone: false
+)"sv;
+
 constexpr std::string_view s_SingleSourceMetadata = R"(
 Sources:
   - Name: testName
@@ -286,6 +312,41 @@ TEST_CASE("RepoSources_SingleSource", "[sources]")
     RequireDefaultSourcesAt(sources, 1);
 }
 
+TEST_CASE("RepoSources_SingleSourceWithMirrors", "[sources]")
+{
+    SetSetting(Stream::UserSources, s_SingleSourceWithMirrors);
+    RemoveSetting(Stream::SourcesMetadata);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == c_DefaultSourceCount + 1);
+
+    REQUIRE(sources[0].Name == "testName");
+    REQUIRE(sources[0].Arg == "testArg");
+    REQUIRE(sources[0].Mirrors.size() == 2);
+    REQUIRE(sources[0].Mirrors[0] == "testMirror1");
+    REQUIRE(sources[0].Mirrors[1] == "testMirror2");
+
+    // Sources without mirrors are unaffected.
+    REQUIRE(sources[1].Mirrors.empty());
+}
+
+TEST_CASE("RepoSources_SingleSourceWithScope", "[sources]")
+{
+    SetSetting(Stream::UserSources, s_SingleSourceWithScope);
+    RemoveSetting(Stream::SourcesMetadata);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == c_DefaultSourceCount + 1);
+
+    REQUIRE(sources[0].Name == "testName");
+    REQUIRE(sources[0].Scope.IdentifierNamespaces == std::vector<std::string>{ "Contoso", "Fabrikam.Tools" });
+    REQUIRE(sources[0].Scope.Publishers == std::vector<std::string>{ "Contoso Ltd." });
+
+    // Sources without a scope are unaffected.
+    REQUIRE(sources[1].Scope.IdentifierNamespaces.empty());
+    REQUIRE(sources[1].Scope.Publishers.empty());
+}
+
 TEST_CASE("RepoSources_ThreeSources", "[sources]")
 {
     SetSetting(Stream::UserSources, s_ThreeSources);
@@ -356,6 +417,57 @@ TEST_CASE("RepoSources_AddSource", "[sources]")
     RequireDefaultSourcesAt(sources, 1);
 }
 
+TEST_CASE("RepoSources_AddSourceWithMirrors", "[sources]")
+{
+    SetSetting(Stream::UserSources, s_EmptySources);
+    TestHook_ClearSourceFactoryOverrides();
+
+    SourceDetails details;
+    details.Name = "thisIsTheName";
+    details.Type = "thisIsTheType";
+    details.Arg = "thisIsTheArg";
+    details.Mirrors = { "thisIsTheFirstMirror", "thisIsTheSecondMirror" };
+
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    TestHook_SetSourceFactoryOverride(details.Type, factory);
+
+    ProgressCallback progress;
+    AddSource(details, progress);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == c_DefaultSourceCount + 1);
+
+    REQUIRE(sources[0].Name == details.Name);
+    REQUIRE(sources[0].Arg == details.Arg);
+    REQUIRE(sources[0].Mirrors == details.Mirrors);
+}
+
+TEST_CASE("RepoSources_AddSourceWithScope", "[sources]")
+{
+    SetSetting(Stream::UserSources, s_EmptySources);
+    TestHook_ClearSourceFactoryOverrides();
+
+    SourceDetails details;
+    details.Name = "thisIsTheName";
+    details.Type = "thisIsTheType";
+    details.Arg = "thisIsTheArg";
+    details.Scope.IdentifierNamespaces = { "thisIsTheNamespace" };
+    details.Scope.Publishers = { "thisIsThePublisher", "thisIsTheOtherPublisher" };
+
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    TestHook_SetSourceFactoryOverride(details.Type, factory);
+
+    ProgressCallback progress;
+    AddSource(details, progress);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources.size() == c_DefaultSourceCount + 1);
+
+    REQUIRE(sources[0].Name == details.Name);
+    REQUIRE(sources[0].Scope.IdentifierNamespaces == details.Scope.IdentifierNamespaces);
+    REQUIRE(sources[0].Scope.Publishers == details.Scope.Publishers);
+}
+
 TEST_CASE("RepoSources_AddMultipleSources", "[sources]")
 {
     SetSetting(Stream::UserSources, s_EmptySources);
@@ -594,6 +706,144 @@ TEST_CASE("RepoSources_UpdateOnOpen", "[sources]")
     REQUIRE(sources[0].LastUpdateTime != ConvertUnixEpochToSystemClock(0));
 }
 
+TEST_CASE("RepoSources_UpdateOnOpen_SingleFlight", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    // The update takes long enough that all of the opens find it in flight.
+    std::atomic<size_t> updateCount = 0;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&) { ++updateCount; std::this_thread::sleep_for(500ms); };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    SetSetting(Stream::UserSources, s_SingleSource);
+    RemoveSetting(Stream::SourcesMetadata);
+
+    // The update lock is a named mutex, so threads stand in for separate processes here.
+    constexpr size_t OpenCount = 8;
+    std::atomic<size_t> failedUpdateCount = 0;
+    std::vector<std::thread> threads;
+
+    for (size_t i = 0; i < OpenCount; ++i)
+    {
+        threads.emplace_back([&]()
+            {
+                ProgressCallback progress;
+                Source source{ name };
+                failedUpdateCount += source.Open(progress).size();
+            });
+    }
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    REQUIRE(updateCount == 1);
+    REQUIRE(failedUpdateCount == 0);
+
+    std::vector<SourceDetails> sources = GetSources();
+    REQUIRE(sources[0].Name == name);
+    REQUIRE(sources[0].LastUpdateTime != ConvertUnixEpochToSystemClock(0));
+
+    // Once fresh, opening again does not update.
+    ProgressCallback progress;
+    OpenSource(name, progress);
+    REQUIRE(updateCount == 1);
+}
+
+TEST_CASE("RepoSources_UpdateOnOpen_LongUpdateInFlight", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    // The update takes longer than an open waits for it.
+    std::atomic<size_t> updateCount = 0;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&) { ++updateCount; std::this_thread::sleep_for(5s); };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    SetSetting(Stream::UserSources, s_SingleSource);
+    RemoveSetting(Stream::SourcesMetadata);
+
+    std::thread updating([&]()
+        {
+            ProgressCallback progress;
+            Source source{ name };
+            source.Open(progress);
+        });
+
+    while (updateCount == 0)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    // The current data is opened without waiting for the update to finish, and without reporting a failure.
+    auto start = std::chrono::steady_clock::now();
+    ProgressCallback progress;
+    Source source{ name };
+    REQUIRE(source.Open(progress).empty());
+    REQUIRE(std::chrono::steady_clock::now() - start < 4s);
+    REQUIRE(updateCount == 1);
+
+    updating.join();
+}
+
+TEST_CASE("RepoSources_UpdateOnOpen_UpdateInFlightFailed", "[sources]")
+{
+    using namespace std::chrono_literals;
+
+    TestHook_ClearSourceFactoryOverrides();
+
+    std::string name = "testName";
+    std::string type = "testType";
+
+    // The first update fails after the second open starts waiting for it.
+    std::atomic<size_t> updateCount = 0;
+    TestSourceFactory factory{ SourcesTestSource::Create };
+    factory.OnUpdate = [&](const SourceDetails&)
+    {
+        if (++updateCount == 1)
+        {
+            std::this_thread::sleep_for(500ms);
+            THROW_HR(E_FAIL);
+        }
+    };
+    TestHook_SetSourceFactoryOverride(type, factory);
+
+    SetSetting(Stream::UserSources, s_SingleSource);
+    RemoveSetting(Stream::SourcesMetadata);
+
+    std::thread failing([&]()
+        {
+            ProgressCallback progress;
+            Source source{ name };
+            source.Open(progress);
+        });
+
+    while (updateCount == 0)
+    {
+        std::this_thread::sleep_for(10ms);
+    }
+
+    // The waiting open updates the source itself.
+    ProgressCallback progress;
+    Source source{ name };
+    REQUIRE(source.Open(progress).empty());
+    REQUIRE(updateCount == 2);
+
+    failing.join();
+}
+
 TEST_CASE("RepoSources_DropSourceByName", "[sources]")
 {
     SetSetting(Stream::UserSources, s_ThreeSources);
@@ -1080,6 +1330,174 @@ TEST_CASE("RepoSources_OpenMultipleWithTotalFailure", "[sources]")
     REQUIRE_THROWS_HR(OpenSource("", progress), APPINSTALLER_CLI_ERROR_FAILED_TO_OPEN_ALL_SOURCES);
 }
 
+TEST_CASE("RepoSources_LazyOpen_OpensOnFirstSearch", "[sources]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFLazySourceOpen>(true);
+
+    std::atomic<size_t> openCount = 0;
+    TestSourceFactory::OpenFunctor open = [&](const SourceDetails& details)
+    {
+        ++openCount;
+        return SourcesTestSource::Create(details);
+    };
+
+    TestHook_ClearSourceFactoryOverrides();
+    TestSourceFactory factory{ open };
+    TestHook_SetSourceFactoryOverride("testType", factory);
+
+    SetSetting(Stream::UserSources, s_TwoSource_AggregateSourceTest);
+
+    ProgressCallback progress;
+    auto source = OpenSource("", progress);
+
+    REQUIRE(source.IsComposite());
+    REQUIRE(source.GetAvailableSources().size() == 2);
+    REQUIRE(source.GetAvailableSources()[0].GetDetails().Name == "winget");
+    REQUIRE(openCount == 0);
+
+    SearchResult result = source.Search({});
+    REQUIRE(result.Matches.size() == 6);
+    REQUIRE(result.Failures.empty());
+    REQUIRE(openCount == 2);
+
+    // Each source is only opened once.
+    source.Search({});
+    REQUIRE(openCount == 2);
+}
+
+TEST_CASE("RepoSources_LazyOpen_NotOpenedIfUnused", "[sources]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFLazySourceOpen>(true);
+
+    std::atomic<size_t> openCount = 0;
+    TestSourceFactory::OpenFunctor open = [&](const SourceDetails& details)
+    {
+        ++openCount;
+        return SourcesTestSource::Create(details);
+    };
+
+    TestHook_ClearSourceFactoryOverrides();
+    TestSourceFactory factory{ open };
+    TestHook_SetSourceFactoryOverride("testType", factory);
+
+    SetSetting(Stream::UserSources, s_TwoSource_AggregateSourceTest);
+
+    ProgressCallback progress;
+    auto available = OpenSource("", progress);
+
+    // Nothing is installed, so the available sources are not needed to correlate.
+    Source installed{ std::make_shared<TestSource>() };
+    Source composite{ installed, available, CompositeSearchBehavior::Installed };
+
+    SearchResult result = composite.Search({});
+    REQUIRE(result.Matches.empty());
+    REQUIRE(openCount == 0);
+}
+
+TEST_CASE("RepoSources_LazyOpen_FailuresReportedPerSource", "[sources]")
+{
+    TestUserSettings settings;
+    settings.Set<Setting::EFLazySourceOpen>(true);
+
+    TestHook_ClearSourceFactoryOverrides();
+    TestSourceFactory factory{ FailingSourcesTestSource::CreateFailAll };
+    TestHook_SetSourceFactoryOverride("testType", factory);
+
+    SetSetting(Stream::UserSources, s_TwoSource_AggregateSourceTest);
+
+    // Opening succeeds, as no source is opened yet.
+    ProgressCallback progress;
+    auto source = OpenSource("", progress);
+    REQUIRE(source);
+
+    SearchResult searchResult = source.Search({});
+    REQUIRE(searchResult.Matches.empty());
+    REQUIRE(searchResult.Failures.size() == 2);
+
+    for (const auto& failure : searchResult.Failures)
+    {
+        HRESULT openFailure = S_OK;
+        try
+        {
+            std::rethrow_exception(failure.Exception);
+        }
+        catch (const wil::ResultException& re)
+        {
+            openFailure = re.GetErrorCode();
+        }
+        catch (...) {}
+
+        REQUIRE(openFailure == FailingSourcesTestSource::FailingHR);
+    }
+}
+
+TEST_CASE("RepoSources_LazyOpen_Benchmark", "[.]")
+{
+    using namespace std::chrono_literals;
+
+    // Two fast and two slow stand-in sources, for a command that only touches the installed side and one that searches everything.
+    constexpr std::string_view fourSources = R"(
+Sources:
+  - Name: fast1
+    Type: testType
+    Arg: testArg
+    Data: testData
+    IsTombstone: false
+  - Name: slow1
+    Type: testType
+    Arg: testArg
+    Data: testData
+    IsTombstone: false
+  - Name: fast2
+    Type: testType
+    Arg: testArg
+    Data: testData
+    IsTombstone: false
+  - Name: slow2
+    Type: testType
+    Arg: testArg
+    Data: testData
+    IsTombstone: false
+)"sv;
+
+    TestSourceFactory::OpenFunctor open = [](const SourceDetails& details)
+    {
+        if (details.Name.find("slow") == 0)
+        {
+            std::this_thread::sleep_for(250ms);
+        }
+
+        return std::shared_ptr<ISource>(new TestSource(details));
+    };
+
+    TestHook_ClearSourceFactoryOverrides();
+    TestSourceFactory factory{ open };
+    TestHook_SetSourceFactoryOverride("testType", factory);
+
+    SetSetting(Stream::UserSources, fourSources);
+
+    auto measure = [](bool lazy, CompositeSearchBehavior behavior)
+    {
+        TestUserSettings settings;
+        settings.Set<Setting::EFLazySourceOpen>(lazy);
+
+        auto start = std::chrono::steady_clock::now();
+
+        ProgressCallback progress;
+        auto available = OpenSource("", progress);
+        Source installed{ std::make_shared<TestSource>() };
+        Source composite{ installed, available, behavior };
+        composite.Search({});
+
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    WARN("Installed only: eager " << measure(false, CompositeSearchBehavior::Installed) << " ms, lazy " << measure(true, CompositeSearchBehavior::Installed) << " ms\n" <<
+        "All packages: eager " << measure(false, CompositeSearchBehavior::AllPackages) << " ms, lazy " << measure(true, CompositeSearchBehavior::AllPackages) << " ms");
+}
+
 TEST_CASE("RepoSources_UpdateSettingsDuringAction_SourcesUpdate", "[sources]")
 {
     SetSetting(Stream::UserSources, s_SingleSource);
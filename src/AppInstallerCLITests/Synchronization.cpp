@@ -123,3 +123,102 @@ TEST_CASE("CPRWL_CancelEndsWait", "[CrossProcessReaderWriteLock]")
     // Upon release of the writer, the other thread should signal
     REQUIRE(signal.wait(1000));
 }
+
+namespace
+{
+    // Starts a child process running the given command line, to stand in for an installer.
+    wil::unique_process_information StartChildProcess(std::wstring commandLine)
+    {
+        STARTUPINFOW startupInfo = { 0 };
+        startupInfo.cb = sizeof(startupInfo);
+
+        wil::unique_process_information processInfo;
+        THROW_LAST_ERROR_IF(!CreateProcessW(nullptr, &commandLine[0], nullptr, nullptr, FALSE, CREATE_NO_WINDOW, nullptr, nullptr, &startupInfo, &processInfo));
+        return processInfo;
+    }
+}
+
+TEST_CASE("WaitOrCancellation_Signaled", "[WaitOrCancellation]")
+{
+    wil::unique_event signal;
+    signal.create();
+    AppInstaller::ProgressCallback progress;
+
+    std::thread otherThread([&signal]() {
+        std::this_thread::sleep_for(100ms);
+        signal.SetEvent();
+        });
+    otherThread.detach();
+
+    REQUIRE(WaitForSingleObjectOrCancellation(signal.get(), progress, 10s) == WaitResult::Signaled);
+}
+
+TEST_CASE("WaitOrCancellation_TimedOut", "[WaitOrCancellation]")
+{
+    wil::unique_event signal;
+    signal.create();
+    AppInstaller::ProgressCallback progress;
+
+    REQUIRE(WaitForSingleObjectOrCancellation(signal.get(), progress, 100ms) == WaitResult::TimedOut);
+    REQUIRE(SleepUnlessCancelled(100ms, progress));
+}
+
+TEST_CASE("WaitOrCancellation_CancelWakesWait", "[WaitOrCancellation]")
+{
+    wil::unique_event signal;
+    signal.create();
+    AppInstaller::ProgressCallback progress;
+
+    std::thread otherThread([&progress]() {
+        std::this_thread::sleep_for(100ms);
+        progress.Cancel();
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    WaitResult result = WaitForSingleObjectOrCancellation(signal.get(), progress);
+    otherThread.join();
+
+    REQUIRE(result == WaitResult::Cancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+}
+
+TEST_CASE("WaitOrCancellation_AlreadyCancelled", "[WaitOrCancellation]")
+{
+    AppInstaller::ProgressCallback progress;
+    progress.Cancel();
+
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(!SleepUnlessCancelled(10s, progress));
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+}
+
+TEST_CASE("WaitOrCancellation_ChildProcessExits", "[WaitOrCancellation]")
+{
+    AppInstaller::ProgressCallback progress;
+    wil::unique_process_information child = StartChildProcess(L"cmd.exe /c exit 7");
+
+    REQUIRE(WaitForSingleObjectOrCancellation(child.hProcess, progress, 10s) == WaitResult::Signaled);
+
+    DWORD exitCode = 0;
+    REQUIRE(GetExitCodeProcess(child.hProcess, &exitCode));
+    REQUIRE(exitCode == 7);
+}
+
+TEST_CASE("WaitOrCancellation_ChildProcessCancelled", "[WaitOrCancellation]")
+{
+    AppInstaller::ProgressCallback progress;
+    wil::unique_process_information child = StartChildProcess(L"cmd.exe /c ping -n 30 127.0.0.1 > nul");
+    auto terminateChild = wil::scope_exit([&]() { TerminateProcess(child.hProcess, 0); });
+
+    std::thread otherThread([&progress]() {
+        std::this_thread::sleep_for(100ms);
+        progress.Cancel();
+        });
+
+    auto start = std::chrono::steady_clock::now();
+    WaitResult result = WaitForSingleObjectOrCancellation(child.hProcess, progress);
+    otherThread.join();
+
+    REQUIRE(result == WaitResult::Cancelled);
+    REQUIRE(std::chrono::steady_clock::now() - start < 5s);
+}
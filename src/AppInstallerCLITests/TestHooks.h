@@ -27,6 +27,11 @@ namespace AppInstaller
     {
         void TestHook_SetSourceFactoryOverride(const std::string& type, std::function<std::unique_ptr<ISourceFactory>()>&& factory);
         void TestHook_ClearSourceFactoryOverrides();
+
+        namespace Microsoft
+        {
+            void TestHook_SetSharedSourceDataTrusted(bool value);
+        }
     }
 
     namespace Logging
@@ -37,8 +37,10 @@
 #include <Resources.h>
 #include <AppInstallerFileLogger.h>
 #include <Commands/ValidateCommand.h>
+#include <OperationCheckpoint.h>
 #include <winget/Settings.h>
 
+using namespace std::chrono_literals;
 using namespace winrt::Windows::Foundation;
 using namespace winrt::Windows::Management::Deployment;
 using namespace TestCommon;
@@ -492,6 +494,38 @@ void OverrideForShellExecute(TestContext& context, int expectedUseCount = -1)
     OverrideForUpdateInstallerMotw(context);
 }
 
+void OverrideForOverlappedInstall(TestContext& context, std::chrono::milliseconds downloadLatency, std::chrono::milliseconds snapshotLatency, std::atomic<size_t>& snapshotCount)
+{
+    OverrideForCheckExistingInstaller(context);
+
+    context.Override({ DownloadInstallerFile, [downloadLatency](TestContext& context)
+    {
+        std::this_thread::sleep_for(downloadLatency);
+        context.Add<Data::HashPair>({ {}, {} });
+        context.Add<Data::InstallerPath>(TestDataFile("AppInstallerTestExeInstaller.exe"));
+    } });
+
+    context.Override({ RenameDownloadedInstaller, [](TestContext&)
+    {
+    } });
+
+    OverrideForUpdateInstallerMotw(context);
+
+    context.Override({ SnapshotARPEntries, [snapshotLatency, &snapshotCount](TestContext& context)
+    {
+        if (!context.Contains(Data::ARPSnapshot))
+        {
+            std::this_thread::sleep_for(snapshotLatency);
+            ++snapshotCount;
+            context.Add<Data::ARPSnapshot>({});
+        }
+    } });
+
+    context.Override({ ReportARPChanges, [](TestContext&)
+    {
+    } });
+}
+
 void OverrideForShellExecute(TestContext& context, std::vector<Dependency>& installationLog)
 {
     context.Override({ DownloadInstallerFile, [&installationLog](TestContext& context)
@@ -574,6 +608,15 @@ void OverrideForMSIX(TestContext& context)
     } });
 }
 
+// A stub installer that fails, as for a package in the middle of a batch that could not be installed.
+void OverrideForFailingMSIX(TestContext& context)
+{
+    context.Override({ MsixInstall, [](TestContext& context)
+    {
+        context.Terminate(HRESULT_FROM_WIN32(ERROR_INSTALL_FAILURE));
+    } });
+}
+
 void OverrideForMSIXUninstall(TestContext& context)
 {
     context.Override({ MsixUninstall, [](TestContext& context)
@@ -713,6 +756,69 @@ TEST_CASE("InstallFlowNonZeroExitCode", "[InstallFlow][workflow]")
     REQUIRE(installResultStr.find("/silentwithprogress") != std::string::npos);
 }
 
+TEST_CASE("InstallFlow_OverlappedWorkflowTasks", "[InstallFlow][workflow]")
+{
+    TestCommon::TempFile installResultPath("TestExeInstalled.txt");
+    TestUserSettings settings;
+    settings.Set<Setting::EFOverlappedWorkflowTasks>(true);
+
+    std::atomic<size_t> snapshotCount{ 0 };
+    std::ostringstream installOutput;
+    TestContext context{ installOutput, std::cin };
+    OverrideForOverlappedInstall(context, 0ms, 0ms, snapshotCount);
+    context.Args.AddArg(Execution::Args::Type::Manifest, TestDataFile("InstallFlowTest_Exe.yaml").GetPath().u8string());
+
+    InstallCommand install({});
+    install.Execute(context);
+    INFO(installOutput.str());
+
+    // The snapshot taken during the download is the one used for the install.
+    REQUIRE(context.GetTerminationHR() == S_OK);
+    REQUIRE(std::filesystem::exists(installResultPath.GetPath()));
+    REQUIRE(snapshotCount == 1);
+}
+
+TEST_CASE("InstallFlow_OverlappedWorkflowTasks_Benchmark", "[.]")
+{
+    constexpr size_t iterations = 5;
+    constexpr auto downloadLatency = 300ms;
+    constexpr auto snapshotLatency = 200ms;
+
+    auto measure = [&](bool overlapped)
+    {
+        std::chrono::milliseconds total{};
+
+        for (size_t i = 0; i < iterations; ++i)
+        {
+            TestCommon::TempFile installResultPath("TestExeInstalled.txt");
+            TestUserSettings settings;
+            settings.Set<Setting::EFOverlappedWorkflowTasks>(overlapped);
+
+            std::atomic<size_t> snapshotCount{ 0 };
+            std::ostringstream installOutput;
+            TestContext context{ installOutput, std::cin };
+            OverrideForOverlappedInstall(context, downloadLatency, snapshotLatency, snapshotCount);
+            context.Args.AddArg(Execution::Args::Type::Manifest, TestDataFile("InstallFlowTest_Exe.yaml").GetPath().u8string());
+
+            auto start = std::chrono::steady_clock::now();
+            InstallCommand install({});
+            install.Execute(context);
+            total += std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+            REQUIRE(context.GetTerminationHR() == S_OK);
+        }
+
+        return total / iterations;
+    };
+
+    std::chrono::milliseconds sequential = measure(false);
+    std::chrono::milliseconds overlapped = measure(true);
+
+    WARN("Install with " << downloadLatency.count() << " ms download and " << snapshotLatency.count() << " ms ARP snapshot\n" <<
+        "Sequential: " << sequential.count() << " ms\n" <<
+        "Overlapped: " << overlapped.count() << " ms");
+}
+
 TEST_CASE("InstallFlow_ExpectedReturnCodes", "[InstallFlow][workflow]")
 {
     TestCommon::TempFile installResultPath("TestExeInstalled.txt");
@@ -1522,6 +1628,143 @@ TEST_CASE("UpdateFlow_UpdateAllApplicable", "[UpdateFlow][workflow]")
     REQUIRE(std::filesystem::exists(updateMSStoreResultPath.GetPath()));
 }
 
+TEST_CASE("UpdateFlow_UpdateAllResume", "[UpdateFlow][workflow]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+
+    {
+        TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
+        TestCommon::TempFile updateMSStoreResultPath("TestMSStoreUpdated.txt");
+
+        std::ostringstream updateOutput;
+        TestContext context{ updateOutput, std::cin };
+        OverrideForCompositeInstalledSource(context);
+        OverrideForShellExecute(context);
+        OverrideForFailingMSIX(context);
+        OverrideForMSStore(context, true);
+        context.Args.AddArg(Execution::Args::Type::All);
+
+        UpgradeCommand update({});
+        update.Execute(context);
+        INFO(updateOutput.str());
+
+        REQUIRE_TERMINATED_WITH(context, APPINSTALLER_CLI_ERROR_UPDATE_ALL_HAS_FAILURE);
+        REQUIRE(std::filesystem::exists(updateExeResultPath.GetPath()));
+        REQUIRE(std::filesystem::exists(updateMSStoreResultPath.GetPath()));
+    }
+
+    // Only the package that failed is left
+    auto checkpoint = OperationCheckpoint::Load("upgrade --all");
+    REQUIRE(checkpoint);
+    REQUIRE(checkpoint->Packages.size() == 3);
+    REQUIRE(checkpoint->GetCompletedCount() == 2);
+
+    {
+        TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
+        TestCommon::TempFile updateMsixResultPath("TestMsixInstalled.txt");
+        TestCommon::TempFile updateMSStoreResultPath("TestMSStoreUpdated.txt");
+
+        std::ostringstream updateOutput;
+        TestContext context{ updateOutput, std::cin };
+        OverrideForCompositeInstalledSource(context);
+        OverrideForShellExecute(context);
+        OverrideForMSIX(context);
+        OverrideForMSStore(context, true);
+        context.Args.AddArg(Execution::Args::Type::All);
+        context.Args.AddArg(Execution::Args::Type::Resume);
+
+        UpgradeCommand update({});
+        update.Execute(context);
+        INFO(updateOutput.str());
+
+        REQUIRE(!context.IsTerminated());
+        REQUIRE(updateOutput.str().find(Resource::LocString(Resource::String::CheckpointResumed).get()) != std::string::npos);
+        REQUIRE(!std::filesystem::exists(updateExeResultPath.GetPath()));
+        REQUIRE(std::filesystem::exists(updateMsixResultPath.GetPath()));
+        REQUIRE(!std::filesystem::exists(updateMSStoreResultPath.GetPath()));
+    }
+
+    // Nothing is left to resume
+    REQUIRE(!OperationCheckpoint::Load("upgrade --all"));
+}
+
+TEST_CASE("UpdateFlow_UpdateAllResumeWithoutCheckpoint", "[UpdateFlow][workflow]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+
+    TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
+    TestCommon::TempFile updateMsixResultPath("TestMsixInstalled.txt");
+
+    std::ostringstream updateOutput;
+    TestContext context{ updateOutput, std::cin };
+    OverrideForCompositeInstalledSource(context);
+    OverrideForShellExecute(context);
+    OverrideForMSIX(context);
+    OverrideForMSStore(context, true);
+    context.Args.AddArg(Execution::Args::Type::All);
+    context.Args.AddArg(Execution::Args::Type::Resume);
+
+    UpgradeCommand update({});
+    update.Execute(context);
+    INFO(updateOutput.str());
+
+    // Everything is updated, as without --resume
+    REQUIRE(updateOutput.str().find(Resource::LocString(Resource::String::CheckpointNotFound).get()) != std::string::npos);
+    REQUIRE(std::filesystem::exists(updateExeResultPath.GetPath()));
+    REQUIRE(std::filesystem::exists(updateMsixResultPath.GetPath()));
+    REQUIRE(!OperationCheckpoint::Load("upgrade --all"));
+}
+
+TEST_CASE("UpdateFlow_UpdateAllResume_Benchmark", "[.]")
+{
+    // The exe installer takes time to download; the msix installer fails in the first run.
+    constexpr auto downloadLatency = 500ms;
+    std::atomic<size_t> snapshotCount = 0;
+
+    auto runUpgrade = [&](bool failMsix, bool resume)
+    {
+        std::ostringstream updateOutput;
+        TestContext context{ updateOutput, std::cin };
+        OverrideForCompositeInstalledSource(context);
+        OverrideForOverlappedInstall(context, downloadLatency, 0ms, snapshotCount);
+        if (failMsix)
+        {
+            OverrideForFailingMSIX(context);
+        }
+        else
+        {
+            OverrideForMSIX(context);
+        }
+        OverrideForMSStore(context, true);
+        context.Args.AddArg(Execution::Args::Type::All);
+        if (resume)
+        {
+            context.Args.AddArg(Execution::Args::Type::Resume);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        UpgradeCommand update({});
+        update.Execute(context);
+        return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+    };
+
+    TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
+    TestCommon::TempFile updateMsixResultPath("TestMsixInstalled.txt");
+    TestCommon::TempFile updateMSStoreResultPath("TestMSStoreUpdated.txt");
+
+    RemoveSetting(Stream::OperationCheckpoints);
+    auto interrupted = runUpgrade(true, false);
+    auto rerun = runUpgrade(false, false);
+
+    RemoveSetting(Stream::OperationCheckpoints);
+    runUpgrade(true, false);
+    auto resumed = runUpgrade(false, true);
+
+    WARN("Interrupted run: " << interrupted.count() << " ms\n" <<
+        "Rerun from the beginning: " << rerun.count() << " ms\n" <<
+        "Resumed run: " << resumed.count() << " ms");
+}
+
 TEST_CASE("UpdateFlow_UpgradeWithDuplicateUpgradeItemsFound", "[UpdateFlow][workflow]")
 {
     TestCommon::TempFile updateExeResultPath("TestExeInstalled.txt");
@@ -1896,6 +2139,54 @@ TEST_CASE("ImportFlow_IgnoreVersions", "[ImportFlow][workflow]")
     REQUIRE(std::filesystem::exists(exeInstallResultPath.GetPath()));
 }
 
+TEST_CASE("ImportFlow_Resume", "[ImportFlow][workflow]")
+{
+    RemoveSetting(Stream::OperationCheckpoints);
+    std::string importFile = TestDataFile("ImportFile-Good.json").GetPath().string();
+
+    {
+        TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
+
+        std::ostringstream importOutput;
+        TestContext context{ importOutput, std::cin };
+        OverrideForImportSource(context);
+        OverrideForFailingMSIX(context);
+        OverrideForShellExecute(context);
+        context.Args.AddArg(Execution::Args::Type::ImportFile, importFile);
+
+        ImportCommand importCommand({});
+        importCommand.Execute(context);
+        INFO(importOutput.str());
+
+        REQUIRE_TERMINATED_WITH(context, APPINSTALLER_CLI_ERROR_IMPORT_INSTALL_FAILED);
+        REQUIRE(std::filesystem::exists(exeInstallResultPath.GetPath()));
+    }
+
+    {
+        TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
+        TestCommon::TempFile msixInstallResultPath("TestMsixInstalled.txt");
+
+        std::ostringstream importOutput;
+        TestContext context{ importOutput, std::cin };
+        OverrideForImportSource(context);
+        OverrideForMSIX(context);
+        OverrideForShellExecute(context);
+        context.Args.AddArg(Execution::Args::Type::ImportFile, importFile);
+        context.Args.AddArg(Execution::Args::Type::Resume);
+
+        ImportCommand importCommand({});
+        importCommand.Execute(context);
+        INFO(importOutput.str());
+
+        // Only the package that failed is installed again
+        REQUIRE(!context.IsTerminated());
+        REQUIRE(!std::filesystem::exists(exeInstallResultPath.GetPath()));
+        REQUIRE(std::filesystem::exists(msixInstallResultPath.GetPath()));
+    }
+
+    RemoveSetting(Stream::OperationCheckpoints);
+}
+
 TEST_CASE("ImportFlow_MissingSource", "[ImportFlow][workflow]")
 {
     TestCommon::TempFile exeInstallResultPath("TestExeInstalled.txt");
@@ -0,0 +1,257 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "TestCommon.h"
+#include <AppInstallerStrings.h>
+#include <YamlFastParser.h>
+
+using namespace std::string_view_literals;
+using namespace TestCommon;
+using namespace AppInstaller::YAML;
+
+namespace
+{
+    void RequireSameNode(const Node& actual, const Node& expected)
+    {
+        REQUIRE(actual.IsDefined() == expected.IsDefined());
+
+        if (!expected.IsDefined())
+        {
+            return;
+        }
+
+        INFO("Expected node at line " << expected.Mark().line << ", column " << expected.Mark().column);
+        REQUIRE(actual.Mark().line == expected.Mark().line);
+        REQUIRE(actual.Mark().column == expected.Mark().column);
+        REQUIRE(actual.IsScalar() == expected.IsScalar());
+        REQUIRE(actual.IsSequence() == expected.IsSequence());
+        REQUIRE(actual.IsMap() == expected.IsMap());
+
+        if (expected.IsScalar())
+        {
+            REQUIRE(actual.as<std::string>() == expected.as<std::string>());
+        }
+        else if (expected.IsSequence())
+        {
+            REQUIRE(actual.Sequence().size() == expected.Sequence().size());
+
+            for (size_t i = 0; i < expected.Sequence().size(); ++i)
+            {
+                RequireSameNode(actual.Sequence()[i], expected.Sequence()[i]);
+            }
+        }
+        else if (expected.IsMap())
+        {
+            REQUIRE(actual.Mapping().size() == expected.Mapping().size());
+
+            for (auto actualItr = actual.Mapping().begin(), expectedItr = expected.Mapping().begin(); expectedItr != expected.Mapping().end(); ++actualItr, ++expectedItr)
+            {
+                RequireSameNode(actualItr->first, expectedItr->first);
+                RequireSameNode(actualItr->second, expectedItr->second);
+            }
+        }
+    }
+
+    void RequireSameAsLibYaml(std::string_view input)
+    {
+        INFO(input);
+        auto actual = FastParser::TryLoad(input);
+        REQUIRE(actual);
+        RequireSameNode(actual.value(), FastParser::LoadWithLibYaml(input));
+    }
+
+    void RequireFallback(std::string_view input)
+    {
+        INFO(input);
+        REQUIRE(!FastParser::TryLoad(input));
+    }
+
+    // Reads all of the YAML files in the test data, without any UTF-8 byte order mark.
+    std::vector<std::pair<std::filesystem::path, std::string>> ReadTestDataYamlFiles()
+    {
+        std::vector<std::pair<std::filesystem::path, std::string>> result;
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(TestDataFile{ "." }.GetPath()))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".yaml")
+            {
+                std::ifstream stream{ entry.path(), std::ios::binary };
+                std::string contents = AppInstaller::Utility::ReadEntireStream(stream);
+
+                if (contents.compare(0, 3, "\xEF\xBB\xBF") == 0)
+                {
+                    contents.erase(0, 3);
+                }
+
+                result.emplace_back(entry.path(), std::move(contents));
+            }
+        }
+
+        return result;
+    }
+}
+
+TEST_CASE("YamlFastParser_TestDataMatchesLibYaml", "[yaml]")
+{
+    size_t parsed = 0;
+
+    for (const auto& file : ReadTestDataYamlFiles())
+    {
+        INFO(file.first);
+        auto actual = FastParser::TryLoad(file.second);
+
+        if (actual)
+        {
+            Node expected;
+            REQUIRE_NOTHROW(expected = FastParser::LoadWithLibYaml(file.second));
+            RequireSameNode(actual.value(), expected);
+            ++parsed;
+        }
+    }
+
+    // Nearly every manifest should be within the subset.
+    REQUIRE(parsed > 50);
+}
+
+TEST_CASE("YamlFastParser_Empty", "[yaml]")
+{
+    for (std::string_view input : { ""sv, "\n\n"sv, "# Comment\n  # Another\n"sv })
+    {
+        auto actual = FastParser::TryLoad(input);
+        REQUIRE(actual);
+        REQUIRE(!actual->IsDefined());
+    }
+}
+
+TEST_CASE("YamlFastParser_Structure", "[yaml]")
+{
+    RequireSameAsLibYaml("Key: Value\nOther: Value # Comment\n");
+    RequireSameAsLibYaml("  Key: Value\n  Nested:\n    Inner: 1\n\n  # Comment\n  Last: 2");
+    RequireSameAsLibYaml("Key:\n- One\n-  Two\n- Three: 3\n  Four: 4\n-\n  - Five\n");
+    RequireSameAsLibYaml("Key:\n  - One: 1\n    Two:\n      - A\n      - B\n  -   Three: 3\n      Four: 4\nLast: Value");
+    RequireSameAsLibYaml("- A\n- B\n");
+    RequireSameAsLibYaml("Key: Value\r\nOther:\r\n  - Value\r\n");
+    RequireSameAsLibYaml("Key: Value   \nKey: Duplicate");
+}
+
+TEST_CASE("YamlFastParser_PlainScalars", "[yaml]")
+{
+    RequireSameAsLibYaml("Url: https://example.com/path#anchor?q=1\nColon: a:b\nHash: a#b");
+    RequireSameAsLibYaml("Negative: -1\nQuestion: ?a\nColon: :a\nBrackets: a[b]{c},d\n");
+    RequireSameAsLibYaml("Key with spaces   : Value with  spaces # Comment # More");
+    RequireSameAsLibYaml(u8"\u041A\u043B\u044E\u0447: \u0437\u043D\u0430\u0447\u0435\u043D\u0438\u0435\nKey: \u4E2D\u6587 \U0001F600\nLast: \u00FC");
+}
+
+TEST_CASE("YamlFastParser_QuotedScalars", "[yaml]")
+{
+    RequireSameAsLibYaml(R"(Key: "Tab\tNew\nQuote\"Slash\\\/Space\ Hex\x41\u00e9\U0001F600\N\_\L\P\0\a\b\v\f\r\e" # Comment)");
+    RequireSameAsLibYaml("Key: \"  spaced \t \"\nOther: \"#not a comment\"#comment");
+    RequireSameAsLibYaml("Key: 'It''s'\nOther: '\"\\n'   # Comment\nLast: ''");
+    RequireSameAsLibYaml("- \"A\"\n- 'B'\n");
+}
+
+TEST_CASE("YamlFastParser_LiteralScalars", "[yaml]")
+{
+    RequireSameAsLibYaml("Key: |\n  Line 1\n\n    Indented\n  Line 3\nNext: Value");
+    RequireSameAsLibYaml("Key: |-\n  Stripped\n\n\nNext: Value");
+    RequireSameAsLibYaml("Key: |+\n  Kept\n\n\nNext: Value");
+    RequireSameAsLibYaml("Key: |+\n  Kept\n\n  ");
+    RequireSameAsLibYaml("Key: | # Comment\n\n  \n  After empty lines\n  # Not a comment\n# Comment\nNext: Value");
+    RequireSameAsLibYaml("Key: |\n  Trailing spaces   \n     \n  End");
+    RequireSameAsLibYaml("Key: |\n  No final line break");
+    RequireSameAsLibYaml("Key: |\nNext: Empty");
+    RequireSameAsLibYaml("Key: |");
+    RequireSameAsLibYaml("- |\n First\n- |-\n  Second\n  Line\n- Key: |\n    Third\n  Other: 1\n");
+    RequireSameAsLibYaml("Key: |\r\n  Line 1\r\n  Line 2\r\n");
+}
+
+TEST_CASE("YamlFastParser_FallsBackOutsideSubset", "[yaml]")
+{
+    // Other YAML features
+    RequireFallback("Key: &anchor Value\nOther: *anchor");
+    RequireFallback("Key: !!str Value");
+    RequireFallback("Key: [1, 2]");
+    RequireFallback("Key: {a: 1}");
+    RequireFallback("Key: >\n  Folded\n");
+    RequireFallback("Key: |2\n   Indented\n");
+    RequireFallback("---\nKey: Value");
+    RequireFallback("Key: Value\n...\n");
+    RequireFallback("%YAML 1.2\n---\nKey: Value");
+    RequireFallback("? Key\n: Value");
+    RequireFallback("\"Quoted key\": Value");
+    RequireFallback("- - Nested");
+    RequireFallback("Just a scalar");
+
+    // Multi-line and empty values
+    RequireFallback("Key: Multi\n  line");
+    RequireFallback("Key: \"Multi\n  line\"");
+    RequireFallback("Key:\nOther: Value");
+    RequireFallback("Key:");
+    RequireFallback("-\n- Value");
+
+    // Characters and whitespace
+    RequireFallback("Key:\tValue");
+    RequireFallback("\tKey: Value");
+    RequireFallback("Key: |\n\tTab\n");
+    RequireFallback("Key: Value\rOther: Value");
+    RequireFallback("Key: \x01");
+    RequireFallback("Key: \xC3");
+    RequireFallback("Key: \xC0\x80");
+    RequireFallback("Key: \xC2\x85");
+    RequireFallback("Key: \xEF\xBB\xBFValue");
+
+    // Invalid YAML
+    RequireFallback("Key: Value\n  Other: Value");
+    RequireFallback("Key: Value: Other");
+    RequireFallback("Key: \"Value\" Other");
+    RequireFallback("Key: \"\\q\"");
+    RequireFallback("Key: \"\\uD800\"");
+}
+
+TEST_CASE("YamlFastParser_LoadMatchesLibYaml", "[yaml]")
+{
+    // Load uses the fast parser, including after removing a byte order mark.
+    std::string input = "Key: Value\nList:\n  - 1\n  - 2\n";
+    RequireSameNode(Load(input), FastParser::LoadWithLibYaml(input));
+    RequireSameNode(Load("\xEF\xBB\xBF" + input), FastParser::LoadWithLibYaml(input));
+}
+
+TEST_CASE("YamlFastParser_Benchmark", "[.]")
+{
+    auto files = ReadTestDataYamlFiles();
+    constexpr size_t iterations = 100;
+    size_t bytes = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& file : files)
+        {
+            bytes += file.second.size();
+            auto result = FastParser::TryLoad(file.second);
+        }
+    }
+    auto fastTime = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& file : files)
+        {
+            try
+            {
+                auto result = FastParser::LoadWithLibYaml(file.second);
+            }
+            catch (...) {}
+        }
+    }
+    auto libYamlTime = std::chrono::steady_clock::now() - start;
+
+    auto megabytesPerSecond = [&](std::chrono::steady_clock::duration time)
+    {
+        return (static_cast<double>(bytes) / (1024 * 1024)) / std::chrono::duration<double>(time).count();
+    };
+
+    WARN("Fast parser: " << std::chrono::duration_cast<std::chrono::milliseconds>(fastTime).count() << " ms, " << megabytesPerSecond(fastTime) << " MB/s\n" <<
+        "libyaml: " << std::chrono::duration_cast<std::chrono::milliseconds>(libYamlTime).count() << " ms, " << megabytesPerSecond(libYamlTime) << " MB/s");
+}
@@ -714,6 +714,51 @@ TEST_CASE("MultifileManifestInputValidation", "[ManifestValidation]")
     }
 }
 
+void AddScalarField(Node& node, std::string name, std::string value)
+{
+    Node key{ Node::Type::Scalar, "", Mark() };
+    key.SetScalar(std::move(name));
+    node.AddMappingNode(std::move(key), Node::Type::Scalar, "", Mark()).SetScalar(std::move(value));
+}
+
+std::string GetManifestErrorMessage(std::function<void()> parse)
+{
+    try
+    {
+        parse();
+    }
+    catch (const ManifestException& e)
+    {
+        return e.GetManifestErrorMessage();
+    }
+
+    return {};
+}
+
+TEST_CASE("MultiFileManifestPopulatedAsMerged", "[ManifestValidation]")
+{
+    auto v1VersionManifest = CreateYamlManifestInfo("ManifestV1-MultiFile-Version.yaml");
+    auto v1InstallerManifest = CreateYamlManifestInfo("ManifestV1-MultiFile-Installer.yaml");
+    auto v1DefaultLocaleManifest = CreateYamlManifestInfo("ManifestV1-MultiFile-DefaultLocale.yaml");
+    auto v1LocaleManifest = CreateYamlManifestInfo("ManifestV1-MultiFile-Locale.yaml");
+
+    // Scope is also in the installer manifest, and the locale manifest already has Copyright
+    AddScalarField(v1DefaultLocaleManifest.Root, "Scope", "user");
+    AddScalarField(v1LocaleManifest.Root, "copyright", "Other Copyright");
+
+    TempFile mergedManifestFile{ "merged.yaml" };
+    std::vector<YamlManifestInfo> input = { v1VersionManifest, v1InstallerManifest, v1DefaultLocaleManifest, v1LocaleManifest };
+    std::string multiFileErrors = GetManifestErrorMessage([&]() { YamlParser::ParseManifest(input, {}, mergedManifestFile); });
+
+    REQUIRE(multiFileErrors.find("Duplicate field found in the manifest. Field: Scope") != std::string::npos);
+    REQUIRE(multiFileErrors.find("Duplicate field found in the manifest. Field: Copyright") != std::string::npos);
+    REQUIRE(multiFileErrors.find("All field names should be PascalCased. Field: copyright") != std::string::npos);
+
+    // The documents are populated in place, with the same errors in the same order as for the merged manifest
+    std::string mergedErrors = GetManifestErrorMessage([&]() { YamlParser::CreateFromPath(mergedManifestFile); });
+    REQUIRE(multiFileErrors == mergedErrors);
+}
+
 TEST_CASE("ManifestApplyLocale", "[ManifestValidation]")
 {
     Manifest manifest = YamlParser::CreateFromPath(TestDataFile("Manifest-Good-MultiLocale.yaml"));
@@ -735,4 +780,77 @@ TEST_CASE("ManifestApplyLocale", "[ManifestValidation]")
     REQUIRE(manifest.CurrentLocalization.Locale == "fr-FR");
     REQUIRE(manifest.CurrentLocalization.Get<Localization::PackageName>() == "fr-FR package name");
     REQUIRE(manifest.CurrentLocalization.Get<Localization::Publisher>() == "es-MX publisher");
-}
\ No newline at end of file
+}
+
+TEST_CASE("ManifestParseAndPopulate_Benchmark", "[.]")
+{
+    constexpr size_t iterations = 100;
+
+    // The corpus is every singleton manifest in the test data, good or bad, and the multi file manifests
+    std::vector<std::string> singletonManifests;
+    std::vector<std::vector<std::string>> multiFileManifests;
+    size_t bytes = 0;
+
+    auto readFile = [&](const std::filesystem::path& path)
+    {
+        std::ifstream stream{ path, std::ios::binary };
+        std::string contents = ReadEntireStream(stream);
+        bytes += contents.size();
+        return contents;
+    };
+
+    for (const auto& entry : std::filesystem::directory_iterator(TestDataFile{ "." }.GetPath()))
+    {
+        std::string fileName = entry.path().filename().u8string();
+        if (entry.is_regular_file() && entry.path().extension() == ".yaml" && fileName.find("Manifest") == 0 && fileName.find("MultiFile") == std::string::npos)
+        {
+            singletonManifests.emplace_back(readFile(entry.path()));
+        }
+    }
+
+    for (std::string_view version : { "V1", "V1_1" })
+    {
+        std::vector<std::string> documents;
+        for (std::string_view type : { "Version", "Installer", "DefaultLocale", "Locale" })
+        {
+            documents.emplace_back(readFile(TestDataFile{ "Manifest" + std::string{ version } + "-MultiFile-" + std::string{ type } + ".yaml" }.GetPath()));
+        }
+        multiFileManifests.emplace_back(std::move(documents));
+    }
+
+    size_t manifestCount = 0;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < iterations; ++i)
+    {
+        for (const auto& manifest : singletonManifests)
+        {
+            try
+            {
+                YamlParser::Create(manifest);
+            }
+            catch (...) {}
+            ++manifestCount;
+        }
+
+        for (const auto& documents : multiFileManifests)
+        {
+            std::vector<YamlManifestInfo> input;
+            for (const auto& document : documents)
+            {
+                YamlManifestInfo info;
+                info.Root = AppInstaller::YAML::Load(document);
+                input.emplace_back(std::move(info));
+            }
+
+            YamlParser::ParseManifest(input);
+            ++manifestCount;
+        }
+    }
+
+    auto time = std::chrono::steady_clock::now() - start;
+    double seconds = std::chrono::duration<double>(time).count();
+
+    WARN(manifestCount << " manifests in " << std::chrono::duration_cast<std::chrono::milliseconds>(time).count() << " ms\n" <<
+        (manifestCount / seconds) << " manifests/s, " << ((static_cast<double>(bytes) * iterations / (1024 * 1024)) / seconds) << " MB/s");
+}
@@ -0,0 +1,177 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/ConnectionWarmup.h"
+#include "Public/winget/NetworkConnectivity.h"
+#include "Public/winget/UserSettings.h"
+#include "Public/AppInstallerLogging.h"
+
+namespace AppInstaller::Network
+{
+    namespace
+    {
+        void SendHeadRequest(HINTERNET session, const std::string& url)
+        {
+            URL_COMPONENTSA components{};
+            components.dwStructSize = sizeof(components);
+            components.dwHostNameLength = 1;
+            components.dwUrlPathLength = 1;
+            components.dwExtraInfoLength = 1;
+            THROW_LAST_ERROR_IF(!InternetCrackUrlA(url.c_str(), static_cast<DWORD>(url.length()), 0, &components));
+
+            std::string host{ components.lpszHostName, components.dwHostNameLength };
+            std::string path{ components.lpszUrlPath, components.dwUrlPathLength };
+            path.append(components.lpszExtraInfo, components.dwExtraInfoLength);
+
+            wil::unique_hinternet connection(InternetConnectA(session, host.c_str(), components.nPort, NULL, NULL, INTERNET_SERVICE_HTTP, 0, 0));
+            THROW_LAST_ERROR_IF_NULL_MSG(connection, "InternetConnect() failed.");
+
+            DWORD flags = INTERNET_FLAG_KEEP_CONNECTION | INTERNET_FLAG_NO_CACHE_WRITE | INTERNET_FLAG_RELOAD | INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS;
+            if (components.nScheme == INTERNET_SCHEME_HTTPS)
+            {
+                flags |= INTERNET_FLAG_SECURE;
+            }
+
+            wil::unique_hinternet request(HttpOpenRequestA(connection.get(), "HEAD", path.empty() ? "/" : path.c_str(), NULL, NULL, NULL, flags, 0));
+            THROW_LAST_ERROR_IF_NULL_MSG(request, "HttpOpenRequest() failed.");
+
+            // Nothing waits on the response; it only needs to be read completely for the connection to be kept.
+            DWORD receiveTimeout = static_cast<DWORD>(ConnectTimeout.count());
+            LOG_IF_WIN32_BOOL_FALSE(InternetSetOptionA(request.get(), INTERNET_OPTION_RECEIVE_TIMEOUT, &receiveTimeout, sizeof(receiveTimeout)));
+
+            THROW_LAST_ERROR_IF_MSG(!HttpSendRequestA(request.get(), NULL, 0, NULL, 0), "HttpSendRequest() failed.");
+        }
+    }
+
+    bool IsConnectionWarmUpEnabled()
+    {
+        return Settings::User().Get<Settings::Setting::NetworkWarmUpConnections>();
+    }
+
+    ConnectionWarmup::ConnectionWarmup()
+    {
+        // The warm ups record their results in the connectivity state; creating it first means that it is destroyed
+        // after this instance has waited for them, rather than while they are still running.
+        ConnectivityState::Instance();
+    }
+
+    ConnectionWarmup::~ConnectionWarmup()
+    {
+        // Closing the session ends any warm up that is still in progress, so that waiting on them is quick.
+        // Stopping new warm ups first means that none start while waiting.
+        wil::unique_hinternet session;
+        std::map<std::string, std::shared_future<void>> warmUps;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_stopped = true;
+            session = std::move(m_session);
+            warmUps = std::move(m_warmUps);
+        }
+
+        session.reset();
+        warmUps.clear();
+    }
+
+    ConnectionWarmup& ConnectionWarmup::Instance()
+    {
+        static ConnectionWarmup s_instance;
+        return s_instance;
+    }
+
+    HINTERNET ConnectionWarmup::GetSession()
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        if (!m_session)
+        {
+            m_session = CreateSession();
+        }
+
+        return m_session.get();
+    }
+
+    void ConnectionWarmup::WarmUp(std::string_view url)
+    {
+        std::string host = GetHostKey(url);
+        if (host.empty() || !IsConnectionWarmUpEnabled() || IsOffline() || ConnectivityState::Instance().IsUnreachable(url))
+        {
+            return;
+        }
+
+        HINTERNET session = GetSession();
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        if (m_stopped)
+        {
+            return;
+        }
+
+        auto itr = m_warmUps.find(host);
+        if (itr != m_warmUps.end() && itr->second.wait_for(std::chrono::seconds::zero()) != std::future_status::ready)
+        {
+            return;
+        }
+
+        AICLI_LOG(Core, Info, << "Warming up connection to " << host);
+
+        m_warmUps[host] = std::async(std::launch::async, [session, url = std::string{ url }]()
+            {
+                auto start = std::chrono::steady_clock::now();
+
+                try
+                {
+                    SendHeadRequest(session, url);
+                    ConnectivityState::Instance().RecordReachable(url);
+                    AICLI_LOG(Core, Verbose, << "Connection warmed up in " <<
+                        std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms: " << url);
+                }
+                catch (const wil::ResultException& re)
+                {
+                    // The request that needs the host reports any error; this only makes it fail sooner.
+                    ConnectivityState::Instance().RecordFailure(url, re.GetErrorCode());
+                    AICLI_LOG(Core, Warning, << "Connection warm up failed with " << Logging::SetHRFormat << re.GetErrorCode() << ": " << url);
+                }
+                CATCH_LOG();
+            }).share();
+    }
+
+    void ConnectionWarmup::WaitFor(std::string_view url)
+    {
+        std::shared_future<void> warmUp;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            auto itr = m_warmUps.find(GetHostKey(url));
+            if (itr == m_warmUps.end())
+            {
+                return;
+            }
+
+            warmUp = itr->second;
+        }
+
+        warmUp.wait();
+    }
+
+    wil::unique_hinternet ConnectionWarmup::CreateSession()
+    {
+        wil::unique_hinternet session(InternetOpenA(
+            "winget-cli",
+            INTERNET_OPEN_TYPE_PRECONFIG,
+            NULL,
+            NULL,
+            0));
+        THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
+
+        // Fail quickly when the host cannot be reached, rather than after the default timeout and retries.
+        DWORD connectTimeout = static_cast<DWORD>(ConnectTimeout.count());
+        LOG_IF_WIN32_BOOL_FALSE(InternetSetOptionA(session.get(), INTERNET_OPTION_CONNECT_TIMEOUT, &connectTimeout, sizeof(connectTimeout)));
+        DWORD connectRetries = 1;
+        LOG_IF_WIN32_BOOL_FALSE(InternetSetOptionA(session.get(), INTERNET_OPTION_CONNECT_RETRIES, &connectRetries, sizeof(connectRetries)));
+
+        return session;
+    }
+}
@@ -9,7 +9,7 @@ namespace AppInstaller::Manifest
     DependencyGraph::DependencyGraph(const Dependency& root, const DependencyList& rootDependencies,
         std::function<const DependencyList(const Dependency&)> infoFunction) : m_root(root), getDependencies(infoFunction)
     {
-        m_adjacents[m_root] = std::set<Dependency>();
+        AddNode(m_root);
         m_toCheck = std::vector<Dependency>();
         rootDependencies.ApplyToType(DependencyType::Package, [&](Dependency dependency)
             {
@@ -22,7 +22,7 @@ namespace AppInstaller::Manifest
 
     DependencyGraph::DependencyGraph(const Dependency& root, std::function<const DependencyList(const Dependency&)> infoFunction) : m_root(root), getDependencies(infoFunction)
     {
-        m_adjacents[m_root] = std::set<Dependency>();
+        AddNode(m_root);
         m_toCheck = std::vector<Dependency>();
     }
 
@@ -67,18 +67,19 @@ namespace AppInstaller::Manifest
 
     void DependencyGraph::AddNode(const Dependency& node)
     {
-        m_adjacents[node] = std::set<Dependency>();
+        GetOrAddNodeId(node);
     }
 
     void DependencyGraph::AddAdjacent(const Dependency& node, const Dependency& adjacent)
     {
-        m_adjacents[node].emplace(adjacent);
+        NodeId nodeId = GetOrAddNodeId(node);
+        NodeId adjacentId = GetOrAddNodeId(adjacent);
+        m_adjacents[nodeId].push_back(adjacentId);
     }
 
     bool DependencyGraph::HasNode(const Dependency& dependency)
     {
-        auto search = m_adjacents.find(dependency);
-        return search != m_adjacents.end();
+        return m_nodeIds.find(dependency.Id) != m_nodeIds.end();
     }
 
     bool DependencyGraph::HasLoop()
@@ -86,49 +87,120 @@ namespace AppInstaller::Manifest
         return m_HasLoop;
     }
 
+    // Runs an iterative version of Tarjan's strongly connected components algorithm from the root, which visits each
+    // node and edge once. The installation order is the order in which nodes finish (all of their dependencies have
+    // been visited), and every component with more than one node, or a node that depends on itself, is a loop.
     void DependencyGraph::CheckForLoopsAndGetOrder()
     {
+        constexpr size_t Unvisited = std::numeric_limits<size_t>::max();
+
         m_installationOrder = std::vector<Dependency>();
-        std::set<Dependency> visited;
-        m_HasLoop = HasLoopDFS(visited, m_root);
-    }
+        m_loops = std::vector<std::vector<Dependency>>();
+        m_HasLoop = false;
 
-    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
-    {
-        return m_installationOrder;
-    }
+        // Visit dependencies in identifier order (and once each) so that the installation order is deterministic.
+        for (auto& adjacents : m_adjacents)
+        {
+            std::sort(adjacents.begin(), adjacents.end(), [&](NodeId a, NodeId b) { return m_nodes[a].Id < m_nodes[b].Id; });
+            adjacents.erase(std::unique(adjacents.begin(), adjacents.end()), adjacents.end());
+        }
 
-    // TODO make this function iterative
-    bool DependencyGraph::HasLoopDFS(std::set<Dependency> visited, const Dependency& node)
-    {
-        bool loop = false;
+        struct Frame
+        {
+            NodeId Node;
+            size_t NextAdjacent;
+        };
+
+        std::vector<size_t> index(m_nodes.size(), Unvisited);
+        std::vector<size_t> lowLink(m_nodes.size(), 0);
+        std::vector<bool> onStack(m_nodes.size(), false);
+        std::vector<NodeId> componentStack;
+        std::vector<Frame> callStack;
+        size_t nextIndex = 0;
+
+        auto visit = [&](NodeId node)
+        {
+            index[node] = lowLink[node] = nextIndex++;
+            componentStack.push_back(node);
+            onStack[node] = true;
+            callStack.push_back(Frame{ node, 0 });
+        };
+
+        visit(GetOrAddNodeId(m_root));
 
-        visited.insert(node);
-        auto lAdjacents = m_adjacents.at(node);
-        for (const auto& adjacent : m_adjacents.at(node))
+        while (!callStack.empty())
         {
-            auto search = visited.find(adjacent);
-            if (search == visited.end()) // if not found
+            Frame& frame = callStack.back();
+            NodeId node = frame.Node;
+            const auto& adjacents = m_adjacents[node];
+
+            if (frame.NextAdjacent < adjacents.size())
             {
-                if (HasLoopDFS(visited, adjacent))
+                NodeId adjacent = adjacents[frame.NextAdjacent++];
+
+                if (index[adjacent] == Unvisited)
                 {
-                    loop = true;
-                    // didn't break the loop to have a complete order at the end (even if a loop exists)
+                    // Invalidates frame
+                    visit(adjacent);
                 }
+                else if (onStack[adjacent])
+                {
+                    lowLink[node] = std::min(lowLink[node], index[adjacent]);
+                }
+
+                continue;
             }
-            else
+
+            callStack.pop_back();
+            m_installationOrder.push_back(m_nodes[node]);
+
+            if (!callStack.empty())
             {
-                loop = true;
-                // didn't break the loop to have a complete order at the end (even if a loop exists)
+                NodeId parent = callStack.back().Node;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[node]);
+            }
+
+            if (lowLink[node] == index[node])
+            {
+                std::vector<Dependency> component;
+                NodeId member = Unvisited;
+
+                do
+                {
+                    member = componentStack.back();
+                    componentStack.pop_back();
+                    onStack[member] = false;
+                    component.push_back(m_nodes[member]);
+                } while (member != node);
+
+                if (component.size() > 1 || std::find(adjacents.begin(), adjacents.end(), node) != adjacents.end())
+                {
+                    m_HasLoop = true;
+                    m_loops.emplace_back(std::move(component));
+                }
             }
         }
+    }
 
-        // Adding to have an order even if a loop is present
-        if (std::find(m_installationOrder.begin(), m_installationOrder.end(), node) == m_installationOrder.end())
+    std::vector<Dependency> DependencyGraph::GetInstallationOrder()
+    {
+        return m_installationOrder;
+    }
+
+    std::vector<std::vector<Dependency>> DependencyGraph::GetLoops()
+    {
+        return m_loops;
+    }
+
+    DependencyGraph::NodeId DependencyGraph::GetOrAddNodeId(const Dependency& node)
+    {
+        auto [itr, inserted] = m_nodeIds.emplace(node.Id, m_nodes.size());
+        if (inserted)
         {
-            m_installationOrder.push_back(node);
+            m_nodes.push_back(node);
+            m_adjacents.emplace_back();
         }
 
-        return loop;
+        return itr->second;
     }
-}
\ No newline at end of file
+}
@@ -8,6 +8,8 @@
 #include "Public/AppInstallerStrings.h"
 #include "Public/AppInstallerLogging.h"
 #include "Public/AppInstallerTelemetry.h"
+#include "Public/winget/ConnectionWarmup.h"
+#include "Public/winget/NetworkConnectivity.h"
 #include "Public/winget/UserSettings.h"
 #include "DODownloader.h"
 
@@ -24,22 +26,29 @@ namespace AppInstaller::Utility
     {
         AICLI_LOG(Core, Info, << "WinINet downloading from url: " << url);
 
-        wil::unique_hinternet session(InternetOpenA(
-            "winget-cli",
-            INTERNET_OPEN_TYPE_PRECONFIG,
-            NULL,
-            NULL,
-            0));
-        THROW_LAST_ERROR_IF_NULL_MSG(session, "InternetOpen() failed.");
+        // The callers have checked that the host can be used.
+        Network::ConnectivityState& connectivity = Network::ConnectivityState::Instance();
+
+        // Downloads share a session, so that they can use the connections that were kept alive or warmed up.
+        Network::ConnectionWarmup& warmup = Network::ConnectionWarmup::Instance();
+        warmup.WaitFor(url);
 
         wil::unique_hinternet urlFile(InternetOpenUrlA(
-            session.get(),
+            warmup.GetSession(),
             url.c_str(),
             NULL,
             0,
             INTERNET_FLAG_IGNORE_REDIRECT_TO_HTTPS, // This allows http->https redirection
             0));
-        THROW_LAST_ERROR_IF_NULL_MSG(urlFile, "InternetOpenUrl() failed.");
+
+        if (!urlFile)
+        {
+            DWORD error = GetLastError();
+            connectivity.RecordFailure(url, HRESULT_FROM_WIN32(error));
+            THROW_WIN32_MSG(error, "InternetOpenUrl() failed.");
+        }
+
+        connectivity.RecordReachable(url);
 
         // Check http return status
         DWORD requestStatus = 0;
@@ -138,6 +147,7 @@ namespace AppInstaller::Utility
         std::optional<DownloadInfo>)
     {
         THROW_HR_IF(E_INVALIDARG, url.empty());
+        Network::ConnectivityState::Instance().ThrowIfUnavailable(url);
         return WinINetDownloadToStream(url, dest, progress, computeHash);
     }
 
@@ -152,6 +162,9 @@ namespace AppInstaller::Utility
         THROW_HR_IF(E_INVALIDARG, url.empty());
         THROW_HR_IF(E_INVALIDARG, dest.empty());
 
+        // Checked before either downloader is used, so that Delivery Optimization is not attempted either.
+        Network::ConnectivityState::Instance().ThrowIfUnavailable(url);
+
         AICLI_LOG(Core, Info, << "Downloading to path: " << dest);
 
         std::filesystem::create_directories(dest.parent_path());
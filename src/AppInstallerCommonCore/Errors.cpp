@@ -160,6 +160,10 @@ namespace AppInstaller
                 return "Header size exceeds the allowable limit of 1024 characters. Please reduce the size and try again.";
             case APPINSTALLER_CLI_ERROR_MSI_INSTALL_FAILED:
                 return "Running MSI install failed";
+            case APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE:
+                return "Network access is disabled by the offline setting";
+            case APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE:
+                return "The host could not be reached recently; try again later";
             case APPINSTALLER_CLI_ERROR_INSTALL_PACKAGE_IN_USE:
                 return "Application is currently running.Exit the application then try again.";
             case APPINSTALLER_CLI_ERROR_INSTALL_INSTALL_IN_PROGRESS:
@@ -42,6 +42,16 @@ namespace AppInstaller::Settings
                 return userSettings.Get<Setting::EFDependencies>();
             case ExperimentalFeature::Feature::DirectMSI:
                 return userSettings.Get<Setting::EFDirectMSI>();
+            case ExperimentalFeature::Feature::LazySourceOpen:
+                return userSettings.Get<Setting::EFLazySourceOpen>();
+            case ExperimentalFeature::Feature::OverlappedWorkflowTasks:
+                return userSettings.Get<Setting::EFOverlappedWorkflowTasks>();
+            case ExperimentalFeature::Feature::CorrelationMemo:
+                return userSettings.Get<Setting::EFCorrelationMemo>();
+            case ExperimentalFeature::Feature::OperationArenas:
+                return userSettings.Get<Setting::EFOperationArenas>();
+            case ExperimentalFeature::Feature::SearchMemo:
+                return userSettings.Get<Setting::EFSearchMemo>();
             default:
                 THROW_HR(E_UNEXPECTED);
             }
@@ -73,6 +83,16 @@ namespace AppInstaller::Settings
             return ExperimentalFeature{ "Show Dependencies Information", "dependencies", "https://aka.ms/winget-settings", Feature::Dependencies };
         case Feature::DirectMSI:
             return ExperimentalFeature{ "Direct MSI Installation", "directMSI", "https://aka.ms/winget-settings", Feature::DirectMSI };
+        case Feature::LazySourceOpen:
+            return ExperimentalFeature{ "Open Sources On First Use", "lazySourceOpen", "https://aka.ms/winget-settings", Feature::LazySourceOpen };
+        case Feature::OverlappedWorkflowTasks:
+            return ExperimentalFeature{ "Overlapped Workflow Tasks", "overlappedWorkflowTasks", "https://aka.ms/winget-settings", Feature::OverlappedWorkflowTasks };
+        case Feature::CorrelationMemo:
+            return ExperimentalFeature{ "Remember Installed Package Correlations", "correlationMemo", "https://aka.ms/winget-settings", Feature::CorrelationMemo };
+        case Feature::OperationArenas:
+            return ExperimentalFeature{ "Operation Memory Arenas", "operationArenas", "https://aka.ms/winget-settings", Feature::OperationArenas };
+        case Feature::SearchMemo:
+            return ExperimentalFeature{ "Search Memoization", "searchMemo", "https://aka.ms/winget-settings", Feature::SearchMemo };
         default:
             THROW_HR(E_UNEXPECTED);
         }
@@ -244,6 +244,8 @@ namespace AppInstaller::Settings
             return TogglePolicy(policy, "EnableAdditionalSources"sv, String::PolicyAdditionalSources);
         case TogglePolicy::Policy::AllowedSources:
             return TogglePolicy(policy, "EnableAllowedSources"sv, String::PolicyAllowedSources);
+        case TogglePolicy::Policy::SharedSourceData:
+            return TogglePolicy(policy, "EnableSharedSourceData"sv, String::PolicyEnableSharedSourceData, false);
         default:
             THROW_HR(E_UNEXPECTED);
         }
@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "AppInstallerSHA256.h"
 #include "winget/ManifestYamlPopulator.h"
+#include "winget/OperationArena.h"
 
 namespace AppInstaller::Manifest
 {
@@ -115,6 +116,161 @@ namespace AppInstaller::Manifest
 
             return result;
         }
+
+        // Folds the character the same way as Utility::CaseInsensitiveEquals.
+        char FoldFieldNameChar(char c)
+        {
+            return static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+
+        bool FieldNameEquals(std::string_view fieldName, std::string_view name)
+        {
+            if (fieldName.length() != name.length())
+            {
+                return false;
+            }
+
+            for (size_t i = 0; i < name.length(); ++i)
+            {
+                if (FoldFieldNameChar(fieldName[i]) != FoldFieldNameChar(name[i]))
+                {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        // FNV-1a of the case folded name, starting from a seeded offset basis.
+        uint32_t HashFieldName(std::string_view name, uint32_t seed)
+        {
+            uint32_t result = 2166136261u ^ (seed * 0x9E3779B9u);
+
+            for (char c : name)
+            {
+                result ^= static_cast<unsigned char>(FoldFieldNameChar(c));
+                result *= 16777619u;
+            }
+
+            return result ^ (result >> 16);
+        }
+
+        // The number of seeds tried for a slot count before doubling it.
+        constexpr uint32_t s_MaxFieldTableSeedAttempts = 1024;
+    }
+
+    ManifestYamlPopulator::FieldTable::FieldTable(std::vector<FieldProcessInfo> fieldInfos)
+    {
+        // Names are matched case insensitively, so only the first of names that differ by case could ever be found.
+        for (auto& fieldInfo : fieldInfos)
+        {
+            if (std::none_of(m_fieldInfos.begin(), m_fieldInfos.end(), [&](const FieldProcessInfo& existing) { return FieldNameEquals(existing.Name, fieldInfo.Name); }))
+            {
+                m_fieldInfos.emplace_back(std::move(fieldInfo));
+            }
+        }
+
+        THROW_HR_IF(E_UNEXPECTED, m_fieldInfos.size() >= std::numeric_limits<uint16_t>::max());
+
+        if (m_fieldInfos.empty())
+        {
+            return;
+        }
+
+        // The tables are small and built once, so search for a seed that gives every field its own slot.
+        size_t slotCount = 1;
+        while (slotCount < m_fieldInfos.size() * 2)
+        {
+            slotCount *= 2;
+        }
+
+        for (;; slotCount *= 2)
+        {
+            for (uint32_t seed = 0; seed < s_MaxFieldTableSeedAttempts; ++seed)
+            {
+                if (TryAssignSlots(seed, slotCount))
+                {
+                    return;
+                }
+            }
+        }
+    }
+
+    bool ManifestYamlPopulator::FieldTable::TryAssignSlots(uint32_t seed, size_t slotCount)
+    {
+        m_slots.assign(slotCount, 0);
+
+        for (size_t i = 0; i < m_fieldInfos.size(); ++i)
+        {
+            uint16_t& slot = m_slots[HashFieldName(m_fieldInfos[i].Name, seed) & (slotCount - 1)];
+
+            if (slot != 0)
+            {
+                return false;
+            }
+
+            slot = static_cast<uint16_t>(i + 1);
+        }
+
+        m_seed = seed;
+        return true;
+    }
+
+    size_t ManifestYamlPopulator::FieldTable::Find(std::string_view name) const
+    {
+        if (m_slots.empty())
+        {
+            return Size();
+        }
+
+        uint16_t slot = m_slots[HashFieldName(name, m_seed) & (m_slots.size() - 1)];
+
+        // Any other name that hashes to the slot is not a field
+        if (slot == 0 || !FieldNameEquals(m_fieldInfos[slot - 1].Name, name))
+        {
+            return Size();
+        }
+
+        return slot - 1;
+    }
+
+    ManifestYamlPopulator::FieldTables::FieldTables(const ManifestVer& manifestVersion) :
+        Root(GetRootFieldProcessInfo(manifestVersion)),
+        Installer(GetInstallerFieldProcessInfo(manifestVersion)),
+        Switches(GetSwitchesFieldProcessInfo(manifestVersion)),
+        ExpectedReturnCodes(GetExpectedReturnCodesFieldProcessInfo(manifestVersion)),
+        Dependencies(GetDependenciesFieldProcessInfo(manifestVersion)),
+        PackageDependencies(GetPackageDependenciesFieldProcessInfo(manifestVersion)),
+        Localization(GetLocalizationFieldProcessInfo(manifestVersion)),
+        Agreement(GetAgreementFieldProcessInfo(manifestVersion)),
+        Markets(GetMarketsFieldProcessInfo(manifestVersion)),
+        AppsAndFeaturesEntry(GetAppsAndFeaturesEntryFieldProcessInfo(manifestVersion))
+    {
+    }
+
+    const ManifestYamlPopulator::FieldTables& ManifestYamlPopulator::GetFieldTables(const ManifestVer& manifestVersion)
+    {
+        static const ManifestVer s_v1{ s_ManifestVersionV1 };
+        static const ManifestVer s_v1_1{ s_ManifestVersionV1_1 };
+
+        // The field process info functions only check these properties of the version, so they identify the tables.
+        uint32_t key = static_cast<uint32_t>(std::min<uint64_t>(manifestVersion.Major(), 2));
+        key |= (manifestVersion >= s_v1 ? 0x4 : 0);
+        key |= (manifestVersion >= s_v1_1 ? 0x8 : 0);
+        key |= (manifestVersion.HasExtension(s_MSStoreExtension) ? 0x10 : 0);
+
+        static std::mutex s_lock;
+        static std::map<uint32_t, std::unique_ptr<const FieldTables>> s_tables;
+
+        std::lock_guard<std::mutex> lock{ s_lock };
+
+        auto& tables = s_tables[key];
+        if (!tables)
+        {
+            tables = std::make_unique<const FieldTables>(manifestVersion);
+        }
+
+        return *tables;
     }
 
     std::vector<ManifestYamlPopulator::FieldProcessInfo> ManifestYamlPopulator::GetRootFieldProcessInfo(const ManifestVer& manifestVersion)
@@ -122,10 +278,10 @@ namespace AppInstaller::Manifest
         // Common fields across versions
         std::vector<FieldProcessInfo> result =
         {
-            { "ManifestVersion", [](const YAML::Node&)->ValidationErrors { /* ManifestVersion already populated. Field listed here for duplicate and PascalCase check */ return {}; } },
-            { "Installers", [this](const YAML::Node& value)->ValidationErrors { m_p_installersNode = &value; return {}; } },
-            { "Localization", [this](const YAML::Node& value)->ValidationErrors { m_p_localizationsNode = &value; return {}; } },
-            { "Channel", [this](const YAML::Node& value)->ValidationErrors { m_p_manifest->Channel = Utility::Trim(value.as<std::string>()); return {}; } },
+            { "ManifestVersion", [](ManifestYamlPopulator&, const YAML::Node&)->ValidationErrors { /* ManifestVersion already populated. Field listed here for duplicate and PascalCase check */ return {}; } },
+            { "Installers", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installersNode = &value; return {}; } },
+            { "Localization", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localizationsNode = &value; return {}; } },
+            { "Channel", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_manifest->Channel = Utility::Trim(value.as<std::string>()); return {}; } },
         };
 
         // Additional version specific fields
@@ -133,9 +289,9 @@ namespace AppInstaller::Manifest
         {
             std::vector<FieldProcessInfo> previewRootFields
             {
-                { "Id", [this](const YAML::Node& value)->ValidationErrors { m_p_manifest->Id = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "Version", [this](const YAML::Node& value)->ValidationErrors { m_p_manifest->Version = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "AppMoniker", [this](const YAML::Node& value)->ValidationErrors {  m_p_manifest->Moniker = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "Id", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_manifest->Id = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "Version", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_manifest->Version = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "AppMoniker", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors {  populator.m_p_manifest->Moniker = Utility::Trim(value.as<std::string>()); return {}; } },
             };
 
             std::move(previewRootFields.begin(), previewRootFields.end(), std::inserter(result, result.end()));
@@ -147,10 +303,10 @@ namespace AppInstaller::Manifest
             {
                 std::vector<FieldProcessInfo> v1RootFields
                 {
-                    { "PackageIdentifier", [this](const YAML::Node& value)->ValidationErrors { m_p_manifest->Id = Utility::Trim(value.as<std::string>()); return {}; } },
-                    { "PackageVersion", [this](const YAML::Node& value)->ValidationErrors { m_p_manifest->Version = Utility::Trim(value.as<std::string>()); return {}; } },
-                    { "Moniker", [this](const YAML::Node& value)->ValidationErrors {  m_p_manifest->Moniker = Utility::Trim(value.as<std::string>()); return {}; } },
-                    { "ManifestType", [](const YAML::Node&)->ValidationErrors { /* ManifestType already checked. Field listed here for duplicate and PascalCase check */ return {}; } },
+                    { "PackageIdentifier", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_manifest->Id = Utility::Trim(value.as<std::string>()); return {}; } },
+                    { "PackageVersion", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_manifest->Version = Utility::Trim(value.as<std::string>()); return {}; } },
+                    { "Moniker", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors {  populator.m_p_manifest->Moniker = Utility::Trim(value.as<std::string>()); return {}; } },
+                    { "ManifestType", [](ManifestYamlPopulator&, const YAML::Node&)->ValidationErrors { /* ManifestType already checked. Field listed here for duplicate and PascalCase check */ return {}; } },
                 };
 
                 std::move(v1RootFields.begin(), v1RootFields.end(), std::inserter(result, result.end()));
@@ -172,9 +328,9 @@ namespace AppInstaller::Manifest
         // Common fields across versions
         std::vector<FieldProcessInfo> result =
         {
-            { "InstallerType", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->InstallerType = ConvertToInstallerTypeEnum(value.as<std::string>()); return {}; } },
-            { "PackageFamilyName", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->PackageFamilyName = value.as<std::string>(); return {}; } },
-            { "ProductCode", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->ProductCode = value.as<std::string>(); return {}; } },
+            { "InstallerType", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->InstallerType = ConvertToInstallerTypeEnum(value.as<std::string>()); return {}; } },
+            { "PackageFamilyName", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->PackageFamilyName = value.as<std::string>(); return {}; } },
+            { "ProductCode", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->ProductCode = value.as<std::string>(); return {}; } },
         };
 
         // Additional version specific fields
@@ -183,8 +339,8 @@ namespace AppInstaller::Manifest
             // Root level and Localization node level
             std::vector<FieldProcessInfo> previewCommonFields =
             {
-                { "UpdateBehavior", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->UpdateBehavior = ConvertToUpdateBehaviorEnum(value.as<std::string>()); return {}; } },
-                { "Switches", [this](const YAML::Node& value)->ValidationErrors { m_p_switches = &(m_p_installer->Switches); return ValidateAndProcessFields(value, SwitchesFieldInfos); } },
+                { "UpdateBehavior", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->UpdateBehavior = ConvertToUpdateBehaviorEnum(value.as<std::string>()); return {}; } },
+                { "Switches", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_switches = &(populator.m_p_installer->Switches); return populator.ValidateAndProcessFields(value, populator.m_fieldTables->Switches); } },
             };
 
             std::move(previewCommonFields.begin(), previewCommonFields.end(), std::inserter(result, result.end()));
@@ -194,17 +350,17 @@ namespace AppInstaller::Manifest
                 // Installer node only
                 std::vector<FieldProcessInfo> installerOnlyFields =
                 {
-                    { "Arch", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Arch = Utility::ConvertToArchitectureEnum(value.as<std::string>()); return {}; } },
-                    { "Url", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Url = value.as<std::string>(); return {}; } },
-                    { "Sha256", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Sha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
-                    { "SignatureSha256", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->SignatureSha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
-                    { "Language", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Locale = value.as<std::string>(); return {}; } },
-                    { "Scope", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Scope = ConvertToScopeEnum(value.as<std::string>()); return {}; } },
+                    { "Arch", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Arch = Utility::ConvertToArchitectureEnum(value.as<std::string>()); return {}; } },
+                    { "Url", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Url = value.as<std::string>(); return {}; } },
+                    { "Sha256", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Sha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
+                    { "SignatureSha256", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->SignatureSha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
+                    { "Language", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Locale = value.as<std::string>(); return {}; } },
+                    { "Scope", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Scope = ConvertToScopeEnum(value.as<std::string>()); return {}; } },
                 };
 
                 if (manifestVersion.HasExtension(s_MSStoreExtension))
                 {
-                    installerOnlyFields.emplace_back("ProductId", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->ProductId = value.as<std::string>(); return {}; });
+                    installerOnlyFields.emplace_back("ProductId", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->ProductId = value.as<std::string>(); return {}; });
                 }
 
                 std::move(installerOnlyFields.begin(), installerOnlyFields.end(), std::inserter(result, result.end()));
@@ -214,10 +370,10 @@ namespace AppInstaller::Manifest
                 // Root node only
                 std::vector<FieldProcessInfo> rootOnlyFields =
                 {
-                    { "MinOSVersion", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->MinOSVersion = value.as<std::string>(); return {}; } },
-                    { "Commands", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Commands = SplitMultiValueField(value.as<std::string>()); return {}; } },
-                    { "Protocols", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Protocols = SplitMultiValueField(value.as<std::string>()); return {}; } },
-                    { "FileExtensions", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->FileExtensions = SplitMultiValueField(value.as<std::string>()); return {}; } },
+                    { "MinOSVersion", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->MinOSVersion = value.as<std::string>(); return {}; } },
+                    { "Commands", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Commands = SplitMultiValueField(value.as<std::string>()); return {}; } },
+                    { "Protocols", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Protocols = SplitMultiValueField(value.as<std::string>()); return {}; } },
+                    { "FileExtensions", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->FileExtensions = SplitMultiValueField(value.as<std::string>()); return {}; } },
                 };
 
                 std::move(rootOnlyFields.begin(), rootOnlyFields.end(), std::inserter(result, result.end()));
@@ -231,20 +387,20 @@ namespace AppInstaller::Manifest
                 // Root level and Installer node level
                 std::vector<FieldProcessInfo> v1CommonFields =
                 {
-                    { "InstallerLocale", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Locale = value.as<std::string>(); return {}; } },
-                    { "Platform", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Platform = ProcessPlatformSequenceNode(value); return {}; } },
-                    { "MinimumOSVersion", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->MinOSVersion = value.as<std::string>(); return {}; } },
-                    { "Scope", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Scope = ConvertToScopeEnum(value.as<std::string>()); return {}; } },
-                    { "InstallModes", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->InstallModes = ProcessInstallModeSequenceNode(value); return {}; } },
-                    { "InstallerSwitches", [this](const YAML::Node& value)->ValidationErrors { m_p_switches = &(m_p_installer->Switches); return ValidateAndProcessFields(value, SwitchesFieldInfos); } },
-                    { "InstallerSuccessCodes", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->InstallerSuccessCodes = ProcessInstallerSuccessCodeSequenceNode(value); return {}; } },
-                    { "UpgradeBehavior", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->UpdateBehavior = ConvertToUpdateBehaviorEnum(value.as<std::string>()); return {}; } },
-                    { "Commands", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Commands = ProcessStringSequenceNode(value); return {}; } },
-                    { "Protocols", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Protocols = ProcessStringSequenceNode(value); return {}; } },
-                    { "FileExtensions", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->FileExtensions = ProcessStringSequenceNode(value); return {}; } },
-                    { "Dependencies", [this](const YAML::Node& value)->ValidationErrors { m_p_dependencyList = &(m_p_installer->Dependencies); return ValidateAndProcessFields(value, DependenciesFieldInfos); } },
-                    { "Capabilities", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Capabilities = ProcessStringSequenceNode(value); return {}; } },
-                    { "RestrictedCapabilities", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->RestrictedCapabilities = ProcessStringSequenceNode(value); return {}; } },
+                    { "InstallerLocale", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Locale = value.as<std::string>(); return {}; } },
+                    { "Platform", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Platform = ProcessPlatformSequenceNode(value); return {}; } },
+                    { "MinimumOSVersion", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->MinOSVersion = value.as<std::string>(); return {}; } },
+                    { "Scope", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Scope = ConvertToScopeEnum(value.as<std::string>()); return {}; } },
+                    { "InstallModes", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->InstallModes = ProcessInstallModeSequenceNode(value); return {}; } },
+                    { "InstallerSwitches", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_switches = &(populator.m_p_installer->Switches); return populator.ValidateAndProcessFields(value, populator.m_fieldTables->Switches); } },
+                    { "InstallerSuccessCodes", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->InstallerSuccessCodes = ProcessInstallerSuccessCodeSequenceNode(value); return {}; } },
+                    { "UpgradeBehavior", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->UpdateBehavior = ConvertToUpdateBehaviorEnum(value.as<std::string>()); return {}; } },
+                    { "Commands", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Commands = ProcessStringSequenceNode(value); return {}; } },
+                    { "Protocols", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Protocols = ProcessStringSequenceNode(value); return {}; } },
+                    { "FileExtensions", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->FileExtensions = ProcessStringSequenceNode(value); return {}; } },
+                    { "Dependencies", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_dependencyList = &(populator.m_p_installer->Dependencies); return populator.ValidateAndProcessFields(value, populator.m_fieldTables->Dependencies); } },
+                    { "Capabilities", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Capabilities = ProcessStringSequenceNode(value); return {}; } },
+                    { "RestrictedCapabilities", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->RestrictedCapabilities = ProcessStringSequenceNode(value); return {}; } },
                 };
 
                 std::move(v1CommonFields.begin(), v1CommonFields.end(), std::inserter(result, result.end()));
@@ -254,10 +410,10 @@ namespace AppInstaller::Manifest
                     // Installer level only fields
                     std::vector<FieldProcessInfo> v1InstallerFields =
                     {
-                        { "Architecture", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Arch = Utility::ConvertToArchitectureEnum(value.as<std::string>()); return {}; } },
-                        { "InstallerUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Url = value.as<std::string>(); return {}; } },
-                        { "InstallerSha256", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->Sha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
-                        { "SignatureSha256", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->SignatureSha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
+                        { "Architecture", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Arch = Utility::ConvertToArchitectureEnum(value.as<std::string>()); return {}; } },
+                        { "InstallerUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Url = value.as<std::string>(); return {}; } },
+                        { "InstallerSha256", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->Sha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
+                        { "SignatureSha256", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->SignatureSha256 = Utility::SHA256::ConvertToBytes(value.as<std::string>()); return {}; } },
                     };
 
                     std::move(v1InstallerFields.begin(), v1InstallerFields.end(), std::inserter(result, result.end()));
@@ -268,15 +424,15 @@ namespace AppInstaller::Manifest
             {
                 std::vector<FieldProcessInfo> fields_v1_1 =
                 {
-                    { "InstallerAbortsTerminal", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->InstallerAbortsTerminal = value.as<bool>(); return {}; } },
-                    { "InstallLocationRequired", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->InstallLocationRequired = value.as<bool>(); return {}; } },
-                    { "RequireExplicitUpgrade", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->RequireExplicitUpgrade = value.as<bool>(); return {}; } },
-                    { "ReleaseDate", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->ReleaseDate = Utility::Trim(value.as<std::string>()); return {}; } },
-                    { "UnsupportedOSArchitectures", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->UnsupportedOSArchitectures = ProcessArchitectureSequenceNode(value); return {}; } },
-                    { "ElevationRequirement", [this](const YAML::Node& value)->ValidationErrors { m_p_installer->ElevationRequirement = ConvertToElevationRequirementEnum(value.as<std::string>()); return {}; } },
-                    { "Markets", [this](const YAML::Node& value)->ValidationErrors { return ProcessMarketsNode(value); } },
-                    { "AppsAndFeaturesEntries", [this](const YAML::Node& value)->ValidationErrors { return ProcessAppsAndFeaturesEntriesNode(value); } },
-                    { "ExpectedReturnCodes", [this](const YAML::Node& value)->ValidationErrors { return ProcessExpectedReturnCodesNode(value); } },
+                    { "InstallerAbortsTerminal", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->InstallerAbortsTerminal = value.as<bool>(); return {}; } },
+                    { "InstallLocationRequired", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->InstallLocationRequired = value.as<bool>(); return {}; } },
+                    { "RequireExplicitUpgrade", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->RequireExplicitUpgrade = value.as<bool>(); return {}; } },
+                    { "ReleaseDate", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->ReleaseDate = Utility::Trim(value.as<std::string>()); return {}; } },
+                    { "UnsupportedOSArchitectures", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->UnsupportedOSArchitectures = ProcessArchitectureSequenceNode(value); return {}; } },
+                    { "ElevationRequirement", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_installer->ElevationRequirement = ConvertToElevationRequirementEnum(value.as<std::string>()); return {}; } },
+                    { "Markets", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { return populator.ProcessMarketsNode(value); } },
+                    { "AppsAndFeaturesEntries", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { return populator.ProcessAppsAndFeaturesEntriesNode(value); } },
+                    { "ExpectedReturnCodes", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { return populator.ProcessExpectedReturnCodesNode(value); } },
                 };
 
                 std::move(fields_v1_1.begin(), fields_v1_1.end(), std::inserter(result, result.end()));
@@ -291,24 +447,24 @@ namespace AppInstaller::Manifest
         // Common fields across versions
         std::vector<FieldProcessInfo> result =
         {
-            { "Custom", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Custom] = value.as<std::string>(); return{}; } },
-            { "Silent", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Silent] = value.as<std::string>(); return{}; } },
-            { "SilentWithProgress", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::SilentWithProgress] = value.as<std::string>(); return{}; } },
-            { "Interactive", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Interactive] = value.as<std::string>(); return{}; } },
-            { "Log", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Log] = value.as<std::string>(); return{}; } },
-            { "InstallLocation", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::InstallLocation] = value.as<std::string>(); return{}; } },
+            { "Custom", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Custom] = value.as<std::string>(); return{}; } },
+            { "Silent", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Silent] = value.as<std::string>(); return{}; } },
+            { "SilentWithProgress", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::SilentWithProgress] = value.as<std::string>(); return{}; } },
+            { "Interactive", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Interactive] = value.as<std::string>(); return{}; } },
+            { "Log", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Log] = value.as<std::string>(); return{}; } },
+            { "InstallLocation", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::InstallLocation] = value.as<std::string>(); return{}; } },
         };
 
         // Additional version specific fields
         if (manifestVersion.Major() == 0)
         {
             // Language only exists in preview manifests. Though we don't use it in our code yet, keep it here to be consistent with schema.
-            result.emplace_back("Language", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Language] = value.as<std::string>(); return{}; });
-            result.emplace_back("Update", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Update] = value.as<std::string>(); return{}; });
+            result.emplace_back("Language", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Language] = value.as<std::string>(); return{}; });
+            result.emplace_back("Update", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Update] = value.as<std::string>(); return{}; });
         }
         else if (manifestVersion.Major() == 1)
         {
-            result.emplace_back("Upgrade", [this](const YAML::Node& value)->ValidationErrors { (*m_p_switches)[InstallerSwitchType::Update] = value.as<std::string>(); return{}; });
+            result.emplace_back("Upgrade", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { (*populator.m_p_switches)[InstallerSwitchType::Update] = value.as<std::string>(); return{}; });
         }
 
         return result;
@@ -320,8 +476,8 @@ namespace AppInstaller::Manifest
 
         if (manifestVersion >= ManifestVer{ s_ManifestVersionV1_1 })
         {
-            result.emplace_back("InstallerReturnCode", [this](const YAML::Node& value)->ValidationErrors { m_p_expectedReturnCode->InstallerReturnCode = static_cast<int>(value.as<int>()); return {}; });
-            result.emplace_back("ReturnResponse", [this](const YAML::Node& value)->ValidationErrors { m_p_expectedReturnCode->ReturnResponse = ConvertToExpectedReturnCodeEnum(value.as<std::string>()); return {}; });
+            result.emplace_back("InstallerReturnCode", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_expectedReturnCode->InstallerReturnCode = static_cast<int>(value.as<int>()); return {}; });
+            result.emplace_back("ReturnResponse", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_expectedReturnCode->ReturnResponse = ConvertToExpectedReturnCodeEnum(value.as<std::string>()); return {}; });
         }
 
         return result;
@@ -332,31 +488,31 @@ namespace AppInstaller::Manifest
         // Common fields across versions
         std::vector<FieldProcessInfo> result =
         {
-            { "Description", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Description>(Utility::Trim(value.as<std::string>())); return {}; } },
-            { "LicenseUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::LicenseUrl>(value.as<std::string>()); return {}; } },
+            { "Description", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Description>(Utility::Trim(value.as<std::string>())); return {}; } },
+            { "LicenseUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::LicenseUrl>(value.as<std::string>()); return {}; } },
         };
 
         // Additional version specific fields
         if (manifestVersion.Major() == 0)
         {
             // Root level and Localization node level
-            result.emplace_back("Homepage", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PackageUrl>(value.as<std::string>()); return {}; });
+            result.emplace_back("Homepage", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PackageUrl>(value.as<std::string>()); return {}; });
 
             if (!forRootFields)
             {
                 // Localization node only
-                result.emplace_back("Language", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Locale = value.as<std::string>(); return {}; });
+                result.emplace_back("Language", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Locale = value.as<std::string>(); return {}; });
             }
             else
             {
                 // Root node only
                 std::vector<FieldProcessInfo> rootOnlyFields =
                 {
-                    { "Name", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PackageName>(Utility::Trim(value.as<std::string>())); return {}; } },
-                    { "Publisher", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Publisher>(value.as<std::string>()); return {}; } },
-                    { "Author", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Author>(value.as<std::string>()); return {}; } },
-                    { "License", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::License>(value.as<std::string>()); return {}; } },
-                    { "Tags", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Tags>(SplitMultiValueField(value.as<std::string>())); return {}; } },
+                    { "Name", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PackageName>(Utility::Trim(value.as<std::string>())); return {}; } },
+                    { "Publisher", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Publisher>(value.as<std::string>()); return {}; } },
+                    { "Author", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Author>(value.as<std::string>()); return {}; } },
+                    { "License", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::License>(value.as<std::string>()); return {}; } },
+                    { "Tags", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Tags>(SplitMultiValueField(value.as<std::string>())); return {}; } },
                 };
 
                 std::move(rootOnlyFields.begin(), rootOnlyFields.end(), std::inserter(result, result.end()));
@@ -370,19 +526,19 @@ namespace AppInstaller::Manifest
                 // Root level and Localization node level
                 std::vector<FieldProcessInfo> v1CommonFields =
                 {
-                    { "PackageLocale", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Locale = value.as<std::string>(); return {}; } },
-                    { "Publisher", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Publisher>(value.as<std::string>()); return {}; } },
-                    { "PublisherUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PublisherUrl>(value.as<std::string>()); return {}; } },
-                    { "PublisherSupportUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PublisherSupportUrl>(value.as<std::string>()); return {}; } },
-                    { "PrivacyUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PrivacyUrl>(value.as<std::string>()); return {}; } },
-                    { "Author", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Author>(value.as<std::string>()); return {}; } },
-                    { "PackageName", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PackageName>(Utility::Trim(value.as<std::string>())); return {}; } },
-                    { "PackageUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::PackageUrl>(value.as<std::string>()); return {}; } },
-                    { "License", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::License>(value.as<std::string>()); return {}; } },
-                    { "Copyright", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Copyright>(value.as<std::string>()); return {}; } },
-                    { "CopyrightUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::CopyrightUrl>(value.as<std::string>()); return {}; } },
-                    { "ShortDescription", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::ShortDescription>(Utility::Trim(value.as<std::string>())); return {}; } },
-                    { "Tags", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::Tags>(ProcessStringSequenceNode(value)); return {}; } },
+                    { "PackageLocale", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Locale = value.as<std::string>(); return {}; } },
+                    { "Publisher", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Publisher>(value.as<std::string>()); return {}; } },
+                    { "PublisherUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PublisherUrl>(value.as<std::string>()); return {}; } },
+                    { "PublisherSupportUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PublisherSupportUrl>(value.as<std::string>()); return {}; } },
+                    { "PrivacyUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PrivacyUrl>(value.as<std::string>()); return {}; } },
+                    { "Author", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Author>(value.as<std::string>()); return {}; } },
+                    { "PackageName", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PackageName>(Utility::Trim(value.as<std::string>())); return {}; } },
+                    { "PackageUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::PackageUrl>(value.as<std::string>()); return {}; } },
+                    { "License", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::License>(value.as<std::string>()); return {}; } },
+                    { "Copyright", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Copyright>(value.as<std::string>()); return {}; } },
+                    { "CopyrightUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::CopyrightUrl>(value.as<std::string>()); return {}; } },
+                    { "ShortDescription", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::ShortDescription>(Utility::Trim(value.as<std::string>())); return {}; } },
+                    { "Tags", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::Tags>(ProcessStringSequenceNode(value)); return {}; } },
                 };
 
                 std::move(v1CommonFields.begin(), v1CommonFields.end(), std::inserter(result, result.end()));
@@ -392,9 +548,9 @@ namespace AppInstaller::Manifest
             {
                 std::vector<FieldProcessInfo> fields_v1_1 =
                 {
-                    { "Agreements", [this](const YAML::Node& value)->ValidationErrors { return ProcessAgreementsNode(value); }, true },
-                    { "ReleaseNotes", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::ReleaseNotes>(value.as<std::string>()); return {}; } },
-                    { "ReleaseNotesUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_localization->Add<Localization::ReleaseNotesUrl>(value.as<std::string>()); return {}; } },
+                    { "Agreements", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { return populator.ProcessAgreementsNode(value); }, true },
+                    { "ReleaseNotes", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::ReleaseNotes>(value.as<std::string>()); return {}; } },
+                    { "ReleaseNotesUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_localization->Add<Localization::ReleaseNotesUrl>(value.as<std::string>()); return {}; } },
                 };
 
                 std::move(fields_v1_1.begin(), fields_v1_1.end(), std::inserter(result, result.end()));
@@ -412,10 +568,10 @@ namespace AppInstaller::Manifest
         {
             result =
             {
-                { "WindowsFeatures", [this](const YAML::Node& value)->ValidationErrors { ProcessDependenciesNode(DependencyType::WindowsFeature, value); return {}; } },
-                { "WindowsLibraries", [this](const YAML::Node& value)->ValidationErrors { ProcessDependenciesNode(DependencyType::WindowsLibrary, value); return {}; } },
-                { "PackageDependencies", [this](const YAML::Node& value)->ValidationErrors { ProcessPackageDependenciesNode(value); return {}; } },
-                { "ExternalDependencies", [this](const YAML::Node& value)->ValidationErrors { ProcessDependenciesNode(DependencyType::External, value); return {}; } },
+                { "WindowsFeatures", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.ProcessDependenciesNode(DependencyType::WindowsFeature, value); return {}; } },
+                { "WindowsLibraries", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.ProcessDependenciesNode(DependencyType::WindowsLibrary, value); return {}; } },
+                { "PackageDependencies", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.ProcessPackageDependenciesNode(value); return {}; } },
+                { "ExternalDependencies", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.ProcessDependenciesNode(DependencyType::External, value); return {}; } },
             };
         }
 
@@ -439,8 +595,8 @@ namespace AppInstaller::Manifest
         {
             result =
             {
-                { "PackageIdentifier", [this](const YAML::Node& value)->ValidationErrors { m_p_packageDependency->Id = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "MinimumVersion", [this](const YAML::Node& value)->ValidationErrors { m_p_packageDependency->MinVersion = Utility::Version(Utility::Trim(value.as<std::string>())); return {}; } },
+                { "PackageIdentifier", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_packageDependency->Id = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "MinimumVersion", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_packageDependency->MinVersion = Utility::Version(Utility::Trim(value.as<std::string>())); return {}; } },
             };
         }
 
@@ -455,9 +611,9 @@ namespace AppInstaller::Manifest
         {
             result =
             {
-                { "AgreementLabel", [this](const YAML::Node& value)->ValidationErrors { m_p_agreement->Label = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "Agreement", [this](const YAML::Node& value)->ValidationErrors { m_p_agreement->AgreementText = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "AgreementUrl", [this](const YAML::Node& value)->ValidationErrors { m_p_agreement->AgreementUrl = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "AgreementLabel", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_agreement->Label = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "Agreement", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_agreement->AgreementText = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "AgreementUrl", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_agreement->AgreementUrl = Utility::Trim(value.as<std::string>()); return {}; } },
             };
         }
 
@@ -472,8 +628,8 @@ namespace AppInstaller::Manifest
         {
             result =
             {
-                { "AllowedMarkets", [this](const YAML::Node& value)->ValidationErrors { m_p_markets->AllowedMarkets = ProcessStringSequenceNode(value); return {}; } },
-                { "ExcludedMarkets", [this](const YAML::Node& value)->ValidationErrors { m_p_markets->ExcludedMarkets = ProcessStringSequenceNode(value); return {}; } },
+                { "AllowedMarkets", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_markets->AllowedMarkets = ProcessStringSequenceNode(value); return {}; } },
+                { "ExcludedMarkets", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_markets->ExcludedMarkets = ProcessStringSequenceNode(value); return {}; } },
             };
         }
 
@@ -488,12 +644,12 @@ namespace AppInstaller::Manifest
         {
             result =
             {
-                { "DisplayName", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->DisplayName = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "Publisher", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->Publisher = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "DisplayVersion", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->DisplayVersion = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "ProductCode", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->ProductCode = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "UpgradeCode", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->UpgradeCode = Utility::Trim(value.as<std::string>()); return {}; } },
-                { "InstallerType", [this](const YAML::Node& value)->ValidationErrors { m_p_appsAndFeaturesEntry->InstallerType = ConvertToInstallerTypeEnum(value.as<std::string>()); return {}; } },
+                { "DisplayName", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->DisplayName = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "Publisher", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->Publisher = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "DisplayVersion", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->DisplayVersion = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "ProductCode", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->ProductCode = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "UpgradeCode", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->UpgradeCode = Utility::Trim(value.as<std::string>()); return {}; } },
+                { "InstallerType", [](ManifestYamlPopulator& populator, const YAML::Node& value)->ValidationErrors { populator.m_p_appsAndFeaturesEntry->InstallerType = ConvertToInstallerTypeEnum(value.as<std::string>()); return {}; } },
             };
         }
 
@@ -502,34 +658,78 @@ namespace AppInstaller::Manifest
 
     ValidationErrors ManifestYamlPopulator::ValidateAndProcessFields(
         const YAML::Node& rootNode,
-        const std::vector<FieldProcessInfo>& fieldInfos)
+        const FieldTable& fieldInfos)
+    {
+        return ValidateAndProcessFields(&rootNode, nullptr, fieldInfos);
+    }
+
+    ValidationErrors ManifestYamlPopulator::ValidateAndProcessFields(
+        const YAML::Node* rootNode,
+        const YAML::Node* multiFileNode,
+        const FieldTable& fieldInfos)
     {
         ValidationErrors resultErrors;
 
-        if (!rootNode.IsMap() || rootNode.size() == 0)
+        auto isMultiFileManifestCommonField = [](const std::string& key)
         {
-            resultErrors.emplace_back(ManifestError::InvalidRootNode, "", "", m_isMergedManifest ? 0 : rootNode.Mark().line, m_isMergedManifest ? 0 : rootNode.Mark().column);
+            // Like the merging of multi file manifests, this only matches the exact field names.
+            return std::find(MultiFileManifestCommonFields.begin(), MultiFileManifestCommonFields.end(), key) != MultiFileManifestCommonFields.end();
+        };
+
+        const YAML::Node& firstNode = rootNode ? *rootNode : *multiFileNode;
+        bool isEmpty = (!rootNode || rootNode->size() == 0);
+
+        if (multiFileNode && multiFileNode->IsMap() && isEmpty)
+        {
+            isEmpty = std::all_of(multiFileNode->Mapping().begin(), multiFileNode->Mapping().end(),
+                [&](auto const& keyValuePair) { return isMultiFileManifestCommonField(keyValuePair.first.as<std::string>()); });
+        }
+
+        if (!firstNode.IsMap() || (multiFileNode && !multiFileNode->IsMap()) || isEmpty)
+        {
+            resultErrors.emplace_back(ManifestError::InvalidRootNode, "", "", m_isMergedManifest ? 0 : firstNode.Mark().line, m_isMergedManifest ? 0 : firstNode.Mark().column);
             return resultErrors;
         }
 
         // Keeps track of already processed fields. Used to check duplicate fields.
-        std::set<std::string> processedFields;
+        std::pmr::vector<bool> processedFields(fieldInfos.Size(), false, Memory::GetScratchResource());
+
+        // Both mappings are sorted, so walking them together visits the fields in the order of the merged mapping,
+        // where the fields of the root node come before equal fields of the multi file node.
+        using MappingIterator = std::multimap<YAML::Node, YAML::Node>::const_iterator;
+        MappingIterator rootIter{}, rootEnd{}, multiFileIter{}, multiFileEnd{};
 
-        for (auto const& keyValuePair : rootNode.Mapping())
+        if (rootNode)
         {
+            rootIter = rootNode->Mapping().begin();
+            rootEnd = rootNode->Mapping().end();
+        }
+
+        if (multiFileNode)
+        {
+            multiFileIter = multiFileNode->Mapping().begin();
+            multiFileEnd = multiFileNode->Mapping().end();
+        }
+
+        while (rootIter != rootEnd || multiFileIter != multiFileEnd)
+        {
+            bool fromRoot = (multiFileIter == multiFileEnd || (rootIter != rootEnd && !(multiFileIter->first < rootIter->first)));
+            auto const& keyValuePair = (fromRoot ? *rootIter++ : *multiFileIter++);
+
             std::string key = keyValuePair.first.as<std::string>();
             const YAML::Node& valueNode = keyValuePair.second;
 
+            if (!fromRoot && isMultiFileManifestCommonField(key))
+            {
+                continue;
+            }
+
             // We'll do case insensitive search first and validate correct case later.
-            auto fieldIter = std::find_if(fieldInfos.begin(), fieldInfos.end(),
-                [&](auto const& s)
-                {
-                    return Utility::CaseInsensitiveEquals(s.Name, key);
-                });
+            size_t fieldIndex = fieldInfos.Find(key);
 
-            if (fieldIter != fieldInfos.end())
+            if (fieldIndex != fieldInfos.Size())
             {
-                const FieldProcessInfo& fieldInfo = *fieldIter;
+                const FieldProcessInfo& fieldInfo = fieldInfos[fieldIndex];
 
                 // Make sure the found key is in Pascal Case
                 if (key != fieldInfo.Name)
@@ -538,11 +738,13 @@ namespace AppInstaller::Manifest
                 }
 
                 // Make sure it's not a duplicate key
-                if (!processedFields.insert(fieldInfo.Name).second)
+                if (processedFields[fieldIndex])
                 {
                     resultErrors.emplace_back(ManifestError::FieldDuplicate, fieldInfo.Name, "", m_isMergedManifest ? 0 : keyValuePair.first.Mark().line, m_isMergedManifest ? 0 : keyValuePair.first.Mark().column);
                 }
 
+                processedFields[fieldIndex] = true;
+
                 if (fieldInfo.RequireVerifiedPublisher)
                 {
                     resultErrors.emplace_back(ManifestError::FieldRequireVerifiedPublisher, fieldInfo.Name, "",
@@ -554,7 +756,7 @@ namespace AppInstaller::Manifest
                 {
                     try
                     {
-                        auto errors = fieldInfo.ProcessFunc(valueNode);
+                        auto errors = fieldInfo.ProcessFunc(*this, valueNode);
                         std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
                     }
                     catch (const std::exception&)
@@ -584,7 +786,7 @@ namespace AppInstaller::Manifest
         {
             Dependency packageDependency = Dependency(DependencyType::Package);
             m_p_packageDependency = &packageDependency;
-            auto errors = ValidateAndProcessFields(entry, PackageDependenciesFieldInfos);
+            auto errors = ValidateAndProcessFields(entry, m_fieldTables->PackageDependencies);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
             m_p_dependencyList->Add(std::move(packageDependency));
         }
@@ -603,7 +805,7 @@ namespace AppInstaller::Manifest
         {
             Agreement agreement;
             m_p_agreement = &agreement;
-            auto errors = ValidateAndProcessFields(entry, AgreementFieldInfos);
+            auto errors = ValidateAndProcessFields(entry, m_fieldTables->Agreement);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
             agreements.emplace_back(std::move(agreement));
         }
@@ -620,7 +822,7 @@ namespace AppInstaller::Manifest
     {
         MarketsInfo markets;
         m_p_markets = &markets;
-        auto errors = ValidateAndProcessFields(marketsNode, MarketsFieldInfos);
+        auto errors = ValidateAndProcessFields(marketsNode, m_fieldTables->Markets);
         m_p_installer->Markets = markets;
         return errors;
     }
@@ -636,7 +838,7 @@ namespace AppInstaller::Manifest
         {
             AppsAndFeaturesEntry appsAndFeaturesEntry;
             m_p_appsAndFeaturesEntry = &appsAndFeaturesEntry;
-            auto errors = ValidateAndProcessFields(entry, AppsAndFeaturesEntryFieldInfos);
+            auto errors = ValidateAndProcessFields(entry, m_fieldTables->AppsAndFeaturesEntry);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
             appsAndFeaturesEntries.emplace_back(std::move(appsAndFeaturesEntry));
         }
@@ -657,7 +859,7 @@ namespace AppInstaller::Manifest
         {
             ExpectedReturnCode returnCode;
             m_p_expectedReturnCode = &returnCode;
-            auto errors = ValidateAndProcessFields(entry, ExpectedReturnCodesFieldInfos);
+            auto errors = ValidateAndProcessFields(entry, m_fieldTables->ExpectedReturnCodes);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
 
             if (!returnCodes.insert({ returnCode.InstallerReturnCode, returnCode.ReturnResponse }).second)
@@ -673,33 +875,27 @@ namespace AppInstaller::Manifest
 
     ValidationErrors ManifestYamlPopulator::PopulateManifestInternal(
         const YAML::Node& rootNode,
+        const YAML::Node* defaultLocaleNode,
+        const std::vector<const YAML::Node*>& localeNodes,
         Manifest& manifest,
         const ManifestVer& manifestVersion,
         ManifestValidateOption validateOption)
     {
         m_validateOption = validateOption;
-        m_isMergedManifest = !rootNode["ManifestType"sv].IsNull() && rootNode["ManifestType"sv].as<std::string>() == "merged";
+        // Errors in a multi file manifest are reported the same way as for the merged manifest, since their positions are not in a single document.
+        m_isMergedManifest = defaultLocaleNode || (!rootNode["ManifestType"sv].IsNull() && rootNode["ManifestType"sv].as<std::string>() == "merged");
+        m_fieldTables = &GetFieldTables(manifestVersion);
 
         ValidationErrors resultErrors;
         manifest.ManifestVersion = manifestVersion;
 
-        // Prepare field infos
-        RootFieldInfos = GetRootFieldProcessInfo(manifestVersion);
-        InstallerFieldInfos = GetInstallerFieldProcessInfo(manifestVersion);
-        SwitchesFieldInfos = GetSwitchesFieldProcessInfo(manifestVersion);
-        ExpectedReturnCodesFieldInfos = GetExpectedReturnCodesFieldProcessInfo(manifestVersion);
-        DependenciesFieldInfos = GetDependenciesFieldProcessInfo(manifestVersion);
-        PackageDependenciesFieldInfos = GetPackageDependenciesFieldProcessInfo(manifestVersion);
-        LocalizationFieldInfos = GetLocalizationFieldProcessInfo(manifestVersion);
-        AgreementFieldInfos = GetAgreementFieldProcessInfo(manifestVersion);
-        MarketsFieldInfos = GetMarketsFieldProcessInfo(manifestVersion);
-        AppsAndFeaturesEntryFieldInfos = GetAppsAndFeaturesEntryFieldProcessInfo(manifestVersion);
-
         // Populate root
         m_p_manifest = &manifest;
         m_p_installer = &(manifest.DefaultInstallerInfo);
         m_p_localization = &(manifest.DefaultLocalization);
-        resultErrors = ValidateAndProcessFields(rootNode, RootFieldInfos);
+
+        // The default locale document of a multi file manifest is merged into the root
+        resultErrors = ValidateAndProcessFields(&rootNode, defaultLocaleNode, m_fieldTables->Root);
 
         if (!m_p_installersNode)
         {
@@ -719,7 +915,7 @@ namespace AppInstaller::Manifest
             installer.Dependencies.Clear();
 
             m_p_installer = &installer;
-            auto errors = ValidateAndProcessFields(entry, InstallerFieldInfos);
+            auto errors = ValidateAndProcessFields(entry, m_fieldTables->Installer);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
 
             // Copy in system reference strings from the root if not set in the installer and appropriate
@@ -768,14 +964,25 @@ namespace AppInstaller::Manifest
             manifest.Installers.emplace_back(std::move(installer));
         }
 
-        // Populate additional localizations
-        if (m_p_localizationsNode && m_p_localizationsNode->IsSequence())
+        // Populate additional localizations, which are the locale documents of a multi file manifest
+        if (!localeNodes.empty())
+        {
+            for (const YAML::Node* entry : localeNodes)
+            {
+                ManifestLocalization localization;
+                m_p_localization = &localization;
+                auto errors = ValidateAndProcessFields(nullptr, entry, m_fieldTables->Localization);
+                std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
+                manifest.Localizations.emplace_back(std::move(localization));
+            }
+        }
+        else if (m_p_localizationsNode && m_p_localizationsNode->IsSequence())
         {
             for (auto const& entry : m_p_localizationsNode->Sequence())
             {
                 ManifestLocalization localization;
                 m_p_localization = &localization;
-                auto errors = ValidateAndProcessFields(entry, LocalizationFieldInfos);
+                auto errors = ValidateAndProcessFields(entry, m_fieldTables->Localization);
                 std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
                 manifest.Localizations.emplace_back(std::move(std::move(localization)));
             }
@@ -791,6 +998,18 @@ namespace AppInstaller::Manifest
         ManifestValidateOption validateOption)
     {
         ManifestYamlPopulator manifestPopulator;
-        return manifestPopulator.PopulateManifestInternal(rootNode, manifest, manifestVersion, validateOption);
+        return manifestPopulator.PopulateManifestInternal(rootNode, nullptr, {}, manifest, manifestVersion, validateOption);
+    }
+
+    ValidationErrors ManifestYamlPopulator::PopulateManifest(
+        const YAML::Node& installerNode,
+        const YAML::Node& defaultLocaleNode,
+        const std::vector<const YAML::Node*>& localeNodes,
+        Manifest& manifest,
+        const ManifestVer& manifestVersion,
+        ManifestValidateOption validateOption)
+    {
+        ManifestYamlPopulator manifestPopulator;
+        return manifestPopulator.PopulateManifestInternal(installerNode, &defaultLocaleNode, localeNodes, manifest, manifestVersion, validateOption);
     }
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include "winget/ManifestSchemaValidation.h"
 #include "winget/ManifestYamlPopulator.h"
 #include "winget/ManifestYamlParser.h"
+#include "winget/OperationArena.h"
 
 namespace AppInstaller::Manifest::YamlParser
 {
@@ -305,12 +306,12 @@ namespace AppInstaller::Manifest::YamlParser
             THROW_HR_IF(E_UNEXPECTED, !input.IsMap());
             THROW_HR_IF(E_UNEXPECTED, !destination.IsMap());
 
-            const std::vector<std::string> FieldsToIgnore = { "PackageIdentifier", "PackageVersion", "ManifestType", "ManifestVersion" };
+            const auto& fieldsToIgnore = ManifestYamlPopulator::MultiFileManifestCommonFields;
 
             for (auto const& keyValuePair : input.Mapping())
             {
                 // We only support string type as key in our manifest
-                if (std::find(FieldsToIgnore.begin(), FieldsToIgnore.end(), keyValuePair.first.as<std::string>()) == FieldsToIgnore.end())
+                if (std::find(fieldsToIgnore.begin(), fieldsToIgnore.end(), keyValuePair.first.as<std::string>()) == fieldsToIgnore.end())
                 {
                     YAML::Node key = keyValuePair.first;
                     YAML::Node value = keyValuePair.second;
@@ -426,10 +427,30 @@ namespace AppInstaller::Manifest::YamlParser
                 return resultErrors;
             }
 
-            // Merge manifests in multi file manifest case
-            const YAML::Node& manifestDoc = (input.size() > 1) ? MergeMultiFileManifest(input) : input[0].Root;
+            std::vector<ValidationError> errors;
+
+            if (input.size() > 1)
+            {
+                // Multi file manifests are populated from their documents, without merging them
+                std::vector<const YAML::Node*> localeDocs;
+                for (const auto& entry : input)
+                {
+                    if (entry.ManifestType == ManifestTypeEnum::Locale)
+                    {
+                        localeDocs.emplace_back(&entry.Root);
+                    }
+                }
+
+                errors = ManifestYamlPopulator::PopulateManifest(
+                    FindUniqueRequiredDocFromMultiFileManifest(input, ManifestTypeEnum::Installer),
+                    FindUniqueRequiredDocFromMultiFileManifest(input, ManifestTypeEnum::DefaultLocale),
+                    localeDocs, manifest, manifestVersion, validateOption);
+            }
+            else
+            {
+                errors = ManifestYamlPopulator::PopulateManifest(input[0].Root, manifest, manifestVersion, validateOption);
+            }
 
-            auto errors = ManifestYamlPopulator::PopulateManifest(manifestDoc, manifest, manifestVersion, validateOption);
             std::move(errors.begin(), errors.end(), std::inserter(resultErrors, resultErrors.end()));
 
             // Extra semantic validations after basic validation and field population
@@ -442,7 +463,7 @@ namespace AppInstaller::Manifest::YamlParser
             // Output merged manifest if requested
             if (!mergedManifestPath.empty())
             {
-                OutputYamlDoc(manifestDoc, mergedManifestPath);
+                OutputYamlDoc(MergeMultiFileManifest(input), mergedManifestPath);
             }
 
             // If there is only one input file, use its hash for the stream
@@ -460,6 +481,7 @@ namespace AppInstaller::Manifest::YamlParser
         ManifestValidateOption validateOption,
         const std::filesystem::path& mergedManifestPath)
     {
+        Memory::OperationArenaScope arenaScope;
         std::vector<YamlManifestInfo> docList;
 
         try
@@ -497,6 +519,7 @@ namespace AppInstaller::Manifest::YamlParser
         ManifestValidateOption validateOption,
         const std::filesystem::path& mergedManifestPath)
     {
+        Memory::OperationArenaScope arenaScope;
         std::vector<YamlManifestInfo> docList;
 
         try
@@ -518,6 +541,7 @@ namespace AppInstaller::Manifest::YamlParser
         ManifestValidateOption validateOption,
         const std::filesystem::path& mergedManifestPath)
     {
+        Memory::OperationArenaScope arenaScope;
         Manifest manifest;
         std::vector<ValidationError> errors;
 
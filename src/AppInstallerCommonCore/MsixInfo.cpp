@@ -430,4 +430,39 @@ namespace AppInstaller::Msix
 
         WriteAppxFileToFile(appxFile.Get(), target, progress);
     }
+
+    std::vector<Utility::SHA256::HashBuffer> MsixInfo::GetPayloadFileBlockHashes(std::string_view packageFile)
+    {
+        THROW_HR_IF(E_NOT_VALID_STATE, m_isBundle);
+
+        std::wstring fileUTF16 = Utility::ConvertToUTF16(packageFile);
+
+        ComPtr<IAppxBlockMapReader> blockMapReader;
+        THROW_IF_FAILED(m_packageReader->GetBlockMap(&blockMapReader));
+
+        ComPtr<IAppxBlockMapFile> blockMapFile;
+        THROW_IF_FAILED(blockMapReader->GetFile(fileUTF16.c_str(), &blockMapFile));
+
+        ComPtr<IAppxBlockMapBlocksEnumerator> blocks;
+        THROW_IF_FAILED(blockMapFile->GetBlocks(&blocks));
+
+        std::vector<Utility::SHA256::HashBuffer> result;
+
+        BOOL hasCurrent = FALSE;
+        THROW_IF_FAILED(blocks->GetHasCurrent(&hasCurrent));
+        while (hasCurrent)
+        {
+            ComPtr<IAppxBlockMapBlock> block;
+            THROW_IF_FAILED(blocks->GetCurrent(&block));
+
+            UINT32 hashSize = 0;
+            wil::unique_cotaskmem_ptr<BYTE> hash;
+            THROW_IF_FAILED(block->GetHash(&hashSize, wil::out_param(hash)));
+            result.emplace_back(hash.get(), hash.get() + hashSize);
+
+            THROW_IF_FAILED(blocks->MoveNext(&hasCurrent));
+        }
+
+        return result;
+    }
 }
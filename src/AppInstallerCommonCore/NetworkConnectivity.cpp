@@ -0,0 +1,290 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/NetworkConnectivity.h"
+#include "Public/winget/UserSettings.h"
+#include "Public/winget/Yaml.h"
+#include "Public/AppInstallerDateTime.h"
+#include "Public/AppInstallerDownloader.h"
+#include "Public/AppInstallerErrors.h"
+#include "Public/AppInstallerLogging.h"
+#include "Public/AppInstallerStrings.h"
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Network
+{
+    namespace
+    {
+        constexpr std::string_view s_ConnectivityYaml_Hosts = "Hosts"sv;
+        constexpr std::string_view s_ConnectivityYaml_Host = "Host"sv;
+        constexpr std::string_view s_ConnectivityYaml_UnreachableUntil = "UnreachableUntil"sv;
+
+        constexpr size_t s_MaxSaveAttempts = 10;
+
+        using UnreachableMap = std::map<std::string, std::chrono::system_clock::time_point>;
+
+        UnreachableMap ReadState(Settings::Stream& stream)
+        {
+            UnreachableMap result;
+
+            auto contents = stream.Get();
+            if (!contents)
+            {
+                return result;
+            }
+
+            std::string value = Utility::ReadEntireStream(*contents);
+
+            try
+            {
+                YAML::Node document = YAML::Load(value);
+                YAML::Node hosts = document[s_ConnectivityYaml_Hosts];
+
+                if (!hosts || !hosts.IsSequence())
+                {
+                    return result;
+                }
+
+                for (const auto& host : hosts.Sequence())
+                {
+                    const YAML::Node& name = host[s_ConnectivityYaml_Host];
+                    const YAML::Node& until = host[s_ConnectivityYaml_UnreachableUntil];
+
+                    if (name && name.IsScalar() && until && until.IsScalar())
+                    {
+                        result[name.as<std::string>()] = Utility::ConvertUnixEpochToSystemClock(until.as<int64_t>());
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // The state only avoids waiting on connections that are likely to fail; start over rather than fail.
+                AICLI_LOG(Core, Warning, << "Ignoring invalid network connectivity state (" << e.what() << ")");
+                result.clear();
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool WriteState(Settings::Stream& stream, const UnreachableMap& state)
+        {
+            YAML::Emitter out;
+            out << YAML::BeginMap;
+            out << YAML::Key << s_ConnectivityYaml_Hosts;
+            out << YAML::BeginSeq;
+
+            for (const auto& host : state)
+            {
+                out << YAML::BeginMap;
+                out << YAML::Key << s_ConnectivityYaml_Host << YAML::Value << host.first;
+                out << YAML::Key << s_ConnectivityYaml_UnreachableUntil << YAML::Value << Utility::ConvertSystemClockToUnixEpoch(host.second);
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            return stream.Set(out.str());
+        }
+    }
+
+    bool IsOffline()
+    {
+        return Settings::User().Get<Settings::Setting::NetworkOffline>();
+    }
+
+    bool IsConnectivityError(HRESULT hr)
+    {
+        // WinHTTP uses the same values as WinINet for these errors.
+        return
+            hr == HRESULT_FROM_WIN32(ERROR_INTERNET_TIMEOUT) ||
+            hr == HRESULT_FROM_WIN32(ERROR_INTERNET_NAME_NOT_RESOLVED) ||
+            hr == HRESULT_FROM_WIN32(ERROR_INTERNET_CANNOT_CONNECT) ||
+            hr == HRESULT_FROM_WIN32(ERROR_INTERNET_DISCONNECTED) ||
+            hr == APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE ||
+            hr == APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE;
+    }
+
+    std::string GetHostKey(std::string_view url)
+    {
+        if (!Utility::IsUrlRemote(url))
+        {
+            return {};
+        }
+
+        size_t hostStart = url.find("://"sv) + 3;
+        size_t hostEnd = url.find_first_of("/?#"sv, hostStart);
+        std::string_view authority = url.substr(hostStart, hostEnd == std::string_view::npos ? std::string_view::npos : hostEnd - hostStart);
+
+        size_t userInfoEnd = authority.rfind('@');
+        if (userInfoEnd != std::string_view::npos)
+        {
+            authority = authority.substr(userInfoEnd + 1);
+        }
+
+        std::string result{ url.substr(0, hostStart) };
+        result += authority;
+        return Utility::ToLower(result);
+    }
+
+    ConnectivityState::ConnectivityState(const Settings::StreamDefinition& stream, std::chrono::seconds window, std::chrono::milliseconds refreshInterval) :
+        m_streamDefinition(stream), m_window(window), m_refreshInterval(refreshInterval) {}
+
+    ConnectivityState& ConnectivityState::Instance()
+    {
+        static ConnectivityState s_instance;
+        return s_instance;
+    }
+
+    void ConnectivityState::ThrowIfUnavailable(std::string_view url)
+    {
+        if (GetHostKey(url).empty())
+        {
+            // Not a network location.
+            return;
+        }
+
+        if (IsOffline())
+        {
+            AICLI_LOG(Core, Info, << "Not accessing the network while offline: " << url);
+            THROW_HR(APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE);
+        }
+
+        if (IsUnreachable(url))
+        {
+            AICLI_LOG(Core, Warning, << "Not accessing a host that could not be reached recently: " << url);
+            THROW_HR(APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE);
+        }
+    }
+
+    bool ConnectivityState::IsUnreachable(std::string_view url)
+    {
+        std::string host = GetHostKey(url);
+        if (host.empty())
+        {
+            return false;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+        RefreshIfStale();
+
+        auto itr = m_unreachableUntil.find(host);
+        return (itr != m_unreachableUntil.end() && std::chrono::system_clock::now() < itr->second);
+    }
+
+    void ConnectivityState::RecordUnreachable(std::string_view url)
+    {
+        std::string host = GetHostKey(url);
+        if (!host.empty())
+        {
+            AICLI_LOG(Core, Warning, << "Host could not be reached: " << host);
+            Update(host, std::chrono::system_clock::now() + m_window);
+        }
+    }
+
+    void ConnectivityState::RecordReachable(std::string_view url)
+    {
+        std::string host = GetHostKey(url);
+        if (host.empty())
+        {
+            return;
+        }
+
+        {
+            // Only the hosts seen as unreachable when last read need to be written.
+            std::lock_guard<std::mutex> lock{ m_lock };
+            if (m_unreachableUntil.find(host) == m_unreachableUntil.end())
+            {
+                return;
+            }
+        }
+
+        Update(host, {});
+    }
+
+    void ConnectivityState::RecordFailure(std::string_view url, HRESULT hr)
+    {
+        if (hr != APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE && hr != APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE && IsConnectivityError(hr))
+        {
+            RecordUnreachable(url);
+        }
+    }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    void ConnectivityState::Invalidate()
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        m_unreachableUntil.clear();
+        m_lastRead.reset();
+    }
+#endif
+
+    void ConnectivityState::RefreshIfStale()
+    {
+        // Another process may have found a host unreachable (or reached it again), but reading the state for every
+        // request would cost more than the connection failures that it avoids; so it is only read again once it is stale.
+        auto now = std::chrono::steady_clock::now();
+        if (m_lastRead && now - m_lastRead.value() < m_refreshInterval)
+        {
+            return;
+        }
+
+        try
+        {
+            Settings::Stream stream{ m_streamDefinition };
+            m_unreachableUntil = ReadState(stream);
+        }
+        CATCH_LOG();
+
+        m_lastRead = now;
+    }
+
+    void ConnectivityState::Update(const std::string& host, std::chrono::system_clock::time_point unreachableUntil)
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        auto apply = [&](UnreachableMap& state)
+        {
+            auto now = std::chrono::system_clock::now();
+            for (auto itr = state.begin(); itr != state.end();)
+            {
+                itr = (itr->second <= now ? state.erase(itr) : std::next(itr));
+            }
+
+            if (unreachableUntil > now)
+            {
+                state[host] = unreachableUntil;
+            }
+            else
+            {
+                state.erase(host);
+            }
+        };
+
+        try
+        {
+            // Merge into the latest persisted state so that observations from other processes are kept.
+            Settings::Stream stream{ m_streamDefinition };
+
+            for (size_t i = 0; i < s_MaxSaveAttempts; ++i)
+            {
+                UnreachableMap state = ReadState(stream);
+                apply(state);
+
+                if (WriteState(stream, state))
+                {
+                    m_unreachableUntil = std::move(state);
+                    m_lastRead = std::chrono::steady_clock::now();
+                    return;
+                }
+            }
+
+            AICLI_LOG(Core, Warning, << "Too many attempts at saving network connectivity state");
+        }
+        CATCH_LOG();
+
+        // Keep the observation for this process even if it could not be saved.
+        apply(m_unreachableUntil);
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Public/winget/OperationArena.h"
+#include "Public/winget/ExperimentalFeature.h"
+
+namespace AppInstaller::Memory
+{
+    namespace
+    {
+        thread_local OperationArena* t_currentArena = nullptr;
+
+        // The decision of the outermost OperationArenaSettingScope on the thread; -1 if there is none.
+        thread_local int t_useArenas = -1;
+
+        bool ShouldUseArenas()
+        {
+            if (t_useArenas >= 0)
+            {
+                return t_useArenas != 0;
+            }
+
+            return Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::OperationArenas);
+        }
+    }
+
+    OperationArena::OperationArena(std::pmr::memory_resource* upstream) :
+        m_buffer(InitialBlockSize, upstream)
+    {
+    }
+
+    void* OperationArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        void* result = m_buffer.allocate(bytes, alignment);
+        m_bytesAllocated += bytes;
+        ++m_allocationCount;
+        return result;
+    }
+
+    bool OperationArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+    {
+        return this == &other;
+    }
+
+    OperationArenaSettingScope::OperationArenaSettingScope() :
+        OperationArenaSettingScope(Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::OperationArenas))
+    {
+    }
+
+    OperationArenaSettingScope::OperationArenaSettingScope(bool useArenas)
+    {
+        if (t_useArenas < 0)
+        {
+            t_useArenas = (useArenas ? 1 : 0);
+            m_isOutermost = true;
+        }
+    }
+
+    OperationArenaSettingScope::~OperationArenaSettingScope()
+    {
+        if (m_isOutermost)
+        {
+            t_useArenas = -1;
+        }
+    }
+
+    OperationArenaScope::OperationArenaScope()
+    {
+        // Nested operations are common (searches within searches), so only decide for the outermost one
+        if (!t_currentArena && ShouldUseArenas())
+        {
+            m_arena = std::make_unique<OperationArena>();
+            t_currentArena = m_arena.get();
+        }
+    }
+
+    OperationArenaScope::OperationArenaScope(bool useArena)
+    {
+        if (useArena && !t_currentArena)
+        {
+            m_arena = std::make_unique<OperationArena>();
+            t_currentArena = m_arena.get();
+        }
+    }
+
+    OperationArenaScope::~OperationArenaScope()
+    {
+        if (m_arena)
+        {
+            t_currentArena = nullptr;
+        }
+    }
+
+    OperationArena* GetCurrentArena()
+    {
+        return t_currentArena;
+    }
+
+    std::pmr::memory_resource* GetScratchResource()
+    {
+        return t_currentArena ? t_currentArena : std::pmr::get_default_resource();
+    }
+}
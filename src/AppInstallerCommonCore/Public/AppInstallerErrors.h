@@ -88,6 +88,8 @@
 #define APPINSTALLER_CLI_ERROR_MSI_INSTALL_FAILED               ((HRESULT)0x8A150049)
 #define APPINSTALLER_CLI_ERROR_INVALID_MSIEXEC_ARGUMENT         ((HRESULT)0x8A15004A)
 #define APPINSTALLER_CLI_ERROR_FAILED_TO_OPEN_ALL_SOURCES       ((HRESULT)0x8A15004B)
+#define APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE                  ((HRESULT)0x8A15004C)
+#define APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE                 ((HRESULT)0x8A15004D)
 
 #define APPINSTALLER_CLI_ERROR_INSTALL_PACKAGE_IN_USE           ((HRESULT)0x8A150101)
 #define APPINSTALLER_CLI_ERROR_INSTALL_INSTALL_IN_PROGRESS      ((HRESULT)0x8A150102)
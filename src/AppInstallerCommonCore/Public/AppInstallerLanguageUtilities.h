@@ -114,6 +114,31 @@ namespace AppInstaller
         // Return a value indicating whether the given enum is stored in the map.
         bool Contains(Enum e) const { return (m_data.find(e) != m_data.end()); }
 
+        // Copies the value for the given enum from the other map, overwriting an existing entry.
+        // Does nothing if the other map does not contain the value; throws if the type of the value cannot be copied.
+        void Copy(const EnumBasedVariantMap& other, Enum e)
+        {
+            auto itr = other.m_data.find(e);
+            if (itr != other.m_data.end())
+            {
+                typename Variant::variant_t value;
+                CopyVariant(itr->second, value, std::make_index_sequence<std::variant_size_v<typename Variant::variant_t>>());
+                m_data[e] = std::move(value);
+            }
+        }
+
+        // Moves the value for the given enum out of the other map, overwriting an existing entry.
+        // Does nothing if the other map does not contain the value.
+        void Move(EnumBasedVariantMap& other, Enum e)
+        {
+            auto itr = other.m_data.find(e);
+            if (itr != other.m_data.end())
+            {
+                m_data[e] = std::move(itr->second);
+                other.m_data.erase(itr);
+            }
+        }
+
         // Gets the value.
         template <Enum E>
         mapping_t<E>& Get()
@@ -142,6 +167,26 @@ namespace AppInstaller
             return itr->second;
         }
 
+        // The variant types are not all copyable, so only copy the alternative that is actually held.
+        template <size_t... I>
+        static void CopyVariant(const typename Variant::variant_t& from, typename Variant::variant_t& to, std::index_sequence<I...>)
+        {
+            ((from.index() == I ? CopyAlternative<I>(from, to) : void()), ...);
+        }
+
+        template <size_t I>
+        static void CopyAlternative(const typename Variant::variant_t& from, typename Variant::variant_t& to)
+        {
+            if constexpr (std::is_copy_constructible_v<std::variant_alternative_t<I, typename Variant::variant_t>>)
+            {
+                to.template emplace<I>(std::get<I>(from));
+            }
+            else
+            {
+                THROW_HR_MSG(E_NOT_VALID_STATE, "CopyAlternative(%d)", static_cast<int>(I));
+            }
+        }
+
         std::map<Enum, typename Variant::variant_t> m_data;
     };
 }
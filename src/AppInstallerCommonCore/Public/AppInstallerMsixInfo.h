@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 #include <AppInstallerProgress.h>
+#include <AppInstallerSHA256.h>
 #include <AppxPackaging.h>
 
 #include <wrl/client.h>
@@ -76,6 +77,13 @@ namespace AppInstaller::Msix
         // Writes the package's manifest to the given path.
         void WriteManifestToFile(const std::filesystem::path& target, IProgressCallback& progress);
 
+        // The size of the blocks that payload files are divided into by the block map.
+        static constexpr size_t BlockMapBlockSize = 64 * 1024;
+
+        // Gets the hashes of the blocks of the given package file, as recorded in the block map.
+        // Each hash covers BlockMapBlockSize bytes of the uncompressed file (the last block may be smaller).
+        std::vector<Utility::SHA256::HashBuffer> GetPayloadFileBlockHashes(std::string_view packageFile);
+
     private:
         bool m_isBundle;
         Microsoft::WRL::ComPtr<IStream> m_stream;
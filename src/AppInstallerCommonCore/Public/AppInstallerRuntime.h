@@ -46,6 +46,9 @@ namespace AppInstaller::Runtime
         SecureSettings,
         // The value of %USERPROFILE%.
         UserProfile,
+        // The machine-wide state storage location, shared by all users.
+        // This is not created, as it must be created with restricted access.
+        SharedState,
     };
 
     // Gets the path to the requested location.
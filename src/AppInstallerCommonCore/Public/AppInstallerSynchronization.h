@@ -55,4 +55,23 @@ namespace AppInstaller::Synchronization
 
         std::vector<wil::unique_mutex> m_mutexesHeld;
     };
+
+    // The outcome of a wait that can be cancelled.
+    enum class WaitResult
+    {
+        Signaled,
+        TimedOut,
+        Cancelled,
+    };
+
+    // Waits until the object is signaled, the timeout elapses, or the operation is cancelled; whichever happens first.
+    // Cancellation wakes the wait immediately, as it is delivered through the cancellation function of the progress callback.
+    // That function is replaced for the duration of the wait, so this must not be used while another operation relies on it.
+    // If the object is null, only the timeout and cancellation are waited on.
+    WaitResult WaitForSingleObjectOrCancellation(HANDLE object, IProgressCallback& progress);
+    WaitResult WaitForSingleObjectOrCancellation(HANDLE object, IProgressCallback& progress, std::chrono::milliseconds timeout);
+
+    // Waits for the given duration, returning early if the operation is cancelled.
+    // Returns true if the full duration elapsed; false if cancelled.
+    bool SleepUnlessCancelled(std::chrono::milliseconds duration, IProgressCallback& progress);
 }
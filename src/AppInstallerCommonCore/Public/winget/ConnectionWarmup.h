@@ -0,0 +1,54 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <wil/resource.h>
+
+#include <future>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Network
+{
+    // Determines if connections should be warmed up, as enabled by the settings.
+    bool IsConnectionWarmUpEnabled();
+
+    // Connects to the hosts that a command will need while it does other work, so that the later requests
+    // do not wait on name resolution and connection setup (including the TLS handshake).
+    // The connections are made on the WinINet session that downloads use, which keeps them alive for those requests.
+    // Warm ups that are still running when it is destroyed are ended and waited for.
+    struct ConnectionWarmup
+    {
+        ConnectionWarmup();
+        ~ConnectionWarmup();
+
+        ConnectionWarmup(const ConnectionWarmup&) = delete;
+        ConnectionWarmup& operator=(const ConnectionWarmup&) = delete;
+
+        // Gets the instance used by the process.
+        static ConnectionWarmup& Instance();
+
+        // Gets the WinINet session for downloads.
+        HINTERNET GetSession();
+
+        // Starts connecting to the host of the url in the background, with a HEAD request for the url.
+        // Does nothing if warming up is disabled, if the network cannot be used for the url,
+        // or if a connection to the host is already being warmed up.
+        void WarmUp(std::string_view url);
+
+        // Waits for a connection to the host of the url that is being warmed up, so that a request can use it
+        // rather than opening another connection at the same time.
+        void WaitFor(std::string_view url);
+
+    private:
+        wil::unique_hinternet CreateSession();
+
+        std::mutex m_lock;
+        bool m_stopped = false;
+        wil::unique_hinternet m_session;
+        // The warm ups that were started, by host.
+        std::map<std::string, std::shared_future<void>> m_warmUps;
+    };
+}
@@ -3,7 +3,9 @@
 #pragma once
 #include "winget/ManifestCommon.h"
 
-namespace AppInstaller::Manifest 
+#include <unordered_map>
+
+namespace AppInstaller::Manifest
 {
     struct DependencyGraph
     {
@@ -27,16 +29,24 @@ namespace AppInstaller::Manifest
 
         std::vector<Dependency> GetInstallationOrder();
 
+        // Gets the loops reachable from the root; each is the set of nodes that depend on each other (a strongly connected component).
+        std::vector<std::vector<Dependency>> GetLoops();
+
     private:
-        // TODO make this function iterative
-        bool HasLoopDFS(std::set<Dependency> visited, const Dependency& node);
+        // Nodes are interned so that the traversal works on indices rather than comparing dependencies.
+        using NodeId = size_t;
+
+        NodeId GetOrAddNodeId(const Dependency& node);
 
         const Dependency& m_root;
-        std::map<Dependency, std::set<Dependency>> m_adjacents;
+        std::vector<Dependency> m_nodes;
+        std::unordered_map<std::string, NodeId> m_nodeIds;
+        std::vector<std::vector<NodeId>> m_adjacents;
         std::function<const DependencyList(const Dependency&)> getDependencies;
-        bool m_HasLoop;
+        bool m_HasLoop = false;
         bool m_rootDependencyEvaluated = false;
         std::vector<Dependency> m_installationOrder;
+        std::vector<std::vector<Dependency>> m_loops;
         std::vector<Dependency> m_toCheck;
     };
 }
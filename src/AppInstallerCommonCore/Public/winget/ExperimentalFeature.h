@@ -23,6 +23,11 @@ namespace AppInstaller::Settings
             Dependencies = 0x1,
             // Before making DirectMSI non-experimental, it should be part of manifest validation.
             DirectMSI = 0x2,
+            LazySourceOpen = 0x4,
+            OverlappedWorkflowTasks = 0x8,
+            CorrelationMemo = 0x10,
+            OperationArenas = 0x20,
+            SearchMemo = 0x40,
             Max, // This MUST always be after all experimental features
 
             // Features listed after Max will not be shown with the features command
@@ -40,6 +40,7 @@ namespace AppInstaller::Settings
             MSStoreSource,
             AdditionalSources,
             AllowedSources,
+            SharedSourceData,
             Max,
         };
 
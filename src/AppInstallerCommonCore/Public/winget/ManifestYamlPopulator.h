@@ -5,16 +5,32 @@
 #include <winget/ManifestValidation.h>
 #include <winget/Yaml.h>
 
+#include <array>
+#include <string_view>
+
 namespace AppInstaller::Manifest
 {
     struct ManifestYamlPopulator
     {
+        // The fields that every document of a multi file manifest contains. Only those of the installer document are populated.
+        static constexpr std::array<std::string_view, 4> MultiFileManifestCommonFields{ "PackageIdentifier", "PackageVersion", "ManifestType", "ManifestVersion" };
+
         static std::vector<ValidationError> PopulateManifest(
             const YAML::Node& rootNode,
             Manifest& manifest,
             const ManifestVer& manifestVersion,
             ManifestValidateOption validateOption);
 
+        // Populates the manifest from the documents of a multi file manifest, with the same result as populating it from the merged document.
+        // The installer and default locale documents provide the root fields, and each locale document provides a localization.
+        static std::vector<ValidationError> PopulateManifest(
+            const YAML::Node& installerNode,
+            const YAML::Node& defaultLocaleNode,
+            const std::vector<const YAML::Node*>& localeNodes,
+            Manifest& manifest,
+            const ManifestVer& manifestVersion,
+            ManifestValidateOption validateOption);
+
     private:
 
         bool m_isMergedManifest = false;
@@ -23,24 +39,58 @@ namespace AppInstaller::Manifest
         // Struct mapping a manifest field to its population logic
         struct FieldProcessInfo
         {
-            FieldProcessInfo(std::string name, std::function<std::vector<ValidationError>(const YAML::Node&)> func, bool requireVerifiedPublisher = false) :
+            using ProcessFunc_t = std::vector<ValidationError>(*)(ManifestYamlPopulator& populator, const YAML::Node& value);
+
+            FieldProcessInfo(std::string name, ProcessFunc_t func, bool requireVerifiedPublisher = false) :
                 Name(std::move(name)), ProcessFunc(func), RequireVerifiedPublisher(requireVerifiedPublisher) {}
 
             std::string Name;
-            std::function<std::vector<ValidationError>(const YAML::Node&)> ProcessFunc;
+            ProcessFunc_t ProcessFunc = nullptr;
             bool RequireVerifiedPublisher = false;
         };
 
-        std::vector<FieldProcessInfo> RootFieldInfos;
-        std::vector<FieldProcessInfo> InstallerFieldInfos;
-        std::vector<FieldProcessInfo> SwitchesFieldInfos;
-        std::vector<FieldProcessInfo> ExpectedReturnCodesFieldInfos;
-        std::vector<FieldProcessInfo> DependenciesFieldInfos;
-        std::vector<FieldProcessInfo> PackageDependenciesFieldInfos;
-        std::vector<FieldProcessInfo> LocalizationFieldInfos;
-        std::vector<FieldProcessInfo> AgreementFieldInfos;
-        std::vector<FieldProcessInfo> MarketsFieldInfos;
-        std::vector<FieldProcessInfo> AppsAndFeaturesEntryFieldInfos;
+        // The fields of one kind of node. Names are looked up case insensitively through a perfect hash,
+        // with the seed chosen when the table is built so that no two fields share a slot.
+        struct FieldTable
+        {
+            FieldTable() = default;
+            FieldTable(std::vector<FieldProcessInfo> fieldInfos);
+
+            // Gets the index of the field matching the name, or Size() if there is none.
+            size_t Find(std::string_view name) const;
+
+            size_t Size() const { return m_fieldInfos.size(); }
+            const FieldProcessInfo& operator[](size_t index) const { return m_fieldInfos[index]; }
+
+        private:
+            bool TryAssignSlots(uint32_t seed, size_t slotCount);
+
+            std::vector<FieldProcessInfo> m_fieldInfos;
+            // The index of the field in each slot plus one; zero for an empty slot.
+            std::vector<uint16_t> m_slots;
+            uint32_t m_seed = 0;
+        };
+
+        // The field tables of a manifest version. They only depend on the version, so they are built once per process for each one.
+        struct FieldTables
+        {
+            FieldTables(const ManifestVer& manifestVersion);
+
+            FieldTable Root;
+            FieldTable Installer;
+            FieldTable Switches;
+            FieldTable ExpectedReturnCodes;
+            FieldTable Dependencies;
+            FieldTable PackageDependencies;
+            FieldTable Localization;
+            FieldTable Agreement;
+            FieldTable Markets;
+            FieldTable AppsAndFeaturesEntry;
+        };
+
+        static const FieldTables& GetFieldTables(const ManifestVer& manifestVersion);
+
+        const FieldTables* m_fieldTables = nullptr;
 
         // These pointers are referenced in the processing functions in manifest field process info table.
         AppInstaller::Manifest::Manifest* m_p_manifest = nullptr;
@@ -58,16 +108,16 @@ namespace AppInstaller::Manifest
         YAML::Node const* m_p_installersNode = nullptr;
         YAML::Node const* m_p_localizationsNode = nullptr;
 
-        std::vector<FieldProcessInfo> GetRootFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetInstallerFieldProcessInfo(const ManifestVer& manifestVersion, bool forRootFields = false);
-        std::vector<FieldProcessInfo> GetSwitchesFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetExpectedReturnCodesFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetDependenciesFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetPackageDependenciesFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetLocalizationFieldProcessInfo(const ManifestVer& manifestVersion, bool forRootFields = false);
-        std::vector<FieldProcessInfo> GetAgreementFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetMarketsFieldProcessInfo(const ManifestVer& manifestVersion);
-        std::vector<FieldProcessInfo> GetAppsAndFeaturesEntryFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetRootFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetInstallerFieldProcessInfo(const ManifestVer& manifestVersion, bool forRootFields = false);
+        static std::vector<FieldProcessInfo> GetSwitchesFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetExpectedReturnCodesFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetDependenciesFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetPackageDependenciesFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetLocalizationFieldProcessInfo(const ManifestVer& manifestVersion, bool forRootFields = false);
+        static std::vector<FieldProcessInfo> GetAgreementFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetMarketsFieldProcessInfo(const ManifestVer& manifestVersion);
+        static std::vector<FieldProcessInfo> GetAppsAndFeaturesEntryFieldProcessInfo(const ManifestVer& manifestVersion);
 
         // This method takes YAML root node and list of manifest field info.
         // Yaml lib does not support case insensitive search and it allows duplicate keys. If duplicate keys exist,
@@ -75,7 +125,14 @@ namespace AppInstaller::Manifest
         // pair ourselves. This also helps with generating aggregated error rather than throwing on first failure.
         std::vector<ValidationError> ValidateAndProcessFields(
             const YAML::Node& rootNode,
-            const std::vector<FieldProcessInfo>& fieldInfos);
+            const FieldTable& fieldInfos);
+
+        // Same as above, for a node of a multi file manifest that is made up of the optional root node and a document.
+        // The fields are processed as they would be in the merged node, without the fields common to all documents.
+        std::vector<ValidationError> ValidateAndProcessFields(
+            const YAML::Node* rootNode,
+            const YAML::Node* multiFileNode,
+            const FieldTable& fieldInfos);
 
         void ProcessDependenciesNode(DependencyType type, const YAML::Node& rootNode);
         std::vector<ValidationError> ProcessPackageDependenciesNode(const YAML::Node& rootNode);
@@ -84,8 +141,11 @@ namespace AppInstaller::Manifest
         std::vector<ValidationError> ProcessAppsAndFeaturesEntriesNode(const YAML::Node& appsAndFeaturesEntriesNode);
         std::vector<ValidationError> ProcessExpectedReturnCodesNode(const YAML::Node& returnCodesNode);
 
+        // The default locale node and locale nodes are only provided for multi file manifests.
         std::vector<ValidationError> PopulateManifestInternal(
             const YAML::Node& rootNode,
+            const YAML::Node* defaultLocaleNode,
+            const std::vector<const YAML::Node*>& localeNodes,
             Manifest& manifest,
             const ManifestVer& manifestVersion,
             ManifestValidateOption validateOption);
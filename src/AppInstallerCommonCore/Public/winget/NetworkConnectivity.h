@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winget/Settings.h>
+
+#include <chrono>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+
+
+namespace AppInstaller::Network
+{
+    // The time allowed to resolve the name of a host and to connect to it.
+    // Transfers are not limited by it; they keep the default timeouts of the network stack.
+    constexpr std::chrono::milliseconds ConnectTimeout{ 5000 };
+
+    // The time that a host is considered unreachable after a connection to it fails.
+    constexpr std::chrono::seconds UnreachableWindow{ 30 };
+
+    // The time that the state read from other processes is used before it is read again.
+    constexpr std::chrono::milliseconds ConnectivityRefreshInterval{ 2000 };
+
+    // Determines if all network access is disabled by the offline setting.
+    bool IsOffline();
+
+    // Determines if the error is a failure to reach the host (name resolution, connection or timeout),
+    // rather than a failure of the request itself.
+    bool IsConnectivityError(HRESULT hr);
+
+    // Gets the key used to track the host of the url ("scheme://host[:port]", lower case).
+    // Returns an empty string if the value is not a remote url.
+    std::string GetHostKey(std::string_view url);
+
+    // Tracks the hosts that could not be reached recently. The state is shared with other processes,
+    // so that each command does not wait on the same connection timeout while the network is down.
+    struct ConnectivityState
+    {
+        ConnectivityState(
+            const Settings::StreamDefinition& stream = Settings::Stream::NetworkConnectivity,
+            std::chrono::seconds window = UnreachableWindow,
+            std::chrono::milliseconds refreshInterval = ConnectivityRefreshInterval);
+
+        ConnectivityState(const ConnectivityState&) = delete;
+        ConnectivityState& operator=(const ConnectivityState&) = delete;
+
+        // Gets the state used by the process.
+        static ConnectivityState& Instance();
+
+        // Throws if no network access should be attempted for the url: APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE
+        // when offline, or APPINSTALLER_CLI_ERROR_HOST_UNREACHABLE when its host could not be reached recently.
+        void ThrowIfUnavailable(std::string_view url);
+
+        // Determines if the host of the url could not be reached recently, by this or any other process.
+        // What other processes recorded is seen once the state read by this one is older than the refresh interval.
+        bool IsUnreachable(std::string_view url);
+
+        // Records that the host of the url could not be reached.
+        void RecordUnreachable(std::string_view url);
+
+        // Records that the host of the url was reached, if it had been recorded as unreachable.
+        void RecordReachable(std::string_view url);
+
+        // Records the result of an operation on the url that failed with the error.
+        // Only connectivity errors mark the host as unreachable.
+        void RecordFailure(std::string_view url, HRESULT hr);
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+        // Forgets the state that was read, so that the next check reads it again.
+        void Invalidate();
+#endif
+
+    private:
+        // Reads the state again if it was last read before the refresh interval; must be called while holding the lock.
+        void RefreshIfStale();
+
+        void Update(const std::string& host, std::chrono::system_clock::time_point unreachableUntil);
+
+        Settings::StreamDefinition m_streamDefinition;
+        std::chrono::seconds m_window;
+        std::chrono::milliseconds m_refreshInterval;
+        std::mutex m_lock;
+        std::optional<std::chrono::steady_clock::time_point> m_lastRead;
+        // The time until which each host is unreachable, as last read.
+        std::map<std::string, std::chrono::system_clock::time_point> m_unreachableUntil;
+    };
+}
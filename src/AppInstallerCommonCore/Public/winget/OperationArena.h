@@ -0,0 +1,87 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+
+namespace AppInstaller::Memory
+{
+    // A monotonic arena for the temporary data of one operation, such as a search, a manifest parse or a correlation.
+    // Deallocation does nothing; all of the memory is returned to the process heap at once when the arena is destroyed.
+    struct OperationArena : public std::pmr::memory_resource
+    {
+        // The size of the first block taken from the upstream resource; later blocks grow geometrically.
+        static constexpr size_t InitialBlockSize = 64 * 1024;
+
+        OperationArena(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+
+        OperationArena(const OperationArena&) = delete;
+        OperationArena& operator=(const OperationArena&) = delete;
+
+        // Gets the number of bytes allocated from the arena.
+        size_t GetBytesAllocated() const { return m_bytesAllocated; }
+
+        // Gets the number of allocations from the arena.
+        size_t GetAllocationCount() const { return m_allocationCount; }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+    private:
+        std::pmr::monotonic_buffer_resource m_buffer;
+        size_t m_bytesAllocated = 0;
+        size_t m_allocationCount = 0;
+    };
+
+    // Decides whether operations on the thread use arenas for the lifetime of the scope, such as a command, so that
+    // each search and parse does not check the settings again. A scope inside of another one keeps the outer decision;
+    // operations outside of any scope check the settings themselves.
+    struct OperationArenaSettingScope
+    {
+        // Uses arenas if the operation arenas experimental feature is enabled.
+        OperationArenaSettingScope();
+
+        // Uses arenas if requested, regardless of the settings.
+        explicit OperationArenaSettingScope(bool useArenas);
+
+        ~OperationArenaSettingScope();
+
+        OperationArenaSettingScope(const OperationArenaSettingScope&) = delete;
+        OperationArenaSettingScope& operator=(const OperationArenaSettingScope&) = delete;
+
+    private:
+        bool m_isOutermost = false;
+    };
+
+    // Installs an arena as the current one for the thread for the lifetime of the scope.
+    // A scope inside of another one keeps using the outer arena, so its memory is held until the outermost operation completes.
+    // Only data that is destroyed before the scope ends may be allocated from the arena.
+    struct OperationArenaScope
+    {
+        // Uses an arena if the current OperationArenaSettingScope decided to, or if the operation arenas experimental feature
+        // is enabled when there is none.
+        OperationArenaScope();
+
+        // Uses an arena if requested, regardless of the settings.
+        explicit OperationArenaScope(bool useArena);
+
+        ~OperationArenaScope();
+
+        OperationArenaScope(const OperationArenaScope&) = delete;
+        OperationArenaScope& operator=(const OperationArenaScope&) = delete;
+
+    private:
+        std::unique_ptr<OperationArena> m_arena;
+    };
+
+    // Gets the arena of the current operation on the thread, or null if there is none.
+    OperationArena* GetCurrentArena();
+
+    // Gets the memory resource for the temporary data of the current operation on the thread;
+    // its arena if there is one, or the default resource otherwise.
+    std::pmr::memory_resource* GetScratchResource();
+}
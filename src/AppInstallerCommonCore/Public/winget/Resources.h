@@ -30,6 +30,7 @@ namespace AppInstaller::StringResource
         WINGET_DEFINE_RESOURCE_STRINGID(PolicyEnableHashOverride);
         WINGET_DEFINE_RESOURCE_STRINGID(PolicyEnableDefaultSource);
         WINGET_DEFINE_RESOURCE_STRINGID(PolicyEnableMSStoreSource);
+        WINGET_DEFINE_RESOURCE_STRINGID(PolicyEnableSharedSourceData);
         WINGET_DEFINE_RESOURCE_STRINGID(PolicyAdditionalSources);
         WINGET_DEFINE_RESOURCE_STRINGID(PolicyAllowedSources);
         WINGET_DEFINE_RESOURCE_STRINGID(PolicySourceAutoUpdateInterval);
@@ -76,6 +76,16 @@ namespace AppInstaller::Settings
         constexpr static StreamDefinition BackupUserSettings{ Type::UserFile, "settings.json.backup"sv };
         // The admin settings.
         constexpr static StreamDefinition AdminSettings{ Type::Secure, "admin_settings"sv };
+        // The observed latency and failures of source locations.
+        constexpr static StreamDefinition SourceLocationStatistics{ Type::Standard, "source_location_statistics"sv };
+        // The hosts that could not be reached recently.
+        constexpr static StreamDefinition NetworkConnectivity{ Type::Standard, "network_connectivity"sv };
+        // The available packages that installed packages correlated to in each source.
+        constexpr static StreamDefinition CorrelationMemo{ Type::Standard, "correlation_memo"sv };
+        // The progress of interrupted commands that install multiple packages.
+        constexpr static StreamDefinition OperationCheckpoints{ Type::Standard, "operation_checkpoints"sv };
+        // The pages of source indexes that were read recently, to be read ahead of the next use.
+        constexpr static StreamDefinition IndexWarmup{ Type::Standard, "index_warmup"sv };
 
         // Gets a Stream for the StreamDefinition.
         // If the stream is synchronized, attempts to Set the value can fail due to another writer
@@ -65,6 +65,7 @@ namespace AppInstaller::Settings
     {
         ProgressBarVisualStyle,
         AutoUpdateTimeInMinutes,
+        SourceWarmUpIndexes,
         EFExperimentalCmd,
         EFExperimentalArg,
         EFDependencies,
@@ -73,9 +74,17 @@ namespace AppInstaller::Settings
         InstallScopeRequirement,
         NetworkDownloader,
         NetworkDOProgressTimeoutInSeconds,
+        NetworkRestRequestHedging,
+        NetworkOffline,
+        NetworkWarmUpConnections,
         InstallLocalePreference,
         InstallLocaleRequirement,
         EFDirectMSI,
+        EFLazySourceOpen,
+        EFOverlappedWorkflowTasks,
+        EFCorrelationMemo,
+        EFOperationArenas,
+        EFSearchMemo,
         Max
     };
 
@@ -111,6 +120,7 @@ namespace AppInstaller::Settings
 
         SETTINGMAPPING_SPECIALIZATION(Setting::ProgressBarVisualStyle, std::string, VisualStyle, VisualStyle::Accent, ".visual.progressBar"sv);
         SETTINGMAPPING_SPECIALIZATION_POLICY(Setting::AutoUpdateTimeInMinutes, uint32_t, std::chrono::minutes, 5min, ".source.autoUpdateIntervalInMinutes"sv, ValuePolicy::SourceAutoUpdateIntervalInMinutes);
+        SETTINGMAPPING_SPECIALIZATION(Setting::SourceWarmUpIndexes, bool, bool, false, ".source.warmUpIndexes"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFExperimentalCmd, bool, bool, false, ".experimentalFeatures.experimentalCmd"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFExperimentalArg, bool, bool, false, ".experimentalFeatures.experimentalArg"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFDependencies, bool, bool, false, ".experimentalFeatures.dependencies"sv);
@@ -119,9 +129,17 @@ namespace AppInstaller::Settings
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallScopeRequirement, std::string, ScopePreference, ScopePreference::None, ".installBehavior.requirements.scope"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDownloader, std::string, InstallerDownloader, InstallerDownloader::Default, ".network.downloader"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::NetworkDOProgressTimeoutInSeconds, uint32_t, std::chrono::seconds, 60s, ".network.doProgressTimeoutInSeconds"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkRestRequestHedging, bool, bool, false, ".network.restRequestHedging"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkOffline, bool, bool, false, ".network.offline"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::NetworkWarmUpConnections, bool, bool, false, ".network.warmUpConnections"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallLocalePreference, std::vector<std::string>, std::vector<std::string>, {}, ".installBehavior.preferences.locale"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::InstallLocaleRequirement, std::vector<std::string>, std::vector<std::string>, {}, ".installBehavior.requirements.locale"sv);
         SETTINGMAPPING_SPECIALIZATION(Setting::EFDirectMSI, bool, bool, false, ".experimentalFeatures.directMSI"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFLazySourceOpen, bool, bool, false, ".experimentalFeatures.lazySourceOpen"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFOverlappedWorkflowTasks, bool, bool, false, ".experimentalFeatures.overlappedWorkflowTasks"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFCorrelationMemo, bool, bool, false, ".experimentalFeatures.correlationMemo"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFOperationArenas, bool, bool, false, ".experimentalFeatures.operationArenas"sv);
+        SETTINGMAPPING_SPECIALIZATION(Setting::EFSearchMemo, bool, bool, false, ".experimentalFeatures.searchMemo"sv);
 
         // Used to deduce the SettingVariant type; making a variant that includes std::monostate and all SettingMapping types.
         template <size_t... I>
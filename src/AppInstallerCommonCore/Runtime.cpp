@@ -24,6 +24,7 @@ namespace AppInstaller::Runtime
         constexpr std::string_view s_SecureSettings_Relative_Unpackaged = "win"sv;
 #ifndef WINGET_DISABLE_FOR_FUZZING
         constexpr std::string_view s_SecureSettings_Relative_Packaged = "pkg"sv;
+        constexpr std::string_view s_SharedState_Relative = "State"sv;
 #endif
         constexpr std::string_view s_PreviewBuildSuffix = "-preview"sv;
 
@@ -309,6 +310,12 @@ namespace AppInstaller::Runtime
                 result = GetKnownFolderPath(FOLDERID_Profile);
                 create = false;
                 break;
+            case PathName::SharedState:
+                result = GetKnownFolderPath(FOLDERID_ProgramData);
+                result /= s_SecureSettings_Base;
+                result /= s_SharedState_Relative;
+                create = false;
+                break;
             default:
                 THROW_HR(E_UNEXPECTED);
             }
@@ -349,6 +356,12 @@ namespace AppInstaller::Runtime
                 result = GetKnownFolderPath(FOLDERID_Profile);
                 create = false;
                 break;
+            case PathName::SharedState:
+                result = GetKnownFolderPath(FOLDERID_ProgramData);
+                result /= s_SecureSettings_Base;
+                result /= s_SharedState_Relative;
+                create = false;
+                break;
             default:
                 THROW_HR(E_UNEXPECTED);
             }
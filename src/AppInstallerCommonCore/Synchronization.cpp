@@ -32,6 +32,34 @@ namespace AppInstaller::Synchronization
             return result;
         }
 
+        WaitResult WaitWithCancellation(HANDLE object, IProgressCallback& progress, DWORD millisecondsToWait)
+        {
+            wil::unique_event cancelled{ wil::EventOptions::ManualReset };
+            auto removeCancel = progress.SetCancellationFunction([&cancelled]() { cancelled.SetEvent(); });
+
+            // Check after setting the function to catch a cancellation that happened before it was set.
+            if (progress.IsCancelled())
+            {
+                return WaitResult::Cancelled;
+            }
+
+            // Cancellation is first so that it wins if both are signaled.
+            HANDLE waitHandles[2] = { cancelled.get(), object };
+            DWORD status = WaitForMultipleObjects((object ? 2 : 1), waitHandles, FALSE, millisecondsToWait);
+
+            switch (status)
+            {
+            case WAIT_OBJECT_0:
+                return WaitResult::Cancelled;
+            case WAIT_OBJECT_0 + 1:
+                return WaitResult::Signaled;
+            case WAIT_TIMEOUT:
+                return WaitResult::TimedOut;
+            default:
+                THROW_LAST_ERROR_MSG("Unexpected WaitForMultipleObjects result: %lu", status);
+            }
+        }
+
         wil::unique_mutex OpenAccessMutex(const std::wstring& name, size_t index)
         {
             THROW_HR_IF(E_INVALIDARG, index >= s_CrossProcessReaderWriteLock_MaxReaders);
@@ -259,4 +287,20 @@ namespace AppInstaller::Synchronization
 
         return result;
     }
+
+    WaitResult WaitForSingleObjectOrCancellation(HANDLE object, IProgressCallback& progress)
+    {
+        return WaitWithCancellation(object, progress, INFINITE);
+    }
+
+    WaitResult WaitForSingleObjectOrCancellation(HANDLE object, IProgressCallback& progress, std::chrono::milliseconds timeout)
+    {
+        THROW_HR_IF(E_INVALIDARG, timeout.count() < 0 || timeout.count() >= INFINITE);
+        return WaitWithCancellation(object, progress, static_cast<DWORD>(timeout.count()));
+    }
+
+    bool SleepUnlessCancelled(std::chrono::milliseconds duration, IProgressCallback& progress)
+    {
+        return WaitForSingleObjectOrCancellation(nullptr, progress, duration) != WaitResult::Cancelled;
+    }
 }
@@ -199,6 +199,8 @@ namespace AppInstaller::Settings
             return std::chrono::minutes(value);
         }
 
+        WINGET_VALIDATE_PASS_THROUGH(SourceWarmUpIndexes)
+
         WINGET_VALIDATE_SIGNATURE(ProgressBarVisualStyle)
         {
             // progressBar property possible values
@@ -227,6 +229,11 @@ namespace AppInstaller::Settings
         WINGET_VALIDATE_PASS_THROUGH(EFDependencies)
         WINGET_VALIDATE_PASS_THROUGH(TelemetryDisable)
         WINGET_VALIDATE_PASS_THROUGH(EFDirectMSI)
+        WINGET_VALIDATE_PASS_THROUGH(EFLazySourceOpen)
+        WINGET_VALIDATE_PASS_THROUGH(EFOverlappedWorkflowTasks)
+        WINGET_VALIDATE_PASS_THROUGH(EFCorrelationMemo)
+        WINGET_VALIDATE_PASS_THROUGH(EFOperationArenas)
+        WINGET_VALIDATE_PASS_THROUGH(EFSearchMemo)
 
         WINGET_VALIDATE_SIGNATURE(InstallScopePreference)
         {
@@ -294,6 +301,10 @@ namespace AppInstaller::Settings
         {
             return std::chrono::seconds(value);
         }
+
+        WINGET_VALIDATE_PASS_THROUGH(NetworkRestRequestHedging)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkOffline)
+        WINGET_VALIDATE_PASS_THROUGH(NetworkWarmUpConnections)
     }
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
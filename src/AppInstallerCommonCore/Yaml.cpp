@@ -3,6 +3,7 @@
 #include <pch.h>
 #include "winget/Yaml.h"
 #include "YamlWrapper.h"
+#include "YamlFastParser.h"
 #include "AppInstallerErrors.h"
 #include "AppInstallerLogging.h"
 #include "AppInstallerStrings.h"
@@ -50,6 +51,31 @@ namespace AppInstaller::YAML
         {
             out << "[line " << mark.line << "; col " << mark.column << ']';
         }
+
+        Node LoadFromParser(Wrapper::Parser& parser, bool allowFastParser = true)
+        {
+            // Most input stays within the subset that the fast parser handles; the rest is left to libyaml.
+            std::optional<std::string_view> utf8Input = parser.GetUTF8Input();
+            if (allowFastParser && utf8Input)
+            {
+                std::optional<Node> result = FastParser::TryLoad(utf8Input.value());
+                if (result)
+                {
+                    return std::move(result).value();
+                }
+            }
+
+            Wrapper::Document document = parser.Load();
+
+            if (document.HasRoot())
+            {
+                return document.GetRoot();
+            }
+            else
+            {
+                return {};
+            }
+        }
     }
 
     Exception::Exception(Type type) :
@@ -268,15 +294,15 @@ namespace AppInstaller::YAML
     Node Load(std::string_view input)
     {
         Wrapper::Parser parser(input);
-        Wrapper::Document document = parser.Load();
+        return LoadFromParser(parser);
+    }
 
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
+    namespace FastParser
+    {
+        Node LoadWithLibYaml(std::string_view input)
         {
-            return {};
+            Wrapper::Parser parser(input);
+            return LoadFromParser(parser, false);
         }
     }
 
@@ -288,16 +314,7 @@ namespace AppInstaller::YAML
     Node Load(std::istream& input, Utility::SHA256::HashBuffer* hashOut)
     {
         Wrapper::Parser parser(input, hashOut);
-        Wrapper::Document document = parser.Load();
-
-        if (document.HasRoot())
-        {
-            return document.GetRoot();
-        }
-        else
-        {
-            return {};
-        }
+        return LoadFromParser(parser);
     }
 
     Node Load(const std::filesystem::path& input, Utility::SHA256::HashBuffer* hashOut)
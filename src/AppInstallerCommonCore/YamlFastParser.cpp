@@ -0,0 +1,883 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include <pch.h>
+#include "YamlFastParser.h"
+#include "AppInstallerLogging.h"
+#include "winget/OperationArena.h"
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__SSE2__)
+#define AICLI_YAML_FAST_PARSER_SSE2
+#include <emmintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
+
+
+namespace AppInstaller::YAML::FastParser
+{
+    namespace
+    {
+        // Thrown when the input is outside of the supported subset; it never escapes TryLoad.
+        struct FallbackRequired
+        {
+            const char* Reason;
+        };
+
+        [[noreturn]] void Fallback(const char* reason)
+        {
+            throw FallbackRequired{ reason };
+        }
+
+        // Manifests are not nested anywhere near this deep; it bounds the recursion.
+        constexpr size_t s_MaximumDepth = 64;
+
+        // libyaml does not allow simple keys that are longer than this.
+        constexpr size_t s_MaximumKeyLength = 1024;
+
+        bool IsBlank(char c)
+        {
+            return c == ' ' || c == '\t';
+        }
+
+#ifdef AICLI_YAML_FAST_PARSER_SSE2
+        unsigned int CountTrailingZeros(unsigned int value)
+        {
+#ifdef _MSC_VER
+            unsigned long result = 0;
+            _BitScanForward(&result, value);
+            return static_cast<unsigned int>(result);
+#else
+            return static_cast<unsigned int>(__builtin_ctz(value));
+#endif
+        }
+#endif
+
+        // Finds the first byte that is not printable ASCII, a tab or a line break; those need to be validated further.
+        size_t FindNonPrintableASCII(std::string_view input, size_t offset)
+        {
+            const char* data = input.data();
+            const size_t size = input.size();
+
+#ifdef AICLI_YAML_FAST_PARSER_SSE2
+            const __m128i space = _mm_set1_epi8(0x20);
+            const __m128i del = _mm_set1_epi8(0x7F);
+            const __m128i tab = _mm_set1_epi8('\t');
+            const __m128i lineFeed = _mm_set1_epi8('\n');
+            const __m128i carriageReturn = _mm_set1_epi8('\r');
+
+            for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+
+                // Bytes of 0x80 and above are negative as signed values, so they are also less than a space.
+                __m128i special = _mm_or_si128(_mm_cmplt_epi8(block, space), _mm_cmpeq_epi8(block, del));
+                __m128i allowed = _mm_or_si128(_mm_cmpeq_epi8(block, tab), _mm_or_si128(_mm_cmpeq_epi8(block, lineFeed), _mm_cmpeq_epi8(block, carriageReturn)));
+                int mask = _mm_movemask_epi8(_mm_andnot_si128(allowed, special));
+
+                if (mask)
+                {
+                    return offset + CountTrailingZeros(static_cast<unsigned int>(mask));
+                }
+            }
+#endif
+
+            for (; offset < size; ++offset)
+            {
+                unsigned char c = static_cast<unsigned char>(data[offset]);
+                if ((c < 0x20 && c != '\t' && c != '\n' && c != '\r') || c >= 0x7F)
+                {
+                    return offset;
+                }
+            }
+
+            return size;
+        }
+
+        // Finds the first ':' or '#', which are the only characters that can end a plain scalar in block context.
+        size_t FindColonOrHash(std::string_view text, size_t offset)
+        {
+            const char* data = text.data();
+            const size_t size = text.size();
+
+#ifdef AICLI_YAML_FAST_PARSER_SSE2
+            const __m128i colon = _mm_set1_epi8(':');
+            const __m128i hash = _mm_set1_epi8('#');
+
+            for (; offset + sizeof(__m128i) <= size; offset += sizeof(__m128i))
+            {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+                int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(block, colon), _mm_cmpeq_epi8(block, hash)));
+
+                if (mask)
+                {
+                    return offset + CountTrailingZeros(static_cast<unsigned int>(mask));
+                }
+            }
+#endif
+
+            for (; offset < size; ++offset)
+            {
+                if (data[offset] == ':' || data[offset] == '#')
+                {
+                    return offset;
+                }
+            }
+
+            return size;
+        }
+
+        // Ensures that the input is valid UTF-8 made up of only the characters that libyaml allows,
+        // and that it does not contain any of the characters that libyaml treats specially but are not handled here.
+        void ValidateInput(std::string_view input)
+        {
+            for (size_t offset = FindNonPrintableASCII(input, 0); offset < input.size(); offset = FindNonPrintableASCII(input, offset))
+            {
+                unsigned char lead = static_cast<unsigned char>(input[offset]);
+                uint32_t value = 0;
+                size_t length = 0;
+
+                if (lead < 0x80)
+                {
+                    Fallback("control character");
+                }
+                else if ((lead & 0xE0) == 0xC0)
+                {
+                    value = lead & 0x1F;
+                    length = 2;
+                }
+                else if ((lead & 0xF0) == 0xE0)
+                {
+                    value = lead & 0x0F;
+                    length = 3;
+                }
+                else if ((lead & 0xF8) == 0xF0)
+                {
+                    value = lead & 0x07;
+                    length = 4;
+                }
+                else
+                {
+                    Fallback("invalid UTF-8");
+                }
+
+                if (input.size() - offset < length)
+                {
+                    Fallback("invalid UTF-8");
+                }
+
+                for (size_t i = 1; i < length; ++i)
+                {
+                    unsigned char trail = static_cast<unsigned char>(input[offset + i]);
+                    if ((trail & 0xC0) != 0x80)
+                    {
+                        Fallback("invalid UTF-8");
+                    }
+
+                    value = (value << 6) | (trail & 0x3F);
+                }
+
+                if ((length == 2 && value < 0x80) || (length == 3 && value < 0x800) || (length == 4 && value < 0x10000))
+                {
+                    Fallback("invalid UTF-8");
+                }
+
+                // NEL, LS and PS are line breaks to libyaml, and a byte order mark is skipped at the start of a line.
+                bool allowed =
+                    (value >= 0xA0 && value <= 0xD7FF && value != 0x2028 && value != 0x2029) ||
+                    (value >= 0xE000 && value <= 0xFFFD && value != 0xFEFF) ||
+                    (value >= 0x10000 && value <= 0x10FFFF);
+
+                if (!allowed)
+                {
+                    Fallback("unsupported character");
+                }
+
+                offset += length;
+            }
+        }
+
+        void AppendUTF8(std::string& value, uint32_t codePoint)
+        {
+            if (codePoint <= 0x7F)
+            {
+                value += static_cast<char>(codePoint);
+            }
+            else if (codePoint <= 0x7FF)
+            {
+                value += static_cast<char>(0xC0 | (codePoint >> 6));
+                value += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else if (codePoint <= 0xFFFF)
+            {
+                value += static_cast<char>(0xE0 | (codePoint >> 12));
+                value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                value += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+            else
+            {
+                value += static_cast<char>(0xF0 | (codePoint >> 18));
+                value += static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+                value += static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+                value += static_cast<char>(0x80 | (codePoint & 0x3F));
+            }
+        }
+
+        size_t SkipSpaces(std::string_view text, size_t offset)
+        {
+            while (offset < text.size() && text[offset] == ' ')
+            {
+                ++offset;
+            }
+
+            return offset;
+        }
+
+        std::string_view TrimTrailingSpaces(std::string_view text)
+        {
+            size_t end = text.find_last_not_of(' ');
+            return text.substr(0, end == std::string_view::npos ? 0 : end + 1);
+        }
+
+        // Determines if the text at the offset is a block sequence entry indicator.
+        bool IsSequenceEntry(std::string_view text, size_t offset)
+        {
+            return offset < text.size() && text[offset] == '-' && (offset + 1 == text.size() || IsBlank(text[offset + 1]));
+        }
+
+        // Determines if nothing but a comment follows the offset, which must be preceded by a blank.
+        bool IsEndOfContent(std::string_view text, size_t offset)
+        {
+            return offset == text.size() || text[offset] == '#';
+        }
+
+        // Finds the end of a plain scalar on the line: a value indicator (':' followed by a blank or the end of the line),
+        // the start of a comment (a '#' following a blank) or the end of the line.
+        size_t FindPlainScalarEnd(std::string_view text, size_t offset)
+        {
+            for (size_t position = FindColonOrHash(text, offset); position < text.size(); position = FindColonOrHash(text, position + 1))
+            {
+                if (text[position] == ':')
+                {
+                    if (position + 1 == text.size() || IsBlank(text[position + 1]))
+                    {
+                        return position;
+                    }
+                }
+                else if (position > offset && IsBlank(text[position - 1]))
+                {
+                    return position;
+                }
+            }
+
+            return text.size();
+        }
+
+        // Determines if a mapping key starts at the offset of a sequence entry.
+        bool IsCompactMapping(std::string_view text, size_t offset)
+        {
+            if (text[offset] == '"' || text[offset] == '\'' || text[offset] == '|')
+            {
+                return false;
+            }
+
+            size_t end = FindPlainScalarEnd(text, offset);
+            return end < text.size() && text[end] == ':';
+        }
+
+        // Ensures that a plain scalar can start at the offset.
+        void CheckPlainScalarStart(std::string_view text, size_t offset)
+        {
+            switch (text[offset])
+            {
+            case '-':
+            case '?':
+            case ':':
+                if (offset + 1 == text.size() || IsBlank(text[offset + 1]))
+                {
+                    Fallback("indicator where a plain scalar was expected");
+                }
+                break;
+            case ',': case '[': case ']': case '{': case '}': case '#': case '&': case '*': case '!':
+            case '|': case '>': case '\'': case '"': case '%': case '@': case '`': case '\t':
+                Fallback("indicator where a plain scalar was expected");
+            }
+        }
+
+        // A line of the input, without its line break.
+        struct Line
+        {
+            std::string_view Text;
+
+            // The number of spaces at the start of the line.
+            size_t Indent = 0;
+
+            // False only for a final line that is ended by the end of the input.
+            bool HasBreak = false;
+        };
+
+        // The lines only live as long as the parse, so they are allocated from the arena of the operation if there is one.
+        std::pmr::vector<Line> SplitLines(std::string_view input)
+        {
+            std::pmr::vector<Line> result{ Memory::GetScratchResource() };
+            result.reserve(input.size() / 32);
+
+            for (size_t offset = 0; offset < input.size();)
+            {
+                Line line;
+                size_t end = input.find('\n', offset);
+
+                if (end == std::string_view::npos)
+                {
+                    line.Text = input.substr(offset);
+                    offset = input.size();
+                }
+                else
+                {
+                    line.Text = input.substr(offset, end - offset);
+                    line.HasBreak = true;
+                    offset = end + 1;
+                }
+
+                if (!line.Text.empty() && line.Text.back() == '\r')
+                {
+                    line.Text.remove_suffix(1);
+                    line.HasBreak = true;
+                }
+
+                if (line.Text.find('\r') != std::string_view::npos)
+                {
+                    Fallback("carriage return line break");
+                }
+
+                // Document markers and directives
+                if ((line.Text.substr(0, 3) == "---" || line.Text.substr(0, 3) == "...") && (line.Text.size() == 3 || IsBlank(line.Text[3])))
+                {
+                    Fallback("document marker");
+                }
+
+                line.Indent = std::min(line.Text.find_first_not_of(' '), line.Text.size());
+                result.emplace_back(line);
+            }
+
+            return result;
+        }
+
+        // Builds the node tree from the lines of the input, mirroring the nodes and marks that libyaml would produce.
+        struct Parser
+        {
+            Parser(std::string_view input) : m_lines(SplitLines(input)) {}
+
+            Node Parse()
+            {
+                if (!SkipInsignificantLines())
+                {
+                    return {};
+                }
+
+                Node result = ParseBlockNode(m_lines[m_current].Indent, 0);
+
+                if (SkipInsignificantLines())
+                {
+                    Fallback("content after the root node");
+                }
+
+                return result;
+            }
+
+        private:
+            // Moves past empty and comment lines; returns false if there are no more lines.
+            bool SkipInsignificantLines()
+            {
+                for (; m_current < m_lines.size(); ++m_current)
+                {
+                    const Line& line = m_lines[m_current];
+
+                    if (line.Indent < line.Text.size())
+                    {
+                        char c = line.Text[line.Indent];
+
+                        if (c == '\t')
+                        {
+                            Fallback("tab in indentation");
+                        }
+                        else if (c != '#')
+                        {
+                            return true;
+                        }
+                    }
+                }
+
+                return false;
+            }
+
+            std::string_view CurrentText() const
+            {
+                return m_lines[m_current].Text;
+            }
+
+            // Gets the mark of the offset in the current line; the column is counted in characters.
+            YAML::Mark GetMark(size_t offset) const
+            {
+                std::string_view text = CurrentText();
+                size_t column = 1;
+
+                for (size_t i = 0; i < offset; ++i)
+                {
+                    if ((static_cast<unsigned char>(text[i]) & 0xC0) != 0x80)
+                    {
+                        ++column;
+                    }
+                }
+
+                return { m_current + 1, column };
+            }
+
+            // Parses the collection that starts at the indentation of the current line.
+            Node ParseBlockNode(size_t indent, size_t depth)
+            {
+                if (IsSequenceEntry(CurrentText(), indent))
+                {
+                    return ParseSequence(indent, depth);
+                }
+                else
+                {
+                    return ParseMapping(indent, depth);
+                }
+            }
+
+            // Parses the value of a mapping key or sequence entry that has nothing after it on its line.
+            Node ParseNestedBlock(size_t indent, size_t depth, bool allowIndentlessSequence)
+            {
+                ++m_current;
+
+                if (SkipInsignificantLines())
+                {
+                    const Line& line = m_lines[m_current];
+
+                    if (line.Indent > indent)
+                    {
+                        return ParseBlockNode(line.Indent, depth + 1);
+                    }
+                    else if (allowIndentlessSequence && line.Indent == indent && IsSequenceEntry(line.Text, indent))
+                    {
+                        return ParseSequence(indent, depth + 1);
+                    }
+                }
+
+                Fallback("empty value");
+            }
+
+            // Determines if the line continues the collection at the indentation after one of its values.
+            bool ContinuesCollection(size_t indent)
+            {
+                if (!SkipInsignificantLines())
+                {
+                    return false;
+                }
+
+                const Line& line = m_lines[m_current];
+
+                if (line.Indent > indent)
+                {
+                    // A continuation of a multi-line scalar, or invalid.
+                    Fallback("unexpected indentation");
+                }
+
+                return line.Indent == indent;
+            }
+
+            Node ParseSequence(size_t indent, size_t depth)
+            {
+                if (depth > s_MaximumDepth)
+                {
+                    Fallback("nesting too deep");
+                }
+
+                Node result(Node::Type::Sequence, YAML_DEFAULT_SEQUENCE_TAG, GetMark(indent));
+
+                do
+                {
+                    std::string_view text = CurrentText();
+                    size_t offset = SkipSpaces(text, indent + 1);
+
+                    if (IsEndOfContent(text, offset))
+                    {
+                        result.AddSequenceNode(ParseNestedBlock(indent, depth, false));
+                    }
+                    else if (IsSequenceEntry(text, offset))
+                    {
+                        Fallback("compact nested sequence");
+                    }
+                    else if (IsCompactMapping(text, offset))
+                    {
+                        // A compact mapping, whose keys are at the column of the first one.
+                        result.AddSequenceNode(ParseMapping(offset, depth + 1));
+                    }
+                    else
+                    {
+                        result.AddSequenceNode(ParseScalar(offset, indent));
+                    }
+                } while (ContinuesCollection(indent) && IsSequenceEntry(CurrentText(), indent));
+
+                return result;
+            }
+
+            Node ParseMapping(size_t indent, size_t depth)
+            {
+                if (depth > s_MaximumDepth)
+                {
+                    Fallback("nesting too deep");
+                }
+
+                Node result(Node::Type::Mapping, YAML_DEFAULT_MAPPING_TAG, GetMark(indent));
+
+                do
+                {
+                    std::string_view text = CurrentText();
+                    CheckPlainScalarStart(text, indent);
+
+                    size_t indicator = FindPlainScalarEnd(text, indent);
+                    if (indicator == text.size() || text[indicator] != ':')
+                    {
+                        Fallback("expected a mapping key");
+                    }
+
+                    if (indicator - indent >= s_MaximumKeyLength)
+                    {
+                        Fallback("mapping key too long");
+                    }
+
+                    std::string_view key = TrimTrailingSpaces(text.substr(indent, indicator - indent));
+                    if (key.find('\t') != std::string_view::npos)
+                    {
+                        Fallback("tab in mapping key");
+                    }
+
+                    Node keyNode(Node::Type::Scalar, YAML_DEFAULT_SCALAR_TAG, GetMark(indent));
+                    keyNode.SetScalar(std::string{ key });
+
+                    size_t offset = SkipSpaces(text, indicator + 1);
+
+                    if (IsEndOfContent(text, offset))
+                    {
+                        result.AddMappingNode(std::move(keyNode), ParseNestedBlock(indent, depth, true));
+                    }
+                    else
+                    {
+                        result.AddMappingNode(std::move(keyNode), ParseScalar(offset, indent));
+                    }
+                } while (ContinuesCollection(indent) && !IsSequenceEntry(CurrentText(), indent));
+
+                return result;
+            }
+
+            // Parses the scalar that starts at the offset in the current line, moving past all of its lines.
+            Node ParseScalar(size_t offset, size_t containerIndent)
+            {
+                std::string_view text = CurrentText();
+                Node result(Node::Type::Scalar, YAML_DEFAULT_SCALAR_TAG, GetMark(offset));
+                std::string value;
+
+                if (text[offset] == '|')
+                {
+                    result.SetScalar(ParseLiteralScalar(offset, containerIndent));
+                    return result;
+                }
+                else if (text[offset] == '"' || text[offset] == '\'')
+                {
+                    size_t end = (text[offset] == '"' ? ParseDoubleQuotedScalar(text, offset, value) : ParseSingleQuotedScalar(text, offset, value));
+
+                    // Only a comment can follow on the line; anything else, such as a value indicator, is not supported.
+                    while (end < text.size() && IsBlank(text[end]))
+                    {
+                        ++end;
+                    }
+
+                    if (!IsEndOfContent(text, end))
+                    {
+                        Fallback("unexpected content after quoted scalar");
+                    }
+                }
+                else
+                {
+                    CheckPlainScalarStart(text, offset);
+                    size_t end = FindPlainScalarEnd(text, offset);
+
+                    if (end < text.size() && text[end] == ':')
+                    {
+                        Fallback("mapping value in scalar");
+                    }
+
+                    value = TrimTrailingSpaces(text.substr(offset, end - offset));
+
+                    if (value.find('\t') != std::string::npos)
+                    {
+                        Fallback("tab in plain scalar");
+                    }
+                }
+
+                result.SetScalar(std::move(value));
+                ++m_current;
+                return result;
+            }
+
+            // Returns the offset after the closing quote.
+            static size_t ParseDoubleQuotedScalar(std::string_view text, size_t offset, std::string& value)
+            {
+                size_t position = offset + 1;
+
+                for (;;)
+                {
+                    size_t special = text.find_first_of("\"\\", position);
+                    if (special == std::string_view::npos)
+                    {
+                        Fallback("multi-line quoted scalar");
+                    }
+
+                    value.append(text.substr(position, special - position));
+
+                    if (text[special] == '"')
+                    {
+                        return special + 1;
+                    }
+
+                    if (special + 1 == text.size())
+                    {
+                        Fallback("escaped line break");
+                    }
+
+                    position = special + 2;
+                    size_t codeLength = 0;
+
+                    switch (text[special + 1])
+                    {
+                    case '0': value += '\0'; break;
+                    case 'a': value += '\x07'; break;
+                    case 'b': value += '\x08'; break;
+                    case 't':
+                    case '\t': value += '\x09'; break;
+                    case 'n': value += '\x0A'; break;
+                    case 'v': value += '\x0B'; break;
+                    case 'f': value += '\x0C'; break;
+                    case 'r': value += '\x0D'; break;
+                    case 'e': value += '\x1B'; break;
+                    case ' ': value += ' '; break;
+                    case '"': value += '"'; break;
+                    case '/': value += '/'; break;
+                    case '\\': value += '\\'; break;
+                    case 'N': AppendUTF8(value, 0x85); break;
+                    case '_': AppendUTF8(value, 0xA0); break;
+                    case 'L': AppendUTF8(value, 0x2028); break;
+                    case 'P': AppendUTF8(value, 0x2029); break;
+                    case 'x': codeLength = 2; break;
+                    case 'u': codeLength = 4; break;
+                    case 'U': codeLength = 8; break;
+                    default:
+                        Fallback("unknown escape");
+                    }
+
+                    if (codeLength)
+                    {
+                        if (text.size() - position < codeLength)
+                        {
+                            Fallback("invalid escape");
+                        }
+
+                        uint32_t codePoint = 0;
+
+                        for (size_t i = 0; i < codeLength; ++i)
+                        {
+                            char c = text[position + i];
+                            uint32_t digit = 0;
+
+                            if (c >= '0' && c <= '9')
+                            {
+                                digit = c - '0';
+                            }
+                            else if (c >= 'a' && c <= 'f')
+                            {
+                                digit = c - 'a' + 10;
+                            }
+                            else if (c >= 'A' && c <= 'F')
+                            {
+                                digit = c - 'A' + 10;
+                            }
+                            else
+                            {
+                                Fallback("invalid escape");
+                            }
+
+                            codePoint = (codePoint << 4) | digit;
+                        }
+
+                        if ((codePoint >= 0xD800 && codePoint <= 0xDFFF) || codePoint > 0x10FFFF)
+                        {
+                            Fallback("invalid escape");
+                        }
+
+                        AppendUTF8(value, codePoint);
+                        position += codeLength;
+                    }
+                }
+            }
+
+            // Returns the offset after the closing quote.
+            static size_t ParseSingleQuotedScalar(std::string_view text, size_t offset, std::string& value)
+            {
+                size_t position = offset + 1;
+
+                for (;;)
+                {
+                    size_t quote = text.find('\'', position);
+                    if (quote == std::string_view::npos)
+                    {
+                        Fallback("multi-line quoted scalar");
+                    }
+
+                    value.append(text.substr(position, quote - position));
+
+                    if (quote + 1 < text.size() && text[quote + 1] == '\'')
+                    {
+                        value += '\'';
+                        position = quote + 2;
+                    }
+                    else
+                    {
+                        return quote + 1;
+                    }
+                }
+            }
+
+            // Parses a literal block scalar the way that libyaml does, leaving the current line at the first one after it.
+            std::string ParseLiteralScalar(size_t offset, size_t containerIndent)
+            {
+                std::string_view text = CurrentText();
+                size_t position = offset + 1;
+
+                // Chomping: -1 strips all final line breaks, 0 keeps one and 1 keeps them all.
+                int chomping = 0;
+                if (position < text.size() && (text[position] == '-' || text[position] == '+'))
+                {
+                    chomping = (text[position] == '+' ? 1 : -1);
+                    ++position;
+                }
+
+                if (position < text.size() && text[position] >= '0' && text[position] <= '9')
+                {
+                    Fallback("block scalar indentation indicator");
+                }
+
+                while (position < text.size() && IsBlank(text[position]))
+                {
+                    ++position;
+                }
+
+                if (position < text.size() && text[position] != '#')
+                {
+                    Fallback("unexpected content after block scalar indicator");
+                }
+
+                std::string value;
+                std::string leadingBreak;
+                std::string trailingBreaks;
+
+                // The leading empty lines, which also determine the indentation when it is not given.
+                size_t maxIndent = 0;
+
+                for (++m_current; m_current < m_lines.size(); ++m_current)
+                {
+                    const Line& line = m_lines[m_current];
+                    maxIndent = std::max(maxIndent, line.Indent);
+
+                    if (line.Indent < line.Text.size())
+                    {
+                        if (line.Text[line.Indent] == '\t')
+                        {
+                            Fallback("tab in block scalar indentation");
+                        }
+
+                        break;
+                    }
+                    else if (!line.HasBreak)
+                    {
+                        ++m_current;
+                        break;
+                    }
+
+                    trailingBreaks += '\n';
+                }
+
+                const size_t indent = std::max({ maxIndent, containerIndent + 1, static_cast<size_t>(1) });
+
+                while (m_current < m_lines.size() && m_lines[m_current].Indent >= indent)
+                {
+                    const Line& line = m_lines[m_current];
+
+                    value += leadingBreak;
+                    leadingBreak.clear();
+                    value += trailingBreaks;
+                    trailingBreaks.clear();
+                    value.append(line.Text.substr(indent));
+
+                    if (line.HasBreak)
+                    {
+                        leadingBreak = '\n';
+                    }
+
+                    // The empty lines after it, which are only part of the scalar if more content follows.
+                    for (++m_current; m_current < m_lines.size(); ++m_current)
+                    {
+                        const Line& next = m_lines[m_current];
+
+                        if (next.Indent < indent && next.Indent < next.Text.size() && next.Text[next.Indent] == '\t')
+                        {
+                            Fallback("tab in block scalar indentation");
+                        }
+
+                        if (next.Indent < next.Text.size() || next.Text.size() > indent)
+                        {
+                            break;
+                        }
+                        else if (!next.HasBreak)
+                        {
+                            ++m_current;
+                            break;
+                        }
+
+                        trailingBreaks += '\n';
+                    }
+                }
+
+                if (chomping != -1)
+                {
+                    value += leadingBreak;
+                }
+
+                if (chomping == 1)
+                {
+                    value += trailingBreaks;
+                }
+
+                return value;
+            }
+
+            std::pmr::vector<Line> m_lines;
+            size_t m_current = 0;
+        };
+    }
+
+    std::optional<Node> TryLoad(std::string_view input)
+    {
+        try
+        {
+            ValidateInput(input);
+            return Parser{ input }.Parse();
+        }
+        catch (const FallbackRequired& fallback)
+        {
+            AICLI_LOG(YAML, Verbose, << "Using libyaml as the input is outside of the fast parser subset: " << fallback.Reason);
+            return {};
+        }
+    }
+}
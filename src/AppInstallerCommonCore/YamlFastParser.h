@@ -0,0 +1,21 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "winget/Yaml.h"
+
+#include <optional>
+#include <string_view>
+
+
+namespace AppInstaller::YAML::FastParser
+{
+    // Loads UTF-8 input (without a byte order mark) that only uses the subset of YAML found in manifests:
+    // block mappings and sequences, plain and quoted single line scalars, literal block scalars and comments.
+    // The result is identical to the one produced by libyaml for the same input.
+    // Returns an empty optional if the input is outside of the subset, including any invalid input,
+    // in which case libyaml must be used instead.
+    std::optional<Node> TryLoad(std::string_view input);
+
+    // Loads the input with libyaml alone, as the reference for the fast parser.
+    Node LoadWithLibYaml(std::string_view input);
+}
@@ -295,6 +295,16 @@ namespace AppInstaller::YAML::Wrapper
         return result;
     }
 
+    std::optional<std::string_view> Parser::GetUTF8Input() const
+    {
+        if (m_utf8Offset)
+        {
+            return std::string_view{ m_input }.substr(m_utf8Offset.value());
+        }
+
+        return {};
+    }
+
     void Parser::PrepareInput()
     {
         constexpr char c_utf16BOM[2] = { static_cast<char>(0xFF), static_cast<char>(0xFE) };
@@ -314,6 +324,7 @@ namespace AppInstaller::YAML::Wrapper
             (m_input[0] == c_utf8BOM[0] && m_input[1] == c_utf8BOM[1] && m_input[2] == c_utf8BOM[2]))
         {
             AICLI_LOG(YAML, Verbose, << "Found UTF-8 BOM");
+            m_utf8Offset = sizeof(c_utf8BOM);
             return;
         }
 
@@ -350,6 +361,7 @@ namespace AppInstaller::YAML::Wrapper
         {
             AICLI_LOG(YAML, Verbose, << "Detected UTF-8");
             yaml_parser_set_encoding(&m_parser, YAML_UTF8_ENCODING);
+            m_utf8Offset = 0;
             return;
         }
 
@@ -358,6 +370,7 @@ namespace AppInstaller::YAML::Wrapper
         std::wstring utf16 = Utility::ConvertToUTF16(m_input, 1252);
         m_input = Utility::ConvertToUTF8(utf16);
         yaml_parser_set_encoding(&m_parser, YAML_UTF8_ENCODING);
+        m_utf8Offset = 0;
     }
 
     Event::~Event()
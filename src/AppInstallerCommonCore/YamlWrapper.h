@@ -7,6 +7,7 @@
 #include "AppInstallerSHA256.h"
 
 #include <iostream>
+#include <optional>
 #include <string_view>
 #include <vector>
 
@@ -83,6 +84,9 @@ namespace AppInstaller::YAML::Wrapper
         // Loads the next document from the input, if one exists.
         Document Load();
 
+        // Gets the input without any byte order mark, if it is UTF-8.
+        std::optional<std::string_view> GetUTF8Input() const;
+
     private:
         // Determines the type of encoding in use, transforming the input as necessary.
         void PrepareInput();
@@ -90,6 +94,8 @@ namespace AppInstaller::YAML::Wrapper
         DestructionToken m_token;
         yaml_parser_t m_parser;
         std::string m_input;
+        // The offset of the UTF-8 content in the input, if it is UTF-8.
+        std::optional<size_t> m_utf8Offset;
     };
 
     // A libyaml yaml_event_t.
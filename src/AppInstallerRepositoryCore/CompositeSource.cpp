@@ -2,6 +2,9 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "CompositeSource.h"
+#include "CorrelationMemo.h"
+#include "SourceScope.h"
+#include <winget/OperationArena.h>
 
 namespace AppInstaller::Repository
 {
@@ -163,6 +166,8 @@ namespace AppInstaller::Repository
         };
 
         // A composite package for the CompositeSource.
+        // State derived from the underlying packages is computed on first use and cached for the
+        // lifetime of the package; changing the available or tracking package discards it.
         struct CompositePackage : public IPackage
         {
             CompositePackage(std::shared_ptr<IPackage> installedPackage, std::shared_ptr<IPackage> availablePackage = {}) :
@@ -181,15 +186,7 @@ namespace AppInstaller::Repository
 
             Utility::LocIndString GetProperty(PackageProperty property) const override
             {
-                std::shared_ptr<IPackageVersion> truth = GetLatestAvailableVersion();
-                if (!truth && m_trackingPackage)
-                {
-                    truth = m_trackingPackage->GetLatestAvailableVersion();
-                }
-                if (!truth)
-                {
-                    truth = GetInstalledVersion();
-                }
+                std::shared_ptr<IPackageVersion> truth = GetPropertyVersion();
 
                 switch (property)
                 {
@@ -221,25 +218,33 @@ namespace AppInstaller::Repository
 
             std::vector<PackageVersionKey> GetAvailableVersionKeys() const override
             {
-                if (m_availablePackage)
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
+
+                if (!m_availableVersionKeys)
                 {
-                    std::vector<PackageVersionKey> result = m_availablePackage->GetAvailableVersionKeys();
-                    std::string_view channel = m_installedChannel;
+                    std::vector<PackageVersionKey> result;
 
-                    // Remove all elements whose channel does not match the installed package.
-                    result.erase(
-                        std::remove_if(result.begin(), result.end(), [&](const PackageVersionKey& pvk) { return !Utility::ICUCaseInsensitiveEquals(pvk.Channel, channel); }),
-                        result.end());
+                    if (m_availablePackage)
+                    {
+                        result = m_availablePackage->GetAvailableVersionKeys();
+                        std::string_view channel = m_installedChannel;
 
-                    return result;
+                        // Remove all elements whose channel does not match the installed package.
+                        result.erase(
+                            std::remove_if(result.begin(), result.end(), [&](const PackageVersionKey& pvk) { return !Utility::ICUCaseInsensitiveEquals(pvk.Channel, channel); }),
+                            result.end());
+                    }
+
+                    m_availableVersionKeys = std::move(result);
                 }
 
-                return {};
+                return m_availableVersionKeys.value();
             }
 
             std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const override
             {
-                return GetAvailableVersion({ "", "", m_installedChannel.get() });
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
+                return GetLatestAvailableVersionInternal();
             }
 
             std::shared_ptr<IPackageVersion> GetAvailableVersion(const PackageVersionKey& versionKey) const override
@@ -254,16 +259,23 @@ namespace AppInstaller::Repository
 
             bool IsUpdateAvailable() const override
             {
-                auto installed = GetInstalledVersion();
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
 
-                if (!installed)
+                if (!m_isUpdateAvailable)
                 {
-                    return false;
-                }
+                    bool result = false;
+                    auto installed = GetInstalledVersion();
+
+                    if (installed)
+                    {
+                        auto latest = GetLatestAvailableVersionInternal();
+                        result = (latest && (GetVACFromVersion(installed.get()).IsUpdatedBy(GetVACFromVersion(latest.get()))));
+                    }
 
-                auto latest = GetLatestAvailableVersion();
+                    m_isUpdateAvailable = result;
+                }
 
-                return (latest && (GetVACFromVersion(installed.get()).IsUpdatedBy(GetVACFromVersion(latest.get()))));
+                return m_isUpdateAvailable.value();
             }
 
             bool IsSame(const IPackage* other) const override
@@ -299,21 +311,75 @@ namespace AppInstaller::Repository
 
             void SetAvailablePackage(std::shared_ptr<IPackage> availablePackage)
             {
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
                 m_availablePackage = std::move(availablePackage);
+                ResetCache();
             }
 
             void SetTracking(Source trackingSource, std::shared_ptr<IPackage> trackingPackage)
             {
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
                 m_trackingSource = std::move(trackingSource);
                 m_trackingPackage = std::move(trackingPackage);
+                ResetCache();
             }
 
         private:
+            // Must be called with the cache lock held.
+            std::shared_ptr<IPackageVersion> GetLatestAvailableVersionInternal() const
+            {
+                if (!m_latestAvailableVersion)
+                {
+                    m_latestAvailableVersion = GetAvailableVersion({ "", "", m_installedChannel.get() });
+                }
+
+                return m_latestAvailableVersion.value();
+            }
+
+            // Gets the version that provides the package level properties.
+            std::shared_ptr<IPackageVersion> GetPropertyVersion() const
+            {
+                std::lock_guard<std::mutex> lock{ m_cacheLock };
+
+                if (!m_propertyVersion)
+                {
+                    std::shared_ptr<IPackageVersion> truth = GetLatestAvailableVersionInternal();
+                    if (!truth && m_trackingPackage)
+                    {
+                        truth = m_trackingPackage->GetLatestAvailableVersion();
+                    }
+                    if (!truth)
+                    {
+                        truth = GetInstalledVersion();
+                    }
+
+                    m_propertyVersion = std::move(truth);
+                }
+
+                return m_propertyVersion.value();
+            }
+
+            // Must be called with the cache lock held.
+            void ResetCache()
+            {
+                m_latestAvailableVersion.reset();
+                m_propertyVersion.reset();
+                m_availableVersionKeys.reset();
+                m_isUpdateAvailable.reset();
+            }
+
             std::shared_ptr<IPackage> m_installedPackage;
             Utility::LocIndString m_installedChannel;
             std::shared_ptr<IPackage> m_availablePackage;
             Source m_trackingSource;
             std::shared_ptr<IPackage> m_trackingPackage;
+
+            // Derived state, computed on first use.
+            mutable std::mutex m_cacheLock;
+            mutable std::optional<std::shared_ptr<IPackageVersion>> m_latestAvailableVersion;
+            mutable std::optional<std::shared_ptr<IPackageVersion>> m_propertyVersion;
+            mutable std::optional<std::vector<PackageVersionKey>> m_availableVersionKeys;
+            mutable std::optional<bool> m_isUpdateAvailable;
         };
 
         // The comparator compares the ResultMatch by MatchType first, then Field in a predefined order.
@@ -404,10 +470,10 @@ namespace AppInstaller::Repository
                 Utility::LocIndString String2;
             };
 
-            // Data relevant to correlation for a package.
+            // Data relevant to correlation for a package; only kept while the search runs, so it uses the arena of the operation if there is one.
             struct PackageData
             {
-                std::set<SystemReferenceString> SystemReferenceStrings;
+                std::pmr::set<SystemReferenceString> SystemReferenceStrings{ Memory::GetScratchResource() };
 
                 void AddIfNotPresent(SystemReferenceString&& srs)
                 {
@@ -542,8 +608,16 @@ namespace AppInstaller::Repository
             }
 
             SearchResult SearchAndHandleFailures(const Source& source, const SearchRequest& request)
+            {
+                bool failed = false;
+                return SearchAndHandleFailures(source, request, failed);
+            }
+
+            // Also reports whether the source failed to complete the search.
+            SearchResult SearchAndHandleFailures(const Source& source, const SearchRequest& request, bool& failed)
             {
                 SearchResult result;
+                failed = false;
 
                 try
                 {
@@ -551,6 +625,8 @@ namespace AppInstaller::Repository
                 }
                 catch (...)
                 {
+                    failed = true;
+
                     if (AddFailureIfSourceNotPresent({ source.GetDetails().Name, std::current_exception() }))
                     {
                         LOG_CAUGHT_EXCEPTION();
@@ -561,6 +637,7 @@ namespace AppInstaller::Repository
                 // Move failures into the result
                 for (SearchResult::Failure& failure : result.Failures)
                 {
+                    failed = true;
                     AddFailureIfSourceNotPresent(std::move(failure));
                 }
 
@@ -642,6 +719,23 @@ namespace AppInstaller::Repository
 
             return {};
         }
+
+        // Gets the package that an installed package was remembered to correlate to; returns null if it is no longer found.
+        std::shared_ptr<IPackage> GetRememberedPackageFromAvailableSource(CompositeResult& result, const Source& source, const std::string& identifier)
+        {
+            SearchRequest directRequest;
+            directRequest.Filters.emplace_back(PackageMatchField::Id, MatchType::Exact, identifier);
+
+            SearchResult directResult = result.SearchAndHandleFailures(source, directRequest);
+
+            if (directResult.Matches.size() == 1)
+            {
+                return std::move(directResult.Matches[0].Package);
+            }
+
+            AICLI_LOG(Repo, Warning, << "Did not find remembered Id [" << identifier << "] in source: " << source.GetDetails().Name);
+            return {};
+        }
     }
 
     CompositeSource::CompositeSource(std::string identifier)
@@ -725,6 +819,36 @@ namespace AppInstaller::Repository
             SearchResult installedResult = m_installedSource.Search(request);
             result.Truncated = installedResult.Truncated;
 
+            // Remembers the correlations with sources whose data has not changed, if enabled; loaded when first needed.
+            std::optional<CorrelationMemo> memo;
+            std::map<std::string, std::string> dataVersions;
+
+            auto getMemo = [&]() -> CorrelationMemo*
+            {
+                if (!memo && Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::CorrelationMemo))
+                {
+                    memo.emplace();
+                }
+                return memo ? &memo.value() : nullptr;
+            };
+
+            auto getDataVersion = [&](const Source& source) -> const std::string&
+            {
+                std::string identifier = source.GetIdentifier();
+                auto itr = dataVersions.find(identifier);
+                if (itr == dataVersions.end())
+                {
+                    std::string dataVersion;
+                    try
+                    {
+                        dataVersion = source.GetDataVersion();
+                    }
+                    CATCH_LOG();
+                    itr = dataVersions.emplace(std::move(identifier), std::move(dataVersion)).first;
+                }
+                return itr->second;
+            };
+
             for (auto&& match : installedResult.Matches)
             {
                 auto compositePackage = std::make_shared<CompositePackage>(std::move(match.Package));
@@ -781,6 +905,9 @@ namespace AppInstaller::Repository
 
                     if (!availablePackage)
                     {
+                        CorrelationMemo* correlationMemo = getMemo();
+                        std::string fingerprint = (correlationMemo ? CorrelationMemo::GetFingerprint(systemReferenceSearch) : std::string{});
+
                         // Search sources and add to result
                         for (const auto& source : m_availableSources)
                         {
@@ -790,10 +917,45 @@ namespace AppInstaller::Repository
                                 continue;
                             }
 
-                            SearchResult availableResult = result.SearchAndHandleFailures(source, systemReferenceSearch);
+                            // Do not search a source that declares it cannot contain the package
+                            if (!CanSourceMatch(source, systemReferenceSearch))
+                            {
+                                continue;
+                            }
+
+                            // Use the remembered correlation if the source data has not changed since it was found
+                            std::string dataVersion = (correlationMemo ? getDataVersion(source) : std::string{});
+                            bool canRemember = correlationMemo && !dataVersion.empty();
+
+                            if (canRemember)
+                            {
+                                auto correlation = correlationMemo->Get(source.GetIdentifier(), dataVersion, fingerprint);
+                                if (correlation)
+                                {
+                                    if (correlation->PackageId.empty())
+                                    {
+                                        continue;
+                                    }
+
+                                    availablePackage = GetRememberedPackageFromAvailableSource(result, source, correlation->PackageId);
+                                    if (availablePackage)
+                                    {
+                                        break;
+                                    }
+                                }
+                            }
+
+                            bool searchFailed = false;
+                            SearchResult availableResult = result.SearchAndHandleFailures(source, systemReferenceSearch, searchFailed);
+                            canRemember = canRemember && !searchFailed;
 
                             if (availableResult.Matches.empty())
                             {
+                                if (canRemember)
+                                {
+                                    correlationMemo->Record(source.GetIdentifier(), dataVersion, fingerprint, {});
+                                }
+
                                 continue;
                             }
 
@@ -806,6 +968,11 @@ namespace AppInstaller::Repository
                                     AICLI_LOG(Repo, Warning, << "  Appropriate available package could not be determined");
                                 });
 
+                            if (canRemember && availablePackage)
+                            {
+                                correlationMemo->Record(source.GetIdentifier(), dataVersion, fingerprint, { availablePackage->GetProperty(PackageProperty::Id).get() });
+                            }
+
                             // We found some matching packages here, don't keep going
                             break;
                         }
@@ -819,6 +986,12 @@ namespace AppInstaller::Repository
                 result.Matches.emplace_back(std::move(compositePackage), std::move(match.MatchCriteria));
             }
 
+            if (memo)
+            {
+                AICLI_LOG(Repo, Info, << "Correlation memo hits: " << memo->GetHitCount() << ", misses: " << memo->GetMissCount());
+                memo->Save();
+            }
+
             // Optimization for the "everything installed" case, no need to allow for reverse correlations
             if (request.IsForEverything() && m_searchBehavior == CompositeSearchBehavior::Installed)
             {
@@ -826,6 +999,10 @@ namespace AppInstaller::Repository
             }
         }
 
+        // The available packages are correlated using the system reference strings of their latest version.
+        SearchRequest availableRequest = request;
+        availableRequest.Fields |= SearchResultFields::LatestVersion | SearchResultFields::CorrelationKeys;
+
         // Search available sources
         for (const auto& source : m_availableSources)
         {
@@ -882,7 +1059,13 @@ namespace AppInstaller::Repository
                 continue;
             }
 
-            SearchResult availableResult = result.SearchAndHandleFailures(source, request);
+            // Do not search a source that declares it cannot contain any matching package.
+            if (!CanSourceMatch(source, request))
+            {
+                continue;
+            }
+
+            SearchResult availableResult = result.SearchAndHandleFailures(source, availableRequest);
 
             for (auto&& match : availableResult.Matches)
             {
@@ -950,6 +1133,12 @@ namespace AppInstaller::Repository
         // Search available sources
         for (const auto& source : m_availableSources)
         {
+            // Do not search a source that declares it cannot contain any matching package.
+            if (!CanSourceMatch(source, request))
+            {
+                continue;
+            }
+
             SearchResult oneSourceResult;
 
             try
@@ -0,0 +1,250 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "CorrelationMemo.h"
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        constexpr std::string_view s_MemoYaml_Sources = "Sources"sv;
+        constexpr std::string_view s_MemoYaml_Identifier = "Identifier"sv;
+        constexpr std::string_view s_MemoYaml_DataVersion = "DataVersion"sv;
+        constexpr std::string_view s_MemoYaml_Correlations = "Correlations"sv;
+        constexpr std::string_view s_MemoYaml_Fingerprint = "Fingerprint"sv;
+        constexpr std::string_view s_MemoYaml_PackageId = "PackageId"sv;
+
+        // The number of correlations kept for a source; past it, only those used by the latest search are kept.
+        constexpr size_t s_MaxCorrelationsPerSource = 10000;
+
+        constexpr size_t s_MaxSaveAttempts = 10;
+
+        template <typename SourceMap>
+        SourceMap ReadMemo(Settings::Stream& stream)
+        {
+            SourceMap result;
+
+            auto contents = stream.Get();
+            if (!contents)
+            {
+                return result;
+            }
+
+            std::string value = Utility::ReadEntireStream(*contents);
+
+            try
+            {
+                YAML::Node document = YAML::Load(value);
+                YAML::Node sources = document[s_MemoYaml_Sources];
+
+                if (!sources || !sources.IsSequence())
+                {
+                    return result;
+                }
+
+                for (const auto& source : sources.Sequence())
+                {
+                    const YAML::Node& identifier = source[s_MemoYaml_Identifier];
+                    const YAML::Node& dataVersion = source[s_MemoYaml_DataVersion];
+                    const YAML::Node& correlations = source[s_MemoYaml_Correlations];
+
+                    if (!identifier || !identifier.IsScalar() || !dataVersion || !dataVersion.IsScalar() || !correlations || !correlations.IsSequence())
+                    {
+                        continue;
+                    }
+
+                    auto& entry = result[identifier.as<std::string>()];
+                    entry.DataVersion = dataVersion.as<std::string>();
+
+                    for (const auto& correlation : correlations.Sequence())
+                    {
+                        const YAML::Node& fingerprint = correlation[s_MemoYaml_Fingerprint];
+                        if (!fingerprint || !fingerprint.IsScalar())
+                        {
+                            continue;
+                        }
+
+                        auto& remembered = entry.Correlations[fingerprint.as<std::string>()];
+
+                        const YAML::Node& packageId = correlation[s_MemoYaml_PackageId];
+                        if (packageId && packageId.IsScalar())
+                        {
+                            remembered.PackageId = packageId.as<std::string>();
+                        }
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // The memo only avoids repeating searches; start over rather than fail.
+                AICLI_LOG(Repo, Warning, << "Ignoring invalid correlation memo (" << e.what() << ")");
+                result.clear();
+            }
+
+            return result;
+        }
+
+        template <typename SourceMap>
+        [[nodiscard]] bool WriteMemo(Settings::Stream& stream, const SourceMap& sources)
+        {
+            YAML::Emitter out;
+            out << YAML::BeginMap;
+            out << YAML::Key << s_MemoYaml_Sources;
+            out << YAML::BeginSeq;
+
+            for (const auto& source : sources)
+            {
+                out << YAML::BeginMap;
+                out << YAML::Key << s_MemoYaml_Identifier << YAML::Value << source.first;
+                out << YAML::Key << s_MemoYaml_DataVersion << YAML::Value << source.second.DataVersion;
+                out << YAML::Key << s_MemoYaml_Correlations;
+                out << YAML::BeginSeq;
+
+                for (const auto& correlation : source.second.Correlations)
+                {
+                    out << YAML::BeginMap;
+                    out << YAML::Key << s_MemoYaml_Fingerprint << YAML::Value << correlation.first;
+                    if (!correlation.second.PackageId.empty())
+                    {
+                        out << YAML::Key << s_MemoYaml_PackageId << YAML::Value << correlation.second.PackageId;
+                    }
+                    out << YAML::EndMap;
+                }
+
+                out << YAML::EndSeq;
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            return stream.Set(out.str());
+        }
+    }
+
+    CorrelationMemo::CorrelationMemo(const Settings::StreamDefinition& stream) : m_streamDefinition(stream)
+    {
+        try
+        {
+            Settings::Stream memoStream{ m_streamDefinition };
+            m_sources = ReadMemo<SourceMap>(memoStream);
+        }
+        CATCH_LOG();
+    }
+
+    std::string CorrelationMemo::GetFingerprint(const SearchRequest& systemReferenceSearch)
+    {
+        std::vector<std::string> references;
+
+        for (const auto& inclusion : systemReferenceSearch.Inclusions)
+        {
+            std::string reference{ ToString(inclusion.Field) };
+            reference += ':';
+            reference += Utility::FoldCase(inclusion.Value);
+            if (inclusion.Additional)
+            {
+                reference += '|';
+                reference += Utility::FoldCase(inclusion.Additional.value());
+            }
+            references.emplace_back(std::move(reference));
+        }
+
+        std::sort(references.begin(), references.end());
+
+        std::string combined;
+        for (const auto& reference : references)
+        {
+            combined += reference;
+            combined += '\n';
+        }
+
+        return Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(combined));
+    }
+
+    std::optional<CorrelationMemo::Correlation> CorrelationMemo::Get(const std::string& sourceIdentifier, const std::string& dataVersion, const std::string& fingerprint)
+    {
+        auto source = m_sources.find(sourceIdentifier);
+        if (source != m_sources.end() && source->second.DataVersion == dataVersion)
+        {
+            auto correlation = source->second.Correlations.find(fingerprint);
+            if (correlation != source->second.Correlations.end())
+            {
+                ++m_hitCount;
+
+                auto& used = m_used[sourceIdentifier];
+                used.DataVersion = dataVersion;
+                used.Correlations[fingerprint] = correlation->second;
+
+                return correlation->second;
+            }
+        }
+
+        ++m_missCount;
+        return {};
+    }
+
+    void CorrelationMemo::Record(const std::string& sourceIdentifier, const std::string& dataVersion, const std::string& fingerprint, Correlation correlation)
+    {
+        for (SourceMap* sources : { &m_sources, &m_used })
+        {
+            auto& source = (*sources)[sourceIdentifier];
+            if (source.DataVersion != dataVersion)
+            {
+                source.DataVersion = dataVersion;
+                source.Correlations.clear();
+            }
+            source.Correlations[fingerprint] = correlation;
+        }
+
+        m_changed = true;
+    }
+
+    void CorrelationMemo::Save()
+    {
+        if (!m_changed)
+        {
+            return;
+        }
+
+        try
+        {
+            // Merge into the latest persisted state so that the correlations recorded by other processes are kept.
+            Settings::Stream stream{ m_streamDefinition };
+
+            for (size_t i = 0; i < s_MaxSaveAttempts; ++i)
+            {
+                SourceMap sources = ReadMemo<SourceMap>(stream);
+
+                for (const auto& used : m_used)
+                {
+                    auto& source = sources[used.first];
+
+                    if (source.DataVersion != used.second.DataVersion ||
+                        source.Correlations.size() + used.second.Correlations.size() > s_MaxCorrelationsPerSource)
+                    {
+                        source = used.second;
+                    }
+                    else
+                    {
+                        for (const auto& correlation : used.second.Correlations)
+                        {
+                            source.Correlations[correlation.first] = correlation.second;
+                        }
+                    }
+                }
+
+                if (WriteMemo(stream, sources))
+                {
+                    m_sources = std::move(sources);
+                    m_changed = false;
+                    return;
+                }
+            }
+
+            AICLI_LOG(Repo, Warning, << "Too many attempts at saving the correlation memo");
+        }
+        CATCH_LOG();
+    }
+}
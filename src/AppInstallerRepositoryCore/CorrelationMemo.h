@@ -0,0 +1,64 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Public/winget/RepositorySearch.h"
+#include <winget/Settings.h>
+
+#include <map>
+#include <optional>
+#include <string>
+
+namespace AppInstaller::Repository
+{
+    // Remembers the available package that each installed package correlated to in each source, so that the
+    // correlation searches are not repeated while neither the installed package nor the source data changes.
+    // An installed package is identified by a fingerprint of its system references; the entries for a source
+    // are all discarded when its data version changes.
+    struct CorrelationMemo
+    {
+        // The remembered correlation of an installed package in a source.
+        struct Correlation
+        {
+            // The identifier of the available package; empty if the installed package did not correlate to any.
+            std::string PackageId;
+        };
+
+        // Loads the memo from the stream.
+        CorrelationMemo(const Settings::StreamDefinition& stream = Settings::Stream::CorrelationMemo);
+
+        // Gets the fingerprint of an installed package from the request used to correlate it.
+        static std::string GetFingerprint(const SearchRequest& systemReferenceSearch);
+
+        // Gets the remembered correlation, if one was recorded against the same data version of the source.
+        std::optional<Correlation> Get(const std::string& sourceIdentifier, const std::string& dataVersion, const std::string& fingerprint);
+
+        // Records the correlation against the data version of the source.
+        void Record(const std::string& sourceIdentifier, const std::string& dataVersion, const std::string& fingerprint, Correlation correlation);
+
+        // Saves the recorded correlations, merging them into the latest persisted state.
+        void Save();
+
+        // Gets the number of lookups that found a remembered correlation.
+        size_t GetHitCount() const { return m_hitCount; }
+
+        // Gets the number of lookups that did not.
+        size_t GetMissCount() const { return m_missCount; }
+
+    private:
+        struct SourceCorrelations
+        {
+            std::string DataVersion;
+            std::map<std::string, Correlation> Correlations;
+        };
+
+        using SourceMap = std::map<std::string, SourceCorrelations>;
+
+        Settings::StreamDefinition m_streamDefinition;
+        SourceMap m_sources;
+        // The correlations used or recorded by this instance; they are kept when the persisted state is trimmed.
+        SourceMap m_used;
+        bool m_changed = false;
+        size_t m_hitCount = 0;
+        size_t m_missCount = 0;
+    };
+}
@@ -22,6 +22,10 @@ namespace AppInstaller::Repository
         // Get the source's information after the source is opened.
         virtual SourceInformation GetInformation() const { return {}; };
 
+        // Gets a value that changes whenever the packages in the source change.
+        // An empty value indicates that the source cannot provide one.
+        virtual std::string GetDataVersion() const { return {}; }
+
         // Execute a search on the source.
         virtual SearchResult Search(const SearchRequest& request) const = 0;
     };
@@ -46,6 +50,9 @@ namespace AppInstaller::Repository
 
         // Opens the source. This function should throw upon open failure rather than returning an empty pointer.
         virtual std::shared_ptr<ISource> Open(IProgressCallback& progress) = 0;
+
+        // Starts reading the local data of the source in the background, so that opening and searching it waits less on storage.
+        virtual void WarmUp() {}
     };
 
     // Internal interface extension to ISource for databases that can be updated after creation, like InstallingPackages
@@ -193,6 +193,12 @@ namespace AppInstaller::Repository::Microsoft
     }
 
     void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const
+    {
+        InstalledEntryTracker tracker;
+        PopulateIndexFromARP(index, scope, {}, tracker);
+    }
+
+    void ARPHelper::PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope, const InstalledPackageFilter& filter, InstalledEntryTracker& tracker) const
     {
         for (auto architecture : Utility::GetApplicableArchitectures())
         {
@@ -200,15 +206,23 @@ namespace AppInstaller::Repository::Microsoft
 
             if (arpRootKey)
             {
-                PopulateIndexFromKey(index, arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture));
+                PopulateIndexFromKey(index, arpRootKey, Manifest::ScopeToString(scope), Utility::ToString(architecture), filter, tracker);
             }
         }
     }
 
     void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const
+    {
+        InstalledEntryTracker tracker;
+        PopulateIndexFromKey(index, key, scope, architecture, {}, tracker);
+    }
+
+    void ARPHelper::PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture, const InstalledPackageFilter& filter, InstalledEntryTracker& tracker) const
     {
         AICLI_LOG(Repo, Info, << "Examining ARP entries for " << scope << " | " << architecture);
 
+        std::string location = std::string{ scope } + '|' + std::string{ architecture };
+
         for (const auto& arpEntry : key)
         {
             std::string productCode;
@@ -217,6 +231,22 @@ namespace AppInstaller::Repository::Microsoft
             {
                 productCode = arpEntry.Name();
 
+                // Skip entries that are already in the index, or that cannot match, before reading anything from them.
+                if (!tracker.ShouldExamine(productCode, location))
+                {
+                    continue;
+                }
+
+                InstalledPackageEntry filterEntry;
+                filterEntry.Id = productCode;
+                filterEntry.Tag = "ARP";
+                filterEntry.ProductCode = productCode;
+
+                if (!filter.CouldMatch(filterEntry))
+                {
+                    continue;
+                }
+
                 Manifest::Manifest manifest;
                 manifest.DefaultLocalization.Add<Manifest::Localization::Tags>({ "ARP" });
 
@@ -258,6 +288,19 @@ namespace AppInstaller::Repository::Microsoft
                     continue;
                 }
 
+                std::optional<std::string> publisherValue;
+                auto publisher = arpKey[Publisher];
+                if (publisher && publisher->GetType() == Registry::Value::Type::String)
+                {
+                    publisherValue = publisher->GetValue<Registry::Value::Type::String>();
+                }
+
+                filterEntry.Name = displayNameValue;
+                if (publisherValue)
+                {
+                    filterEntry.Publisher = publisherValue.value();
+                }
+
                 // If no version can be determined, ignore this entry
                 manifest.Version = DetermineVersion(arpKey);
                 if (manifest.Version.empty())
@@ -266,10 +309,16 @@ namespace AppInstaller::Repository::Microsoft
                     continue;
                 }
 
-                auto publisher = arpKey[Publisher];
-                if (publisher && publisher->GetType() == Registry::Value::Type::String)
+                if (!filter.CouldMatch(filterEntry))
+                {
+                    // The entry is valid, so it must still own its product code over any duplicates that follow.
+                    tracker.RecordValid(productCode, location, false);
+                    continue;
+                }
+
+                if (publisherValue)
                 {
-                    manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>(publisher->GetValue<Registry::Value::Type::String>());
+                    manifest.DefaultLocalization.Add<Manifest::Localization::Publisher>(publisherValue.value());
 
                     // If Publisher is set, change the Id using name normalization
                     // TODO: Figure out how to actually make this work since there are often instances of the same
@@ -306,6 +355,7 @@ namespace AppInstaller::Repository::Microsoft
                 }
 
                 SQLiteIndex::IdType manifestId = manifestIdOpt.value();
+                tracker.RecordValid(productCode, location, true);
 
                 // Pass scope along to metadata.
                 index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledScope, scope);
@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include "Microsoft/InstalledPackageFilter.h"
 #include "Microsoft/SQLiteIndex.h"
 #include <AppInstallerArchitecture.h>
 #include <winget/Registry.h>
@@ -73,9 +74,19 @@ namespace AppInstaller::Repository::Microsoft
         // Handles all of the architectures for the given scope.
         void PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope) const;
 
+        // Populates the index with the ARP entries from the given scope that could match the filter
+        // and are not already in the index according to the tracker.
+        void PopulateIndexFromARP(SQLiteIndex& index, Manifest::ScopeEnum scope, const InstalledPackageFilter& filter, InstalledEntryTracker& tracker) const;
+
         // Populates the index with the ARP entries from the given key.
         // This entry point is primarily to allow unit tests to operate of arbitrary keys;
         // product code should use PopulateIndexFromARP.
         void PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture) const;
+
+        // Populates the index with the ARP entries from the given key that could match the filter
+        // and are not already in the index according to the tracker.
+        // The product code is checked against the filter before the entry is opened, and the name and publisher
+        // before the rest of its values are read.
+        void PopulateIndexFromKey(SQLiteIndex& index, const Registry::Key& key, std::string_view scope, std::string_view architecture, const InstalledPackageFilter& filter, InstalledEntryTracker& tracker) const;
     };
 }
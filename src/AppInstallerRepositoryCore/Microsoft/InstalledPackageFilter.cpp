@@ -0,0 +1,229 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/InstalledPackageFilter.h"
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        // Determines if a folded value from an entry could match the folded value from the request.
+        // The index compares values either exactly or ASCII case-insensitively; comparing folded values
+        // accepts everything that either of those would.
+        bool ValueCouldMatch(MatchType type, std::string_view requested, std::string_view value)
+        {
+            switch (type)
+            {
+            case MatchType::Exact:
+            case MatchType::CaseInsensitive:
+                return value == requested;
+            case MatchType::StartsWith:
+                return value.substr(0, requested.size()) == requested;
+            case MatchType::Substring:
+                return value.find(requested) != std::string_view::npos;
+            default:
+                // Other match types are not evaluated here.
+                return true;
+            }
+        }
+    }
+
+    // The values of an entry with their cases folded, as they would be compared by the index.
+    struct InstalledPackageFilter::FoldedEntry
+    {
+        FoldedEntry(const InstalledPackageEntry& entry) :
+            Id(Utility::FoldCase(entry.Id)),
+            Tag(Utility::FoldCase(entry.Tag)),
+            ProductCode(Utility::FoldCase(entry.ProductCode)),
+            PackageFamilyName(Utility::FoldCase(entry.PackageFamilyName))
+        {
+            if (entry.Name)
+            {
+                Name = Utility::FoldCase(entry.Name.value());
+            }
+
+            if (entry.Publisher)
+            {
+                Publisher = Utility::FoldCase(entry.Publisher.value());
+            }
+        }
+
+        std::string Id;
+        std::string Tag;
+        std::string ProductCode;
+        std::string PackageFamilyName;
+        std::optional<std::string> Name;
+        std::optional<std::string> Publisher;
+
+        // Only created when a condition needs them, as normalization is expensive.
+        std::optional<std::string> NormalizedName;
+        std::optional<std::string> NormalizedPublisher;
+    };
+
+    InstalledPackageFilter::InstalledPackageFilter(const SearchRequest& request)
+    {
+        if (request.IsForEverything())
+        {
+            return;
+        }
+
+        m_isForEverything = false;
+
+        auto needsNormalizer = [](const PackageMatchFilter& filter)
+        {
+            return filter.Field == PackageMatchField::NormalizedNameAndPublisher && filter.Type == MatchType::Exact;
+        };
+
+        if (std::any_of(request.Inclusions.begin(), request.Inclusions.end(), needsNormalizer) ||
+            std::any_of(request.Filters.begin(), request.Filters.end(), needsNormalizer))
+        {
+            // This matches the normalization used by the index.
+            m_normalizer = std::make_shared<Utility::NameNormalizer>(Utility::NormalizationVersion::Initial);
+        }
+
+        if (request.Query)
+        {
+            // The field is unused for the query, as it is matched against many fields.
+            m_query = CreateCondition(PackageMatchField::Unknown, request.Query.value(), nullptr);
+        }
+
+        for (const auto& inclusion : request.Inclusions)
+        {
+            m_inclusions.emplace_back(CreateCondition(inclusion.Field, inclusion, m_normalizer.get()));
+        }
+
+        for (const auto& filter : request.Filters)
+        {
+            m_filters.emplace_back(CreateCondition(filter.Field, filter, m_normalizer.get()));
+        }
+    }
+
+    bool InstalledPackageFilter::CouldMatch(const InstalledPackageEntry& entry) const
+    {
+        if (m_isForEverything)
+        {
+            return true;
+        }
+
+        FoldedEntry folded{ entry };
+
+        // (Query || Inclusions...) && Filters...
+        if (m_query || !m_inclusions.empty())
+        {
+            bool included = (m_query && CouldMatchQuery(folded));
+
+            for (size_t i = 0; !included && i < m_inclusions.size(); ++i)
+            {
+                included = CouldMatchCondition(folded, m_inclusions[i]);
+            }
+
+            if (!included)
+            {
+                return false;
+            }
+        }
+
+        for (const auto& filter : m_filters)
+        {
+            if (!CouldMatchCondition(folded, filter))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    InstalledPackageFilter::Condition InstalledPackageFilter::CreateCondition(PackageMatchField field, const RequestMatch& match, const Utility::NameNormalizer* normalizer)
+    {
+        Condition result{ field, match.Type, Utility::FoldCase(match.Value), {} };
+
+        if (match.Additional)
+        {
+            result.Additional = Utility::FoldCase(match.Additional.value());
+        }
+
+        if (field == PackageMatchField::NormalizedNameAndPublisher && normalizer && match.Type == MatchType::Exact)
+        {
+            Utility::NormalizedName normalized = normalizer->Normalize(result.Value, result.Additional);
+            result.Value = normalized.Name();
+            result.Additional = normalized.Publisher();
+        }
+
+        return result;
+    }
+
+    bool InstalledPackageFilter::CouldMatchQuery(FoldedEntry& entry) const
+    {
+        // The query is matched against all of the fields that installed entries populate.
+        for (PackageMatchField field : { PackageMatchField::Id, PackageMatchField::Name, PackageMatchField::Moniker, PackageMatchField::Tag, PackageMatchField::PackageFamilyName, PackageMatchField::ProductCode })
+        {
+            Condition condition = m_query.value();
+            condition.Field = field;
+
+            if (CouldMatchCondition(entry, condition))
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool InstalledPackageFilter::CouldMatchCondition(FoldedEntry& entry, const Condition& condition) const
+    {
+        switch (condition.Field)
+        {
+        case PackageMatchField::Id:
+            return ValueCouldMatch(condition.Type, condition.Value, entry.Id);
+        case PackageMatchField::Name:
+            return !entry.Name || ValueCouldMatch(condition.Type, condition.Value, entry.Name.value());
+        case PackageMatchField::Moniker:
+            // Installed entries have an empty moniker.
+            return ValueCouldMatch(condition.Type, condition.Value, {});
+        case PackageMatchField::Command:
+            // Installed entries have no commands.
+            return false;
+        case PackageMatchField::Tag:
+            return !entry.Tag.empty() && ValueCouldMatch(condition.Type, condition.Value, entry.Tag);
+        case PackageMatchField::PackageFamilyName:
+            return !entry.PackageFamilyName.empty() && ValueCouldMatch(condition.Type, condition.Value, entry.PackageFamilyName);
+        case PackageMatchField::ProductCode:
+            return !entry.ProductCode.empty() && ValueCouldMatch(condition.Type, condition.Value, entry.ProductCode);
+        case PackageMatchField::NormalizedNameAndPublisher:
+            if (condition.Type != MatchType::Exact || !m_normalizer || !entry.Name || !entry.Publisher)
+            {
+                return true;
+            }
+
+            if (!entry.NormalizedName)
+            {
+                entry.NormalizedName = m_normalizer->NormalizeName(entry.Name.value()).Name();
+                entry.NormalizedPublisher = m_normalizer->NormalizePublisher(entry.Publisher.value());
+            }
+
+            return entry.NormalizedName.value() == condition.Value && entry.NormalizedPublisher.value() == condition.Additional;
+        default:
+            // Fields that are not understood here could match anything.
+            return true;
+        }
+    }
+
+    bool InstalledEntryTracker::ShouldExamine(const std::string& key, std::string_view location) const
+    {
+        auto itr = m_entries.find(key);
+        return (itr == m_entries.end() || (!itr->second.Added && itr->second.Location == location));
+    }
+
+    void InstalledEntryTracker::RecordValid(const std::string& key, std::string_view location, bool added)
+    {
+        auto& state = m_entries[key];
+
+        if (state.Location.empty())
+        {
+            state.Location = location;
+        }
+
+        state.Added = state.Added || added;
+    }
+}
@@ -0,0 +1,89 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Public/winget/RepositorySearch.h"
+#include <winget/NameNormalization.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // The values of an installed package entry that a filter is evaluated against.
+    // Name and Publisher are read from the system after the other values; while they are not set,
+    // any condition on them is assumed to match.
+    struct InstalledPackageEntry
+    {
+        std::string_view Id;
+        std::string_view Tag;
+        std::string_view ProductCode;
+        std::string_view PackageFamilyName;
+        std::optional<std::string_view> Name;
+        std::optional<std::string_view> Publisher;
+    };
+
+    // A conservative form of a search request, used to skip installed entries before the rest of their data is read
+    // and they are added to the index. An entry is only rejected if the index could not return it for the request,
+    // so searching an index that holds just the accepted entries gives the same results as searching a full one.
+    struct InstalledPackageFilter
+    {
+        // Creates a filter that accepts every entry.
+        InstalledPackageFilter() = default;
+
+        // Creates a filter for the request.
+        InstalledPackageFilter(const SearchRequest& request);
+
+        // Returns true if the filter accepts every entry.
+        bool IsForEverything() const { return m_isForEverything; }
+
+        // Returns true if the entry could be returned for the request.
+        bool CouldMatch(const InstalledPackageEntry& entry) const;
+
+    private:
+        // A match from the request, with its values folded (and normalized for NormalizedNameAndPublisher).
+        struct Condition
+        {
+            PackageMatchField Field;
+            MatchType Type;
+            std::string Value;
+            std::string Additional;
+        };
+
+        struct FoldedEntry;
+
+        static Condition CreateCondition(PackageMatchField field, const RequestMatch& match, const Utility::NameNormalizer* normalizer);
+        bool CouldMatchQuery(FoldedEntry& entry) const;
+        bool CouldMatchCondition(FoldedEntry& entry, const Condition& condition) const;
+
+        bool m_isForEverything = true;
+        std::optional<Condition> m_query;
+        std::vector<Condition> m_inclusions;
+        std::vector<Condition> m_filters;
+        std::shared_ptr<Utility::NameNormalizer> m_normalizer;
+    };
+
+    // Tracks the installed entries examined while populating an index, so that populating the same index again
+    // with a different filter only adds the entries that are not already in it. When the same key is listed in
+    // more than one location, the first location in which it was found valid owns it, as with a full population.
+    struct InstalledEntryTracker
+    {
+        // Returns true if the entry at the location should be examined.
+        bool ShouldExamine(const std::string& key, std::string_view location) const;
+
+        // Records that the entry at the location was found valid, and whether it was added to the index.
+        void RecordValid(const std::string& key, std::string_view location, bool added);
+
+    private:
+        struct EntryState
+        {
+            std::string Location;
+            bool Added = false;
+        };
+
+        std::map<std::string, EntryState> m_entries;
+    };
+}
@@ -4,9 +4,16 @@
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
 #include "Microsoft/SQLiteIndex.h"
 #include "Microsoft/SQLiteIndexSource.h"
+#include "Microsoft/SQLiteIndexWarmup.h"
+#include "SourceMirrors.h"
+#include "SQLiteZipEntry.h"
 
 #include <AppInstallerDeployment.h>
 #include <AppInstallerMsixInfo.h>
+#include <winget/GroupPolicy.h>
+
+#include <AclAPI.h>
+#include <sddl.h>
 
 using namespace std::string_literals;
 using namespace std::string_view_literals;
@@ -20,13 +27,21 @@ namespace AppInstaller::Repository::Microsoft
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFileName = "index.db"sv;
         // TODO: This being hard coded to force using the Public directory name is not ideal.
         static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexFilePath = "Public\\index.db"sv;
-
-        // Construct the package location from the given details.
-        // Currently expects that the arg is an https uri pointing to the root of the data.
-        std::string GetPackageLocation(const SourceDetails& details)
+        // The same file, as named by the ZIP central directory of the package.
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_IndexZipEntryName = "Public/index.db"sv;
+        // The files of the machine-wide shared data, and the file recording which shared version a user has verified.
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_SharedCurrentFileName = "current"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_SharedLockFileName = "update.lock"sv;
+        static constexpr std::string_view s_PreIndexedPackageSourceFactory_SharedVerifiedFileName = "shared.verified"sv;
+        // Administrators and SYSTEM own and can change the shared data; users can only read it.
+        static constexpr std::wstring_view s_PreIndexedPackageSourceFactory_SharedRootSecurityDescriptor = L"O:BAD:P(A;OICI;FA;;;SY)(A;OICI;FA;;;BA)(A;OICI;FRFX;;;BU)"sv;
+
+        // Construct the package location from the given source location (the arg or one of the mirrors).
+        // Currently expects that the location is an https uri pointing to the root of the data.
+        std::string GetPackageLocation(const std::string& location)
         {
-            THROW_HR_IF(E_INVALIDARG, details.Arg.empty());
-            std::string result = details.Arg;
+            THROW_HR_IF(E_INVALIDARG, location.empty());
+            std::string result = location;
             if (result.back() != '/')
             {
                 result += '/';
@@ -35,6 +50,12 @@ namespace AppInstaller::Repository::Microsoft
             return result;
         }
 
+        // Remote package locations must be secure.
+        bool IsLocationSecure(const std::string& packageLocation)
+        {
+            return !Utility::IsUrlRemote(packageLocation) || Utility::IsUrlSecure(packageLocation);
+        }
+
         // Gets the package family name from the details.
         std::string GetPackageFamilyNameFromDetails(const SourceDetails& details)
         {
@@ -75,28 +96,36 @@ namespace AppInstaller::Repository::Microsoft
                     THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
                 }
 
-                std::string packageLocation = GetPackageLocation(details);
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_NOT_SECURE, !IsLocationSecure(GetPackageLocation(details.Arg)));
+                for (const auto& mirror : details.Mirrors)
+                {
+                    THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_NOT_SECURE, !IsLocationSecure(GetPackageLocation(mirror)));
+                }
 
-                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_NOT_SECURE, Utility::IsUrlRemote(packageLocation) && !Utility::IsUrlSecure(packageLocation));
+                // The index is large, so its download time says little about the latency of the location.
+                return ExecuteWithSourceLocations(details, [&](const std::string& location)
+                    {
+                        std::string packageLocation = GetPackageLocation(location);
 
-                AICLI_LOG(Repo, Info, << "Initializing source from: " << details.Name << " => " << packageLocation);
+                        AICLI_LOG(Repo, Info, << "Initializing source from: " << details.Name << " => " << packageLocation);
 
-                Msix::MsixInfo packageInfo(packageLocation);
-                THROW_HR_IF(APPINSTALLER_CLI_ERROR_PACKAGE_IS_BUNDLE, packageInfo.GetIsBundle());
+                        Msix::MsixInfo packageInfo(packageLocation);
+                        THROW_HR_IF(APPINSTALLER_CLI_ERROR_PACKAGE_IS_BUNDLE, packageInfo.GetIsBundle());
 
-                auto fullName = packageInfo.GetPackageFullName();
-                AICLI_LOG(Repo, Info, << "Found package full name: " << details.Name << " => " << fullName);
+                        auto fullName = packageInfo.GetPackageFullName();
+                        AICLI_LOG(Repo, Info, << "Found package full name: " << details.Name << " => " << fullName);
 
-                details.Data = Msix::GetPackageFamilyNameFromFullName(fullName);
-                details.Identifier = Msix::GetPackageFamilyNameFromFullName(fullName);
+                        details.Data = Msix::GetPackageFamilyNameFromFullName(fullName);
+                        details.Identifier = Msix::GetPackageFamilyNameFromFullName(fullName);
 
-                auto lock = LockExclusive(details, progress);
-                if (!lock)
-                {
-                    return false;
-                }
+                        auto lock = LockExclusive(details, progress);
+                        if (!lock)
+                        {
+                            return false;
+                        }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                        return UpdateInternal(packageLocation, packageInfo, details, progress);
+                    }, false);
             }
 
             bool Update(const SourceDetails& details, IProgressCallback& progress) override final
@@ -143,29 +172,33 @@ namespace AppInstaller::Repository::Microsoft
             {
                 THROW_HR_IF(E_INVALIDARG, details.Type != PreIndexedPackageSourceFactory::Type());
 
-                std::string packageLocation = GetPackageLocation(details);
-                Msix::MsixInfo packageInfo(packageLocation);
+                // Content from any location is held to the same checks; a mirror that fails them is moved past.
+                return ExecuteWithSourceLocations(details, [&](const std::string& location)
+                    {
+                        std::string packageLocation = GetPackageLocation(location);
+                        Msix::MsixInfo packageInfo(packageLocation);
 
-                // The package should not be a bundle
-                THROW_HR_IF(APPINSTALLER_CLI_ERROR_PACKAGE_IS_BUNDLE, packageInfo.GetIsBundle());
+                        // The package should not be a bundle
+                        THROW_HR_IF(APPINSTALLER_CLI_ERROR_PACKAGE_IS_BUNDLE, packageInfo.GetIsBundle());
 
-                // Ensure that family name has not changed
-                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE,
-                    GetPackageFamilyNameFromDetails(details) != Msix::GetPackageFamilyNameFromFullName(packageInfo.GetPackageFullName()));
+                        // Ensure that family name has not changed
+                        THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE,
+                            GetPackageFamilyNameFromDetails(details) != Msix::GetPackageFamilyNameFromFullName(packageInfo.GetPackageFullName()));
 
-                if (progress.IsCancelled())
-                {
-                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
-                    return false;
-                }
+                        if (progress.IsCancelled())
+                        {
+                            AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                            return false;
+                        }
 
-                auto lock = LockExclusive(details, progress, isBackground);
-                if (!lock)
-                {
-                    return false;
-                }
+                        auto lock = LockExclusive(details, progress, isBackground);
+                        if (!lock)
+                        {
+                            return false;
+                        }
 
-                return UpdateInternal(packageLocation, packageInfo, details, progress);
+                        return UpdateInternal(packageLocation, packageInfo, details, progress);
+                    }, false);
             }
         };
 
@@ -214,7 +247,7 @@ namespace AppInstaller::Repository::Microsoft
                 std::filesystem::path indexLocation = extension->GetPackagePath();
                 indexLocation /= s_PreIndexedPackageSourceFactory_IndexFilePath;
 
-                SQLiteIndex index = SQLiteIndex::Open(indexLocation.u8string(), SQLiteIndex::OpenDisposition::Immutable);
+                SQLiteIndex index = SQLiteIndexWarmup::Instance().OpenIndex(IndexDataLocation{ indexLocation });
 
                 // We didn't use to store the source identifier, so we compute it here in case it's
                 // missing from the details.
@@ -222,6 +255,19 @@ namespace AppInstaller::Repository::Microsoft
                 return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
             }
 
+            void WarmUp() override
+            {
+                SQLiteIndexWarmup::Instance().WarmUp(GetPackageFamilyNameFromDetails(m_details), [details = m_details](IProgressCallback& progress)
+                    {
+                        auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(details), progress);
+                        auto extension = (lock ? GetExtensionFromDetails(details) : std::nullopt);
+                        if (extension)
+                        {
+                            SQLiteIndexWarmup::Instance().WarmUpIndex(IndexDataLocation{ extension->GetPackagePath() / s_PreIndexedPackageSourceFactory_IndexFilePath }, progress);
+                        }
+                    });
+            }
+
         private:
             SourceDetails m_details;
         };
@@ -329,6 +375,19 @@ namespace AppInstaller::Repository::Microsoft
             }
         };
 
+        // Removes the file if it exists, logging rather than failing if it cannot be.
+        void RemoveFileIfPresent(const std::filesystem::path& path)
+        {
+            try
+            {
+                if (std::filesystem::exists(path))
+                {
+                    std::filesystem::remove(path);
+                }
+            }
+            CATCH_LOG();
+        }
+
         // Constructs the location that we will write files to.
         std::filesystem::path GetStatePathFromDetails(const SourceDetails& details)
         {
@@ -338,6 +397,527 @@ namespace AppInstaller::Repository::Microsoft
             return result;
         }
 
+        // Determines if the state location holds source data.
+        bool StateHasData(const std::filesystem::path& packageState)
+        {
+            return std::filesystem::exists(packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName) &&
+                (std::filesystem::exists(packageState / s_PreIndexedPackageSourceFactory_IndexFileName) ||
+                    std::filesystem::exists(packageState / s_PreIndexedPackageSourceFactory_PackageFileName));
+        }
+
+        // Removes the source data from the state location, leaving any other files.
+        void RemoveDataFromState(const std::filesystem::path& packageState)
+        {
+            RemoveFileIfPresent(packageState / s_PreIndexedPackageSourceFactory_IndexFileName);
+            RemoveFileIfPresent(packageState / s_PreIndexedPackageSourceFactory_PackageFileName);
+            RemoveFileIfPresent(packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName);
+        }
+
+        // Finds the index in the state location; in place in the package if it was kept, or the extracted file otherwise.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        std::optional<IndexDataLocation> FindIndexInState(const std::filesystem::path& packageState)
+        {
+            std::filesystem::path packagePath = packageState / s_PreIndexedPackageSourceFactory_PackageFileName;
+            if (std::filesystem::exists(packagePath))
+            {
+                auto entry = SQLite::FindStoredZipEntry(packagePath, s_PreIndexedPackageSourceFactory_IndexZipEntryName);
+                if (entry)
+                {
+                    return IndexDataLocation{ packagePath, std::move(entry) };
+                }
+
+                AICLI_LOG(Repo, Verbose, << "Package at " << packagePath << " does not contain a stored index; falling back to extracted index");
+            }
+
+            std::filesystem::path indexPath = packageState / s_PreIndexedPackageSourceFactory_IndexFileName;
+
+            if (!std::filesystem::exists(indexPath))
+            {
+                AICLI_LOG(Repo, Info, << "Data not found at " << indexPath);
+                return {};
+            }
+
+            return IndexDataLocation{ indexPath };
+        }
+
+        // Opens the index from the state location.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        SQLiteIndex OpenIndexFromState(const std::filesystem::path& packageState)
+        {
+            auto location = FindIndexInState(packageState);
+            THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING, !location);
+
+            return SQLiteIndexWarmup::Instance().OpenIndex(location.value(), SQLiteIndex::OpenDisposition::Read);
+        }
+
+        // Verifies the uncompressed index data at the given location in the file against the block hashes from the package block map.
+        bool VerifyIndexAgainstBlockMap(const std::filesystem::path& file, uint64_t offset, uint64_t size, const std::vector<Utility::SHA256::HashBuffer>& blockHashes, IProgressCallback& progress)
+        {
+            constexpr uint64_t blockSize = Msix::MsixInfo::BlockMapBlockSize;
+            if (blockHashes.size() != (size + blockSize - 1) / blockSize)
+            {
+                AICLI_LOG(Repo, Error, << "Block map has " << blockHashes.size() << " blocks for index of size " << size);
+                return false;
+            }
+
+            std::ifstream stream{ file, std::ios_base::in | std::ios_base::binary };
+            THROW_LAST_ERROR_IF(!stream);
+            stream.seekg(static_cast<std::streamoff>(offset));
+
+            std::unique_ptr<uint8_t[]> buffer = std::make_unique<uint8_t[]>(static_cast<size_t>(blockSize));
+            uint64_t remaining = size;
+
+            for (const auto& expectedHash : blockHashes)
+            {
+                if (progress.IsCancelled())
+                {
+                    return false;
+                }
+
+                uint32_t toRead = static_cast<uint32_t>(std::min(remaining, blockSize));
+                stream.read(reinterpret_cast<char*>(buffer.get()), toRead);
+                if (!stream || static_cast<uint64_t>(stream.gcount()) != toRead ||
+                    !Utility::SHA256::AreEqual(expectedHash, Utility::SHA256::ComputeHash(buffer.get(), toRead)))
+                {
+                    AICLI_LOG(Repo, Error, << "Index in " << file << " does not match block map at offset " << (size - remaining));
+                    return false;
+                }
+
+                remaining -= toRead;
+            }
+
+            return true;
+        }
+
+        // Brings the package local to the state location. If the index is stored uncompressed the package is kept so that the index
+        // can be used in place, otherwise the index is extracted from it and the package is only kept if requested.
+        // Returns false if cancelled.
+        bool WritePackageToState(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const std::filesystem::path& packageState, bool keepPackage, IProgressCallback& progress)
+        {
+            std::filesystem::path manifestPath = packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName;
+            std::filesystem::path indexPath = packageState / s_PreIndexedPackageSourceFactory_IndexFileName;
+            std::filesystem::path packagePath = packageState / s_PreIndexedPackageSourceFactory_PackageFileName;
+
+            std::filesystem::path tempPackagePath = packagePath;
+            tempPackagePath += ".dnld";
+
+            auto removeTempPackage = wil::scope_exit([&]()
+                {
+                    try
+                    {
+                        if (std::filesystem::exists(tempPackagePath))
+                        {
+                            std::filesystem::remove(tempPackagePath);
+                        }
+                    }
+                    CATCH_LOG();
+                });
+
+            if (Utility::IsUrlRemote(packageLocation))
+            {
+                Utility::Download(packageLocation, tempPackagePath, Utility::DownloadType::Index, progress);
+            }
+            else
+            {
+                std::filesystem::copy_file(Utility::ConvertToUTF16(packageLocation), tempPackagePath, std::filesystem::copy_options::overwrite_existing);
+            }
+
+            if (progress.IsCancelled())
+            {
+                AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                return false;
+            }
+
+            bool useInPlace = false;
+
+            {
+                Msix::MsixInfo localPackageInfo(tempPackagePath.u8string());
+
+                // Ensure that the package did not change between inspecting it and bringing it local
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE, localPackageInfo.GetIsBundle() ||
+                    localPackageInfo.GetPackageFullName() != packageInfo.GetPackageFullName());
+
+                auto entry = SQLite::FindStoredZipEntry(tempPackagePath, s_PreIndexedPackageSourceFactory_IndexZipEntryName);
+                if (entry)
+                {
+                    // The block map is covered by the package signature, so this provides the same
+                    // guarantee that reading the file through the packaging APIs would.
+                    if (!VerifyIndexAgainstBlockMap(entry->ZipFile, entry->DataOffset, entry->Size, localPackageInfo.GetPayloadFileBlockHashes(s_PreIndexedPackageSourceFactory_IndexFilePath), progress))
+                    {
+                        if (progress.IsCancelled())
+                        {
+                            AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                            return false;
+                        }
+
+                        THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_INTEGRITY_FAILURE);
+                    }
+
+                    useInPlace = true;
+                }
+                else
+                {
+                    AICLI_LOG(Repo, Info, << "Index is compressed in the package; extracting it");
+                    localPackageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, indexPath, progress);
+                }
+
+                localPackageInfo.WriteManifestToFile(manifestPath, progress);
+            }
+
+            if (useInPlace || keepPackage)
+            {
+                std::filesystem::rename(tempPackagePath, packagePath);
+            }
+            else
+            {
+                RemoveFileIfPresent(packagePath);
+            }
+
+            if (useInPlace)
+            {
+                RemoveFileIfPresent(indexPath);
+            }
+
+            return true;
+        }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+        static bool s_PreIndexedPackageSourceFactory_TestHook_SharedDataTrusted = false;
+#endif
+
+        // The shared data is used by every user, so it can only be written by administrators (including SYSTEM).
+        bool CanWriteSharedData()
+        {
+#ifndef AICLI_DISABLE_TEST_HOOKS
+            if (s_PreIndexedPackageSourceFactory_TestHook_SharedDataTrusted)
+            {
+                return true;
+            }
+#endif
+
+            return Runtime::IsRunningAsAdmin();
+        }
+
+        // Creates the root of the shared data, if needed, such that only administrators and SYSTEM can change its contents.
+        void EnsureSharedRootExists(const std::filesystem::path& sharedRoot)
+        {
+            if (std::filesystem::exists(sharedRoot))
+            {
+                return;
+            }
+
+            std::filesystem::create_directories(sharedRoot.parent_path());
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+            if (s_PreIndexedPackageSourceFactory_TestHook_SharedDataTrusted)
+            {
+                std::filesystem::create_directory(sharedRoot);
+                return;
+            }
+#endif
+
+            wil::unique_hlocal_security_descriptor securityDescriptor;
+            THROW_IF_WIN32_BOOL_FALSE(ConvertStringSecurityDescriptorToSecurityDescriptorW(
+                s_PreIndexedPackageSourceFactory_SharedRootSecurityDescriptor.data(), SDDL_REVISION_1, &securityDescriptor, nullptr));
+
+            SECURITY_ATTRIBUTES attributes{ sizeof(attributes), securityDescriptor.get(), FALSE };
+            if (!CreateDirectoryW(sharedRoot.c_str(), &attributes))
+            {
+                DWORD error = GetLastError();
+                THROW_WIN32_IF(error, error != ERROR_ALREADY_EXISTS);
+            }
+        }
+
+        // The shared data can only be trusted if its root is owned by administrators or SYSTEM, as it is when created here;
+        // a user could otherwise have created it for others to read.
+        bool IsSharedRootTrusted(const std::filesystem::path& sharedRoot)
+        {
+#ifndef AICLI_DISABLE_TEST_HOOKS
+            if (s_PreIndexedPackageSourceFactory_TestHook_SharedDataTrusted)
+            {
+                return std::filesystem::exists(sharedRoot);
+            }
+#endif
+
+            if (!std::filesystem::exists(sharedRoot))
+            {
+                return false;
+            }
+
+            PSID owner = nullptr;
+            wil::unique_hlocal_security_descriptor securityDescriptor;
+            DWORD error = GetNamedSecurityInfoW(sharedRoot.c_str(), SE_FILE_OBJECT, OWNER_SECURITY_INFORMATION, &owner, nullptr, nullptr, nullptr, &securityDescriptor);
+            if (error != ERROR_SUCCESS)
+            {
+                AICLI_LOG(Repo, Warning, << "Unable to get the owner of the shared source data: " << error);
+                return false;
+            }
+
+            if (!IsWellKnownSid(owner, WinBuiltinAdministratorsSid) && !IsWellKnownSid(owner, WinLocalSystemSid))
+            {
+                AICLI_LOG(Repo, Warning, << "Shared source data at " << sharedRoot << " is not owned by administrators; ignoring it");
+                return false;
+            }
+
+            return true;
+        }
+
+        // Constructs the location of the shared data for the source.
+        std::filesystem::path GetSharedPathFromDetails(const SourceDetails& details)
+        {
+            std::filesystem::path result = Runtime::GetPathTo(Runtime::PathName::SharedState);
+            result /= PreIndexedPackageSourceFactory::Type();
+            result /= GetPackageFamilyNameFromDetails(details);
+            return result;
+        }
+
+        // Each version of the shared data is in its own directory, named for the package full name, that is not changed once
+        // it is complete. The current version is named by a file that is replaced when a new version is complete, after which
+        // the old versions are removed unless they are still open.
+        std::optional<std::filesystem::path> GetCurrentSharedVersion(const std::filesystem::path& sharedState)
+        {
+            std::ifstream stream{ sharedState / s_PreIndexedPackageSourceFactory_SharedCurrentFileName };
+            if (!stream)
+            {
+                return {};
+            }
+
+            std::string name;
+            std::getline(stream, name);
+
+            if (name.empty() || name.find_first_of("\\/:") != std::string::npos || name.front() == '.')
+            {
+                AICLI_LOG(Repo, Warning, << "Current shared source data version is not valid: " << name);
+                return {};
+            }
+
+            std::filesystem::path result = sharedState / Utility::ConvertToUTF16(name);
+            if (!StateHasData(result))
+            {
+                return {};
+            }
+
+            return result;
+        }
+
+        // *Should only be called when holding the lock from LockSharedData*
+        void SetCurrentSharedVersion(const std::filesystem::path& sharedState, const std::string& name)
+        {
+            std::filesystem::path currentPath = sharedState / s_PreIndexedPackageSourceFactory_SharedCurrentFileName;
+            std::filesystem::path tempPath = currentPath;
+            tempPath += ".tmp";
+
+            {
+                std::ofstream stream{ tempPath, std::ios_base::out | std::ios_base::trunc };
+                stream << name;
+                THROW_HR_IF(E_FAIL, !stream);
+            }
+
+            std::filesystem::rename(tempPath, currentPath);
+        }
+
+        // *Should only be called when holding the lock from LockSharedData*
+        void RemoveOtherSharedVersions(const std::filesystem::path& sharedState, const std::filesystem::path& currentVersion)
+        {
+            for (const auto& entry : std::filesystem::directory_iterator{ sharedState })
+            {
+                if (entry.is_directory() && entry.path() != currentVersion)
+                {
+                    try
+                    {
+                        std::filesystem::remove_all(entry.path());
+                    }
+                    catch (const std::exception&)
+                    {
+                        // It will be removed by a later update once it is no longer open.
+                        AICLI_LOG(Repo, Info, << "Unable to remove old shared source data, it is likely still in use: " << entry.path());
+                    }
+                }
+            }
+        }
+
+        // Locks the shared data for updating. A lock on a file is used as, unlike the named lock, it covers every session on the machine.
+        // Returns an empty handle if cancelled.
+        wil::unique_hfile LockSharedData(const std::filesystem::path& sharedState, IProgressCallback& progress)
+        {
+            wil::unique_hfile file{ CreateFileW((sharedState / s_PreIndexedPackageSourceFactory_SharedLockFileName).c_str(),
+                GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_ALWAYS, FILE_FLAG_OVERLAPPED, nullptr) };
+            THROW_LAST_ERROR_IF(!file);
+
+            wil::unique_event completed{ wil::EventOptions::ManualReset };
+            OVERLAPPED overlapped{};
+            overlapped.hEvent = completed.get();
+
+            if (!LockFileEx(file.get(), LOCKFILE_EXCLUSIVE_LOCK, 0, 1, 0, &overlapped))
+            {
+                DWORD error = GetLastError();
+                THROW_WIN32_IF(error, error != ERROR_IO_PENDING);
+
+                if (Synchronization::WaitForSingleObjectOrCancellation(completed.get(), progress) != Synchronization::WaitResult::Signaled)
+                {
+                    CancelIoEx(file.get(), &overlapped);
+                }
+
+                DWORD unused = 0;
+                if (!GetOverlappedResult(file.get(), &overlapped, &unused, TRUE))
+                {
+                    error = GetLastError();
+                    THROW_WIN32_IF(error, error != ERROR_OPERATION_ABORTED);
+                    return {};
+                }
+            }
+
+            return file;
+        }
+
+        // Verifies the shared version against the signed block map of its package.
+        bool VerifySharedVersion(const std::filesystem::path& versionState, const SourceDetails& details, IProgressCallback& progress)
+        {
+            std::filesystem::path packagePath = versionState / s_PreIndexedPackageSourceFactory_PackageFileName;
+            Msix::MsixInfo packageInfo(packagePath.u8string());
+
+            std::string fullName = packageInfo.GetPackageFullName();
+            if (packageInfo.GetIsBundle() || fullName != versionState.filename().u8string() ||
+                Msix::GetPackageFamilyNameFromFullName(fullName) != GetPackageFamilyNameFromDetails(details))
+            {
+                AICLI_LOG(Repo, Error, << "Shared source data package does not match its location: " << fullName);
+                return false;
+            }
+
+            auto blockHashes = packageInfo.GetPayloadFileBlockHashes(s_PreIndexedPackageSourceFactory_IndexFilePath);
+
+            auto entry = SQLite::FindStoredZipEntry(packagePath, s_PreIndexedPackageSourceFactory_IndexZipEntryName);
+            if (entry)
+            {
+                return VerifyIndexAgainstBlockMap(entry->ZipFile, entry->DataOffset, entry->Size, blockHashes, progress);
+            }
+
+            std::filesystem::path indexPath = versionState / s_PreIndexedPackageSourceFactory_IndexFileName;
+            return VerifyIndexAgainstBlockMap(indexPath, 0, std::filesystem::file_size(indexPath), blockHashes, progress);
+        }
+
+        // Records that this user has verified the shared version, so that it is not verified again.
+        void RecordSharedVersionVerified(const std::filesystem::path& userState, const std::string& versionName)
+        {
+            std::filesystem::create_directories(userState);
+            std::ofstream stream{ userState / s_PreIndexedPackageSourceFactory_SharedVerifiedFileName, std::ios_base::out | std::ios_base::trunc };
+            stream << versionName;
+        }
+
+        // Determines whether this user can use the shared version, verifying it the first time that they do.
+        bool EnsureSharedVersionVerified(const std::filesystem::path& versionState, const SourceDetails& details, const std::filesystem::path& userState, IProgressCallback& progress)
+        {
+            std::string versionName = versionState.filename().u8string();
+            std::string verifiedVersion;
+            {
+                std::ifstream stream{ userState / s_PreIndexedPackageSourceFactory_SharedVerifiedFileName };
+                std::getline(stream, verifiedVersion);
+            }
+
+            if (verifiedVersion == versionName)
+            {
+                return true;
+            }
+
+            if (!VerifySharedVersion(versionState, details, progress))
+            {
+                if (!progress.IsCancelled())
+                {
+                    AICLI_LOG(Repo, Error, << "Shared source data failed verification, it will not be used: " << versionState);
+                }
+
+                return false;
+            }
+
+            RecordSharedVersionVerified(userState, versionName);
+            return true;
+        }
+
+        // Determines whether the shared version is at least as new as the data for this user, which is only written when the shared data is older than the source.
+        bool IsSharedVersionCurrent(const std::filesystem::path& versionState, const std::filesystem::path& userState)
+        {
+            if (!StateHasData(userState))
+            {
+                return true;
+            }
+
+            Msix::MsixInfo sharedPackageInfo((versionState / s_PreIndexedPackageSourceFactory_PackageFileName).u8string());
+            return sharedPackageInfo.IsNewerThan(userState / s_PreIndexedPackageSourceFactory_AppxManifestFileName);
+        }
+
+        // Opens the index from the current shared version, unless the data for this user is newer.
+        // Each user verifies a version the first time that they use it.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        std::optional<SQLiteIndex> TryOpenIndexFromSharedState(const SourceDetails& details, const std::filesystem::path& userState, IProgressCallback& progress)
+        {
+            if (!IsSharedRootTrusted(Runtime::GetPathTo(Runtime::PathName::SharedState)))
+            {
+                return {};
+            }
+
+            std::filesystem::path sharedState = GetSharedPathFromDetails(details);
+
+            // A new version can replace the current one, and remove it, between reading its name and opening it.
+            for (size_t attempt = 0; attempt < 2; ++attempt)
+            {
+                auto currentVersion = GetCurrentSharedVersion(sharedState);
+                if (!currentVersion)
+                {
+                    return {};
+                }
+
+                try
+                {
+                    if (!IsSharedVersionCurrent(currentVersion.value(), userState))
+                    {
+                        return {};
+                    }
+
+                    if (!EnsureSharedVersionVerified(currentVersion.value(), details, userState, progress))
+                    {
+                        return {};
+                    }
+
+                    AICLI_LOG(Repo, Info, << "Opening shared source data: " << currentVersion.value());
+                    return OpenIndexFromState(currentVersion.value());
+                }
+                catch (...)
+                {
+                    if (attempt != 0 || GetCurrentSharedVersion(sharedState) == currentVersion)
+                    {
+                        throw;
+                    }
+
+                    AICLI_LOG(Repo, Info, << "Shared source data was replaced while opening it; retrying");
+                }
+            }
+
+            return {};
+        }
+
+        // Finds the index that opening the source would use, without verifying the shared data; only for reading ahead of the open.
+        // *Should only be called when under a CrossProcessReaderWriteLock*
+        std::optional<IndexDataLocation> FindIndexToWarmUp(const SourceDetails& details)
+        {
+            std::filesystem::path userState = GetStatePathFromDetails(details);
+
+            if (Settings::GroupPolicies().IsEnabled(Settings::TogglePolicy::Policy::SharedSourceData) &&
+                IsSharedRootTrusted(Runtime::GetPathTo(Runtime::PathName::SharedState)))
+            {
+                auto currentVersion = GetCurrentSharedVersion(GetSharedPathFromDetails(details));
+                if (currentVersion && IsSharedVersionCurrent(currentVersion.value(), userState))
+                {
+                    auto location = FindIndexInState(currentVersion.value());
+                    if (location)
+                    {
+                        return location;
+                    }
+                }
+            }
+
+            return FindIndexInState(userState);
+        }
+
         struct DesktopContextSourceReference : public ISourceReference
         {
             DesktopContextSourceReference(const SourceDetails& details) : m_details(details)
@@ -360,21 +940,36 @@ namespace AppInstaller::Repository::Microsoft
                     return {};
                 }
 
-                std::filesystem::path packageLocation = GetStatePathFromDetails(m_details);
-                packageLocation /= s_PreIndexedPackageSourceFactory_IndexFileName;
+                std::filesystem::path userState = GetStatePathFromDetails(m_details);
+                std::optional<SQLiteIndex> index;
 
-                if (!std::filesystem::exists(packageLocation))
+                if (Settings::GroupPolicies().IsEnabled(Settings::TogglePolicy::Policy::SharedSourceData))
                 {
-                    AICLI_LOG(Repo, Info, << "Data not found at " << packageLocation);
-                    THROW_HR(APPINSTALLER_CLI_ERROR_SOURCE_DATA_MISSING);
+                    index = TryOpenIndexFromSharedState(m_details, userState, progress);
                 }
 
-                SQLiteIndex index = SQLiteIndex::Open(packageLocation.u8string(), SQLiteIndex::OpenDisposition::Read);
+                if (!index)
+                {
+                    index = OpenIndexFromState(userState);
+                }
 
                 // We didn't use to store the source identifier, so we compute it here in case it's
                 // missing from the details.
                 m_details.Identifier = GetPackageFamilyNameFromDetails(m_details);
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), std::move(lock));
+                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index).value(), std::move(lock));
+            }
+
+            void WarmUp() override
+            {
+                SQLiteIndexWarmup::Instance().WarmUp(GetPackageFamilyNameFromDetails(m_details), [details = m_details](IProgressCallback& progress)
+                    {
+                        auto lock = Synchronization::CrossProcessReaderWriteLock::LockShared(CreateNameForCPRWL(details), progress);
+                        auto location = (lock ? FindIndexToWarmUp(details) : std::nullopt);
+                        if (location)
+                        {
+                            SQLiteIndexWarmup::Instance().WarmUpIndex(location.value(), progress);
+                        }
+                    });
             }
 
         private:
@@ -389,19 +984,25 @@ namespace AppInstaller::Repository::Microsoft
                 return std::make_shared<DesktopContextSourceReference>(details);
             }
 
-            bool UpdateInternal(const std::string&, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) override
+            bool UpdateInternal(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress) override
             {
-                // We will extract the manifest and index files directly to this location
+                if (Settings::GroupPolicies().IsEnabled(Settings::TogglePolicy::Policy::SharedSourceData))
+                {
+                    std::optional<bool> result = UpdateSharedData(packageLocation, packageInfo, details, progress);
+                    if (result)
+                    {
+                        return result.value();
+                    }
+                }
+
+                // We will keep the package, or extract the index file from it, directly to this location
                 std::filesystem::path packageState = GetStatePathFromDetails(details);
                 std::filesystem::create_directories(packageState);
 
-                std::filesystem::path manifestPath = packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName;
-                std::filesystem::path indexPath = packageState / s_PreIndexedPackageSourceFactory_IndexFileName;
-
-                if (std::filesystem::exists(manifestPath) && std::filesystem::exists(indexPath))
+                if (StateHasData(packageState))
                 {
                     // If we already have a manifest, use it to determine if we need to update or not.
-                    if (!packageInfo.IsNewerThan(manifestPath))
+                    if (!packageInfo.IsNewerThan(packageState / s_PreIndexedPackageSourceFactory_AppxManifestFileName))
                     {
                         AICLI_LOG(Repo, Info, << "Remote source data was not newer than existing, no update needed");
                         return true;
@@ -414,14 +1015,12 @@ namespace AppInstaller::Repository::Microsoft
                     return false;
                 }
 
-                packageInfo.WriteToFile(s_PreIndexedPackageSourceFactory_IndexFilePath, indexPath, progress);
-                packageInfo.WriteManifestToFile(manifestPath, progress);
-
-                return true;
+                return WritePackageToState(packageLocation, packageInfo, packageState, false, progress);
             }
 
             bool RemoveInternal(const SourceDetails& details, IProgressCallback&) override
             {
+                // The shared data is left for the other users of the machine.
                 std::filesystem::path packageState = GetStatePathFromDetails(details);
 
                 if (!std::filesystem::exists(packageState))
@@ -436,6 +1035,112 @@ namespace AppInstaller::Repository::Microsoft
 
                 return true;
             }
+
+        private:
+            // Updates the shared data if this process can write it, or determines that it is already up to date.
+            // Returns an empty value if the data for this user must be updated instead.
+            std::optional<bool> UpdateSharedData(const std::string& packageLocation, Msix::MsixInfo& packageInfo, const SourceDetails& details, IProgressCallback& progress)
+            {
+                std::filesystem::path sharedRoot = Runtime::GetPathTo(Runtime::PathName::SharedState);
+                bool canWrite = CanWriteSharedData();
+
+                if (canWrite)
+                {
+                    EnsureSharedRootExists(sharedRoot);
+                }
+
+                if (!IsSharedRootTrusted(sharedRoot))
+                {
+                    return {};
+                }
+
+                std::filesystem::path sharedState = GetSharedPathFromDetails(details);
+                std::filesystem::path userState = GetStatePathFromDetails(details);
+
+                auto currentVersion = GetCurrentSharedVersion(sharedState);
+                if (currentVersion && !packageInfo.IsNewerThan(currentVersion.value() / s_PreIndexedPackageSourceFactory_AppxManifestFileName))
+                {
+                    return UseCurrentSharedVersion(currentVersion.value(), details, userState, progress);
+                }
+
+                if (!canWrite)
+                {
+                    AICLI_LOG(Repo, Info, << "Shared source data is out of date and cannot be updated by this user; updating data for this user");
+                    return {};
+                }
+
+                std::filesystem::create_directories(sharedState);
+                wil::unique_hfile lock = LockSharedData(sharedState, progress);
+                if (!lock)
+                {
+                    AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                    return false;
+                }
+
+                // Another process may have updated the data while this one waited for the lock.
+                currentVersion = GetCurrentSharedVersion(sharedState);
+                if (currentVersion && !packageInfo.IsNewerThan(currentVersion.value() / s_PreIndexedPackageSourceFactory_AppxManifestFileName))
+                {
+                    AICLI_LOG(Repo, Info, << "Shared source data was updated by another process while waiting");
+                    return UseCurrentSharedVersion(currentVersion.value(), details, userState, progress);
+                }
+
+                std::string versionName = packageInfo.GetPackageFullName();
+                std::filesystem::path versionState = sharedState / Utility::ConvertToUTF16(versionName);
+                std::filesystem::path tempState = versionState;
+                tempState += ".tmp";
+
+                // Remove anything left by an update that did not complete.
+                std::filesystem::remove_all(tempState);
+                std::filesystem::remove_all(versionState);
+                std::filesystem::create_directories(tempState);
+
+                auto removeTempState = wil::scope_exit([&]()
+                    {
+                        try
+                        {
+                            std::filesystem::remove_all(tempState);
+                        }
+                        CATCH_LOG();
+                    });
+
+                // The package is always kept so that each user can verify the index against it.
+                if (!WritePackageToState(packageLocation, packageInfo, tempState, true, progress))
+                {
+                    return false;
+                }
+
+                std::filesystem::rename(tempState, versionState);
+                SetCurrentSharedVersion(sharedState, versionName);
+                AICLI_LOG(Repo, Info, << "Updated shared source data: " << versionState);
+
+                RemoveOtherSharedVersions(sharedState, versionState);
+
+                // The index was verified as it was written.
+                RecordSharedVersionVerified(userState, versionName);
+                RemoveDataFromState(userState);
+                return true;
+            }
+
+            // Uses the current shared version, which is not older than the remote data, in place of the data for this user.
+            // Returns an empty value if it cannot be used.
+            std::optional<bool> UseCurrentSharedVersion(const std::filesystem::path& versionState, const SourceDetails& details, const std::filesystem::path& userState, IProgressCallback& progress)
+            {
+                if (!EnsureSharedVersionVerified(versionState, details, userState, progress))
+                {
+                    if (progress.IsCancelled())
+                    {
+                        AICLI_LOG(Repo, Info, << "Cancelling update upon request");
+                        return false;
+                    }
+
+                    return {};
+                }
+
+                AICLI_LOG(Repo, Info, << "Shared source data is not older than remote, no update needed");
+                RemoveDataFromState(userState);
+                return true;
+            }
         };
     }
 
@@ -450,4 +1155,11 @@ namespace AppInstaller::Repository::Microsoft
             return std::make_unique<DesktopContextFactory>();
         }
     }
+
+#ifndef AICLI_DISABLE_TEST_HOOKS
+    void TestHook_SetSharedSourceDataTrusted(bool value)
+    {
+        s_PreIndexedPackageSourceFactory_TestHook_SharedDataTrusted = value;
+    }
+#endif
 }
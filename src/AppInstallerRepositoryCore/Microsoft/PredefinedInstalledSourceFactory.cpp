@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "Microsoft/ARPHelper.h"
+#include "Microsoft/InstalledPackageFilter.h"
 #include "Microsoft/PredefinedInstalledSourceFactory.h"
 #include "Microsoft/SQLiteIndex.h"
 #include "Microsoft/SQLiteIndexSource.h"
@@ -10,6 +11,8 @@
 #include <winget/Registry.h>
 #include <AppInstallerArchitecture.h>
 
+#include <shared_mutex>
+
 using namespace std::string_literals;
 using namespace std::string_view_literals;
 
@@ -17,8 +20,10 @@ namespace AppInstaller::Repository::Microsoft
 {
     namespace
     {
-        // Populates the index with the entries from MSIX.
-        void PopulateIndexFromMSIX(SQLiteIndex& index)
+        constexpr std::string_view s_MSIXLocation = "MSIX"sv;
+
+        // Populates the index with the entries from MSIX that could match the filter and are not already in the index.
+        void PopulateIndexFromMSIX(SQLiteIndex& index, const InstalledPackageFilter& filter, InstalledEntryTracker& tracker)
         {
             using namespace winrt::Windows::ApplicationModel;
             using namespace winrt::Windows::Management::Deployment;
@@ -50,8 +55,25 @@ namespace AppInstaller::Repository::Microsoft
                 }
 
                 auto packageId = package.Id();
+                std::string fullName = Utility::ConvertToUTF8(packageId.FullName());
+                if (!tracker.ShouldExamine(fullName, s_MSIXLocation))
+                {
+                    continue;
+                }
+
                 Utility::NormalizedString familyName = Utility::ConvertToUTF8(packageId.FamilyName());
 
+                // Check the filter before retrieving the localized DisplayName, which is comparatively expensive.
+                InstalledPackageEntry filterEntry;
+                filterEntry.Id = familyName;
+                filterEntry.Tag = "msix"sv;
+                filterEntry.PackageFamilyName = familyName;
+
+                if (!filter.CouldMatch(filterEntry))
+                {
+                    continue;
+                }
+
                 manifest.Id = familyName;
 
                 bool isPackageNameSet = false;
@@ -81,6 +103,14 @@ namespace AppInstaller::Repository::Microsoft
                     manifest.DefaultLocalization.Add<Manifest::Localization::PackageName>(Utility::ConvertToUTF8(packageId.Name()));
                 }
 
+                std::string packageName = manifest.DefaultLocalization.Get<Manifest::Localization::PackageName>();
+                filterEntry.Name = packageName;
+
+                if (!filter.CouldMatch(filterEntry))
+                {
+                    continue;
+                }
+
                 std::ostringstream strstr;
                 auto packageVersion = packageId.Version();
                 strstr << packageVersion.Major << '.' << packageVersion.Minor << '.' << packageVersion.Build << '.' << packageVersion.Revision;
@@ -91,12 +121,83 @@ namespace AppInstaller::Repository::Microsoft
 
                 // Use the full name as a unique key for the path
                 auto manifestId = index.AddManifest(manifest, std::filesystem::path{ packageId.FullName().c_str() });
+                tracker.RecordValid(fullName, s_MSIXLocation, true);
 
                 index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::InstalledType, 
                     Manifest::InstallerTypeToString(Manifest::InstallerTypeEnum::Msix));
             }
         }
 
+        // The installed packages source. Rather than reading every installed package when opened, the entries
+        // are read when a search needs them; only those that could match the request are added to the index,
+        // which then runs the search. Once a search for everything is made, the index holds every entry.
+        struct PredefinedInstalledSource : public ISource
+        {
+            PredefinedInstalledSource(const SourceDetails& details, PredefinedInstalledSourceFactory::Filter filter) :
+                m_filter(filter),
+                m_source(std::make_shared<SQLiteIndexSource>(
+                    details,
+                    SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest()),
+                    Synchronization::CrossProcessReaderWriteLock{},
+                    true))
+            {}
+
+            const std::string& GetIdentifier() const override { return m_source->GetIdentifier(); }
+
+            const SourceDetails& GetDetails() const override { return m_source->GetDetails(); }
+
+            SearchResult Search(const SearchRequest& request) const override
+            {
+                // Once every entry is in the index it no longer changes, so searches can run at the same time.
+                {
+                    std::shared_lock<std::shared_mutex> lock{ m_populateLock };
+
+                    if (m_isFullyPopulated)
+                    {
+                        return m_source->Search(request);
+                    }
+                }
+
+                // Until then, the search must not see the index while entries are being added to it (or rolled back).
+                std::unique_lock<std::shared_mutex> lock{ m_populateLock };
+
+                if (!m_isFullyPopulated)
+                {
+                    InstalledPackageFilter filter{ request };
+                    Populate(filter);
+                    m_isFullyPopulated = filter.IsForEverything();
+                }
+
+                return m_source->Search(request);
+            }
+
+        private:
+            void Populate(const InstalledPackageFilter& filter) const
+            {
+                SQLiteIndex& index = m_source->GetIndex();
+
+                // Put installed packages into the index
+                if (m_filter == PredefinedInstalledSourceFactory::Filter::None || m_filter == PredefinedInstalledSourceFactory::Filter::ARP)
+                {
+                    ARPHelper arpHelper;
+                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::Machine, filter, m_tracker);
+                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::User, filter, m_tracker);
+                }
+
+                if (m_filter == PredefinedInstalledSourceFactory::Filter::None || m_filter == PredefinedInstalledSourceFactory::Filter::MSIX)
+                {
+                    PopulateIndexFromMSIX(index, filter, m_tracker);
+                }
+            }
+
+            PredefinedInstalledSourceFactory::Filter m_filter;
+            std::shared_ptr<SQLiteIndexSource> m_source;
+            // Held exclusively while entries are added to the index, and shared by searches of the fully populated index.
+            mutable std::shared_mutex m_populateLock;
+            mutable bool m_isFullyPopulated = false;
+            mutable InstalledEntryTracker m_tracker;
+        };
+
         struct PredefinedInstalledSourceReference : public ISourceReference
         {
             PredefinedInstalledSourceReference(const SourceDetails& details) : m_details(details)
@@ -117,23 +218,7 @@ namespace AppInstaller::Repository::Microsoft
                 PredefinedInstalledSourceFactory::Filter filter = PredefinedInstalledSourceFactory::StringToFilter(m_details.Arg);
                 AICLI_LOG(Repo, Info, << "Creating PredefinedInstalledSource with filter [" << PredefinedInstalledSourceFactory::FilterToString(filter) << ']');
 
-                // Create an in memory index
-                SQLiteIndex index = SQLiteIndex::CreateNew(SQLITE_MEMORY_DB_CONNECTION_TARGET, Schema::Version::Latest());
-
-                // Put installed packages into the index
-                if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::ARP)
-                {
-                    ARPHelper arpHelper;
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::Machine);
-                    arpHelper.PopulateIndexFromARP(index, Manifest::ScopeEnum::User);
-                }
-
-                if (filter == PredefinedInstalledSourceFactory::Filter::None || filter == PredefinedInstalledSourceFactory::Filter::MSIX)
-                {
-                    PopulateIndexFromMSIX(index);
-                }
-
-                return std::make_shared<SQLiteIndexSource>(m_details, std::move(index), Synchronization::CrossProcessReaderWriteLock{}, true);
+                return std::make_shared<PredefinedInstalledSource>(m_details, filter);
             }
 
         private:
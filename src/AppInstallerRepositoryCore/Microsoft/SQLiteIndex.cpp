@@ -3,6 +3,7 @@
 #include "pch.h"
 #include "SQLiteIndex.h"
 #include "Schema/MetadataTable.h"
+#include "SQLiteVfs.h"
 #include <winget/ManifestYamlParser.h>
 
 namespace AppInstaller::Repository::Microsoft
@@ -23,44 +24,23 @@ namespace AppInstaller::Repository::Microsoft
                 return "Unknown";
             }
         }
-    }
-
-    SQLiteIndex SQLiteIndex::CreateNew(const std::string& filePath, Schema::Version version, CreateOptions options)
-    {
-        AICLI_LOG(Repo, Info, << "Creating new SQLite Index [" << version << "] at '" << filePath << "'");
-        SQLiteIndex result{ filePath, version };
-
-        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(result.m_dbconn, "sqliteindex_createnew");
 
-        Schema::MetadataTable::Create(result.m_dbconn);
-        // Use calculated version, as incoming version could be 'latest'
-        result.m_version.SetSchemaVersion(result.m_dbconn);
-
-        result.m_interface->CreateTables(result.m_dbconn, options);
-
-        result.SetLastWriteTime();
-
-        savepoint.Commit();
-
-        return result;
-    }
-
-    SQLiteIndex SQLiteIndex::Open(const std::string& filePath, OpenDisposition disposition)
-    {
-        AICLI_LOG(Repo, Info, << "Opening SQLite Index for " << GetOpenDispositionString(disposition) << " at '" << filePath << "'");
-        switch (disposition)
-        {
-        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Read:
-            return { filePath, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::None };
-        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::ReadWrite:
-            return { filePath, SQLite::Connection::OpenDisposition::ReadWrite, SQLite::Connection::OpenFlags::None };
-        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Immutable:
+        // Creates a URI target that opens the given file with the given query parameters; the parameters are changed
+        // to record the pages read from the file if the options ask for it.
+        std::string CreateUriTarget(const std::string& filePath, std::string_view parameters, SQLiteIndex::OpenOptions options = SQLiteIndex::OpenOptions::None)
         {
+            std::string recordingParameters;
+            if (options == SQLiteIndex::OpenOptions::RecordPageReads)
+            {
+                recordingParameters = SQLite::RecordPageReadsInUriParameters(parameters);
+                parameters = recordingParameters;
+            }
+
             // Following the algorithm set forth at https://sqlite.org/uri.html [3.1] to convert to a URI path
             // The execution order builds out the string so that it shouldn't require any moves (other than growing)
             std::string target;
-            // Add an 'arbitrary' growth size to prevent the majority of needing to grow (adding 'file:/' and '?immutable=1')
-            target.reserve(filePath.size() + 20);
+            // Add an 'arbitrary' growth size to prevent the majority of needing to grow (adding 'file:/' and '?')
+            target.reserve(filePath.size() + 20 + parameters.size());
 
             target += "file:";
 
@@ -97,15 +77,182 @@ namespace AppInstaller::Repository::Microsoft
                 wasLastCharSlash = wasThisCharSlash;
             }
 
-            target += "?immutable=1";
+            target += '?';
+            target += parameters;
+
+            return target;
+        }
+
+        // The URI query parameters for each disposition.
+        constexpr std::string_view s_ReadOnlyParameter = "mode=ro"sv;
+        constexpr std::string_view s_ReadWriteParameter = "mode=rw"sv;
+        constexpr std::string_view s_ImmutableParameter = "immutable=1"sv;
+
+        // Statements used to export an index for packaging.
+        // Objects that SQLite creates on its own, such as automatic indices, are left for it to create again.
+        constexpr std::string_view s_ExportStmt_GetSchemaObjects = R"(select [type], [name], [sql] from [sqlite_master] where [sql] is not null and [name] not like 'sqlite\_%' escape '\' order by [type] <> 'table', [rowid])"sv;
+        constexpr std::string_view s_ExportStmt_DisableJournal = "pragma journal_mode = off"sv;
+        constexpr std::string_view s_ExportStmt_DisableSync = "pragma synchronous = off"sv;
+        constexpr std::string_view s_ExportStmt_AttachWorking = "attach database ? as [working]"sv;
+        constexpr std::string_view s_ExportStmt_DetachWorking = "detach database [working]"sv;
+
+        // An object from the schema of a database.
+        struct SchemaObject
+        {
+            std::string Type;
+            std::string Name;
+            std::string Sql;
+        };
+
+        // Gets the objects in the schema of the database, tables first.
+        std::vector<SchemaObject> GetSchemaObjects(const SQLite::Connection& connection)
+        {
+            std::vector<SchemaObject> result;
+
+            SQLite::Statement select = SQLite::Statement::Create(connection, s_ExportStmt_GetSchemaObjects);
+            while (select.Step())
+            {
+                auto [type, name, sql] = select.GetRow<std::string, std::string, std::string>();
+                result.emplace_back(SchemaObject{ std::move(type), std::move(name), std::move(sql) });
+            }
+
+            return result;
+        }
 
-            return { target, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
+        // Creates the statement that copies all rows of the table from the working database, in rowid order.
+        std::string CreateCopyTableStatement(const SQLite::Connection& connection, const std::string& tableName)
+        {
+            std::vector<std::string> columns;
+            bool hasRowIdColumn = false;
+
+            SQLite::Statement tableInfo = SQLite::Statement::Create(connection, "pragma table_info([" + tableName + "])");
+            while (tableInfo.Step())
+            {
+                // Columns are [cid, name, type, notnull, dflt_value, pk]
+                columns.emplace_back(tableInfo.GetColumn<std::string>(1));
+                hasRowIdColumn = hasRowIdColumn || Utility::CaseInsensitiveEquals(columns.back(), SQLite::RowIDName);
+            }
+
+            // The rowids must be kept, as they are referenced from other tables.
+            if (!hasRowIdColumn)
+            {
+                columns.emplace(columns.begin(), SQLite::RowIDName);
+            }
+
+            std::ostringstream columnList;
+            for (size_t i = 0; i < columns.size(); ++i)
+            {
+                columnList << (i ? ", [" : "[") << columns[i] << ']';
+            }
+
+            std::ostringstream result;
+            result << "insert into [main].[" << tableName << "] (" << columnList.str() << ") select " << columnList.str() <<
+                " from [working].[" << tableName << "] order by [" << SQLite::RowIDName << ']';
+            return result.str();
         }
+    }
+
+    SQLiteIndex SQLiteIndex::CreateNew(const std::string& filePath, Schema::Version version, CreateOptions options)
+    {
+        AICLI_LOG(Repo, Info, << "Creating new SQLite Index [" << version << "] at '" << filePath << "'");
+        SQLiteIndex result{ filePath, version };
+
+        SQLite::Savepoint savepoint = SQLite::Savepoint::Create(result.m_dbconn, "sqliteindex_createnew");
+
+        Schema::MetadataTable::Create(result.m_dbconn);
+        // Use calculated version, as incoming version could be 'latest'
+        result.m_version.SetSchemaVersion(result.m_dbconn);
+
+        result.m_interface->CreateTables(result.m_dbconn, options);
+
+        result.SetLastWriteTime();
+
+        savepoint.Commit();
+
+        return result;
+    }
+
+    SQLiteIndex SQLiteIndex::Open(const std::string& filePath, OpenDisposition disposition, OpenOptions options)
+    {
+        AICLI_LOG(Repo, Info, << "Opening SQLite Index for " << GetOpenDispositionString(disposition) << " at '" << filePath << "'");
+
+        // Recording the page reads chooses the VFS through the URI, so the disposition is passed in it as well.
+        bool useUri = (options == OpenOptions::RecordPageReads);
+
+        switch (disposition)
+        {
+        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Read:
+            if (useUri)
+            {
+                return { CreateUriTarget(filePath, s_ReadOnlyParameter, options), SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
+            }
+            return { filePath, SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::None };
+        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::ReadWrite:
+            if (useUri)
+            {
+                return { CreateUriTarget(filePath, s_ReadWriteParameter, options), SQLite::Connection::OpenDisposition::ReadWrite, SQLite::Connection::OpenFlags::Uri };
+            }
+            return { filePath, SQLite::Connection::OpenDisposition::ReadWrite, SQLite::Connection::OpenFlags::None };
+        case AppInstaller::Repository::Microsoft::SQLiteIndex::OpenDisposition::Immutable:
+            return { CreateUriTarget(filePath, s_ImmutableParameter, options), SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
         default:
             THROW_HR(E_UNEXPECTED);
         }
     }
 
+    SQLiteIndex SQLiteIndex::Open(const SQLite::ZipStoredEntry& entry, OpenOptions options)
+    {
+        std::string zipFilePath = entry.ZipFile.u8string();
+        AICLI_LOG(Repo, Info, << "Opening SQLite Index for ImmutableRead from stored entry at '" << zipFilePath << "' [" << entry.DataOffset << ", " << entry.Size << "]");
+        std::string parameters{ s_ImmutableParameter };
+        parameters += '&';
+        parameters += SQLite::GetStoredZipEntryUriParameters(entry);
+        return { CreateUriTarget(zipFilePath, parameters, options), SQLite::Connection::OpenDisposition::ReadOnly, SQLite::Connection::OpenFlags::Uri };
+    }
+
+    SQLiteIndex& SQLiteIndex::operator=(SQLiteIndex&& other)
+    {
+        if (this != &other)
+        {
+            // The functions belong to the index being replaced, so they are called while its connection is still open.
+            CallOnClose();
+
+            m_dbconn = std::move(other.m_dbconn);
+            m_version = std::move(other.m_version);
+            m_interface = std::move(other.m_interface);
+            m_onClose = std::move(other.m_onClose);
+            other.m_onClose.clear();
+        }
+
+        return *this;
+    }
+
+    SQLiteIndex::~SQLiteIndex()
+    {
+        CallOnClose();
+    }
+
+    void SQLiteIndex::OnClose(std::function<void(SQLiteIndex&)> onClose)
+    {
+        m_onClose.emplace_back(std::move(onClose));
+    }
+
+    void SQLiteIndex::CallOnClose()
+    {
+        // The functions are called here rather than by the connection, so that they run outside of SQLite and can still use it.
+        std::vector<std::function<void(SQLiteIndex&)>> onCloseFunctions = std::move(m_onClose);
+        m_onClose.clear();
+
+        for (const auto& onClose : onCloseFunctions)
+        {
+            try
+            {
+                onClose(*this);
+            }
+            CATCH_LOG();
+        }
+    }
+
     SQLiteIndex::SQLiteIndex(const std::string& target, SQLite::Connection::OpenDisposition disposition, SQLite::Connection::OpenFlags flags) :
         m_dbconn(SQLite::Connection::Create(target, disposition, flags))
     {
@@ -243,6 +390,78 @@ namespace AppInstaller::Repository::Microsoft
         m_interface->PrepareForPackaging(m_dbconn);
     }
 
+    void SQLiteIndex::ExportForPackaging(const std::filesystem::path& target) const
+    {
+        AICLI_LOG(Repo, Info, << "Exporting index for packaging to '" << target.u8string() << "'");
+
+        std::string workingPath = m_dbconn.GetFilePath();
+        THROW_HR_IF(E_NOT_VALID_STATE, workingPath.empty());
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_FILE_EXISTS), std::filesystem::exists(target));
+
+        auto start = std::chrono::steady_clock::now();
+
+        // Determine the objects kept in the packaged index by preparing an empty copy of the schema,
+        // so that the schema version remains the only owner of what packaging removes.
+        std::vector<SchemaObject> packagedSchema;
+        {
+            SQLite::Connection schemaConnection = SQLite::Connection::Create(":memory:", SQLite::Connection::OpenDisposition::Create);
+            schemaConnection.EnableICU();
+
+            for (const auto& object : GetSchemaObjects(m_dbconn))
+            {
+                SQLite::Statement::Create(schemaConnection, object.Sql).Execute();
+            }
+
+            m_interface->PrepareForPackaging(schemaConnection);
+            packagedSchema = GetSchemaObjects(schemaConnection);
+        }
+
+        // The target is only complete once everything has been written; remove it on any failure.
+        auto removeTarget = wil::scope_exit([&]()
+            {
+                std::error_code error;
+                std::filesystem::remove(target, error);
+            });
+
+        {
+            SQLite::Connection packaged = SQLite::Connection::Create(target.u8string(), SQLite::Connection::OpenDisposition::Create);
+            packaged.EnableICU();
+
+            // A partially written target is never used, so it needs neither a journal nor syncs along the way.
+            SQLite::Statement::Create(packaged, s_ExportStmt_DisableJournal).Step();
+            SQLite::Statement::Create(packaged, s_ExportStmt_DisableSync).Execute();
+
+            SQLite::Statement attach = SQLite::Statement::Create(packaged, s_ExportStmt_AttachWorking);
+            attach.Bind(1, workingPath);
+            attach.Execute();
+
+            {
+                SQLite::Savepoint savepoint = SQLite::Savepoint::Create(packaged, "sqliteindex_exportforpackaging");
+
+                // Write the rows of each table in their final order, then build the indices over the complete tables.
+                // This leaves the pages packed, without the free space that VACUUM would otherwise need to remove.
+                for (const auto& object : packagedSchema)
+                {
+                    SQLite::Statement::Create(packaged, object.Sql).Execute();
+
+                    if (object.Type == "table")
+                    {
+                        SQLite::Statement::Create(packaged, CreateCopyTableStatement(packaged, object.Name)).Execute();
+                    }
+                }
+
+                savepoint.Commit();
+            }
+
+            SQLite::Statement::Create(packaged, s_ExportStmt_DetachWorking).Execute();
+        }
+
+        removeTarget.release();
+
+        AICLI_LOG(Repo, Info, << "Exported index for packaging in " <<
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms");
+    }
+
     bool SQLiteIndex::CheckConsistency(bool log) const
     {
         AICLI_LOG(Repo, Info, << "Checking index consistency...");
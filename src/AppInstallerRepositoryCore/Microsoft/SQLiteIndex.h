@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #pragma once
 #include "SQLiteWrapper.h"
+#include "SQLiteZipEntry.h"
 #include "Microsoft/Schema/ISQLiteIndex.h"
 #include "Microsoft/Schema/Version.h"
 #include "ISource.h"
@@ -12,6 +13,7 @@
 
 #include <chrono>
 #include <filesystem>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <optional>
@@ -40,7 +42,10 @@ namespace AppInstaller::Repository::Microsoft
         SQLiteIndex& operator=(const SQLiteIndex&) = delete;
 
         SQLiteIndex(SQLiteIndex&&) = default;
-        SQLiteIndex& operator=(SQLiteIndex&&) = default;
+        // Calls the OnClose functions of this index before taking over the other.
+        SQLiteIndex& operator=(SQLiteIndex&& other);
+
+        ~SQLiteIndex();
 
         // Creates a new index database of the given version.
         static SQLiteIndex CreateNew(const std::string& filePath, Schema::Version version = Schema::Version::Latest(), CreateOptions options = CreateOptions::None);
@@ -56,12 +61,29 @@ namespace AppInstaller::Repository::Microsoft
             Immutable,
         };
 
+        // Options for opening the index.
+        enum class OpenOptions
+        {
+            None,
+            // Record the pages that are read from the file of the index; see SQLite::Connection::GetPagesRead.
+            RecordPageReads,
+        };
+
         // Opens an existing index database.
-        static SQLiteIndex Open(const std::string& filePath, OpenDisposition disposition);
+        static SQLiteIndex Open(const std::string& filePath, OpenDisposition disposition, OpenOptions options = OpenOptions::None);
+
+        // Opens an existing index database that is stored uncompressed inside of a ZIP file, for immutable read.
+        static SQLiteIndex Open(const SQLite::ZipStoredEntry& entry, OpenOptions options = OpenOptions::None);
+
+        // Calls the function when the index is destroyed, before its connection is closed.
+        void OnClose(std::function<void(SQLiteIndex&)> onClose);
 
         // Gets the schema version of the index.
         Schema::Version GetVersion() const { return m_version; }
 
+        // Gets the connection to the database; for operations on the database file rather than the data of the index.
+        SQLite::Connection& GetConnection() { return m_dbconn; }
+
 #ifndef AICLI_DISABLE_TEST_HOOKS
         // Changes the version of the interface being used to operate on the database.
         // Should only be used for testing.
@@ -113,6 +135,11 @@ namespace AppInstaller::Repository::Microsoft
         // Removes data that is no longer needed for an index that is to be published.
         void PrepareForPackaging();
 
+        // Writes the index as PrepareForPackaging would leave it to a new database file at the target path,
+        // in a single pass and without modifying this index.
+        // The rows are written in their final order and only the indices kept for packaging are created.
+        void ExportForPackaging(const std::filesystem::path& target) const;
+
         // Checks the consistency of the index to ensure that every referenced row exists.
         // Returns true if index is consistent; false if it is not.
         bool CheckConsistency(bool log = false) const;
@@ -160,8 +187,12 @@ namespace AppInstaller::Repository::Microsoft
         // Sets the last write time metadata value in the index.
         void SetLastWriteTime();
 
+        // Calls and removes the OnClose functions.
+        void CallOnClose();
+
         SQLite::Connection m_dbconn;
         Schema::Version m_version;
         std::unique_ptr<Schema::ISQLiteIndex> m_interface;
+        std::vector<std::function<void(SQLiteIndex&)>> m_onClose;
     };
 }
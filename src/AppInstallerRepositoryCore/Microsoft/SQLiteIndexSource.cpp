@@ -3,6 +3,8 @@
 #include "pch.h"
 #include "Microsoft/SQLiteIndexSource.h"
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include "SourceMirrors.h"
+#include <winget/NetworkConnectivity.h>
 #include <winget/ManifestYamlParser.h>
 
 
@@ -79,7 +81,13 @@ namespace AppInstaller::Repository::Microsoft
                     manifestSHA256 = SHA256::ConvertToBytes(manifestHashString.value());
                 }
 
-                return GetManifestFromArgAndRelativePath(source->GetDetails().Arg, relativePathOpt.value(), manifestSHA256);
+                // The hash from the index is verified regardless of the location the manifest comes from.
+                const SourceDetails& details = source->GetDetails();
+                return ExecuteWithSourceLocations(details, [&](const std::string& location)
+                    {
+                        // With mirrors available, move on to the next one rather than retrying.
+                        return GetManifestFromArgAndRelativePath(location, relativePathOpt.value(), manifestSHA256, details.Mirrors.empty());
+                    });
             }
 
             Source GetSource() const override
@@ -101,7 +109,7 @@ namespace AppInstaller::Repository::Microsoft
             }
 
         private:
-            static Manifest::Manifest GetManifestFromArgAndRelativePath(const std::string& arg, const std::string& relativePath, const SHA256::HashBuffer& expectedHash)
+            static Manifest::Manifest GetManifestFromArgAndRelativePath(const std::string& arg, const std::string& relativePath, const SHA256::HashBuffer& expectedHash, bool allowRetry)
             {
                 std::string fullPath = arg;
                 if (fullPath.back() != '/')
@@ -117,7 +125,7 @@ namespace AppInstaller::Repository::Microsoft
                     AICLI_LOG(Repo, Info, << "Downloading manifest");
                     ProgressCallback emptyCallback;
 
-                    const int MaxRetryCount = 2;
+                    const int MaxRetryCount = allowRetry ? 2 : 1;
                     for (int retryCount = 0; retryCount < MaxRetryCount; ++retryCount)
                     {
                         bool success = false;
@@ -135,7 +143,8 @@ namespace AppInstaller::Repository::Microsoft
                         }
                         catch (...)
                         {
-                            if (retryCount < MaxRetryCount - 1)
+                            // Retrying cannot help when the host could not be reached.
+                            if (retryCount < MaxRetryCount - 1 && !Network::IsConnectivityError(wil::ResultFromCaughtException()))
                             {
                                 AICLI_LOG(Repo, Info, << "Downloading manifest failed, waiting a bit and retrying: " << fullPath);
                                 Sleep(500);
@@ -361,6 +370,13 @@ namespace AppInstaller::Repository::Microsoft
         return m_details.Identifier;
     }
 
+    std::string SQLiteIndexSource::GetDataVersion() const
+    {
+        std::ostringstream result;
+        result << m_index.GetVersion() << '/' << Utility::ConvertSystemClockToUnixEpoch(NonConstSharedFromThis()->GetIndex().GetLastWriteTime());
+        return result.str();
+    }
+
     SearchResult SQLiteIndexSource::Search(const SearchRequest& request) const
     {
         auto indexResults = m_index.Search(request);
@@ -35,6 +35,9 @@ namespace AppInstaller::Repository::Microsoft
         // Must be suitable for filesystem names.
         const std::string& GetIdentifier() const override;
 
+        // Gets the schema version and last write time of the index.
+        std::string GetDataVersion() const override;
+
         // Execute a search on the source.
         SearchResult Search(const SearchRequest& request) const override;
 
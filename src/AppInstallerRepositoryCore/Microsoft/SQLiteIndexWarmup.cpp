@@ -0,0 +1,456 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "Microsoft/SQLiteIndexWarmup.h"
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::Microsoft
+{
+    namespace
+    {
+        constexpr std::string_view s_IndexWarmupYaml_Indexes = "Indexes"sv;
+        constexpr std::string_view s_IndexWarmupYaml_Location = "Location"sv;
+        constexpr std::string_view s_IndexWarmupYaml_Pages = "Pages"sv;
+
+        // The number of indexes whose pages are recorded; past it, the least recently used are dropped.
+        constexpr size_t s_MaxIndexes = 8;
+        // The number of pages recorded for an index.
+        constexpr size_t s_MaxRecordedPages = 1024;
+        // The number of pages read by a warm up; about 32 MB with the default page size.
+        constexpr size_t s_MaxWarmUpPages = 8192;
+        // The number of adjacent pages combined into a single read.
+        constexpr size_t s_MaxPagesPerRead = 32;
+        // SQLite B-trees are far shallower than this; it only stops a corrupt file from being walked forever.
+        constexpr size_t s_MaxTreeDepth = 20;
+
+        constexpr size_t s_MaxSaveAttempts = 10;
+
+        // The B-tree page layout; see the database file format in the SQLite documentation.
+        constexpr size_t s_DatabaseHeaderSize = 100;
+        constexpr size_t s_InteriorPageHeaderSize = 12;
+        constexpr uint8_t s_InteriorIndexPageType = 0x02;
+        constexpr uint8_t s_InteriorTablePageType = 0x05;
+
+        uint16_t ReadBigEndian16(const uint8_t* data)
+        {
+            return static_cast<uint16_t>((data[0] << 8) | data[1]);
+        }
+
+        uint32_t ReadBigEndian32(const uint8_t* data)
+        {
+            return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+        }
+
+        // Gets the child pages of a B-tree page; empty if it is a leaf.
+        std::vector<uint32_t> GetChildPages(uint32_t page, const uint8_t* data, uint32_t pageSize)
+        {
+            std::vector<uint32_t> result;
+
+            // The first page also holds the database header.
+            size_t header = (page == 1 ? s_DatabaseHeaderSize : 0);
+            if (header + s_InteriorPageHeaderSize > pageSize || (data[header] != s_InteriorIndexPageType && data[header] != s_InteriorTablePageType))
+            {
+                return result;
+            }
+
+            // Each cell of an interior page starts with the page number of its left child; the right most child is in the header.
+            uint16_t cellCount = ReadBigEndian16(data + header + 3);
+            size_t cellPointers = header + s_InteriorPageHeaderSize;
+
+            for (size_t i = 0; i < cellCount && cellPointers + 2 * (i + 1) <= pageSize; ++i)
+            {
+                uint16_t cellOffset = ReadBigEndian16(data + cellPointers + 2 * i);
+                if (static_cast<size_t>(cellOffset) + 4 <= pageSize)
+                {
+                    result.emplace_back(ReadBigEndian32(data + cellOffset));
+                }
+            }
+
+            result.emplace_back(ReadBigEndian32(data + header + 8));
+            return result;
+        }
+
+        // Reads pages of an index into the file cache, combining adjacent pages into single reads.
+        // Each page is read once, and no more than the maximum for a warm up are read.
+        struct IndexFileReader
+        {
+            IndexFileReader(const IndexDataLocation& location, uint32_t pageSize, uint32_t pageCount, IProgressCallback& progress) :
+                m_offset(location.GetOffset()), m_pageSize(pageSize), m_pageCount(pageCount), m_read(static_cast<size_t>(pageCount) + 1), m_progress(progress)
+            {
+                // Sharing delete allows the source to be updated while the warm up is reading it.
+                m_file.reset(CreateFileW(location.File.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr));
+                THROW_LAST_ERROR_IF(!m_file);
+            }
+
+            // Reads the pages, calling the function with the data of each page that is read.
+            void Read(std::vector<uint32_t> pages, const std::function<void(uint32_t, const uint8_t*)>& onPage)
+            {
+                std::sort(pages.begin(), pages.end());
+                pages.erase(std::unique(pages.begin(), pages.end()), pages.end());
+                pages.erase(std::remove_if(pages.begin(), pages.end(), [&](uint32_t page) { return page == 0 || page > m_pageCount || m_read[page]; }), pages.end());
+
+                if (m_pagesRead + pages.size() > s_MaxWarmUpPages)
+                {
+                    pages.resize(s_MaxWarmUpPages - m_pagesRead);
+                }
+
+                std::vector<uint8_t> buffer(s_MaxPagesPerRead * m_pageSize);
+
+                for (size_t first = 0; first < pages.size() && !m_progress.IsCancelled();)
+                {
+                    size_t count = 1;
+                    while (first + count < pages.size() && count < s_MaxPagesPerRead && pages[first + count] == pages[first] + count)
+                    {
+                        ++count;
+                    }
+
+                    uint64_t offset = m_offset + static_cast<uint64_t>(pages[first] - 1) * m_pageSize;
+                    OVERLAPPED overlapped{};
+                    overlapped.Offset = static_cast<DWORD>(offset);
+                    overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+                    DWORD bytesRead = 0;
+                    THROW_LAST_ERROR_IF(!ReadFile(m_file.get(), buffer.data(), static_cast<DWORD>(count * m_pageSize), &bytesRead, &overlapped));
+
+                    for (size_t i = 0; i < count && (i + 1) * m_pageSize <= bytesRead; ++i)
+                    {
+                        uint32_t page = pages[first + i];
+                        m_read[page] = true;
+                        ++m_pagesRead;
+                        onPage(page, buffer.data() + i * m_pageSize);
+                    }
+
+                    first += count;
+                }
+            }
+
+            size_t GetPagesRead() const { return m_pagesRead; }
+
+        private:
+            wil::unique_hfile m_file;
+            uint64_t m_offset;
+            uint32_t m_pageSize;
+            uint32_t m_pageCount;
+            std::vector<bool> m_read;
+            size_t m_pagesRead = 0;
+            IProgressCallback& m_progress;
+        };
+
+        // The recorded pages of each index, in the order that the indexes were last used.
+        using RecordedIndexes = std::vector<std::pair<std::string, std::vector<uint32_t>>>;
+
+        RecordedIndexes ReadRecordedIndexes(Settings::Stream& stream)
+        {
+            RecordedIndexes result;
+
+            auto contents = stream.Get();
+            if (!contents)
+            {
+                return result;
+            }
+
+            std::string value = Utility::ReadEntireStream(*contents);
+
+            try
+            {
+                YAML::Node document = YAML::Load(value);
+                YAML::Node indexes = document[s_IndexWarmupYaml_Indexes];
+
+                if (!indexes || !indexes.IsSequence())
+                {
+                    return result;
+                }
+
+                for (const auto& index : indexes.Sequence())
+                {
+                    const YAML::Node& location = index[s_IndexWarmupYaml_Location];
+                    const YAML::Node& pages = index[s_IndexWarmupYaml_Pages];
+                    if (!location || !location.IsScalar() || !pages || !pages.IsScalar())
+                    {
+                        continue;
+                    }
+
+                    auto& entry = result.emplace_back(location.as<std::string>(), std::vector<uint32_t>{});
+                    std::istringstream pageStream{ pages.as<std::string>() };
+                    uint32_t page = 0;
+                    while (pageStream >> page)
+                    {
+                        entry.second.emplace_back(page);
+                    }
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // The recorded pages only make warm ups read more; start over rather than fail.
+                AICLI_LOG(Repo, Warning, << "Ignoring invalid recorded index pages (" << e.what() << ")");
+                result.clear();
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool WriteRecordedIndexes(Settings::Stream& stream, const RecordedIndexes& indexes)
+        {
+            YAML::Emitter out;
+            out << YAML::BeginMap;
+            out << YAML::Key << s_IndexWarmupYaml_Indexes;
+            out << YAML::BeginSeq;
+
+            for (const auto& [location, pages] : indexes)
+            {
+                // The pages are kept in a single value, as there are too many for an entry each.
+                std::ostringstream pageStream;
+                for (uint32_t page : pages)
+                {
+                    pageStream << page << ' ';
+                }
+
+                out << YAML::BeginMap;
+                out << YAML::Key << s_IndexWarmupYaml_Location << YAML::Value << location;
+                out << YAML::Key << s_IndexWarmupYaml_Pages << YAML::Value << pageStream.str();
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            return stream.Set(out.str());
+        }
+
+        // Saves the pages that an index read from its file, for later warm ups.
+        void SavePageReads(const Settings::StreamDefinition& streamDefinition, const std::string& location, const std::vector<uint32_t>& pagesRead)
+        {
+            if (pagesRead.empty())
+            {
+                return;
+            }
+
+            Settings::Stream stream{ streamDefinition };
+
+            for (size_t i = 0; i < s_MaxSaveAttempts; ++i)
+            {
+                RecordedIndexes indexes = ReadRecordedIndexes(stream);
+
+                // The pages read by this process come first, followed by those that were recorded before.
+                std::vector<uint32_t> pages = pagesRead;
+                auto existing = std::find_if(indexes.begin(), indexes.end(), [&](const auto& index) { return index.first == location; });
+                if (existing != indexes.end())
+                {
+                    pages.insert(pages.end(), existing->second.begin(), existing->second.end());
+                    indexes.erase(existing);
+                }
+
+                std::set<uint32_t> seen;
+                pages.erase(std::remove_if(pages.begin(), pages.end(), [&](uint32_t page) { return !seen.insert(page).second; }), pages.end());
+                if (pages.size() > s_MaxRecordedPages)
+                {
+                    pages.resize(s_MaxRecordedPages);
+                }
+
+                indexes.emplace_back(location, std::move(pages));
+                if (indexes.size() > s_MaxIndexes)
+                {
+                    indexes.erase(indexes.begin(), indexes.begin() + (indexes.size() - s_MaxIndexes));
+                }
+
+                if (WriteRecordedIndexes(stream, indexes))
+                {
+                    return;
+                }
+            }
+
+            AICLI_LOG(Repo, Warning, << "Failed to save the recorded index pages after retries");
+        }
+    }
+
+    bool IsIndexWarmUpEnabled()
+    {
+        return Settings::User().Get<Settings::Setting::SourceWarmUpIndexes>();
+    }
+
+    std::string IndexDataLocation::GetKey() const
+    {
+        std::string result = File.u8string();
+        if (Entry)
+        {
+            result += '|';
+            result += std::to_string(Entry->DataOffset);
+        }
+        return result;
+    }
+
+    SQLiteIndex IndexDataLocation::Open(SQLiteIndex::OpenDisposition disposition, SQLiteIndex::OpenOptions options) const
+    {
+        return (Entry ? SQLiteIndex::Open(Entry.value(), options) : SQLiteIndex::Open(File.u8string(), disposition, options));
+    }
+
+    SQLiteIndexWarmup::SQLiteIndexWarmup(const Settings::StreamDefinition& stream) : m_streamDefinition(stream) {}
+
+    SQLiteIndexWarmup::~SQLiteIndexWarmup()
+    {
+        // Cancelling ends any warm up that is still in progress, so that waiting on them is quick.
+        // It also stops the warm ups that are running from starting others.
+        std::map<std::string, std::shared_future<void>> warmUps;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            m_progress.Cancel();
+            warmUps = std::move(m_warmUps);
+        }
+
+        warmUps.clear();
+    }
+
+    SQLiteIndexWarmup& SQLiteIndexWarmup::Instance()
+    {
+        static SQLiteIndexWarmup s_instance;
+        return s_instance;
+    }
+
+    void SQLiteIndexWarmup::WarmUp(const std::string& identifier, std::function<void(IProgressCallback&)> warmUp)
+    {
+        if (!IsIndexWarmUpEnabled())
+        {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        // Once per process is enough; the pages stay in the file cache.
+        if (m_progress.IsCancelled() || m_warmUps.find(identifier) != m_warmUps.end())
+        {
+            return;
+        }
+
+        AICLI_LOG(Repo, Info, << "Warming up index of source " << identifier);
+
+        m_warmUps[identifier] = std::async(std::launch::async, [this, identifier, warmUp = std::move(warmUp)]()
+            {
+                // Opening the source reports any error; this only makes it faster.
+                try
+                {
+                    warmUp(m_progress);
+                }
+                CATCH_LOG();
+            }).share();
+    }
+
+    size_t SQLiteIndexWarmup::WarmUpIndex(const IndexDataLocation& location, IProgressCallback& progress) const
+    {
+        auto start = std::chrono::steady_clock::now();
+
+        uint32_t pageSize = 0;
+        uint32_t pageCount = 0;
+        std::vector<uint32_t> roots{ 1 };
+
+        {
+            // Reading the layout through SQLite also reads the schema into the file cache.
+            SQLiteIndex index = location.Open();
+            const SQLite::Connection& connection = index.GetConnection();
+            pageSize = static_cast<uint32_t>(connection.GetPageSize());
+            pageCount = static_cast<uint32_t>(connection.GetPageCount());
+            std::vector<uint32_t> rootPages = connection.GetRootPages();
+            roots.insert(roots.end(), rootPages.begin(), rootPages.end());
+        }
+
+        IndexFileReader reader{ location, pageSize, pageCount, progress };
+
+        // The child pages of the interior pages that were read.
+        std::map<uint32_t, std::vector<uint32_t>> children;
+        auto collectChildren = [&](uint32_t page, const uint8_t* data)
+        {
+            std::vector<uint32_t> pageChildren = GetChildPages(page, data, pageSize);
+            if (!pageChildren.empty())
+            {
+                children[page] = std::move(pageChildren);
+            }
+        };
+
+        // Every search starts at the roots, and the pages that were read recently are likely to be read again.
+        reader.Read(roots, collectChildren);
+        reader.Read(GetRecordedPages(location), collectChildren);
+
+        // Then the interior pages, one level of every tree at a time. All of the leaves of a tree are at the same depth,
+        // so once the first child of a page is a leaf, the rest of them are as well and are left for the searches.
+        std::vector<uint32_t> level = roots;
+        for (size_t depth = 0; depth < s_MaxTreeDepth && !level.empty() && !progress.IsCancelled(); ++depth)
+        {
+            std::vector<uint32_t> nextLevel;
+
+            for (uint32_t page : level)
+            {
+                auto itr = children.find(page);
+                if (itr == children.end())
+                {
+                    continue;
+                }
+
+                uint32_t firstChild = itr->second.front();
+                reader.Read({ firstChild }, collectChildren);
+                if (children.find(firstChild) != children.end())
+                {
+                    nextLevel.insert(nextLevel.end(), itr->second.begin(), itr->second.end());
+                }
+            }
+
+            reader.Read(nextLevel, collectChildren);
+            level = std::move(nextLevel);
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Warmed up " << reader.GetPagesRead() << " pages in " <<
+            std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms: " << location.GetKey());
+
+        return reader.GetPagesRead();
+    }
+
+    SQLiteIndex SQLiteIndexWarmup::OpenIndex(const IndexDataLocation& location, SQLiteIndex::OpenDisposition disposition) const
+    {
+        if (!IsIndexWarmUpEnabled())
+        {
+            return location.Open(disposition);
+        }
+
+        std::optional<SQLiteIndex> recording;
+        try
+        {
+            recording.emplace(location.Open(disposition, SQLiteIndex::OpenOptions::RecordPageReads));
+        }
+        catch (...)
+        {
+            // Recording only makes later warm ups better; an index that cannot be opened reports the error from the open below.
+            LOG_CAUGHT_EXCEPTION();
+        }
+
+        if (!recording)
+        {
+            return location.Open(disposition);
+        }
+
+        SQLiteIndex index = std::move(recording.value());
+
+        // Saving reads the settings stream and writes it, so it is done once the index is done with rather than as pages are read.
+        index.OnClose([streamDefinition = m_streamDefinition, key = location.GetKey()](SQLiteIndex& closing)
+            {
+                SavePageReads(streamDefinition, key, closing.GetConnection().GetPagesRead());
+            });
+
+        return index;
+    }
+
+    std::vector<uint32_t> SQLiteIndexWarmup::GetRecordedPages(const IndexDataLocation& location) const
+    {
+        Settings::Stream stream{ m_streamDefinition };
+        std::string key = location.GetKey();
+
+        for (auto& [indexLocation, pages] : ReadRecordedIndexes(stream))
+        {
+            if (indexLocation == key)
+            {
+                return std::move(pages);
+            }
+        }
+
+        return {};
+    }
+}
@@ -0,0 +1,81 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Microsoft/SQLiteIndex.h"
+#include "SQLiteZipEntry.h"
+#include <AppInstallerProgress.h>
+#include <winget/Settings.h>
+
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace AppInstaller::Repository::Microsoft
+{
+    // Determines if source indexes should be warmed up, as enabled by the settings.
+    bool IsIndexWarmUpEnabled();
+
+    // The location of the data of an index; either a database file, or the part of a package that it is stored in.
+    struct IndexDataLocation
+    {
+        // The file that contains the index.
+        std::filesystem::path File;
+
+        // The location of the index in the package, if the file is a package.
+        std::optional<SQLite::ZipStoredEntry> Entry;
+
+        // Gets the offset of the first byte of the index in the file.
+        uint64_t GetOffset() const { return (Entry ? Entry->DataOffset : 0); }
+
+        // Gets a string that identifies the location.
+        std::string GetKey() const;
+
+        // Opens the index; an index in a package is always opened for immutable read.
+        SQLiteIndex Open(SQLiteIndex::OpenDisposition disposition = SQLiteIndex::OpenDisposition::Immutable, SQLiteIndex::OpenOptions options = SQLiteIndex::OpenOptions::None) const;
+    };
+
+    // Reads the parts of source indexes that searches use first into the file cache on a background thread,
+    // so that the first searches after the machine starts or the index is updated do not wait on storage
+    // for each page. The parts are the root of every table and index, the pages that recent processes read
+    // from the index, and the interior pages of every table and index (the levels that every lookup walks).
+    // Warm ups that are still running when it is destroyed are cancelled and waited for.
+    struct SQLiteIndexWarmup
+    {
+        SQLiteIndexWarmup(const Settings::StreamDefinition& stream = Settings::Stream::IndexWarmup);
+        ~SQLiteIndexWarmup();
+
+        SQLiteIndexWarmup(const SQLiteIndexWarmup&) = delete;
+        SQLiteIndexWarmup& operator=(const SQLiteIndexWarmup&) = delete;
+
+        // Gets the instance used by the process.
+        static SQLiteIndexWarmup& Instance();
+
+        // Runs the warm up of the index of a source in the background; the function should find the index,
+        // holding any lock needed to read it, and call WarmUpIndex.
+        // Does nothing if warming up is disabled, or if the index of the source is already being warmed up.
+        void WarmUp(const std::string& identifier, std::function<void(IProgressCallback&)> warmUp);
+
+        // Reads the parts of the index that searches use first into the file cache.
+        // Returns the number of pages that were read.
+        size_t WarmUpIndex(const IndexDataLocation& location, IProgressCallback& progress) const;
+
+        // Opens the index, recording the pages that it reads from its file so that later warm ups read them.
+        // The pages are saved when the index is destroyed. Opens the index without recording if warming up is disabled.
+        SQLiteIndex OpenIndex(const IndexDataLocation& location, SQLiteIndex::OpenDisposition disposition = SQLiteIndex::OpenDisposition::Immutable) const;
+
+        // Gets the pages that were recorded for the index, most recently read first.
+        std::vector<uint32_t> GetRecordedPages(const IndexDataLocation& location) const;
+
+    private:
+        Settings::StreamDefinition m_streamDefinition;
+        ProgressCallback m_progress;
+        std::mutex m_lock;
+        // The warm ups that were started, by source identifier.
+        std::map<std::string, std::shared_future<void>> m_warmUps;
+    };
+}
@@ -279,14 +279,15 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
             if (select.Step())
             {
-                std::string partValue = select.GetColumn<std::string>(1);
+                std::string_view partValue = select.GetColumn<std::string_view>(1);
                 if (result.empty())
                 {
                     result = partValue;
                 }
                 else
                 {
-                    result = partValue + '/' + result;
+                    result.insert(0, 1, '/');
+                    result.insert(0, partValue);
                 }
 
                 if (select.GetColumnIsNull(0))
@@ -54,6 +54,8 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
             bool useLike) const;
 
         static bool MatchUsesLike(MatchType match);
+
+        // The statement is executed before the filter is released, so an exact value is bound without a copy.
         void BindStatementForMatchType(SQLite::Statement& statement, MatchType match, int bindIndex, std::string_view value);
 
         virtual void BindStatementForMatchType(SQLite::Statement& statement, const PackageMatchFilter& filter, const std::vector<int>& bindIndex);
@@ -261,6 +261,12 @@ namespace AppInstaller::Repository::Microsoft::Schema::V1_0
 
     void SearchResultsTable::BindStatementForMatchType(SQLite::Statement& statement, MatchType match, int bindIndex, std::string_view value)
     {
+        if (match == MatchType::Exact)
+        {
+            statement.BindStatic(bindIndex, value);
+            return;
+        }
+
         std::string valueToUse;
 
         if (MatchUsesLike(match))
@@ -31,7 +31,7 @@ CREATE TABLE [metadata](
     {
         THROW_HR_IF(E_INVALIDARG, name.empty());
         SQLite::Statement result = SQLite::Statement::Create(connection, s_MetadataTableStmt_GetNamedValue);
-        result.Bind(1, name);
+        result.BindStatic(1, name);
         THROW_HR_IF(E_NOT_SET, !result.Step());
         return result;
     }
@@ -40,7 +40,7 @@ CREATE TABLE [metadata](
     {
         THROW_HR_IF(E_INVALIDARG, name.empty());
         SQLite::Statement result = SQLite::Statement::Create(connection, s_MetadataTableStmt_SetNamedValue);
-        result.Bind(1, name);
+        result.BindStatic(1, name);
         return result;
     }
 }
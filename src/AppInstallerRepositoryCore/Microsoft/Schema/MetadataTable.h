@@ -41,9 +41,11 @@ namespace AppInstaller::Repository::Microsoft::Schema
 
     private:
         // Internal function that gets the named value.
+        // The statement refers to the name rather than a copy of it, so it must not outlive the name.
         static SQLite::Statement GetNamedValueStatement(SQLite::Connection& connection, std::string_view name);
 
         // Internal function that sets the named value.
+        // The statement refers to the name rather than a copy of it, so it must not outlive the name.
         static SQLite::Statement SetNamedValueStatement(SQLite::Connection& connection, std::string_view name);
     };
 }
@@ -239,6 +239,9 @@ namespace AppInstaller::Repository
         strstr << Utility::GetCurrentUnixEpoch();
         index.SetMetadataByManifestId(manifestId, PackageVersionMetadata::TrackingWriteTime, strstr.str());
 
+        // Searches that include the tracking data must be executed again
+        InvalidateSearchMemo();
+
         std::shared_ptr<Version::implementation> result = std::make_shared<Version::implementation>();
         result->Id = manifestId;
         return { std::move(result) };
@@ -266,6 +269,8 @@ namespace AppInstaller::Repository
                 }
             }
         }
+
+        InvalidateSearchMemo();
     }
 
     std::unique_ptr<ISourceFactory> PackageTrackingCatalogSourceFactory::Create()
@@ -93,6 +93,21 @@ namespace AppInstaller::Repository
         }
     };
 
+    // The data of the packages in a search result, in addition to their identifier and name.
+    enum class SearchResultFields : uint32_t
+    {
+        None = 0x0,
+        // The latest version of each package.
+        LatestVersion = 0x1,
+        // Every version of each package.
+        Versions = 0x2 | LatestVersion,
+        // The package family names and product codes of the versions.
+        CorrelationKeys = 0x4,
+        All = Versions | CorrelationKeys,
+    };
+
+    DEFINE_ENUM_FLAG_OPERATORS(SearchResultFields);
+
     // Container for data used to filter the available manifests in a source.
     // It can be thought of as:
     //  (Query || Inclusions...) && Filters...
@@ -115,6 +130,10 @@ namespace AppInstaller::Repository
         // The default of 0 will place no limit.
         size_t MaximumResults{};
 
+        // The data of the matching packages that the caller needs. A source may leave out the rest
+        // and retrieve it when it is used, so the same result is valid for any fields.
+        SearchResultFields Fields = SearchResultFields::All;
+
         // Returns a value indicating whether this request is for all available data.
         bool IsForEverything() const;
 
@@ -18,6 +18,7 @@ namespace AppInstaller::Repository
 {
     struct ISourceReference;
     struct ISource;
+    struct SearchMemo;
 
     // Defines the origin of the source details.
     enum class SourceOrigin
@@ -83,6 +84,18 @@ namespace AppInstaller::Repository
         AvailablePackages,
     };
 
+    // The packages that a source contains, when it declares them, so that requests that cannot match them can skip it.
+    // An empty list places no limit.
+    struct SourceScope
+    {
+        // The namespaces of the package identifiers; an identifier is within a namespace if it is equal to it
+        // or starts with it followed by a '.', ignoring case.
+        std::vector<std::string> IdentifierNamespaces;
+
+        // The publishers of the packages, as they are also reported by their installations.
+        std::vector<std::string> Publishers;
+    };
+
     // Interface for source configurations. Source configurations are used to get a source reference without opening the source.
     struct SourceDetails
     {
@@ -95,6 +108,12 @@ namespace AppInstaller::Repository
         // The argument used when adding the source.
         std::string Arg;
 
+        // Equivalent locations to Arg that source data may also be retrieved from, in order of preference.
+        std::vector<std::string> Mirrors;
+
+        // The packages that the source is declared to contain.
+        SourceScope Scope;
+
         // The source's extra data string.
         std::string Data;
 
@@ -145,6 +164,9 @@ namespace AppInstaller::Repository
 
         // Required query parameters in get manifest request.
         std::vector<std::string> RequiredQueryParameters;
+
+        // The packages that the source advertises it contains; used where the details do not declare a scope.
+        SourceScope Scope;
     };
 
     // Represents a source which would be interacted from outside of repository lib.
@@ -195,15 +217,30 @@ namespace AppInstaller::Repository
         // Get the source's information.
         SourceInformation GetInformation() const;
 
+        // Gets a value that changes whenever the packages in the source change; empty if the source cannot provide one.
+        std::string GetDataVersion() const;
+
         // Returns true if the origin type can contain available packages.
         bool ContainsAvailablePackages() const;
 
         // Set custom header.
         bool SetCustomHeader(std::optional<std::string> header);
 
+        // Sets the mirror locations of a source to be added.
+        void SetMirrors(std::vector<std::string> mirrors);
+
+        // Sets the scope of a source to be added.
+        void SetScope(SourceScope scope);
+
         // Execute a search on the source.
         SearchResult Search(const SearchRequest& request) const;
 
+        // Execute many searches on the source, returning the result of each in the same order.
+        // Requests that only look up a package identifier are combined into a single search;
+        // other requests are executed individually. A failure is reported in the result of
+        // the requests that it affects rather than thrown.
+        std::vector<SearchResult> SearchBatch(const std::vector<SearchRequest>& requests) const;
+
         /* Source agreements */
 
         // Get required agreement fields info.
@@ -237,6 +274,11 @@ namespace AppInstaller::Repository
         // Opens the source. This function should throw upon open failure rather than returning an empty pointer.
         std::vector<SourceDetails> Open(IProgressCallback& progress);
 
+        // Starts reading the local data of the named source, or of the default sources if no name is given, in the
+        // background if warming up indexes is enabled, so that opening and searching them later waits less on storage.
+        // The sources are also found in the background, so this should be called as early in the command as possible.
+        static void WarmUp(std::string_view name);
+
         // Add source. Source add command.
         bool Add(IProgressCallback& progress);
 
@@ -264,4 +306,30 @@ namespace AppInstaller::Repository
         bool m_isComposite = false;
         mutable PackageTrackingCatalog m_trackingCatalog;
     };
+
+    // Remembers the results of the searches of each source for the lifetime of the scope, such as a command,
+    // so that an identical search of the same source returns the same result without being executed again.
+    // A scope inside of another one keeps using the outer memo. The memo is only used by the thread that created it.
+    struct SearchMemoScope
+    {
+        // Uses a memo if the search memo experimental feature is enabled.
+        SearchMemoScope();
+
+        // Uses a memo if requested, regardless of the settings.
+        explicit SearchMemoScope(bool useMemo);
+
+        ~SearchMemoScope();
+
+        SearchMemoScope(const SearchMemoScope&) = delete;
+        SearchMemoScope& operator=(const SearchMemoScope&) = delete;
+
+    private:
+        std::unique_ptr<SearchMemo> m_memo;
+    };
+
+    // Discards the remembered search results of the current scope on the thread; used when package data is changed.
+    void InvalidateSearchMemo();
+
+    // Saves the latency of source locations observed by this process that has not been saved yet; done once per command.
+    void SaveSourceLocationStatistics();
 }
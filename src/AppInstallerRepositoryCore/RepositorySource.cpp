@@ -9,14 +9,18 @@
 #include "Microsoft/PredefinedInstalledSourceFactory.h"
 #include "Microsoft/PredefinedWriteableSourceFactory.h"
 #include "Microsoft/PreIndexedPackageSourceFactory.h"
+#include "Microsoft/SQLiteIndexWarmup.h"
 #include "Rest/RestSourceFactory.h"
 #include "PackageTrackingCatalogSourceFactory.h"
+#include "SearchMemo.h"
 
 #ifndef AICLI_DISABLE_TEST_HOOKS
 #include "Microsoft/ConfigurableTestSourceFactory.h"
 #endif
 
 #include <winget/GroupPolicy.h>
+#include <winget/NetworkConnectivity.h>
+#include <winget/OperationArena.h>
 
 using namespace AppInstaller::Settings;
 using namespace std::chrono_literals;
@@ -29,6 +33,23 @@ namespace AppInstaller::Repository
         static std::map<std::string, std::function<std::unique_ptr<ISourceFactory>()>> s_Sources_TestHook_SourceFactories;
 #endif
 
+        // Determines if the request only looks up a package by its identifier.
+        bool IsIdentifierLookup(const SearchRequest& request)
+        {
+            return
+                !request.Query &&
+                request.Filters.empty() &&
+                request.Inclusions.size() == 1 &&
+                request.Inclusions[0].Field == PackageMatchField::Id &&
+                (request.Inclusions[0].Type == MatchType::Exact || request.Inclusions[0].Type == MatchType::CaseInsensitive);
+        }
+
+        // Determines if the value satisfies the identifier lookup.
+        bool IsIdentifierMatch(const PackageMatchFilter& lookup, std::string_view value)
+        {
+            return (lookup.Type == MatchType::Exact ? lookup.Value == value : Utility::CaseInsensitiveEquals(lookup.Value, value));
+        }
+
         std::shared_ptr<ISourceReference> CreateSourceFromDetails(const SourceDetails& details)
         {
             return ISourceFactory::GetForType(details.Type)->Create(details);
@@ -53,7 +74,11 @@ namespace AppInstaller::Repository
             CATCH_LOG();
 
             AICLI_LOG(Repo, Info, << "Source add/update failed, waiting a bit and retrying: " << details.Name);
-            std::this_thread::sleep_for(2s);
+            if (!Synchronization::SleepUnlessCancelled(2s, progress))
+            {
+                AICLI_LOG(Repo, Info, << "Source add/update cancelled while waiting to retry: " << details.Name);
+                return false;
+            }
 
             // If this one fails, maybe the problem is persistent.
             result = (factory.get()->*member)(details, progress);
@@ -99,6 +124,12 @@ namespace AppInstaller::Repository
                 return false;
             }
 
+            if (Network::IsOffline())
+            {
+                AICLI_LOG(Repo, Info, << "Not updating source while offline: " << details.Name);
+                return false;
+            }
+
             constexpr static auto s_ZeroMins = 0min;
             auto autoUpdateTime = User().Get<Setting::AutoUpdateTimeInMinutes>();
 
@@ -119,6 +150,80 @@ namespace AppInstaller::Repository
             return false;
         }
 
+        // Sources are updated by one process at a time through this lock, which is separate from the lock on the source data
+        // so that processes waiting for an update do not block readers of the current data.
+        std::string CreateNameForSourceUpdateLock(const SourceDetails& details)
+        {
+            return "WinGetSourceUpdate_" + Utility::SHA256::ConvertToString(Utility::SHA256::ComputeHash(details.Name));
+        }
+
+        // The longest time to wait for an update of the source by another process before opening the current data.
+        // The update may itself be waiting for readers of the source, which can include this process.
+        constexpr std::chrono::milliseconds s_MaxWaitForUpdateInFlight = 2s;
+
+        // The outcome of updating a source before it is opened.
+        enum class UpdateBeforeOpenResult
+        {
+            // The source is up to date.
+            Updated,
+            // The update failed; the current data is opened.
+            Failed,
+            // Another process is still updating the source; the current data is opened, as it would be for any reader during the update.
+            UpdateInFlight,
+        };
+
+        // Updates a source that is past its auto update time before it is opened.
+        // If another process is already updating the source, waits a short time for it and uses its result rather than updating again.
+        UpdateBeforeOpenResult UpdateSourceBeforeOpen(SourceDetails& details, IProgressCallback& progress)
+        {
+            bool updateInFlight = false;
+            auto updateLock = Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForSourceUpdateLock(details), 0ms);
+
+            if (!updateLock)
+            {
+                AICLI_LOG(Repo, Info, << "Waiting for an update of the source by another process: " << details.Name);
+                updateInFlight = true;
+                updateLock = Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForSourceUpdateLock(details), s_MaxWaitForUpdateInFlight);
+
+                if (!updateLock)
+                {
+                    AICLI_LOG(Repo, Info, << "The update of the source by another process did not finish in time; opening the current data: " << details.Name);
+                    return UpdateBeforeOpenResult::UpdateInFlight;
+                }
+            }
+
+            // Read the metadata again now that no other update is running, as one may have completed since it was read.
+            SourceList sourceList;
+            auto detailsInternal = sourceList.GetSource(details.Name);
+            THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_NOT_FOUND), !detailsInternal);
+
+            if (detailsInternal->LastUpdateTime > details.LastUpdateTime)
+            {
+                details.LastUpdateTime = detailsInternal->LastUpdateTime;
+            }
+
+            if (!ShouldUpdateBeforeOpen(details))
+            {
+                AICLI_LOG(Repo, Info, << "Source was updated by another process: " << details.Name);
+                return UpdateBeforeOpenResult::Updated;
+            }
+
+            if (updateInFlight)
+            {
+                // The update that was waited on failed, possibly for a reason specific to that process, so try it once here.
+                AICLI_LOG(Repo, Info, << "The update of the source by another process did not succeed; updating it here: " << details.Name);
+            }
+
+            if (!BackgroundUpdateSourceFromDetails(details, progress))
+            {
+                return UpdateBeforeOpenResult::Failed;
+            }
+
+            detailsInternal->LastUpdateTime = details.LastUpdateTime;
+            sourceList.SaveMetadata(*detailsInternal);
+            return UpdateBeforeOpenResult::Updated;
+        }
+
         SourceDetails GetPredefinedSourceDetails(PredefinedSource source)
         {
             SourceDetails details;
@@ -170,6 +275,125 @@ namespace AppInstaller::Repository
             SourceDetails m_details;
             std::exception_ptr m_exception;
         };
+
+        // Opens the source from its reference the first time that it is searched, so that the sources a command does not
+        // use are never opened. An open failure is presented back at search time, as with OpenExceptionProxy.
+        struct LazyOpenSource : public ISource
+        {
+            LazyOpenSource(std::shared_ptr<ISourceReference> reference) :
+                m_reference(std::move(reference)), m_details(m_reference->GetDetails()) {}
+
+            const SourceDetails& GetDetails() const override { return m_details; }
+
+            const std::string& GetIdentifier() const override
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                if (m_source)
+                {
+                    return m_source->GetIdentifier();
+                }
+
+                // The reference can provide the identifier without opening the source.
+                if (!m_identifier)
+                {
+                    try
+                    {
+                        m_identifier = m_reference->GetIdentifier();
+                    }
+                    catch (...)
+                    {
+                        LOG_CAUGHT_EXCEPTION();
+                        m_identifier = m_details.Identifier;
+                    }
+                }
+
+                return m_identifier.value();
+            }
+
+            SourceInformation GetInformation() const override
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                if (m_source)
+                {
+                    return m_source->GetInformation();
+                }
+
+                // The reference can provide the information (used for agreements) without opening the source.
+                // A source that cannot provide it would fail to open, so it has no information, like an OpenExceptionProxy.
+                try
+                {
+                    return m_reference->GetInformation();
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                    return {};
+                }
+            }
+
+            std::string GetDataVersion() const override
+            {
+                // The data is only known once the source is open; a source that fails to open has no version.
+                std::shared_ptr<ISource> source = EnsureOpen();
+                return source ? source->GetDataVersion() : std::string{};
+            }
+
+            SearchResult Search(const SearchRequest& request) const override
+            {
+                std::shared_ptr<ISource> source = EnsureOpen();
+
+                if (!source)
+                {
+                    SearchResult result;
+                    result.Failures.emplace_back(SearchResult::Failure{ m_details.Name, m_exception });
+                    return result;
+                }
+
+                return source->Search(request);
+            }
+
+        private:
+            // Opens the source if that has not been attempted yet; returns null if it failed to open.
+            std::shared_ptr<ISource> EnsureOpen() const
+            {
+                std::lock_guard<std::mutex> lock{ m_lock };
+
+                if (!m_openAttempted)
+                {
+                    m_openAttempted = true;
+                    auto start = std::chrono::steady_clock::now();
+                    auto elapsed = [&]() { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count(); };
+
+                    try
+                    {
+                        // The progress given to Source::Open is not available here, so the open cannot be cancelled.
+                        ProgressCallback progress;
+                        m_source = m_reference->Open(progress);
+                        THROW_HR_IF(E_ABORT, !m_source);
+                        AICLI_LOG(Repo, Info, << "Opened source on first use: " << m_details.Name << " [" << elapsed() << " ms]");
+                    }
+                    catch (...)
+                    {
+                        LOG_CAUGHT_EXCEPTION();
+                        AICLI_LOG(Repo, Warning, << "Failed to open available source on first use: " << m_details.Name << " [" << elapsed() << " ms]");
+                        m_source.reset();
+                        m_exception = std::current_exception();
+                    }
+                }
+
+                return m_source;
+            }
+
+            std::shared_ptr<ISourceReference> m_reference;
+            SourceDetails m_details;
+            mutable std::mutex m_lock;
+            mutable bool m_openAttempted = false;
+            mutable std::shared_ptr<ISource> m_source;
+            mutable std::exception_ptr m_exception;
+            mutable std::optional<std::string> m_identifier;
+        };
     }
 
     std::unique_ptr<ISourceFactory> ISourceFactory::GetForType(std::string_view type)
@@ -396,6 +620,12 @@ namespace AppInstaller::Repository
         }
     }
 
+    std::string Source::GetDataVersion() const
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source || m_isComposite);
+        return m_source->GetDataVersion();
+    }
+
     bool Source::ContainsAvailablePackages() const
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), IsComposite());
@@ -408,10 +638,144 @@ namespace AppInstaller::Repository
         return m_sourceReferences[0]->SetCustomHeader(header);
     }
 
+    void Source::SetMirrors(std::vector<std::string> mirrors)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_isSourceToBeAdded || m_sourceReferences.size() != 1);
+        m_sourceReferences[0]->GetDetails().Mirrors = std::move(mirrors);
+    }
+
+    void Source::SetScope(SourceScope scope)
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_isSourceToBeAdded || m_sourceReferences.size() != 1);
+        m_sourceReferences[0]->GetDetails().Scope = std::move(scope);
+    }
+
     SearchResult Source::Search(const SearchRequest& request) const
     {
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source);
-        return m_source->Search(request);
+        Memory::OperationArenaScope arenaScope;
+
+        SearchMemo* memo = SearchMemo::Current();
+        if (!memo)
+        {
+            return m_source->Search(request);
+        }
+
+        std::string canonicalRequest = SearchMemo::GetCanonicalRequest(request);
+        if (auto remembered = memo->Get(m_source, canonicalRequest))
+        {
+            return std::move(remembered).value();
+        }
+
+        SearchResult result = m_source->Search(request);
+        memo->Record(m_source, std::move(canonicalRequest), result);
+        return result;
+    }
+
+    std::vector<SearchResult> Source::SearchBatch(const std::vector<SearchRequest>& requests) const
+    {
+        THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !m_source);
+        Memory::OperationArenaScope arenaScope;
+        SearchMemoScope memoScope;
+
+        std::vector<SearchResult> result(requests.size());
+
+        auto searchInto = [&](const SearchRequest& request, SearchResult& searchResult)
+        {
+            try
+            {
+                searchResult = Search(request);
+            }
+            catch (...)
+            {
+                searchResult.Failures.emplace_back(SearchResult::Failure{ m_source->GetDetails().Name, std::current_exception() });
+            }
+        };
+
+        std::vector<size_t> lookups;
+        for (size_t i = 0; i < requests.size(); ++i)
+        {
+            if (IsIdentifierLookup(requests[i]))
+            {
+                lookups.push_back(i);
+            }
+            else
+            {
+                searchInto(requests[i], result[i]);
+            }
+        }
+
+        if (lookups.size() == 1)
+        {
+            searchInto(requests[lookups[0]], result[lookups[0]]);
+        }
+        else if (!lookups.empty())
+        {
+            // Search for all of the identifiers at once, so that the work shared by every search
+            // (such as correlating the installed packages) is only done a single time.
+            SearchRequest combined;
+            for (size_t index : lookups)
+            {
+                const PackageMatchFilter& lookup = requests[index].Inclusions[0];
+                if (std::none_of(combined.Inclusions.begin(), combined.Inclusions.end(),
+                    [&](const PackageMatchFilter& inclusion) { return inclusion.Type == lookup.Type && inclusion.Value == lookup.Value; }))
+                {
+                    combined.Inclusions.emplace_back(lookup);
+                }
+            }
+
+            AICLI_LOG(Repo, Info, << "Combining " << lookups.size() << " identifier lookups into a single search with " << combined.Inclusions.size() << " inclusions");
+
+            SearchResult combinedResult;
+            searchInto(combined, combinedResult);
+
+            for (size_t index : lookups)
+            {
+                const SearchRequest& request = requests[index];
+                const PackageMatchFilter& lookup = request.Inclusions[0];
+                SearchResult& lookupResult = result[index];
+
+                for (const auto& match : combinedResult.Matches)
+                {
+                    bool isMatch = (match.MatchCriteria.Field == PackageMatchField::Id && IsIdentifierMatch(lookup, match.MatchCriteria.Value));
+
+                    if (!isMatch && match.Package)
+                    {
+                        isMatch = IsIdentifierMatch(lookup, match.Package->GetProperty(PackageProperty::Id));
+                    }
+
+                    if (!isMatch)
+                    {
+                        continue;
+                    }
+
+                    if (request.MaximumResults && lookupResult.Matches.size() >= request.MaximumResults)
+                    {
+                        lookupResult.Truncated = true;
+                        break;
+                    }
+
+                    lookupResult.Matches.emplace_back(match);
+                }
+
+                if (combinedResult.Truncated)
+                {
+                    // The matches for this identifier may be among those left out of the combined search.
+                    if (lookupResult.Matches.empty())
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Combined search was truncated; searching for identifier individually: " << lookup.Value);
+                        searchInto(request, lookupResult);
+                        continue;
+                    }
+
+                    lookupResult.Truncated = true;
+                }
+
+                lookupResult.Failures = combinedResult.Failures;
+            }
+        }
+
+        return result;
     }
 
     ImplicitAgreementFieldEnum Source::GetAgreementFieldsFromSourceInformation() const
@@ -469,6 +833,7 @@ namespace AppInstaller::Repository
         auto writableSource = std::dynamic_pointer_cast<IMutablePackageSource>(m_source);
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !writableSource);
         writableSource->AddPackageVersion(manifest, relativePath);
+        InvalidateSearchMemo();
     }
 
     void Source::RemovePackageVersion(const Manifest::Manifest& manifest, const std::filesystem::path& relativePath)
@@ -477,6 +842,27 @@ namespace AppInstaller::Repository
         auto writableSource = std::dynamic_pointer_cast<IMutablePackageSource>(m_source);
         THROW_HR_IF(HRESULT_FROM_WIN32(ERROR_INVALID_STATE), !writableSource);
         writableSource->RemovePackageVersion(manifest, relativePath);
+        InvalidateSearchMemo();
+    }
+
+    void Source::WarmUp(std::string_view name)
+    {
+        std::string sourceName{ name };
+
+        // Reading the source list is done along with the rest of the command startup rather than before it.
+        Microsoft::SQLiteIndexWarmup::Instance().WarmUp("*Sources|" + sourceName, [sourceName](IProgressCallback&)
+            {
+                Source source{ sourceName };
+
+                for (const auto& sourceReference : source.m_sourceReferences)
+                {
+                    // The data of a source that is updated before it is opened is replaced, and reading it would delay the update.
+                    if (!ShouldUpdateBeforeOpen(sourceReference->GetDetails()))
+                    {
+                        sourceReference->WarmUp();
+                    }
+                }
+            });
     }
 
     std::vector<SourceDetails> Source::Open(IProgressCallback& progress)
@@ -487,8 +873,6 @@ namespace AppInstaller::Repository
 
         if (!m_source)
         {
-            SourceList sourceList;
-
             // Check for updates before opening.
             for (auto& sourceReference : m_sourceReferences)
             {
@@ -499,16 +883,18 @@ namespace AppInstaller::Repository
                     {
                         // TODO: Consider adding a context callback to indicate we are doing the same action
                         // to avoid the progress bar fill up multiple times.
-                        if (BackgroundUpdateSourceFromDetails(details, progress))
-                        {
-                            auto detailsInternal = sourceList.GetSource(details.Name);
-                            detailsInternal->LastUpdateTime = details.LastUpdateTime;
-                            sourceList.SaveMetadata(*detailsInternal);
-                        }
-                        else
+                        switch (UpdateSourceBeforeOpen(details, progress))
                         {
+                        case UpdateBeforeOpenResult::Failed:
                             AICLI_LOG(Repo, Error, << "Failed to update source: " << details.Name);
                             result.emplace_back(details);
+                            break;
+                        case UpdateBeforeOpenResult::UpdateInFlight:
+                            // Not a failure; the update by the other process is used by the next open.
+                            AICLI_LOG(Repo, Info, << "Opening the current data while another process updates the source: " << details.Name);
+                            break;
+                        default:
+                            break;
                         }
                     }
                     catch (...)
@@ -520,7 +906,20 @@ namespace AppInstaller::Repository
                 }
             }
 
-            if (m_sourceReferences.size() > 1)
+            if (m_sourceReferences.size() > 1 && ExperimentalFeature::IsEnabled(ExperimentalFeature::Feature::LazySourceOpen))
+            {
+                AICLI_LOG(Repo, Info, << "Multiple sources available, creating aggregated source that opens them on first use.");
+                auto aggregatedSource = std::make_shared<CompositeSource>("*DefaultSource");
+
+                for (auto& sourceReference : m_sourceReferences)
+                {
+                    AICLI_LOG(Repo, Info, << "Adding to aggregated source: " << sourceReference->GetDetails().Name);
+                    aggregatedSource->AddAvailableSource(Source{ std::make_shared<LazyOpenSource>(sourceReference) });
+                }
+
+                m_source = aggregatedSource;
+            }
+            else if (m_sourceReferences.size() > 1)
             {
                 AICLI_LOG(Repo, Info, << "Multiple sources available, creating aggregated source.");
                 auto aggregatedSource = std::make_shared<CompositeSource>("*DefaultSource");
@@ -615,9 +1014,12 @@ namespace AppInstaller::Repository
 
             try
             {
+                // Hold the update lock so that updates before open in other processes wait for this one and use its result.
+                auto updateLock = Synchronization::CrossProcessReaderWriteLock::LockExclusive(CreateNameForSourceUpdateLock(details), progress);
+
                 // TODO: Consider adding a context callback to indicate we are doing the same action
                 // to avoid the progress bar fill up multiple times.
-                if (UpdateSourceFromDetails(details, progress))
+                if (updateLock && UpdateSourceFromDetails(details, progress))
                 {
                     auto detailsInternal = sourceList.GetSource(details.Name);
                     detailsInternal->LastUpdateTime = details.LastUpdateTime;
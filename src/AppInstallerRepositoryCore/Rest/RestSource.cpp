@@ -61,6 +61,7 @@ namespace AppInstaller::Repository::Rest
             {
                 std::shared_ptr<const RestSource> source = GetReferenceSource();
                 std::scoped_lock versionsLock{ m_packageVersionsLock };
+                EnsureFieldsInternal(SearchResultFields::Versions);
 
                 std::vector<PackageVersionKey> result;
                 for (const auto& versionInfo : m_package.Versions)
@@ -75,6 +76,7 @@ namespace AppInstaller::Repository::Rest
             std::shared_ptr<IPackageVersion> GetLatestAvailableVersion() const override
             {
                 std::scoped_lock versionsLock{ m_packageVersionsLock };
+                EnsureFieldsInternal(SearchResultFields::LatestVersion);
                 return GetLatestVersionInternal();
             }
 
@@ -104,6 +106,23 @@ namespace AppInstaller::Repository::Rest
                 return m_package.PackageInformation;
             }
 
+            // Gets the version with the fields, retrieving them if the search did not include them.
+            IRestClient::VersionInfo GetVersionWithFields(const IRestClient::VersionInfo& versionInfo, SearchResultFields fields) const
+            {
+                std::scoped_lock versionsLock{ m_packageVersionsLock };
+                EnsureFieldsInternal(fields);
+
+                for (const auto& packageVersion : m_package.Versions)
+                {
+                    if (!(packageVersion.VersionAndChannel < versionInfo.VersionAndChannel) && !(versionInfo.VersionAndChannel < packageVersion.VersionAndChannel))
+                    {
+                        return packageVersion;
+                    }
+                }
+
+                return versionInfo;
+            }
+
             // This function is designed to handle the case where the only version that is returned by the
             // initial search is Unknown. In that case, we perform a search intended to trigger the optimized
             // path and directly get all manifests.
@@ -124,6 +143,7 @@ namespace AppInstaller::Repository::Rest
                         if (result.Matches.size() == 1)
                         {
                             m_package.Versions = std::move(result.Matches[0].Versions);
+                            m_package.Fields = result.Matches[0].Fields;
                             SortVersionsInternal();
                         }
                         else
@@ -162,8 +182,41 @@ namespace AppInstaller::Repository::Rest
             // Must hold m_packageVersionsLock while calling this
             std::shared_ptr<IPackageVersion> GetLatestVersionInternal() const;
 
+            // Retrieves the data that the search did not include, if the package does not have all of the fields.
+            // Must hold m_packageVersionsLock while calling this
+            void EnsureFieldsInternal(SearchResultFields fields) const
+            {
+                if (WI_AreAllFlagsSet(m_package.Fields, fields))
+                {
+                    return;
+                }
+
+                AICLI_LOG(Repo, Verbose, << "Retrieving the rest of the data of package: " << m_package.PackageInformation.PackageIdentifier);
+
+                SearchRequest request;
+                request.Inclusions.emplace_back(PackageMatchField::Id, MatchType::Exact, m_package.PackageInformation.PackageIdentifier);
+
+                IRestClient::SearchResult result = GetReferenceSource()->GetRestClient().Search(request);
+
+                for (auto& match : result.Matches)
+                {
+                    if (Utility::CaseInsensitiveEquals(match.PackageInformation.PackageIdentifier, m_package.PackageInformation.PackageIdentifier))
+                    {
+                        m_package.Versions = std::move(match.Versions);
+                        m_package.Fields = match.Fields;
+                        SortVersionsInternal();
+                        return;
+                    }
+                }
+
+                // The package was removed from the source since the search; keep what the search returned.
+                AICLI_LOG(Repo, Warning, << "Did not find the rest of the data of package: " << m_package.PackageInformation.PackageIdentifier);
+                THROW_HR_IF(APPINSTALLER_CLI_ERROR_RESTSOURCE_INVALID_DATA, m_package.Versions.empty());
+                m_package.Fields = SearchResultFields::All;
+            }
+
             // Must hold m_packageVersionsLock while calling this
-            void SortVersionsInternal()
+            void SortVersionsInternal() const
             {
                 std::sort(m_package.Versions.begin(), m_package.Versions.end(),
                     [](const IRestClient::VersionInfo& a, const IRestClient::VersionInfo& b)
@@ -172,8 +225,9 @@ namespace AppInstaller::Repository::Rest
                     });
             }
 
-            IRestClient::Package m_package;
-            // Protects access to m_package.Versions
+            // The versions and fields are retrieved on first use if the search did not include them.
+            mutable IRestClient::Package m_package;
+            // Protects access to m_package.Versions and m_package.Fields
             mutable std::mutex m_packageVersionsLock;
         };
 
@@ -181,8 +235,8 @@ namespace AppInstaller::Repository::Rest
         struct PackageVersion : public SourceReference, public IPackageVersion
         {
             PackageVersion(
-                const std::shared_ptr<RestSource>& source, std::shared_ptr<AvailablePackage>&& package, IRestClient::VersionInfo versionInfo)
-                : SourceReference(source), m_package(std::move(package)), m_versionInfo(std::move(versionInfo)) {}
+                const std::shared_ptr<RestSource>& source, std::shared_ptr<AvailablePackage>&& package, IRestClient::VersionInfo versionInfo, SearchResultFields fields)
+                : SourceReference(source), m_package(std::move(package)), m_versionInfo(std::move(versionInfo)), m_hasCorrelationKeys(WI_AreAllFlagsSet(fields, SearchResultFields::CorrelationKeys)) {}
 
             // Inherited via IPackageVersion
             Utility::LocIndString GetProperty(PackageVersionProperty property) const override
@@ -212,12 +266,14 @@ namespace AppInstaller::Repository::Rest
                 switch (property)
                 {
                 case PackageVersionMultiProperty::PackageFamilyName:
+                    EnsureCorrelationKeys();
                     for (std::string pfn : m_versionInfo.PackageFamilyNames)
                     {
                         result.emplace_back(Utility::LocIndString{ pfn });
                     }
                     break;
                 case PackageVersionMultiProperty::ProductCode:
+                    EnsureCorrelationKeys();
                     for (std::string productCode : m_versionInfo.ProductCodes)
                     {
                         result.emplace_back(Utility::LocIndString{ productCode });
@@ -298,6 +354,21 @@ namespace AppInstaller::Repository::Rest
             }
 
         private:
+            // Retrieves the package family names and product codes of the version if the search did not include them.
+            void EnsureCorrelationKeys() const
+            {
+                std::scoped_lock correlationKeysLock{ m_correlationKeysLock };
+                if (m_hasCorrelationKeys)
+                {
+                    return;
+                }
+
+                IRestClient::VersionInfo versionInfo = m_package->GetVersionWithFields(m_versionInfo, SearchResultFields::CorrelationKeys);
+                m_versionInfo.PackageFamilyNames = std::move(versionInfo.PackageFamilyNames);
+                m_versionInfo.ProductCodes = std::move(versionInfo.ProductCodes);
+                m_hasCorrelationKeys = true;
+            }
+
             template<AppInstaller::Manifest::Localization Field>
             void BuildPackageVersionMultiPropertyWithFallback(std::vector<Utility::LocIndString>& result) const
             {
@@ -317,7 +388,9 @@ namespace AppInstaller::Repository::Rest
             }
 
             std::shared_ptr<AvailablePackage> m_package;
-            IRestClient::VersionInfo m_versionInfo;
+            mutable IRestClient::VersionInfo m_versionInfo;
+            mutable bool m_hasCorrelationKeys;
+            mutable std::mutex m_correlationKeysLock;
         };
 
         std::shared_ptr<IPackageVersion> AvailablePackage::GetAvailableVersion(const PackageVersionKey& versionKey) const
@@ -331,6 +404,8 @@ namespace AppInstaller::Repository::Rest
                 return {};
             }
 
+            EnsureFieldsInternal((versionKey.Version.empty() && versionKey.Channel.empty()) ? SearchResultFields::LatestVersion : SearchResultFields::Versions);
+
             std::shared_ptr<IPackageVersion> packageVersion;
             if (!versionKey.Version.empty() && !versionKey.Channel.empty())
             {
@@ -339,7 +414,7 @@ namespace AppInstaller::Repository::Rest
                     if (CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetVersion().ToString(), versionKey.Version)
                         && CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetChannel().ToString(), versionKey.Channel))
                     {
-                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo);
+                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo, m_package.Fields);
                         break;
                     }
                 }
@@ -354,7 +429,7 @@ namespace AppInstaller::Repository::Rest
                 {
                     if (CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetChannel().ToString(), versionKey.Channel))
                     {
-                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo);
+                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo, m_package.Fields);
                         break;
                     }
                 }
@@ -365,7 +440,7 @@ namespace AppInstaller::Repository::Rest
                 {
                     if (CaseInsensitiveEquals(versionInfo.VersionAndChannel.GetVersion().ToString(), versionKey.Version))
                     {
-                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo);
+                        packageVersion = std::make_shared<PackageVersion>(source, NonConstSharedFromThis(), versionInfo, m_package.Fields);
                         break;
                     }
                 }
@@ -376,7 +451,7 @@ namespace AppInstaller::Repository::Rest
 
         std::shared_ptr<IPackageVersion> AvailablePackage::GetLatestVersionInternal() const
         {
-            return std::make_shared<PackageVersion>(GetReferenceSource(), NonConstSharedFromThis(), m_package.Versions.front());
+            return std::make_shared<PackageVersion>(GetReferenceSource(), NonConstSharedFromThis(), m_package.Versions.front(), m_package.Fields);
         }
     }
 
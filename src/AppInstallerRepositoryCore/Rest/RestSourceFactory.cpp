@@ -59,6 +59,8 @@ namespace AppInstaller::Repository::Rest
                         m_information.RequiredPackageMatchFields = sourceInformation.RequiredPackageMatchFields;
                         m_information.UnsupportedQueryParameters = sourceInformation.UnsupportedQueryParameters;
                         m_information.RequiredQueryParameters = sourceInformation.RequiredQueryParameters;
+                        m_information.Scope.IdentifierNamespaces = sourceInformation.IdentifierNamespaces;
+                        m_information.Scope.Publishers = sourceInformation.Publishers;
 
                         m_information.SourceAgreementsIdentifier = sourceInformation.SourceAgreementsIdentifier;
                         for (auto const& agreement : sourceInformation.SourceAgreements)
@@ -50,6 +50,9 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                 return result;
             }
 
+            // A response to a request for only some of the data lists the data that it includes.
+            SearchResultFields fields = RestHelper::GetResponseFields(searchResponseObject);
+
             for (auto& manifestItem : dataArray.value().get())
             {
                 std::optional<std::string> packageId = JsonHelper::GetRawStringValueFromJsonNode(manifestItem, JsonHelper::GetUtilityString(PackageIdentifier));
@@ -85,7 +88,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                     }
                 }
 
-                if (versionList.size() == 0)
+                if (versionList.size() == 0 && WI_IsAnyFlagSet(fields, SearchResultFields::LatestVersion))
                 {
                     AICLI_LOG(Repo, Error, << "Received no versions in package: " << packageId.value());
                     return {};
@@ -94,6 +97,7 @@ namespace AppInstaller::Repository::Rest::Schema::V1_0::Json
                 IRestClient::PackageInfo packageInfo{
                         std::move(packageId.value()), std::move(packageName.value()), std::move(publisher.value()) };
                 IRestClient::Package package{ std::move(packageInfo), std::move(versionList) };
+                package.Fields = fields;
                 result.Matches.emplace_back(std::move(package));
             }
 
@@ -131,7 +131,16 @@ namespace AppInstaller::Repository::Rest::Schema::V1_1
         }
 
         SearchRequestSerializer serializer;
-        return serializer.Serialize(resultSearchRequest);
+        web::json::value result = serializer.Serialize(resultSearchRequest);
+
+        // Only ask for some of the data from sources that support it, as others may reject the request.
+        if (m_information.SupportedExtensions.end() != std::find_if(m_information.SupportedExtensions.begin(), m_information.SupportedExtensions.end(),
+            [](const std::string& extension) { return Utility::CaseInsensitiveEquals(extension, SearchResponseFieldsExtension); }))
+        {
+            RestHelper::SetResponseFields(result, searchRequest.Fields);
+        }
+
+        return result;
     }
 
     IRestClient::SearchResult Interface::GetSearchResult(const web::json::value& searchResponseObject) const
@@ -13,6 +13,12 @@ namespace AppInstaller::Repository::Rest::Schema
     constexpr std::string_view Data = "Data"sv;
     constexpr std::string_view ContinuationToken = "ContinuationToken"sv;
 
+    // Search response fields extension; when the source information lists it in its SupportedExtensions, the
+    // search request may list the data that the client needs in ResponseFields. The response lists the data
+    // that it includes in ResponseFields as well; a response without them includes all of the data.
+    constexpr std::string_view SearchResponseFieldsExtension = "SearchResponseFields"sv;
+    constexpr std::string_view ResponseFields = "ResponseFields"sv;
+
     // General API Header constant
     constexpr std::string_view ContractVersion = "Version"sv;
 
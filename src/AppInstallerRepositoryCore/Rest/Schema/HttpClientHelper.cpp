@@ -2,25 +2,58 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "HttpClientHelper.h"
+#include <winget/NetworkConnectivity.h>
+#include <winhttp.h>
 
 namespace AppInstaller::Repository::Rest::Schema
 {
-    HttpClientHelper::HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> stage) : m_defaultRequestHandlerStage(stage) {}
+    namespace
+    {
+        web::http::http_request CreatePostRequest(const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers)
+        {
+            web::http::http_request request{ web::http::methods::POST };
+            request.headers().set_content_type(web::http::details::mime_types::application_json);
+            request.set_body(body.serialize());
+
+            // Add headers
+            for (auto& pair : headers)
+            {
+                request.headers().add(pair.first, pair.second);
+            }
+
+            return request;
+        }
+
+        web::http::http_request CreateGetRequest(const std::unordered_map<utility::string_t, utility::string_t>& headers)
+        {
+            web::http::http_request request{ web::http::methods::GET };
+            request.headers().set_content_type(web::http::details::mime_types::application_json);
+
+            // Add headers
+            for (auto& pair : headers)
+            {
+                request.headers().add(pair.first, pair.second);
+            }
+
+            return request;
+        }
+    }
+
+    HttpClientHelper::HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> stage, std::shared_ptr<RequestHedgingPolicy> hedgingPolicy) :
+        m_defaultRequestHandlerStage(stage), m_hedgingPolicy(std::move(hedgingPolicy))
+    {
+        if (!m_hedgingPolicy && Settings::User().Get<Settings::Setting::NetworkRestRequestHedging>())
+        {
+            m_hedgingPolicy = RequestHedgingPolicy::Instance();
+        }
+    }
 
     pplx::task<web::http::http_response> HttpClientHelper::Post(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
         AICLI_LOG(Repo, Info, << "Sending http POST request to: " << utility::conversions::to_utf8string(uri));
         web::http::client::http_client client = GetClient(uri);
-        web::http::http_request request{ web::http::methods::POST };
-        request.headers().set_content_type(web::http::details::mime_types::application_json);
-        request.set_body(body.serialize());
-
-        // Add headers
-        for (auto& pair : headers)
-        {
-            request.headers().add(pair.first, pair.second);
-        }
+        web::http::http_request request = CreatePostRequest(body, headers);
 
         AICLI_LOG(Repo, Verbose, << "Http POST request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
@@ -30,13 +63,23 @@ namespace AppInstaller::Repository::Rest::Schema
     std::optional<web::json::value> HttpClientHelper::HandlePost(
         const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
-        web::http::http_response httpResponse;
-        HttpClientHelper::Post(uri, body, headers).then([&httpResponse](const web::http::http_response& response)
+        return ValidateAndExtractResponse(SendTrackingConnectivity(uri, [&]()
             {
-                httpResponse = response;
-            }).wait();
-
-        return ValidateAndExtractResponse(httpResponse);
+                if (!m_hedgingPolicy)
+                {
+                    web::http::http_response httpResponse;
+                    HttpClientHelper::Post(uri, body, headers).then([&httpResponse](const web::http::http_response& response)
+                        {
+                            httpResponse = response;
+                        }).wait();
+
+                    return httpResponse;
+                }
+
+                // REST source POST requests are searches, which are safe to send more than once.
+                AICLI_LOG(Repo, Info, << "Sending http POST request to: " << utility::conversions::to_utf8string(uri));
+                return SendRequest(uri, [&]() { return CreatePostRequest(body, headers); });
+            }));
     }
 
     pplx::task<web::http::http_response> HttpClientHelper::Get(
@@ -44,14 +87,7 @@ namespace AppInstaller::Repository::Rest::Schema
     {
         AICLI_LOG(Repo, Info, << "Sending http GET request to: " << utility::conversions::to_utf8string(uri));
         web::http::client::http_client client = GetClient(uri);
-        web::http::http_request request{ web::http::methods::GET };
-        request.headers().set_content_type(web::http::details::mime_types::application_json);
-
-        // Add headers
-        for (auto& pair : headers)
-        {
-            request.headers().add(pair.first, pair.second);
-        }
+        web::http::http_request request = CreateGetRequest(headers);
 
         AICLI_LOG(Repo, Verbose, << "Http GET request details:\n" << utility::conversions::to_utf8string(request.to_string()));
 
@@ -61,18 +97,36 @@ namespace AppInstaller::Repository::Rest::Schema
     std::optional<web::json::value> HttpClientHelper::HandleGet(
         const utility::string_t& uri, const std::unordered_map<utility::string_t, utility::string_t>& headers) const
     {
-        web::http::http_response httpResponse;
-        Get(uri, headers).then([&httpResponse](const web::http::http_response& response)
+        return ValidateAndExtractResponse(SendTrackingConnectivity(uri, [&]()
             {
-                httpResponse = response;
-            }).wait();
-
-        return ValidateAndExtractResponse(httpResponse);
+                if (!m_hedgingPolicy)
+                {
+                    web::http::http_response httpResponse;
+                    Get(uri, headers).then([&httpResponse](const web::http::http_response& response)
+                        {
+                            httpResponse = response;
+                        }).wait();
+
+                    return httpResponse;
+                }
+
+                AICLI_LOG(Repo, Info, << "Sending http GET request to: " << utility::conversions::to_utf8string(uri));
+                return SendRequest(uri, [&]() { return CreateGetRequest(headers); });
+            }));
     }
 
     web::http::client::http_client HttpClientHelper::GetClient(const utility::string_t& uri) const
     {
-        web::http::client::http_client client{ uri };
+        web::http::client::http_client_config config;
+
+        // Fail quickly when the host cannot be reached; sending and receiving keep the default timeout.
+        config.set_nativehandle_options([transferTimeout = static_cast<int>(config.timeout<std::chrono::milliseconds>().count())](web::http::client::native_handle handle)
+            {
+                int connectTimeout = static_cast<int>(Network::ConnectTimeout.count());
+                LOG_IF_WIN32_BOOL_FALSE(WinHttpSetTimeouts(handle, connectTimeout, connectTimeout, transferTimeout, transferTimeout));
+            });
+
+        web::http::client::http_client client{ uri, config };
 
         // Add default custom handlers if any.
         if (m_defaultRequestHandlerStage)
@@ -83,6 +137,34 @@ namespace AppInstaller::Repository::Rest::Schema
         return client;
     }
 
+    web::http::http_response HttpClientHelper::SendRequest(const utility::string_t& uri, const std::function<web::http::http_request()>& createRequest) const
+    {
+        return SendHedgedRequest(*m_hedgingPolicy, uri, [&](const pplx::cancellation_token& cancellationToken)
+            {
+                // Each request uses its own client, and thus its own connection.
+                return GetClient(uri).request(createRequest(), cancellationToken);
+            });
+    }
+
+    web::http::http_response HttpClientHelper::SendTrackingConnectivity(const utility::string_t& uri, const std::function<web::http::http_response()>& send) const
+    {
+        std::string utf8Uri = utility::conversions::to_utf8string(uri);
+        Network::ConnectivityState& connectivity = Network::ConnectivityState::Instance();
+        connectivity.ThrowIfUnavailable(utf8Uri);
+
+        try
+        {
+            web::http::http_response response = send();
+            connectivity.RecordReachable(utf8Uri);
+            return response;
+        }
+        catch (const web::http::http_exception& e)
+        {
+            connectivity.RecordFailure(utf8Uri, HRESULT_FROM_WIN32(e.error_code().value()));
+            throw;
+        }
+    }
+
     std::optional<web::json::value> HttpClientHelper::ValidateAndExtractResponse(const web::http::http_response& response) const
     {
         AICLI_LOG(Repo, Info, << "Response status: " << response.status_code());
@@ -3,6 +3,7 @@
 #pragma once
 #include <cpprest/http_client.h>
 #include <cpprest/json.h>
+#include "RequestHedging.h"
 
 #include <optional>
 #include <vector>
@@ -11,7 +12,8 @@ namespace AppInstaller::Repository::Rest::Schema
 {
     struct HttpClientHelper
     {
-        HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> = {});
+        // When no hedging policy is given, the shared policy is used if request hedging is enabled in the settings.
+        HttpClientHelper(std::optional<std::shared_ptr<web::http::http_pipeline_stage>> = {}, std::shared_ptr<RequestHedgingPolicy> hedgingPolicy = {});
 
         pplx::task<web::http::http_response> Post(const utility::string_t& uri, const web::json::value& body, const std::unordered_map<utility::string_t, utility::string_t> &headers = {}) const;
 
@@ -29,6 +31,13 @@ namespace AppInstaller::Repository::Rest::Schema
     private:
         web::http::client::http_client GetClient(const utility::string_t& uri) const;
 
+        // Sends the request, hedging it if enabled. The create function must create a new request each time it is called.
+        web::http::http_response SendRequest(const utility::string_t& uri, const std::function<web::http::http_request()>& createRequest) const;
+
+        // Sends the request unless the network is unavailable for the uri, recording whether its host could be reached.
+        web::http::http_response SendTrackingConnectivity(const utility::string_t& uri, const std::function<web::http::http_response()>& send) const;
+
         std::optional<std::shared_ptr<web::http::http_pipeline_stage>> m_defaultRequestHandlerStage;
+        std::shared_ptr<RequestHedgingPolicy> m_hedgingPolicy;
     };
 }
@@ -38,6 +38,8 @@ namespace AppInstaller::Repository::Rest::Schema
     {
         PackageInfo PackageInformation;
         std::vector<VersionInfo> Versions;
+        // The data of the package that the response included; the rest is retrieved when it is needed.
+        SearchResultFields Fields = SearchResultFields::All;
 
         Package(PackageInfo packageInfo, std::vector<VersionInfo> versions)
         : PackageInformation(std::move(packageInfo)), Versions(std::move(versions)) {}
@@ -67,6 +69,9 @@ namespace AppInstaller::Repository::Rest::Schema
         std::vector<std::string> RequiredPackageMatchFields;
         std::vector<std::string> UnsupportedQueryParameters;
         std::vector<std::string> RequiredQueryParameters;
+        std::vector<std::string> IdentifierNamespaces;
+        std::vector<std::string> Publishers;
+        std::vector<std::string> SupportedExtensions;
 
         Information() {}
         Information(std::string sourceId, std::vector<std::string> versions)
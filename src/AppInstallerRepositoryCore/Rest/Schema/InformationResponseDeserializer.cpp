@@ -25,6 +25,10 @@ namespace AppInstaller::Repository::Rest::Schema
         constexpr std::string_view RequiredPackageMatchFields = "RequiredPackageMatchFields"sv;
         constexpr std::string_view UnsupportedQueryParameters = "UnsupportedQueryParameters"sv;
         constexpr std::string_view RequiredQueryParameters = "RequiredQueryParameters"sv;
+
+        constexpr std::string_view IdentifierNamespaces = "IdentifierNamespaces"sv;
+        constexpr std::string_view Publishers = "Publishers"sv;
+        constexpr std::string_view SupportedExtensions = "SupportedExtensions"sv;
     }
 
     IRestClient::Information InformationResponseDeserializer::Deserialize(const web::json::value& dataObject) const
@@ -122,6 +126,9 @@ namespace AppInstaller::Repository::Rest::Schema
             info.UnsupportedPackageMatchFields = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(UnsupportedPackageMatchFields));
             info.RequiredQueryParameters = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(RequiredQueryParameters));
             info.UnsupportedQueryParameters = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(UnsupportedQueryParameters));
+            info.IdentifierNamespaces = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(IdentifierNamespaces));
+            info.Publishers = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(Publishers));
+            info.SupportedExtensions = JsonHelper::GetRawStringArrayFromJsonNode(dataValue, JsonHelper::GetUtilityString(SupportedExtensions));
 
             return info;
         }
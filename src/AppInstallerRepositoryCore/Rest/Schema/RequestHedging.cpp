@@ -0,0 +1,225 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "RequestHedging.h"
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    namespace
+    {
+        // The state shared by the requests in a hedged set; the losing request may complete after the caller returns.
+        struct HedgedRequestState
+        {
+            std::mutex Lock;
+            std::condition_variable Completed;
+            size_t Started = 0;
+            size_t Failed = 0;
+            std::optional<web::http::http_response> Response;
+            size_t ResponseIndex = 0;
+            std::exception_ptr FirstRequestError;
+        };
+
+        void WatchRequest(const std::shared_ptr<HedgedRequestState>& state, pplx::task<web::http::http_response> task, size_t index)
+        {
+            task.then([state, index](pplx::task<web::http::http_response> completed)
+                {
+                    std::optional<web::http::http_response> response;
+                    std::exception_ptr error;
+
+                    try
+                    {
+                        response = completed.get();
+                    }
+                    catch (...)
+                    {
+                        error = std::current_exception();
+                    }
+
+                    {
+                        std::lock_guard<std::mutex> lock{ state->Lock };
+
+                        if (response)
+                        {
+                            if (!state->Response)
+                            {
+                                state->Response = std::move(response);
+                                state->ResponseIndex = index;
+                            }
+                        }
+                        else
+                        {
+                            ++state->Failed;
+                            if (index == 0)
+                            {
+                                state->FirstRequestError = error;
+                            }
+                        }
+                    }
+
+                    state->Completed.notify_all();
+                });
+        }
+
+        // Requests to the same scheme, host, port and path share latency samples.
+        utility::string_t GetEndpoint(const utility::string_t& uri)
+        {
+            web::uri parsed{ uri };
+            return parsed.authority().to_string() + parsed.path();
+        }
+    }
+
+    RequestHedgingPolicy::RequestHedgingPolicy() : RequestHedgingPolicy(Options{}) {}
+
+    RequestHedgingPolicy::RequestHedgingPolicy(const Options& options) : m_options(options) {}
+
+    std::shared_ptr<RequestHedgingPolicy> RequestHedgingPolicy::Instance()
+    {
+        static std::shared_ptr<RequestHedgingPolicy> s_instance = std::make_shared<RequestHedgingPolicy>();
+        return s_instance;
+    }
+
+    std::chrono::milliseconds RequestHedgingPolicy::GetHedgeDelay(const utility::string_t& endpoint) const
+    {
+        std::vector<std::chrono::milliseconds> samples;
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+
+            auto itr = m_latencies.find(endpoint);
+            if (itr == m_latencies.end() || itr->second.size() < std::max<size_t>(m_options.MinimumSamples, 1))
+            {
+                return m_options.InitialDelay;
+            }
+
+            samples.assign(itr->second.begin(), itr->second.end());
+        }
+
+        size_t index = static_cast<size_t>(m_options.Percentile * static_cast<double>(samples.size()));
+        index = std::min(index, samples.size() - 1);
+        std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+        return std::clamp(samples[index], m_options.MinimumDelay, m_options.MaximumDelay);
+    }
+
+    void RequestHedgingPolicy::RecordLatency(const utility::string_t& endpoint, std::chrono::milliseconds latency)
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        auto& samples = m_latencies[endpoint];
+        samples.push_back(latency);
+        while (samples.size() > m_options.SampleWindow)
+        {
+            samples.pop_front();
+        }
+    }
+
+    void RequestHedgingPolicy::RecordRequest()
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        ++m_requestCount;
+    }
+
+    bool RequestHedgingPolicy::TryAcquireHedge()
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        double allowed = static_cast<double>(m_options.BudgetBurst) + m_options.BudgetRatio * static_cast<double>(m_requestCount);
+        if (static_cast<double>(m_hedgeCount) + 1 > allowed)
+        {
+            return false;
+        }
+
+        ++m_hedgeCount;
+        return true;
+    }
+
+    web::http::http_response SendHedgedRequest(
+        RequestHedgingPolicy& policy,
+        const utility::string_t& uri,
+        const std::function<pplx::task<web::http::http_response>(const pplx::cancellation_token&)>& send)
+    {
+        utility::string_t endpoint = GetEndpoint(uri);
+        std::chrono::milliseconds delay = policy.GetHedgeDelay(endpoint);
+
+        auto state = std::make_shared<HedgedRequestState>();
+        pplx::cancellation_token_source cancellationSources[2];
+        std::chrono::steady_clock::time_point startTimes[2];
+
+        auto isDone = [&]() { return state->Response || state->Failed == state->Started; };
+
+        policy.RecordRequest();
+        startTimes[0] = std::chrono::steady_clock::now();
+        state->Started = 1;
+        WatchRequest(state, send(cancellationSources[0].get_token()), 0);
+
+        std::unique_lock<std::mutex> lock{ state->Lock };
+
+        if (!state->Completed.wait_for(lock, delay, isDone))
+        {
+            if (policy.TryAcquireHedge())
+            {
+                AICLI_LOG(Repo, Info, << "Sending hedged request after " << delay.count() << "ms to: " << utility::conversions::to_utf8string(uri));
+
+                // Do not hold the lock while sending, as the first request's completion needs it.
+                lock.unlock();
+
+                std::optional<pplx::task<web::http::http_response>> hedge;
+                try
+                {
+                    startTimes[1] = std::chrono::steady_clock::now();
+                    hedge = send(cancellationSources[1].get_token());
+                }
+                catch (...)
+                {
+                    LOG_CAUGHT_EXCEPTION();
+                }
+
+                if (hedge)
+                {
+                    {
+                        std::lock_guard<std::mutex> startLock{ state->Lock };
+                        state->Started = 2;
+                    }
+
+                    WatchRequest(state, std::move(hedge.value()), 1);
+                }
+
+                lock.lock();
+            }
+            else
+            {
+                AICLI_LOG(Repo, Verbose, << "Request hedging budget exhausted");
+            }
+        }
+
+        state->Completed.wait(lock, isDone);
+
+        if (!state->Response)
+        {
+            std::rethrow_exception(state->FirstRequestError);
+        }
+
+        size_t winner = state->ResponseIndex;
+        web::http::http_response result = state->Response.value();
+        size_t started = state->Started;
+        lock.unlock();
+
+        auto latency = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTimes[winner]);
+        policy.RecordLatency(endpoint, latency);
+
+        for (size_t i = 0; i < started; ++i)
+        {
+            if (i != winner)
+            {
+                cancellationSources[i].cancel();
+            }
+        }
+
+        if (started > 1)
+        {
+            AICLI_LOG(Repo, Info, << (winner == 0 ? "Original" : "Hedged") << " request completed first, in " << latency.count() << "ms");
+        }
+
+        return result;
+    }
+}
@@ -0,0 +1,74 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cpprest/http_client.h>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace AppInstaller::Repository::Rest::Schema
+{
+    // Decides when a duplicate (hedged) request should be sent for an idempotent REST call that has not yet completed.
+    // The delay is derived from the recent latency of the endpoint, and hedges are limited by a budget shared by all endpoints.
+    struct RequestHedgingPolicy
+    {
+        struct Options
+        {
+            // The delay used until an endpoint has enough latency samples.
+            std::chrono::milliseconds InitialDelay{ 1000 };
+
+            // The bounds of the delay.
+            std::chrono::milliseconds MinimumDelay{ 50 };
+            std::chrono::milliseconds MaximumDelay{ 5000 };
+
+            // The latency percentile of the endpoint, in the range (0, 1], after which the hedge is sent.
+            double Percentile = 0.95;
+
+            // The number of latency samples kept per endpoint, and the number needed before they are used.
+            size_t SampleWindow = 64;
+            size_t MinimumSamples = 8;
+
+            // The number of hedges allowed is BudgetBurst + BudgetRatio * (the number of requests sent).
+            double BudgetRatio = 0.1;
+            size_t BudgetBurst = 2;
+        };
+
+        RequestHedgingPolicy();
+        RequestHedgingPolicy(const Options& options);
+
+        // Gets the policy shared by all clients when hedging is enabled in the settings.
+        static std::shared_ptr<RequestHedgingPolicy> Instance();
+
+        // Gets the delay after which a hedge should be sent for the endpoint.
+        std::chrono::milliseconds GetHedgeDelay(const utility::string_t& endpoint) const;
+
+        // Records the latency of a completed request to the endpoint.
+        void RecordLatency(const utility::string_t& endpoint, std::chrono::milliseconds latency);
+
+        // Records that a (non-hedge) request was sent, which grows the hedge budget.
+        void RecordRequest();
+
+        // Consumes from the hedge budget; returns false if the budget is exhausted.
+        bool TryAcquireHedge();
+
+    private:
+        Options m_options;
+        mutable std::mutex m_lock;
+        std::map<utility::string_t, std::deque<std::chrono::milliseconds>> m_latencies;
+        size_t m_requestCount = 0;
+        size_t m_hedgeCount = 0;
+    };
+
+    // Sends a request and, if it has not completed after the policy's delay for the endpoint, a duplicate of it.
+    // The first response received is returned and the other request is cancelled. If all requests fail,
+    // the error from the original request is thrown.
+    // The send function is called once per request, with the token that cancels it, and must create a new request each time.
+    web::http::http_response SendHedgedRequest(
+        RequestHedgingPolicy& policy,
+        const utility::string_t& uri,
+        const std::function<pplx::task<web::http::http_response>(const pplx::cancellation_token&)>& send);
+}
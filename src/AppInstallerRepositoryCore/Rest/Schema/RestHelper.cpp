@@ -9,6 +9,17 @@ using namespace AppInstaller::Repository::Rest::Schema;
 
 namespace AppInstaller::Repository::Rest::Schema
 {
+    namespace
+    {
+        // The names of the response fields; all of the data has no name, as it is the same as not listing any.
+        constexpr std::pair<SearchResultFields, std::string_view> s_ResponseFieldNames[] =
+        {
+            { SearchResultFields::Versions, "Versions"sv },
+            { SearchResultFields::LatestVersion, "LatestVersion"sv },
+            { SearchResultFields::CorrelationKeys, "CorrelationKeys"sv },
+        };
+    }
+
     utility::string_t RestHelper::GetRestAPIBaseUri(std::string restApiUri)
     {
         // Trim
@@ -83,4 +94,48 @@ namespace AppInstaller::Repository::Rest::Schema
         std::vector<std::string> result{ set.begin(), set.end() };
         return result;
     }
+
+    void RestHelper::SetResponseFields(web::json::value& searchRequestObject, SearchResultFields fields)
+    {
+        if (fields == SearchResultFields::All)
+        {
+            return;
+        }
+
+        std::vector<web::json::value> names;
+        SearchResultFields remaining = fields;
+        for (const auto& [field, name] : s_ResponseFieldNames)
+        {
+            // Versions includes the latest version, so it is listed on its own.
+            if (WI_AreAllFlagsSet(remaining, field))
+            {
+                names.emplace_back(web::json::value::string(JsonHelper::GetUtilityString(name)));
+                WI_ClearAllFlags(remaining, field);
+            }
+        }
+
+        searchRequestObject[JsonHelper::GetUtilityString(ResponseFields)] = web::json::value::array(std::move(names));
+    }
+
+    SearchResultFields RestHelper::GetResponseFields(const web::json::value& searchResponseObject)
+    {
+        if (!JsonHelper::GetRawJsonArrayFromJsonNode(searchResponseObject, JsonHelper::GetUtilityString(ResponseFields)))
+        {
+            return SearchResultFields::All;
+        }
+
+        SearchResultFields result = SearchResultFields::None;
+        for (const auto& name : JsonHelper::GetRawStringArrayFromJsonNode(searchResponseObject, JsonHelper::GetUtilityString(ResponseFields)))
+        {
+            for (const auto& [field, fieldName] : s_ResponseFieldNames)
+            {
+                if (Utility::CaseInsensitiveEquals(name, fieldName))
+                {
+                    result |= field;
+                }
+            }
+        }
+
+        return result;
+    }
 }
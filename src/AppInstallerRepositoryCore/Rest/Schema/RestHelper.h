@@ -1,6 +1,7 @@
 // Copyright (c) Microsoft Corporation.
 // Licensed under the MIT License.
 #pragma once
+#include <winget/RepositorySearch.h>
 #include <cpprest/json.h>
 
 namespace AppInstaller::Repository::Rest::Schema
@@ -21,5 +22,11 @@ namespace AppInstaller::Repository::Rest::Schema
         static std::optional<utility::string_t> GetContinuationToken(const web::json::value& jsonObject);
 
         static std::vector<std::string> GetUniqueItems(const std::vector<std::string>& list);
+
+        // Adds the response fields to a search request body; nothing is added if the fields are all of the data.
+        static void SetResponseFields(web::json::value& searchRequestObject, SearchResultFields fields);
+
+        // Gets the data that a search response includes, as listed by its response fields.
+        static SearchResultFields GetResponseFields(const web::json::value& searchResponseObject);
     };
 }
@@ -0,0 +1,403 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SQLiteVfs.h"
+
+#include <mutex>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::SQLite
+{
+    namespace
+    {
+        constexpr std::string_view s_PageReadsVfsName = "winget-pagereads"sv;
+        constexpr std::string_view s_VfsParameter = "vfs"sv;
+        constexpr char s_PageReadsBaseVfsParameter[] = "pagereadsvfs";
+
+        // Reads past this are not recorded; the pages read first are the ones worth reading ahead of a search.
+        constexpr size_t s_MaxPageReads = 4096;
+
+        // The page size is stored in the database header as a big endian value, with 1 meaning 65536.
+        constexpr sqlite3_int64 s_PageSizeOffset = 16;
+
+        int PassThroughVfsDelete(sqlite3_vfs* vfs, const char* name, int syncDir)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xDelete(baseVfs, name, syncDir);
+        }
+
+        int PassThroughVfsAccess(sqlite3_vfs* vfs, const char* name, int flags, int* result)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xAccess(baseVfs, name, flags, result);
+        }
+
+        int PassThroughVfsFullPathname(sqlite3_vfs* vfs, const char* name, int size, char* output)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xFullPathname(baseVfs, name, size, output);
+        }
+
+        void* PassThroughVfsDlOpen(sqlite3_vfs* vfs, const char* fileName)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xDlOpen(baseVfs, fileName);
+        }
+
+        void PassThroughVfsDlError(sqlite3_vfs* vfs, int size, char* message)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            baseVfs->xDlError(baseVfs, size, message);
+        }
+
+        void (*PassThroughVfsDlSym(sqlite3_vfs* vfs, void* handle, const char* symbol))(void)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xDlSym(baseVfs, handle, symbol);
+        }
+
+        void PassThroughVfsDlClose(sqlite3_vfs* vfs, void* handle)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            baseVfs->xDlClose(baseVfs, handle);
+        }
+
+        int PassThroughVfsRandomness(sqlite3_vfs* vfs, int size, char* output)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xRandomness(baseVfs, size, output);
+        }
+
+        int PassThroughVfsSleep(sqlite3_vfs* vfs, int microseconds)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xSleep(baseVfs, microseconds);
+        }
+
+        int PassThroughVfsCurrentTime(sqlite3_vfs* vfs, double* time)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xCurrentTime(baseVfs, time);
+        }
+
+        int PassThroughVfsGetLastError(sqlite3_vfs* vfs, int size, char* output)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            return baseVfs->xGetLastError(baseVfs, size, output);
+        }
+
+        int PassThroughVfsCurrentTimeInt64(sqlite3_vfs* vfs, sqlite3_int64* time)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            if (baseVfs->iVersion >= 2 && baseVfs->xCurrentTimeInt64)
+            {
+                return baseVfs->xCurrentTimeInt64(baseVfs, time);
+            }
+
+            double julianDay = 0;
+            int result = baseVfs->xCurrentTime(baseVfs, &julianDay);
+            *time = static_cast<sqlite3_int64>(julianDay * 86400000.0);
+            return result;
+        }
+
+        // A file opened through the page reads VFS. The file of the VFS that it wraps is allocated separately,
+        // as its size depends on which VFS that is.
+        struct PageReadsFile
+        {
+            sqlite3_file Base;
+            sqlite3_file* Underlying;
+            // The page size of the main database, once its header has been read.
+            uint32_t PageSize;
+            // The pages read from the main database; null for other files. Its capacity is reserved when the file
+            // is opened so that recording a read never allocates.
+            std::vector<uint32_t>* Pages;
+        };
+
+        PageReadsFile* AsPageReadsFile(sqlite3_file* file)
+        {
+            return reinterpret_cast<PageReadsFile*>(file);
+        }
+
+        void FreeUnderlyingFile(sqlite3_file* underlying)
+        {
+            if (underlying->pMethods)
+            {
+                underlying->pMethods->xClose(underlying);
+            }
+
+            sqlite3_free(underlying);
+        }
+
+        int PageReadsFileClose(sqlite3_file* file)
+        {
+            PageReadsFile* readsFile = AsPageReadsFile(file);
+            sqlite3_file* underlying = readsFile->Underlying;
+            int result = underlying->pMethods->xClose(underlying);
+
+            sqlite3_free(underlying);
+            delete readsFile->Pages;
+            readsFile->Pages = nullptr;
+
+            return result;
+        }
+
+        int PageReadsFileRead(sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset)
+        {
+            PageReadsFile* readsFile = AsPageReadsFile(file);
+            sqlite3_file* underlying = readsFile->Underlying;
+            int result = underlying->pMethods->xRead(underlying, buffer, amount, offset);
+
+            if (result == SQLITE_OK && readsFile->Pages)
+            {
+                if (!readsFile->PageSize && offset == 0 && amount >= s_PageSizeOffset + 2)
+                {
+                    const uint8_t* header = static_cast<const uint8_t*>(buffer);
+                    uint32_t pageSize = (static_cast<uint32_t>(header[s_PageSizeOffset]) << 8) | header[s_PageSizeOffset + 1];
+                    readsFile->PageSize = (pageSize == 1 ? 65536 : pageSize);
+                }
+
+                // Reads before the header are of the header, which is in the first page.
+                uint32_t page = (readsFile->PageSize ? static_cast<uint32_t>(offset / readsFile->PageSize) + 1 : 1);
+                if (readsFile->Pages->size() < readsFile->Pages->capacity())
+                {
+                    readsFile->Pages->emplace_back(page);
+                }
+            }
+
+            return result;
+        }
+
+        int PageReadsFileWrite(sqlite3_file* file, const void* buffer, int amount, sqlite3_int64 offset)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xWrite(underlying, buffer, amount, offset);
+        }
+
+        int PageReadsFileTruncate(sqlite3_file* file, sqlite3_int64 size)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xTruncate(underlying, size);
+        }
+
+        int PageReadsFileSync(sqlite3_file* file, int flags)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xSync(underlying, flags);
+        }
+
+        int PageReadsFileSize(sqlite3_file* file, sqlite3_int64* size)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xFileSize(underlying, size);
+        }
+
+        int PageReadsFileLock(sqlite3_file* file, int lock)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xLock(underlying, lock);
+        }
+
+        int PageReadsFileUnlock(sqlite3_file* file, int lock)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xUnlock(underlying, lock);
+        }
+
+        int PageReadsFileCheckReservedLock(sqlite3_file* file, int* result)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xCheckReservedLock(underlying, result);
+        }
+
+        int PageReadsFileControl(sqlite3_file* file, int op, void* arg)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xFileControl(underlying, op, arg);
+        }
+
+        int PageReadsFileSectorSize(sqlite3_file* file)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xSectorSize(underlying);
+        }
+
+        int PageReadsFileDeviceCharacteristics(sqlite3_file* file)
+        {
+            sqlite3_file* underlying = AsPageReadsFile(file)->Underlying;
+            return underlying->pMethods->xDeviceCharacteristics(underlying);
+        }
+
+        // Only the version 1 methods are passed through, so SQLite does not use shared memory or memory mapping for these files.
+        const sqlite3_io_methods s_PageReadsFileMethods =
+        {
+            1,
+            PageReadsFileClose,
+            PageReadsFileRead,
+            PageReadsFileWrite,
+            PageReadsFileTruncate,
+            PageReadsFileSync,
+            PageReadsFileSize,
+            PageReadsFileLock,
+            PageReadsFileUnlock,
+            PageReadsFileCheckReservedLock,
+            PageReadsFileControl,
+            PageReadsFileSectorSize,
+            PageReadsFileDeviceCharacteristics,
+        };
+
+        int PageReadsVfsOpen(sqlite3_vfs* vfs, const char* name, sqlite3_file* file, int flags, int* outFlags)
+        {
+            sqlite3_vfs* baseVfs = GetBaseVfs(vfs);
+            bool isMainDb = (flags & SQLITE_OPEN_MAIN_DB) != 0;
+
+            if (isMainDb)
+            {
+                // The connection uses this VFS, so the one that it would have used otherwise is named by the URI.
+                const char* baseVfsName = sqlite3_uri_parameter(name, s_PageReadsBaseVfsParameter);
+                if (baseVfsName)
+                {
+                    baseVfs = sqlite3_vfs_find(baseVfsName);
+                    if (!baseVfs || baseVfs == vfs)
+                    {
+                        return SQLITE_CANTOPEN;
+                    }
+                }
+            }
+
+            PageReadsFile* readsFile = AsPageReadsFile(file);
+            readsFile->Base.pMethods = nullptr;
+            readsFile->PageSize = 0;
+            readsFile->Pages = nullptr;
+
+            readsFile->Underlying = static_cast<sqlite3_file*>(sqlite3_malloc64(static_cast<sqlite3_uint64>(baseVfs->szOsFile)));
+            if (!readsFile->Underlying)
+            {
+                return SQLITE_NOMEM;
+            }
+            memset(readsFile->Underlying, 0, static_cast<size_t>(baseVfs->szOsFile));
+
+            int result = baseVfs->xOpen(baseVfs, name, readsFile->Underlying, flags, outFlags);
+            if (result != SQLITE_OK)
+            {
+                FreeUnderlyingFile(readsFile->Underlying);
+                return result;
+            }
+
+            if (isMainDb)
+            {
+                try
+                {
+                    readsFile->Pages = new std::vector<uint32_t>();
+                    readsFile->Pages->reserve(s_MaxPageReads);
+                }
+                catch (...)
+                {
+                    delete readsFile->Pages;
+                    readsFile->Pages = nullptr;
+                    FreeUnderlyingFile(readsFile->Underlying);
+                    return SQLITE_NOMEM;
+                }
+            }
+
+            readsFile->Base.pMethods = &s_PageReadsFileMethods;
+            return SQLITE_OK;
+        }
+
+        void EnsurePageReadsVfsRegistered()
+        {
+            static std::once_flag s_registered;
+            static sqlite3_vfs s_vfs{};
+
+            std::call_once(s_registered, []()
+                {
+                    sqlite3_vfs* defaultVfs = sqlite3_vfs_find(nullptr);
+                    THROW_HR_IF(E_UNEXPECTED, !defaultVfs);
+
+                    InitializePassThroughVfs(s_vfs, defaultVfs, s_PageReadsVfsName.data(), static_cast<int>(sizeof(PageReadsFile)), PageReadsVfsOpen);
+                    RegisterPassThroughVfs(s_vfs);
+                });
+        }
+    }
+
+    void InitializePassThroughVfs(sqlite3_vfs& vfs, sqlite3_vfs* baseVfs, const char* name, int fileSize, int (*open)(sqlite3_vfs*, const char*, sqlite3_file*, int, int*))
+    {
+        vfs.iVersion = 2;
+        vfs.szOsFile = fileSize;
+        vfs.mxPathname = baseVfs->mxPathname;
+        vfs.zName = name;
+        vfs.pAppData = baseVfs;
+        vfs.xOpen = open;
+        vfs.xDelete = PassThroughVfsDelete;
+        vfs.xAccess = PassThroughVfsAccess;
+        vfs.xFullPathname = PassThroughVfsFullPathname;
+        vfs.xDlOpen = PassThroughVfsDlOpen;
+        vfs.xDlError = PassThroughVfsDlError;
+        vfs.xDlSym = PassThroughVfsDlSym;
+        vfs.xDlClose = PassThroughVfsDlClose;
+        vfs.xRandomness = PassThroughVfsRandomness;
+        vfs.xSleep = PassThroughVfsSleep;
+        vfs.xCurrentTime = PassThroughVfsCurrentTime;
+        vfs.xGetLastError = PassThroughVfsGetLastError;
+        vfs.xCurrentTimeInt64 = PassThroughVfsCurrentTimeInt64;
+    }
+
+    sqlite3_vfs* GetBaseVfs(sqlite3_vfs* vfs)
+    {
+        return static_cast<sqlite3_vfs*>(vfs->pAppData);
+    }
+
+    void RegisterPassThroughVfs(sqlite3_vfs& vfs)
+    {
+        int result = sqlite3_vfs_register(&vfs, 0);
+        THROW_HR_IF_MSG(MAKE_HRESULT(SEVERITY_ERROR, FACILITY_SQLITE, result), result != SQLITE_OK, "Failed to register VFS: %hs", vfs.zName);
+
+        AICLI_LOG(SQL, Verbose, << "Registered SQLite VFS: " << vfs.zName);
+    }
+
+    std::string RecordPageReadsInUriParameters(std::string_view parameters)
+    {
+        EnsurePageReadsVfsRegistered();
+
+        std::string result{ s_VfsParameter };
+        result += '=';
+        result += s_PageReadsVfsName;
+
+        while (!parameters.empty())
+        {
+            size_t end = parameters.find('&');
+            std::string_view parameter = parameters.substr(0, end);
+            parameters = (end == std::string_view::npos ? std::string_view{} : parameters.substr(end + 1));
+
+            if (parameter.empty())
+            {
+                continue;
+            }
+
+            result += '&';
+
+            // The VFS that would have been used is passed on to the one that records the reads.
+            if (parameter.size() > s_VfsParameter.size() && parameter.substr(0, s_VfsParameter.size()) == s_VfsParameter && parameter[s_VfsParameter.size()] == '=')
+            {
+                result += s_PageReadsBaseVfsParameter;
+                result += parameter.substr(s_VfsParameter.size());
+            }
+            else
+            {
+                result += parameter;
+            }
+        }
+
+        return result;
+    }
+
+    std::vector<uint32_t> GetPagesRead(sqlite3_file* file)
+    {
+        if (!file || file->pMethods != &s_PageReadsFileMethods || !AsPageReadsFile(file)->Pages)
+        {
+            return {};
+        }
+
+        return *AsPageReadsFile(file)->Pages;
+    }
+}
@@ -0,0 +1,31 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <winsqlite/winsqlite3.h>
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace AppInstaller::Repository::SQLite
+{
+    // Sets up a VFS that passes everything other than opening files to the base VFS, which is stored as its app data.
+    void InitializePassThroughVfs(sqlite3_vfs& vfs, sqlite3_vfs* baseVfs, const char* name, int fileSize, int (*open)(sqlite3_vfs*, const char*, sqlite3_file*, int, int*));
+
+    // Gets the base VFS of a VFS that was set up by InitializePassThroughVfs.
+    sqlite3_vfs* GetBaseVfs(sqlite3_vfs* vfs);
+
+    // Registers a VFS that was set up by InitializePassThroughVfs; throws on failure.
+    void RegisterPassThroughVfs(sqlite3_vfs& vfs);
+
+    // Changes the URI query parameters of a connection so that it records the pages of the main database that it reads from its file.
+    // The VFS named by the parameters, or the default VFS, is used through a VFS that records the reads; it is registered if needed.
+    // The connection must be opened with Connection::OpenFlags::Uri; the pages are retrieved with Connection::GetPagesRead.
+    std::string RecordPageReadsInUriParameters(std::string_view parameters);
+
+    // Gets the pages (1 based) that were read from a main database file opened through the VFS that records them, in the order
+    // that they were read, including repeated reads. Returns an empty value if the file was not opened through that VFS.
+    // SQLite serializes the use of a file by its connection, so this must be called while holding the mutex of the connection.
+    std::vector<uint32_t> GetPagesRead(sqlite3_file* file);
+}
@@ -2,6 +2,7 @@
 // Licensed under the MIT License.
 #include "pch.h"
 #include "SQLiteWrapper.h"
+#include "SQLiteVfs.h"
 #include "ICU/SQLiteICU.h"
 
 #include <wil/result_macros.h>
@@ -55,9 +56,14 @@ namespace AppInstaller::Repository::SQLite
             THROW_IF_SQLITE_FAILED(sqlite3_bind_text64(stmt, index, v.c_str(), v.size(), SQLITE_TRANSIENT, SQLITE_UTF8));
         }
 
+        void ParameterSpecificsImpl<std::string>::BindStatic(sqlite3_stmt* stmt, int index, const std::string& v)
+        {
+            THROW_IF_SQLITE_FAILED(sqlite3_bind_text64(stmt, index, v.c_str(), v.size(), SQLITE_STATIC, SQLITE_UTF8));
+        }
+
         std::string ParameterSpecificsImpl<std::string>::GetColumn(sqlite3_stmt* stmt, int column)
         {
-            return reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            return std::string{ ParameterSpecificsImpl<std::string_view>::GetColumn(stmt, column) };
         }
 
         void ParameterSpecificsImpl<std::string_view>::Bind(sqlite3_stmt* stmt, int index, std::string_view v)
@@ -74,6 +80,25 @@ namespace AppInstaller::Repository::SQLite
             }
         }
 
+        void ParameterSpecificsImpl<std::string_view>::BindStatic(sqlite3_stmt* stmt, int index, std::string_view v)
+        {
+            // As with Bind, an empty value must have a non-null data pointer; a literal lives forever.
+            const char* data = (v.empty() ? "" : v.data());
+            THROW_IF_SQLITE_FAILED(sqlite3_bind_text64(stmt, index, data, v.size(), SQLITE_STATIC, SQLITE_UTF8));
+        }
+
+        std::string_view ParameterSpecificsImpl<std::string_view>::GetColumn(sqlite3_stmt* stmt, int column)
+        {
+            // The text must be retrieved before the size, so that the size is of the UTF-8 form.
+            const char* text = reinterpret_cast<const char*>(sqlite3_column_text(stmt, column));
+            if (!text)
+            {
+                return {};
+            }
+
+            return { text, static_cast<size_t>(sqlite3_column_bytes(stmt, column)) };
+        }
+
         void ParameterSpecificsImpl<int>::Bind(sqlite3_stmt* stmt, int index, int v)
         {
             THROW_IF_SQLITE_FAILED(sqlite3_bind_int(stmt, index, v));
@@ -116,6 +141,11 @@ namespace AppInstaller::Repository::SQLite
             THROW_IF_SQLITE_FAILED(sqlite3_bind_blob64(stmt, index, v.data(), v.size(), SQLITE_TRANSIENT));
         }
 
+        void ParameterSpecificsImpl<blob_t>::BindStatic(sqlite3_stmt* stmt, int index, const blob_t& v)
+        {
+            THROW_IF_SQLITE_FAILED(sqlite3_bind_blob64(stmt, index, v.data(), v.size(), SQLITE_STATIC));
+        }
+
         blob_t ParameterSpecificsImpl<blob_t>::GetColumn(sqlite3_stmt* stmt, int column)
         {
             const blob_t::value_type* blobPtr = reinterpret_cast<const blob_t::value_type *>(sqlite3_column_blob(stmt, column));
@@ -164,6 +194,52 @@ namespace AppInstaller::Repository::SQLite
         return sqlite3_changes(m_dbconn.get());
     }
 
+    std::string Connection::GetFilePath() const
+    {
+        char const* const result = sqlite3_db_filename(m_dbconn.get(), "main");
+        return result ? result : std::string{};
+    }
+
+    int Connection::GetPageSize() const
+    {
+        Statement statement = Statement::Create(*this, "PRAGMA page_size");
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int>(0);
+    }
+
+    int Connection::GetPageCount() const
+    {
+        Statement statement = Statement::Create(*this, "PRAGMA page_count");
+        THROW_HR_IF(E_UNEXPECTED, !statement.Step());
+        return statement.GetColumn<int>(0);
+    }
+
+    std::vector<uint32_t> Connection::GetRootPages() const
+    {
+        std::vector<uint32_t> result;
+
+        // Views and triggers have a root page of zero.
+        Statement statement = Statement::Create(*this, "SELECT rootpage FROM sqlite_master WHERE rootpage > 0");
+        while (statement.Step())
+        {
+            result.emplace_back(static_cast<uint32_t>(statement.GetColumn<int64_t>(0)));
+        }
+
+        return result;
+    }
+
+    std::vector<uint32_t> Connection::GetPagesRead() const
+    {
+        // The file is only used by its connection while holding the connection mutex.
+        sqlite3_mutex* mutex = sqlite3_db_mutex(m_dbconn.get());
+        sqlite3_mutex_enter(mutex);
+        auto leaveMutex = wil::scope_exit([&]() { sqlite3_mutex_leave(mutex); });
+
+        sqlite3_file* file = nullptr;
+        THROW_IF_SQLITE_FAILED(sqlite3_file_control(m_dbconn.get(), "main", SQLITE_FCNTL_FILE_POINTER, &file));
+        return SQLite::GetPagesRead(file);
+    }
+
     Statement::Statement(const Connection& connection, std::string_view sql)
     {
         m_id = GetNextStatementId();
@@ -233,18 +309,33 @@ namespace AppInstaller::Repository::SQLite
 
     bool Statement::Step(bool failFastOnError)
     {
-        AICLI_LOG(SQL, Verbose, << "Stepping statement #" << m_id);
+        // This is called for every row, so only check once whether the messages are needed.
+        const bool logVerbose = Logging::Log().IsEnabled(Logging::Channel::SQL, Logging::Level::Verbose);
+
+        if (logVerbose)
+        {
+            AICLI_LOG(SQL, Verbose, << "Stepping statement #" << m_id);
+        }
+
         int result = sqlite3_step(m_stmt.get());
 
         if (result == SQLITE_ROW)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has data");
+            if (logVerbose)
+            {
+                AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has data");
+            }
+
             m_state = State::HasRow;
             return true;
         }
         else if (result == SQLITE_DONE)
         {
-            AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has completed");
+            if (logVerbose)
+            {
+                AICLI_LOG(SQL, Verbose, << "Statement #" << m_id << " has completed");
+            }
+
             m_state = State::Completed;
             return false;
         }
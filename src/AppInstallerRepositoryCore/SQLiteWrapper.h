@@ -61,6 +61,7 @@ namespace AppInstaller::Repository::SQLite
         {
             inline static const std::string& ToLog(const std::string& v) { return v; }
             static void Bind(sqlite3_stmt* stmt, int index, const std::string& v);
+            static void BindStatic(sqlite3_stmt* stmt, int index, const std::string& v);
             static std::string GetColumn(sqlite3_stmt* stmt, int column);
         };
 
@@ -69,6 +70,8 @@ namespace AppInstaller::Repository::SQLite
         {
             inline static const std::string_view& ToLog(const std::string_view& v) { return v; }
             static void Bind(sqlite3_stmt* stmt, int index, std::string_view v);
+            static void BindStatic(sqlite3_stmt* stmt, int index, std::string_view v);
+            static std::string_view GetColumn(sqlite3_stmt* stmt, int column);
         };
 
         template <>
@@ -100,6 +103,7 @@ namespace AppInstaller::Repository::SQLite
         {
             static std::string ToLog(const blob_t& v);
             static void Bind(sqlite3_stmt* stmt, int index, const blob_t& v);
+            static void BindStatic(sqlite3_stmt* stmt, int index, const blob_t& v);
             static blob_t GetColumn(sqlite3_stmt* stmt, int column);
         };
 
@@ -174,6 +178,23 @@ namespace AppInstaller::Repository::SQLite
         // Gets the count of changed rows for the last executed statement.
         int GetChanges() const;
 
+        // Gets the path of the file containing the main database; empty for temporary and in-memory databases.
+        std::string GetFilePath() const;
+
+        // Gets the size of the pages of the main database.
+        int GetPageSize() const;
+
+        // Gets the number of pages in the main database.
+        int GetPageCount() const;
+
+        // Gets the root page of every table and index in the main database, other than the schema table (which is rooted at page 1).
+        std::vector<uint32_t> GetRootPages() const;
+
+        // Gets the number (1 based) of each page of the main database that has been read from its file, in the order that they were read.
+        // The connection must have been opened with the URI parameters from RecordPageReadsInUriParameters; otherwise this is empty.
+        // Pages that are in the page cache of the connection are not read again, so this mostly holds the first use of each.
+        std::vector<uint32_t> GetPagesRead() const;
+
         operator sqlite3* () const { return m_dbconn.get(); }
 
     private:
@@ -224,6 +245,16 @@ namespace AppInstaller::Repository::SQLite
             details::ParameterSpecifics<Value>::Bind(m_stmt.get(), index, std::forward<Value>(v));
         }
 
+        // Bind a text or blob parameter to the statement without SQLite making a copy of it.
+        // The value must remain valid until the parameter is bound again or the statement is destroyed.
+        // The index is 1 based.
+        template <typename Value>
+        void BindStatic(int index, const Value& v)
+        {
+            AICLI_LOG(SQL, Verbose, << "Binding statement #" << m_id << ": " << index << " => " << details::ParameterSpecifics<Value>::ToLog(v));
+            details::ParameterSpecifics<Value>::BindStatic(m_stmt.get(), index, v);
+        }
+
         // Evaluate the statement; either retrieving the next row or executing some action.
         // Returns true if there is a row of data, or false if there is none.
         // This return value is the equivalent of 'GetState() == State::HasRow' after calling Step.
@@ -237,6 +268,7 @@ namespace AppInstaller::Repository::SQLite
         bool GetColumnIsNull(int column);
 
         // Gets the value of the specified column from the current row.
+        // A std::string_view refers to memory owned by the statement, and is only valid until the next call to Step or Reset.
         // The index is 0 based.
         template <typename Value>
         Value GetColumn(int column)
@@ -247,6 +279,7 @@ namespace AppInstaller::Repository::SQLite
 
         // Gets the entire row of values from the current row.
         // The values requested *must* be those available starting from the first column, but trailing columns can be omitted.
+        // As with GetColumn, any std::string_view values are only valid until the next call to Step or Reset.
         template <typename... Values>
         std::tuple<Values...> GetRow()
         {
@@ -0,0 +1,438 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SQLiteZipEntry.h"
+#include "SQLiteVfs.h"
+
+#include <mutex>
+
+using namespace std::string_view_literals;
+
+namespace AppInstaller::Repository::SQLite
+{
+    namespace
+    {
+        // ZIP record signatures and sizes; see the PKWARE APPNOTE.TXT for the format description.
+        constexpr uint32_t s_LocalFileHeaderSignature = 0x04034b50;
+        constexpr uint32_t s_CentralDirectoryHeaderSignature = 0x02014b50;
+        constexpr uint32_t s_EndOfCentralDirectorySignature = 0x06054b50;
+        constexpr uint32_t s_Zip64EndOfCentralDirectorySignature = 0x06064b50;
+        constexpr uint32_t s_Zip64EndOfCentralDirectoryLocatorSignature = 0x07064b50;
+        constexpr uint16_t s_Zip64ExtraFieldId = 0x0001;
+
+        constexpr size_t s_LocalFileHeaderSize = 30;
+        constexpr size_t s_EndOfCentralDirectorySize = 22;
+        constexpr size_t s_Zip64EndOfCentralDirectorySize = 56;
+        constexpr size_t s_Zip64EndOfCentralDirectoryLocatorSize = 20;
+        constexpr size_t s_MaxCommentSize = 0xFFFF;
+
+        constexpr uint16_t s_CompressionMethodStored = 0;
+        constexpr uint16_t s_GeneralPurposeFlagEncrypted = 0x1;
+
+        constexpr std::string_view s_ZipEntryVfsName = "winget-zipentry"sv;
+        constexpr char s_ZipEntryOffsetParameter[] = "zipentryoffset";
+        constexpr char s_ZipEntrySizeParameter[] = "zipentrysize";
+
+#define THROW_ZIP_CORRUPT_IF(_condition_, _message_) THROW_HR_IF_MSG(HRESULT_FROM_WIN32(ERROR_FILE_CORRUPT), _condition_, _message_)
+
+        // Reads little endian values out of a buffer, with bounds checking.
+        struct ByteReader
+        {
+            ByteReader(const std::vector<uint8_t>& buffer, size_t position = 0) : m_buffer(buffer), m_position(position) {}
+
+            template <typename T>
+            T Read()
+            {
+                THROW_ZIP_CORRUPT_IF(m_position + sizeof(T) > m_buffer.size(), "Unexpected end of ZIP record");
+
+                T result = 0;
+                for (size_t i = 0; i < sizeof(T); ++i)
+                {
+                    result |= static_cast<T>(static_cast<T>(m_buffer[m_position + i]) << (8 * i));
+                }
+
+                m_position += sizeof(T);
+                return result;
+            }
+
+            std::string_view ReadString(size_t length)
+            {
+                THROW_ZIP_CORRUPT_IF(m_position + length > m_buffer.size(), "Unexpected end of ZIP record");
+                std::string_view result{ reinterpret_cast<const char*>(m_buffer.data() + m_position), length };
+                m_position += length;
+                return result;
+            }
+
+            void Skip(size_t length)
+            {
+                THROW_ZIP_CORRUPT_IF(m_position + length > m_buffer.size(), "Unexpected end of ZIP record");
+                m_position += length;
+            }
+
+            size_t Position() const { return m_position; }
+
+        private:
+            const std::vector<uint8_t>& m_buffer;
+            size_t m_position;
+        };
+
+        std::vector<uint8_t> ReadFileRange(std::ifstream& stream, uint64_t offset, size_t size)
+        {
+            std::vector<uint8_t> result(size);
+            stream.seekg(static_cast<std::streamoff>(offset));
+            stream.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(size));
+            THROW_ZIP_CORRUPT_IF(!stream || static_cast<size_t>(stream.gcount()) != size, "Failed to read ZIP record");
+            return result;
+        }
+
+        // The location of the central directory.
+        struct CentralDirectoryLocation
+        {
+            uint64_t Offset = 0;
+            uint64_t Size = 0;
+            uint64_t EntryCount = 0;
+            // The position of the end of central directory records; entry data must be before this.
+            uint64_t End = 0;
+        };
+
+        CentralDirectoryLocation FindCentralDirectory(std::ifstream& stream, uint64_t fileSize)
+        {
+            THROW_ZIP_CORRUPT_IF(fileSize < s_EndOfCentralDirectorySize, "File too small to be a ZIP");
+
+            // The end of central directory record is at the end of the file, followed only by a comment.
+            size_t tailSize = static_cast<size_t>(std::min<uint64_t>(fileSize, s_EndOfCentralDirectorySize + s_MaxCommentSize + s_Zip64EndOfCentralDirectoryLocatorSize));
+            uint64_t tailOffset = fileSize - tailSize;
+            std::vector<uint8_t> tail = ReadFileRange(stream, tailOffset, tailSize);
+
+            std::optional<size_t> eocdPosition;
+            for (size_t i = tailSize - s_EndOfCentralDirectorySize + 1; i-- > 0;)
+            {
+                if (ByteReader{ tail, i }.Read<uint32_t>() == s_EndOfCentralDirectorySignature)
+                {
+                    eocdPosition = i;
+                    break;
+                }
+            }
+
+            THROW_ZIP_CORRUPT_IF(!eocdPosition, "End of central directory not found");
+
+            ByteReader eocd{ tail, eocdPosition.value() + sizeof(uint32_t) };
+            eocd.Skip(2 * sizeof(uint16_t)); // disk numbers
+            eocd.Skip(sizeof(uint16_t)); // entries on this disk
+
+            CentralDirectoryLocation result;
+            result.EntryCount = eocd.Read<uint16_t>();
+            result.Size = eocd.Read<uint32_t>();
+            result.Offset = eocd.Read<uint32_t>();
+            result.End = tailOffset + eocdPosition.value();
+
+            // MSIX packages always carry the ZIP64 records, so look for the locator immediately preceding the record.
+            if (eocdPosition.value() >= s_Zip64EndOfCentralDirectoryLocatorSize)
+            {
+                ByteReader locator{ tail, eocdPosition.value() - s_Zip64EndOfCentralDirectoryLocatorSize };
+                if (locator.Read<uint32_t>() == s_Zip64EndOfCentralDirectoryLocatorSignature)
+                {
+                    locator.Skip(sizeof(uint32_t)); // disk number
+                    uint64_t zip64EocdOffset = locator.Read<uint64_t>();
+                    THROW_ZIP_CORRUPT_IF(zip64EocdOffset + s_Zip64EndOfCentralDirectorySize > tailOffset + eocdPosition.value(), "Invalid ZIP64 locator");
+
+                    std::vector<uint8_t> zip64EocdBuffer = ReadFileRange(stream, zip64EocdOffset, s_Zip64EndOfCentralDirectorySize);
+                    ByteReader zip64Eocd{ zip64EocdBuffer };
+                    THROW_ZIP_CORRUPT_IF(zip64Eocd.Read<uint32_t>() != s_Zip64EndOfCentralDirectorySignature, "Invalid ZIP64 end of central directory");
+                    zip64Eocd.Skip(sizeof(uint64_t)); // record size
+                    zip64Eocd.Skip(2 * sizeof(uint16_t)); // versions
+                    zip64Eocd.Skip(2 * sizeof(uint32_t)); // disk numbers
+                    zip64Eocd.Skip(sizeof(uint64_t)); // entries on this disk
+
+                    result.EntryCount = zip64Eocd.Read<uint64_t>();
+                    result.Size = zip64Eocd.Read<uint64_t>();
+                    result.Offset = zip64Eocd.Read<uint64_t>();
+                    result.End = zip64EocdOffset;
+                }
+            }
+
+            THROW_ZIP_CORRUPT_IF(result.Offset > result.End || result.Size > result.End - result.Offset, "Central directory is outside of the file");
+            return result;
+        }
+
+        // A file opened through the VFS; the underlying file of the default VFS immediately follows it in memory.
+        struct ZipEntryFile
+        {
+            sqlite3_file Base;
+            sqlite3_int64 Offset;
+            sqlite3_int64 Size;
+
+            sqlite3_file* Underlying() { return reinterpret_cast<sqlite3_file*>(this + 1); }
+        };
+
+        ZipEntryFile* AsZipEntryFile(sqlite3_file* file)
+        {
+            return reinterpret_cast<ZipEntryFile*>(file);
+        }
+
+        int ZipEntryFileClose(sqlite3_file* file)
+        {
+            sqlite3_file* underlying = AsZipEntryFile(file)->Underlying();
+            return underlying->pMethods->xClose(underlying);
+        }
+
+        int ZipEntryFileRead(sqlite3_file* file, void* buffer, int amount, sqlite3_int64 offset)
+        {
+            ZipEntryFile* entryFile = AsZipEntryFile(file);
+            int available = 0;
+
+            if (offset < entryFile->Size)
+            {
+                available = static_cast<int>(std::min<sqlite3_int64>(amount, entryFile->Size - offset));
+                sqlite3_file* underlying = entryFile->Underlying();
+                int result = underlying->pMethods->xRead(underlying, buffer, available, entryFile->Offset + offset);
+                if (result != SQLITE_OK)
+                {
+                    return result;
+                }
+            }
+
+            if (available < amount)
+            {
+                // SQLite requires that the unread portion of the buffer be zero filled.
+                memset(static_cast<uint8_t*>(buffer) + available, 0, static_cast<size_t>(amount - available));
+                return SQLITE_IOERR_SHORT_READ;
+            }
+
+            return SQLITE_OK;
+        }
+
+        int ZipEntryFileWrite(sqlite3_file*, const void*, int, sqlite3_int64)
+        {
+            return SQLITE_READONLY;
+        }
+
+        int ZipEntryFileTruncate(sqlite3_file*, sqlite3_int64)
+        {
+            return SQLITE_READONLY;
+        }
+
+        int ZipEntryFileSync(sqlite3_file*, int)
+        {
+            return SQLITE_OK;
+        }
+
+        int ZipEntryFileSize(sqlite3_file* file, sqlite3_int64* size)
+        {
+            *size = AsZipEntryFile(file)->Size;
+            return SQLITE_OK;
+        }
+
+        int ZipEntryFileLock(sqlite3_file*, int)
+        {
+            // The data is immutable, so there is nothing to protect.
+            return SQLITE_OK;
+        }
+
+        int ZipEntryFileCheckReservedLock(sqlite3_file*, int* result)
+        {
+            *result = 0;
+            return SQLITE_OK;
+        }
+
+        int ZipEntryFileControl(sqlite3_file*, int, void*)
+        {
+            return SQLITE_NOTFOUND;
+        }
+
+        int ZipEntryFileSectorSize(sqlite3_file* file)
+        {
+            sqlite3_file* underlying = AsZipEntryFile(file)->Underlying();
+            return underlying->pMethods->xSectorSize(underlying);
+        }
+
+        int ZipEntryFileDeviceCharacteristics(sqlite3_file*)
+        {
+            return SQLITE_IOCAP_IMMUTABLE;
+        }
+
+        const sqlite3_io_methods s_ZipEntryFileMethods =
+        {
+            1,
+            ZipEntryFileClose,
+            ZipEntryFileRead,
+            ZipEntryFileWrite,
+            ZipEntryFileTruncate,
+            ZipEntryFileSync,
+            ZipEntryFileSize,
+            ZipEntryFileLock,
+            ZipEntryFileLock,
+            ZipEntryFileCheckReservedLock,
+            ZipEntryFileControl,
+            ZipEntryFileSectorSize,
+            ZipEntryFileDeviceCharacteristics,
+        };
+
+        // The VFS delegates everything but main database files to the default VFS.
+        int ZipEntryVfsOpen(sqlite3_vfs* vfs, const char* name, sqlite3_file* file, int flags, int* outFlags)
+        {
+            sqlite3_vfs* defaultVfs = GetBaseVfs(vfs);
+
+            if (!(flags & SQLITE_OPEN_MAIN_DB))
+            {
+                // Temporary files used for sorting and the like are not part of the entry.
+                return defaultVfs->xOpen(defaultVfs, name, file, flags, outFlags);
+            }
+
+            sqlite3_int64 offset = sqlite3_uri_int64(name, s_ZipEntryOffsetParameter, -1);
+            sqlite3_int64 size = sqlite3_uri_int64(name, s_ZipEntrySizeParameter, -1);
+            if (offset < 0 || size < 0)
+            {
+                return SQLITE_CANTOPEN;
+            }
+
+            ZipEntryFile* entryFile = AsZipEntryFile(file);
+            entryFile->Base.pMethods = nullptr;
+            entryFile->Offset = offset;
+            entryFile->Size = size;
+
+            sqlite3_file* underlying = entryFile->Underlying();
+            int openFlags = (flags & ~(SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE)) | SQLITE_OPEN_READONLY;
+            int result = defaultVfs->xOpen(defaultVfs, name, underlying, openFlags, outFlags);
+            if (result != SQLITE_OK)
+            {
+                return result;
+            }
+
+            // Never trust the offsets more than the file itself.
+            sqlite3_int64 fileSize = 0;
+            result = underlying->pMethods->xFileSize(underlying, &fileSize);
+            if (result != SQLITE_OK || offset > fileSize || size > fileSize - offset)
+            {
+                underlying->pMethods->xClose(underlying);
+                return (result != SQLITE_OK ? result : SQLITE_CORRUPT);
+            }
+
+            entryFile->Base.pMethods = &s_ZipEntryFileMethods;
+            return SQLITE_OK;
+        }
+
+        void EnsureZipEntryVfsRegistered()
+        {
+            static std::once_flag s_registered;
+            static sqlite3_vfs s_vfs{};
+
+            std::call_once(s_registered, []()
+                {
+                    sqlite3_vfs* defaultVfs = sqlite3_vfs_find(nullptr);
+                    THROW_HR_IF(E_UNEXPECTED, !defaultVfs);
+
+                    InitializePassThroughVfs(s_vfs, defaultVfs, s_ZipEntryVfsName.data(), static_cast<int>(sizeof(ZipEntryFile)) + defaultVfs->szOsFile, ZipEntryVfsOpen);
+                    RegisterPassThroughVfs(s_vfs);
+                });
+        }
+    }
+
+    std::optional<ZipStoredEntry> FindStoredZipEntry(const std::filesystem::path& zipFile, std::string_view entryName)
+    {
+        std::ifstream stream{ zipFile, std::ios_base::in | std::ios_base::binary };
+        THROW_LAST_ERROR_IF(!stream);
+
+        uint64_t fileSize = std::filesystem::file_size(zipFile);
+        CentralDirectoryLocation centralDirectory = FindCentralDirectory(stream, fileSize);
+        std::vector<uint8_t> directory = ReadFileRange(stream, centralDirectory.Offset, static_cast<size_t>(centralDirectory.Size));
+
+        ByteReader reader{ directory };
+        for (uint64_t i = 0; i < centralDirectory.EntryCount; ++i)
+        {
+            THROW_ZIP_CORRUPT_IF(reader.Read<uint32_t>() != s_CentralDirectoryHeaderSignature, "Invalid central directory header");
+            reader.Skip(2 * sizeof(uint16_t)); // versions
+            uint16_t flags = reader.Read<uint16_t>();
+            uint16_t method = reader.Read<uint16_t>();
+            reader.Skip(2 * sizeof(uint16_t)); // time and date
+            reader.Skip(sizeof(uint32_t)); // CRC-32
+            uint64_t compressedSize = reader.Read<uint32_t>();
+            uint64_t uncompressedSize = reader.Read<uint32_t>();
+            uint16_t nameLength = reader.Read<uint16_t>();
+            uint16_t extraLength = reader.Read<uint16_t>();
+            uint16_t commentLength = reader.Read<uint16_t>();
+            reader.Skip(sizeof(uint16_t)); // disk number
+            reader.Skip(sizeof(uint16_t) + sizeof(uint32_t)); // attributes
+            uint64_t localHeaderOffset = reader.Read<uint32_t>();
+            std::string_view name = reader.ReadString(nameLength);
+
+            if (name != entryName)
+            {
+                reader.Skip(static_cast<size_t>(extraLength) + commentLength);
+                continue;
+            }
+
+            // Values too large for the header are moved to the ZIP64 extra field, in a fixed order.
+            size_t extraEnd = reader.Position() + extraLength;
+            while (reader.Position() + 2 * sizeof(uint16_t) <= extraEnd)
+            {
+                uint16_t extraId = reader.Read<uint16_t>();
+                uint16_t extraSize = reader.Read<uint16_t>();
+                size_t fieldEnd = reader.Position() + extraSize;
+                THROW_ZIP_CORRUPT_IF(fieldEnd > extraEnd, "Invalid extra field");
+
+                if (extraId == s_Zip64ExtraFieldId)
+                {
+                    if (uncompressedSize == UINT32_MAX)
+                    {
+                        uncompressedSize = reader.Read<uint64_t>();
+                    }
+                    if (compressedSize == UINT32_MAX)
+                    {
+                        compressedSize = reader.Read<uint64_t>();
+                    }
+                    if (localHeaderOffset == UINT32_MAX)
+                    {
+                        localHeaderOffset = reader.Read<uint64_t>();
+                    }
+                }
+
+                reader.Skip(fieldEnd - reader.Position());
+            }
+
+            if (method != s_CompressionMethodStored || (flags & s_GeneralPurposeFlagEncrypted) || compressedSize != uncompressedSize)
+            {
+                AICLI_LOG(SQL, Verbose, << "ZIP entry '" << entryName << "' is not stored uncompressed [method " << method << ", flags " << flags << "]");
+                return {};
+            }
+
+            THROW_ZIP_CORRUPT_IF(localHeaderOffset > centralDirectory.Offset || centralDirectory.Offset - localHeaderOffset < s_LocalFileHeaderSize, "Local header is outside of the file");
+
+            std::vector<uint8_t> localHeaderBuffer = ReadFileRange(stream, localHeaderOffset, s_LocalFileHeaderSize);
+            ByteReader localHeader{ localHeaderBuffer };
+            THROW_ZIP_CORRUPT_IF(localHeader.Read<uint32_t>() != s_LocalFileHeaderSignature, "Invalid local file header");
+            localHeader.Skip(2 * sizeof(uint16_t)); // version and flags
+            THROW_ZIP_CORRUPT_IF(localHeader.Read<uint16_t>() != method, "Local file header does not match central directory");
+            localHeader.Skip(2 * sizeof(uint16_t) + 3 * sizeof(uint32_t)); // time, date, crc and sizes (possibly deferred to a data descriptor)
+            uint16_t localNameLength = localHeader.Read<uint16_t>();
+            uint16_t localExtraLength = localHeader.Read<uint16_t>();
+
+            THROW_ZIP_CORRUPT_IF(localNameLength != nameLength, "Local file header does not match central directory");
+            std::vector<uint8_t> localName = ReadFileRange(stream, localHeaderOffset + s_LocalFileHeaderSize, localNameLength);
+            THROW_ZIP_CORRUPT_IF((std::string_view{ reinterpret_cast<const char*>(localName.data()), localName.size() } != entryName), "Local file header does not match central directory");
+
+            ZipStoredEntry result;
+            result.ZipFile = zipFile;
+            result.DataOffset = localHeaderOffset + s_LocalFileHeaderSize + localNameLength + localExtraLength;
+            result.Size = uncompressedSize;
+
+            // Entry data must lie entirely before the central directory.
+            THROW_ZIP_CORRUPT_IF(result.DataOffset > centralDirectory.Offset || result.Size > centralDirectory.Offset - result.DataOffset, "Entry data is outside of the file");
+
+            return result;
+        }
+
+        return {};
+    }
+
+    std::string GetStoredZipEntryUriParameters(const ZipStoredEntry& entry)
+    {
+        EnsureZipEntryVfsRegistered();
+
+        std::ostringstream result;
+        result << "vfs=" << s_ZipEntryVfsName << '&' << s_ZipEntryOffsetParameter << '=' << entry.DataOffset << '&' << s_ZipEntrySizeParameter << '=' << entry.Size;
+        return result.str();
+    }
+}
+
+#undef THROW_ZIP_CORRUPT_IF
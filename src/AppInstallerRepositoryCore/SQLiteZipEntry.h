@@ -0,0 +1,35 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace AppInstaller::Repository::SQLite
+{
+    // The location of an entry that is stored without compression inside of a ZIP file (such as an MSIX package).
+    struct ZipStoredEntry
+    {
+        // The ZIP file that contains the entry.
+        std::filesystem::path ZipFile;
+
+        // The offset of the first byte of the entry data from the start of the ZIP file.
+        uint64_t DataOffset = 0;
+
+        // The size of the entry data.
+        uint64_t Size = 0;
+    };
+
+    // Finds the entry with the given name (using '/' separators) in the ZIP file.
+    // Returns an empty value if the entry is not present or its data is not stored uncompressed.
+    // Throws if the ZIP structure is invalid, including an entry whose data does not lie within the file.
+    std::optional<ZipStoredEntry> FindStoredZipEntry(const std::filesystem::path& zipFile, std::string_view entryName);
+
+    // Gets the URI query parameters that direct a connection to read the entry data through
+    // a read-only VFS, rather than the containing file as a whole. Registers the VFS if needed.
+    // The parameters should be appended to a "file:" URI of the ZIP file; the connection must
+    // be created read only with Connection::OpenFlags::Uri.
+    std::string GetStoredZipEntryUriParameters(const ZipStoredEntry& entry);
+}
@@ -0,0 +1,135 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SearchMemo.h"
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        thread_local SearchMemo* t_currentMemo = nullptr;
+
+        // Writes the value with its length, so that no value can be confused with the separators around it.
+        void WriteValue(std::ostringstream& stream, std::string_view value)
+        {
+            stream << value.length() << ':' << value;
+        }
+
+        void WriteMatch(std::ostringstream& stream, const RequestMatch& match)
+        {
+            stream << static_cast<int>(match.Type) << ',';
+            WriteValue(stream, match.Value);
+
+            if (match.Additional)
+            {
+                stream << '+';
+                WriteValue(stream, match.Additional.value());
+            }
+        }
+
+        void WriteFilters(std::ostringstream& stream, char kind, const std::vector<PackageMatchFilter>& filters)
+        {
+            for (const auto& filter : filters)
+            {
+                stream << kind << static_cast<int>(filter.Field) << ',';
+                WriteMatch(stream, filter);
+            }
+        }
+    }
+
+    SearchMemo* SearchMemo::Current()
+    {
+        return t_currentMemo;
+    }
+
+    std::string SearchMemo::GetCanonicalRequest(const SearchRequest& request)
+    {
+        // The order of the inclusions and filters is kept, as it can affect the order of the results.
+        std::ostringstream result;
+
+        if (request.Query)
+        {
+            result << 'Q';
+            WriteMatch(result, request.Query.value());
+        }
+
+        WriteFilters(result, 'I', request.Inclusions);
+        WriteFilters(result, 'F', request.Filters);
+
+        result << 'L' << request.MaximumResults;
+
+        return result.str();
+    }
+
+    std::optional<SearchResult> SearchMemo::Get(const std::shared_ptr<ISource>& source, const std::string& canonicalRequest)
+    {
+        auto sourceItr = m_results.find(source);
+        if (sourceItr != m_results.end())
+        {
+            auto resultItr = sourceItr->second.find(canonicalRequest);
+            if (resultItr != sourceItr->second.end())
+            {
+                ++m_hitCount;
+                return resultItr->second;
+            }
+        }
+
+        ++m_missCount;
+        return std::nullopt;
+    }
+
+    void SearchMemo::Record(const std::shared_ptr<ISource>& source, std::string canonicalRequest, const SearchResult& result)
+    {
+        // A failure may not happen again, so the search is executed the next time it is requested
+        if (result.Failures.empty())
+        {
+            m_results[source].insert_or_assign(std::move(canonicalRequest), result);
+        }
+    }
+
+    void SearchMemo::Clear()
+    {
+        m_results.clear();
+    }
+
+    SearchMemoScope::SearchMemoScope()
+    {
+        // Searches are nested within searches, so only check the settings for the outermost scope
+        if (!t_currentMemo && Settings::ExperimentalFeature::IsEnabled(Settings::ExperimentalFeature::Feature::SearchMemo))
+        {
+            m_memo = std::make_unique<SearchMemo>();
+            t_currentMemo = m_memo.get();
+        }
+    }
+
+    SearchMemoScope::SearchMemoScope(bool useMemo)
+    {
+        if (useMemo && !t_currentMemo)
+        {
+            m_memo = std::make_unique<SearchMemo>();
+            t_currentMemo = m_memo.get();
+        }
+    }
+
+    SearchMemoScope::~SearchMemoScope()
+    {
+        if (m_memo)
+        {
+            t_currentMemo = nullptr;
+
+            if (m_memo->GetHitCount() || m_memo->GetMissCount())
+            {
+                AICLI_LOG(Repo, Info, << "Search memo hits: " << m_memo->GetHitCount() << ", misses: " << m_memo->GetMissCount());
+            }
+        }
+    }
+
+    void InvalidateSearchMemo()
+    {
+        if (t_currentMemo)
+        {
+            AICLI_LOG(Repo, Verbose, << "Package data changed, discarding remembered search results");
+            t_currentMemo->Clear();
+        }
+    }
+}
@@ -0,0 +1,50 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "ISource.h"
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace AppInstaller::Repository
+{
+    // Remembers the results of the searches of each source during an operation, so that an identical
+    // search of the same source returns the same result without being executed again.
+    // The memo is owned by a SearchMemoScope and is only visible to the thread that created it.
+    struct SearchMemo
+    {
+        SearchMemo() = default;
+
+        SearchMemo(const SearchMemo&) = delete;
+        SearchMemo& operator=(const SearchMemo&) = delete;
+
+        // Gets the memo of the current operation on the thread, or null if there is none.
+        static SearchMemo* Current();
+
+        // Gets the canonical form of the request; requests with the same form always produce the same results.
+        static std::string GetCanonicalRequest(const SearchRequest& request);
+
+        // Gets the remembered result of the request on the source.
+        std::optional<SearchResult> Get(const std::shared_ptr<ISource>& source, const std::string& canonicalRequest);
+
+        // Records the result of the request on the source. Results with failures are not recorded.
+        void Record(const std::shared_ptr<ISource>& source, std::string canonicalRequest, const SearchResult& result);
+
+        // Discards all of the remembered results.
+        void Clear();
+
+        // Gets the number of searches that were answered from the memo.
+        size_t GetHitCount() const { return m_hitCount; }
+
+        // Gets the number of searches that were not.
+        size_t GetMissCount() const { return m_missCount; }
+
+    private:
+        // The sources are held so that their addresses cannot be reused by another source during the operation.
+        std::map<std::shared_ptr<ISource>, std::map<std::string, SearchResult>> m_results;
+        size_t m_hitCount = 0;
+        size_t m_missCount = 0;
+    };
+}
@@ -17,6 +17,9 @@ namespace AppInstaller::Repository
         constexpr std::string_view s_SourcesYaml_Source_Name = "Name"sv;
         constexpr std::string_view s_SourcesYaml_Source_Type = "Type"sv;
         constexpr std::string_view s_SourcesYaml_Source_Arg = "Arg"sv;
+        constexpr std::string_view s_SourcesYaml_Source_Mirrors = "Mirrors"sv;
+        constexpr std::string_view s_SourcesYaml_Source_IdentifierNamespaces = "IdentifierNamespaces"sv;
+        constexpr std::string_view s_SourcesYaml_Source_Publishers = "Publishers"sv;
         constexpr std::string_view s_SourcesYaml_Source_Data = "Data"sv;
         constexpr std::string_view s_SourcesYaml_Source_Identifier = "Identifier"sv;
         constexpr std::string_view s_SourcesYaml_Source_IsTombstone = "IsTombstone"sv;
@@ -60,6 +63,50 @@ namespace AppInstaller::Repository
             return true;
         }
 
+        // Attempts to read an optional sequence of scalar values from the node.
+        bool TryReadOptionalScalarSequence(std::string_view settingName, const std::string& settingValue, const YAML::Node& sourceNode, std::string_view name, std::vector<std::string>& values)
+        {
+            YAML::Node valueNode = sourceNode[std::string{ name }];
+
+            if (!valueNode || valueNode.IsNull())
+            {
+                return true;
+            }
+
+            if (!valueNode.IsSequence())
+            {
+                AICLI_LOG(Repo, Error, << "Setting '" << settingName << "' did not contain the expected format (" << name << " is invalid within a source):\n" << settingValue);
+                return false;
+            }
+
+            for (const auto& value : valueNode.Sequence())
+            {
+                if (!value.IsScalar())
+                {
+                    AICLI_LOG(Repo, Error, << "Setting '" << settingName << "' did not contain the expected format (" << name << " is invalid within a source):\n" << settingValue);
+                    return false;
+                }
+
+                values.emplace_back(value.as<std::string>());
+            }
+
+            return true;
+        }
+
+        // Writes a sequence of scalar values, unless it is empty.
+        void EmitOptionalScalarSequence(YAML::Emitter& out, std::string_view name, const std::vector<std::string>& values)
+        {
+            if (!values.empty())
+            {
+                out << YAML::Key << name << YAML::Value << YAML::BeginSeq;
+                for (const auto& value : values)
+                {
+                    out << value;
+                }
+                out << YAML::EndSeq;
+            }
+        }
+
         // Attempts to read the source details from the given stream.
         // Results are all or nothing; if any failures occur, no details are returned.
         bool TryReadSourceDetails(
@@ -170,6 +217,9 @@ namespace AppInstaller::Repository
                     out << YAML::Key << s_SourcesYaml_Source_Name << YAML::Value << details.Name;
                     out << YAML::Key << s_SourcesYaml_Source_Type << YAML::Value << details.Type;
                     out << YAML::Key << s_SourcesYaml_Source_Arg << YAML::Value << details.Arg;
+                    EmitOptionalScalarSequence(out, s_SourcesYaml_Source_Mirrors, details.Mirrors);
+                    EmitOptionalScalarSequence(out, s_SourcesYaml_Source_IdentifierNamespaces, details.Scope.IdentifierNamespaces);
+                    EmitOptionalScalarSequence(out, s_SourcesYaml_Source_Publishers, details.Scope.Publishers);
                     out << YAML::Key << s_SourcesYaml_Source_Data << YAML::Value << details.Data;
                     out << YAML::Key << s_SourcesYaml_Source_Identifier << YAML::Value << details.Identifier;
                     out << YAML::Key << s_SourcesYaml_Source_IsTombstone << YAML::Value << details.IsTombstone;
@@ -486,6 +536,8 @@ namespace AppInstaller::Repository
     {
         Stream{ Stream::UserSources }.Remove();
         Stream{ Stream::SourcesMetadata }.Remove();
+        Stream{ Stream::SourceLocationStatistics }.Remove();
+        Stream{ Stream::NetworkConnectivity }.Remove();
     }
 
     void SourceList::OverwriteSourceList()
@@ -568,6 +620,9 @@ namespace AppInstaller::Repository
                     if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Data, details.Data)) { return false; }
                     if (!TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_IsTombstone, details.IsTombstone)) { return false; }
                     TryReadScalar(name, settingValue, source, s_SourcesYaml_Source_Identifier, details.Identifier, false);
+                    if (!TryReadOptionalScalarSequence(name, settingValue, source, s_SourcesYaml_Source_Mirrors, details.Mirrors)) { return false; }
+                    if (!TryReadOptionalScalarSequence(name, settingValue, source, s_SourcesYaml_Source_IdentifierNamespaces, details.Scope.IdentifierNamespaces)) { return false; }
+                    if (!TryReadOptionalScalarSequence(name, settingValue, source, s_SourcesYaml_Source_Publishers, details.Scope.Publishers)) { return false; }
                     return true;
                 });
 
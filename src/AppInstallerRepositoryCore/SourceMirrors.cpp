@@ -0,0 +1,332 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SourceMirrors.h"
+
+using namespace std::string_view_literals;
+using namespace std::chrono_literals;
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        constexpr std::string_view s_LocationsYaml_Locations = "Locations"sv;
+        constexpr std::string_view s_LocationsYaml_Location = "Location"sv;
+        constexpr std::string_view s_LocationsYaml_Latency = "Latency"sv;
+        constexpr std::string_view s_LocationsYaml_ConsecutiveFailures = "ConsecutiveFailures"sv;
+        constexpr std::string_view s_LocationsYaml_LastFailure = "LastFailure"sv;
+
+        // The weight given to a new latency sample.
+        constexpr double s_LatencySampleWeight = 0.3;
+
+        // A location that fails is avoided for a time that doubles with each consecutive failure, up to the maximum.
+        constexpr std::chrono::minutes s_FailureBackoffInitial = 1min;
+        constexpr std::chrono::minutes s_FailureBackoffMaximum = 24h;
+
+        constexpr size_t s_MaxSaveAttempts = 10;
+
+        bool IsBackingOff(const SourceLocationStatistics& statistics, std::chrono::system_clock::time_point now)
+        {
+            if (statistics.ConsecutiveFailures <= 0)
+            {
+                return false;
+            }
+
+            std::chrono::minutes backoff = s_FailureBackoffMaximum;
+            if (statistics.ConsecutiveFailures <= 16)
+            {
+                backoff = std::min<std::chrono::minutes>(s_FailureBackoffInitial * (1ll << (statistics.ConsecutiveFailures - 1)), s_FailureBackoffMaximum);
+            }
+
+            return now < statistics.LastFailureTime + backoff;
+        }
+
+        std::map<std::string, SourceLocationStatistics> ReadStatistics(Settings::Stream& stream)
+        {
+            std::map<std::string, SourceLocationStatistics> result;
+
+            auto contents = stream.Get();
+            if (!contents)
+            {
+                return result;
+            }
+
+            std::string value = Utility::ReadEntireStream(*contents);
+
+            try
+            {
+                YAML::Node document = YAML::Load(value);
+                YAML::Node locations = document[s_LocationsYaml_Locations];
+
+                if (!locations || !locations.IsSequence())
+                {
+                    return result;
+                }
+
+                for (const auto& location : locations.Sequence())
+                {
+                    const YAML::Node& name = location[s_LocationsYaml_Location];
+                    if (!name || !name.IsScalar())
+                    {
+                        continue;
+                    }
+
+                    SourceLocationStatistics statistics;
+
+                    const YAML::Node& latency = location[s_LocationsYaml_Latency];
+                    if (latency && latency.IsScalar())
+                    {
+                        statistics.Latency = std::chrono::milliseconds{ latency.as<int64_t>() };
+                    }
+
+                    const YAML::Node& failures = location[s_LocationsYaml_ConsecutiveFailures];
+                    if (failures && failures.IsScalar())
+                    {
+                        statistics.ConsecutiveFailures = failures.as<int64_t>();
+                    }
+
+                    const YAML::Node& lastFailure = location[s_LocationsYaml_LastFailure];
+                    if (lastFailure && lastFailure.IsScalar())
+                    {
+                        statistics.LastFailureTime = Utility::ConvertUnixEpochToSystemClock(lastFailure.as<int64_t>());
+                    }
+
+                    result[name.as<std::string>()] = statistics;
+                }
+            }
+            catch (const std::exception& e)
+            {
+                // The statistics are only an optimization; start over rather than fail.
+                AICLI_LOG(Repo, Warning, << "Ignoring invalid source location statistics (" << e.what() << ")");
+                result.clear();
+            }
+
+            return result;
+        }
+
+        [[nodiscard]] bool WriteStatistics(Settings::Stream& stream, const std::map<std::string, SourceLocationStatistics>& statistics)
+        {
+            YAML::Emitter out;
+            out << YAML::BeginMap;
+            out << YAML::Key << s_LocationsYaml_Locations;
+            out << YAML::BeginSeq;
+
+            for (const auto& location : statistics)
+            {
+                out << YAML::BeginMap;
+                out << YAML::Key << s_LocationsYaml_Location << YAML::Value << location.first;
+                if (location.second.Latency)
+                {
+                    out << YAML::Key << s_LocationsYaml_Latency << YAML::Value << static_cast<int64_t>(location.second.Latency->count());
+                }
+                out << YAML::Key << s_LocationsYaml_ConsecutiveFailures << YAML::Value << location.second.ConsecutiveFailures;
+                out << YAML::Key << s_LocationsYaml_LastFailure << YAML::Value << Utility::ConvertSystemClockToUnixEpoch(location.second.LastFailureTime);
+                out << YAML::EndMap;
+            }
+
+            out << YAML::EndSeq;
+            out << YAML::EndMap;
+
+            return stream.Set(out.str());
+        }
+    }
+
+    SourceLocationTracker::SourceLocationTracker(const Settings::StreamDefinition& stream) : m_streamDefinition(stream) {}
+
+    SourceLocationTracker& SourceLocationTracker::Instance()
+    {
+        static SourceLocationTracker s_instance;
+        return s_instance;
+    }
+
+    std::vector<std::string> SourceLocationTracker::GetRankedLocations(const SourceDetails& details)
+    {
+        struct RankedLocation
+        {
+            const std::string* Location;
+            bool BackingOff;
+            std::chrono::milliseconds Latency;
+            std::chrono::system_clock::time_point LastFailureTime;
+        };
+
+        std::vector<const std::string*> locations;
+        locations.emplace_back(&details.Arg);
+        for (const auto& mirror : details.Mirrors)
+        {
+            if (std::find_if(locations.begin(), locations.end(), [&](const std::string* location) { return *location == mirror; }) == locations.end())
+            {
+                locations.emplace_back(&mirror);
+            }
+        }
+
+        std::vector<RankedLocation> ranked;
+        auto now = std::chrono::system_clock::now();
+
+        {
+            std::lock_guard<std::mutex> lock{ m_lock };
+            EnsureLoaded();
+
+            for (const std::string* location : locations)
+            {
+                SourceLocationStatistics statistics;
+                auto itr = m_statistics.find(*location);
+                if (itr != m_statistics.end())
+                {
+                    statistics = itr->second;
+                }
+
+                ranked.emplace_back(RankedLocation{ location, IsBackingOff(statistics, now), statistics.Latency.value_or(0ms), statistics.LastFailureTime });
+            }
+        }
+
+        // A stable sort keeps the configured order between otherwise equal locations.
+        std::stable_sort(ranked.begin(), ranked.end(), [](const RankedLocation& a, const RankedLocation& b)
+            {
+                if (a.BackingOff != b.BackingOff)
+                {
+                    return !a.BackingOff;
+                }
+
+                if (a.BackingOff)
+                {
+                    return a.LastFailureTime < b.LastFailureTime;
+                }
+
+                return a.Latency < b.Latency;
+            });
+
+        std::vector<std::string> result;
+        for (const auto& location : ranked)
+        {
+            result.emplace_back(*location.Location);
+        }
+
+        return result;
+    }
+
+    SourceLocationStatistics SourceLocationTracker::GetStatistics(const std::string& location)
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        EnsureLoaded();
+
+        auto itr = m_statistics.find(location);
+        return (itr == m_statistics.end() ? SourceLocationStatistics{} : itr->second);
+    }
+
+    void SourceLocationTracker::RecordSuccess(const std::string& location, std::chrono::milliseconds latency)
+    {
+        Update(location, [latency](SourceLocationStatistics& statistics)
+            {
+                if (statistics.Latency)
+                {
+                    double smoothed = (1.0 - s_LatencySampleWeight) * static_cast<double>(statistics.Latency->count()) + s_LatencySampleWeight * static_cast<double>(latency.count());
+                    statistics.Latency = std::chrono::milliseconds{ static_cast<int64_t>(smoothed + 0.5) };
+                }
+                else
+                {
+                    statistics.Latency = latency;
+                }
+
+                statistics.ConsecutiveFailures = 0;
+            });
+    }
+
+    void SourceLocationTracker::RecordSuccess(const std::string& location)
+    {
+        Update(location, [](SourceLocationStatistics& statistics)
+            {
+                statistics.ConsecutiveFailures = 0;
+            });
+    }
+
+    void SourceLocationTracker::RecordFailure(const std::string& location)
+    {
+        auto now = std::chrono::system_clock::now();
+
+        Update(location, [now](SourceLocationStatistics& statistics)
+            {
+                ++statistics.ConsecutiveFailures;
+                statistics.LastFailureTime = now;
+            });
+    }
+
+    void SourceLocationTracker::EnsureLoaded()
+    {
+        if (!m_loaded)
+        {
+            Settings::Stream stream{ m_streamDefinition };
+            m_statistics = ReadStatistics(stream);
+            m_loaded = true;
+        }
+    }
+
+    void SourceLocationTracker::Save()
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+        SaveInternal();
+    }
+
+    void SourceLocationTracker::Update(const std::string& location, UpdateFunction update)
+    {
+        std::lock_guard<std::mutex> lock{ m_lock };
+
+        try
+        {
+            EnsureLoaded();
+        }
+        CATCH_LOG();
+
+        SourceLocationStatistics& statistics = m_statistics[location];
+        int64_t previousFailures = statistics.ConsecutiveFailures;
+        update(statistics);
+        bool failuresChanged = (statistics.ConsecutiveFailures != previousFailures);
+
+        m_unsaved.emplace_back(location, std::move(update));
+
+        // Other processes should stop (or resume) using a location as soon as possible; a change in latency can wait.
+        if (failuresChanged)
+        {
+            SaveInternal();
+        }
+    }
+
+    void SourceLocationTracker::SaveInternal()
+    {
+        if (m_unsaved.empty())
+        {
+            return;
+        }
+
+        try
+        {
+            Settings::Stream stream{ m_streamDefinition };
+
+            for (size_t i = 0; i < s_MaxSaveAttempts; ++i)
+            {
+                std::map<std::string, SourceLocationStatistics> statistics = ReadStatistics(stream);
+                for (const auto& unsaved : m_unsaved)
+                {
+                    unsaved.second(statistics[unsaved.first]);
+                }
+
+                if (WriteStatistics(stream, statistics))
+                {
+                    m_statistics = std::move(statistics);
+                    m_loaded = true;
+                    m_unsaved.clear();
+                    return;
+                }
+            }
+
+            AICLI_LOG(Repo, Warning, << "Too many attempts at saving source location statistics");
+        }
+        CATCH_LOG();
+
+        // The observations are still used by this process even though they could not be saved.
+    }
+
+    void SaveSourceLocationStatistics()
+    {
+        SourceLocationTracker::Instance().Save();
+    }
+}
@@ -0,0 +1,144 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Public/winget/RepositorySource.h"
+#include <AppInstallerErrors.h>
+#include <AppInstallerLogging.h>
+#include <winget/Settings.h>
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace AppInstaller::Repository
+{
+    // The observed behavior of a source location.
+    struct SourceLocationStatistics
+    {
+        // The smoothed latency of successful operations, if any have been recorded.
+        std::optional<std::chrono::milliseconds> Latency;
+
+        // The number of failures since the last success.
+        int64_t ConsecutiveFailures = 0;
+
+        // The time of the most recent failure.
+        std::chrono::system_clock::time_point LastFailureTime = {};
+    };
+
+    // Tracks the latency and failures of source locations (the arg and mirrors of sources),
+    // persisting them across runs, and ranks the locations of a source using them.
+    // Observations are kept in memory; they are saved right away only when a location starts or stops failing,
+    // and otherwise when Save is called (once per command).
+    struct SourceLocationTracker
+    {
+        SourceLocationTracker(const Settings::StreamDefinition& stream = Settings::Stream::SourceLocationStatistics);
+
+        // Gets the tracker used by product code.
+        static SourceLocationTracker& Instance();
+
+        // Gets the locations of the source, with the best ranked first.
+        // Locations that failed recently are ranked after all others; the rest are ranked by latency,
+        // with locations that have no recorded latency treated as the fastest so that they are measured.
+        std::vector<std::string> GetRankedLocations(const SourceDetails& details);
+
+        // Gets the statistics for the location.
+        SourceLocationStatistics GetStatistics(const std::string& location);
+
+        // Records the outcome of an operation against the location.
+        void RecordSuccess(const std::string& location, std::chrono::milliseconds latency);
+        void RecordSuccess(const std::string& location);
+        void RecordFailure(const std::string& location);
+
+        // Saves the observations that have not been saved yet.
+        void Save();
+
+    private:
+        using UpdateFunction = std::function<void(SourceLocationStatistics&)>;
+
+        void EnsureLoaded();
+        void Update(const std::string& location, UpdateFunction update);
+        void SaveInternal();
+
+        Settings::StreamDefinition m_streamDefinition;
+        std::mutex m_lock;
+        bool m_loaded = false;
+        std::map<std::string, SourceLocationStatistics> m_statistics;
+        // The observations not yet saved, replayed onto the persisted values when saving so that those from other processes are kept.
+        std::vector<std::pair<std::string, UpdateFunction>> m_unsaved;
+    };
+
+    // Runs the operation with each location of the source in rank order until it succeeds, passing the location.
+    // When the source has no mirrors, the operation is run once with the source arg and nothing is tracked.
+    // A failure moves on to the next location immediately; if all fail, the error from the last one is thrown.
+    // When measureLatency is false, only success or failure is recorded (for operations whose duration is
+    // dominated by the amount of data transferred).
+    // An operation returning bool that returns false (such as when cancelled or when a lock is not acquired) has not
+    // completed, so its result is returned without recording anything; cancellation errors are rethrown the same way.
+    template <typename Operation>
+    auto ExecuteWithSourceLocations(const SourceDetails& details, Operation&& operation, bool measureLatency = true) -> decltype(operation(details.Arg))
+    {
+        if (details.Mirrors.empty())
+        {
+            return operation(details.Arg);
+        }
+
+        SourceLocationTracker& tracker = SourceLocationTracker::Instance();
+        std::vector<std::string> locations = tracker.GetRankedLocations(details);
+
+        for (size_t i = 0; i < locations.size(); ++i)
+        {
+            const std::string& location = locations[i];
+            auto start = std::chrono::steady_clock::now();
+
+            try
+            {
+                auto result = operation(location);
+
+                if constexpr (std::is_same_v<decltype(result), bool>)
+                {
+                    if (!result)
+                    {
+                        AICLI_LOG(Repo, Verbose, << "Operation did not complete for source location " << location);
+                        return result;
+                    }
+                }
+
+                if (measureLatency)
+                {
+                    tracker.RecordSuccess(location, std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start));
+                }
+                else
+                {
+                    tracker.RecordSuccess(location);
+                }
+
+                return result;
+            }
+            catch (...)
+            {
+                // Being offline or cancelled says nothing about the location, and no other location will be tried either.
+                HRESULT hr = wil::ResultFromCaughtException();
+                if (hr == APPINSTALLER_CLI_ERROR_NETWORK_OFFLINE || hr == E_ABORT || hr == APPINSTALLER_CLI_ERROR_CTRL_SIGNAL_RECEIVED)
+                {
+                    throw;
+                }
+
+                tracker.RecordFailure(location);
+
+                if (i + 1 == locations.size())
+                {
+                    throw;
+                }
+
+                AICLI_LOG(Repo, Warning, << "Operation failed for source location " << location << ", moving to " << locations[i + 1]);
+            }
+        }
+
+        THROW_HR(E_UNEXPECTED);
+    }
+}
@@ -0,0 +1,192 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#include "pch.h"
+#include "SourceScope.h"
+#include <AppInstallerLogging.h>
+#include <AppInstallerStrings.h>
+#include <winget/NameNormalization.h>
+
+namespace AppInstaller::Repository
+{
+    namespace
+    {
+        // Normalizes the publisher in the same way as the index does when searching for a name and publisher.
+        std::string NormalizePublisher(std::string_view publisher)
+        {
+            static std::mutex s_lock;
+            static Utility::NameNormalizer s_normalizer{ Utility::NormalizationVersion::Initial };
+
+            std::string folded = Utility::FoldCase(publisher);
+
+            std::lock_guard<std::mutex> lock{ s_lock };
+            return s_normalizer.NormalizePublisher(folded);
+        }
+
+        bool IsLookup(MatchType type)
+        {
+            return type == MatchType::Exact || type == MatchType::CaseInsensitive;
+        }
+
+        bool IsLimitableFilter(const PackageMatchFilter& filter)
+        {
+            return
+                (filter.Field == PackageMatchField::Id && (IsLookup(filter.Type) || filter.Type == MatchType::StartsWith)) ||
+                (filter.Field == PackageMatchField::NormalizedNameAndPublisher && IsLookup(filter.Type));
+        }
+    }
+
+    SourceScopeFilter::SourceScopeFilter(const SourceScope& declared, const SourceScope& advertised)
+    {
+        const auto& identifierNamespaces = (declared.IdentifierNamespaces.empty() ? advertised.IdentifierNamespaces : declared.IdentifierNamespaces);
+        for (std::string_view identifierNamespace : identifierNamespaces)
+        {
+            while (!identifierNamespace.empty() && identifierNamespace.back() == '.')
+            {
+                identifierNamespace.remove_suffix(1);
+            }
+
+            if (!identifierNamespace.empty())
+            {
+                m_identifierNamespaces.emplace_back(Utility::FoldCase(identifierNamespace) + '.');
+            }
+        }
+
+        const auto& publishers = (declared.Publishers.empty() ? advertised.Publishers : declared.Publishers);
+        for (const auto& publisher : publishers)
+        {
+            m_publishers.emplace_back(NormalizePublisher(publisher));
+        }
+    }
+
+    SourceScopeFilter SourceScopeFilter::ForSource(const Source& source)
+    {
+        SourceScope declared = source.GetDetails().Scope;
+
+        if (!declared.IdentifierNamespaces.empty() && !declared.Publishers.empty())
+        {
+            return { declared };
+        }
+
+        return { declared, source.GetInformation().Scope };
+    }
+
+    bool SourceScopeFilter::IsLimitable(const SearchRequest& request)
+    {
+        return
+            std::any_of(request.Filters.begin(), request.Filters.end(), IsLimitableFilter) ||
+            (!request.Query && std::any_of(request.Inclusions.begin(), request.Inclusions.end(), IsLimitableFilter));
+    }
+
+    bool SourceScopeFilter::IsLimited() const
+    {
+        return !m_identifierNamespaces.empty() || !m_publishers.empty();
+    }
+
+    bool SourceScopeFilter::CanMatch(const SearchRequest& request) const
+    {
+        if (!IsLimited())
+        {
+            return true;
+        }
+
+        // Every filter must match, so a single one outside of the scope excludes the request.
+        for (const auto& filter : request.Filters)
+        {
+            if (GetVerdict(filter) == Verdict::OutOfScope)
+            {
+                return false;
+            }
+        }
+
+        // The query matches fields defined by the source, so it could match any package.
+        if (request.Query || request.Inclusions.empty())
+        {
+            return true;
+        }
+
+        // The publisher of an installed package often differs from the one in its manifests, so a system reference
+        // could match a package within the scope even when the names and publishers of the same request do not.
+        for (const auto& inclusion : request.Inclusions)
+        {
+            if (GetVerdict(inclusion) != Verdict::OutOfScope)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    SourceScopeFilter::Verdict SourceScopeFilter::GetVerdict(const PackageMatchFilter& filter) const
+    {
+        switch (filter.Field)
+        {
+        case PackageMatchField::Id:
+            if (!m_identifierNamespaces.empty() && (IsLookup(filter.Type) || filter.Type == MatchType::StartsWith))
+            {
+                return IsIdentifierInScope(Utility::FoldCase(filter.Value), filter.Type == MatchType::StartsWith) ? Verdict::InScope : Verdict::OutOfScope;
+            }
+            break;
+
+        case PackageMatchField::NormalizedNameAndPublisher:
+            if (!m_publishers.empty() && IsLookup(filter.Type))
+            {
+                std::string publisher = NormalizePublisher(filter.Additional.value_or(Utility::NormalizedString{}));
+                return std::find(m_publishers.begin(), m_publishers.end(), publisher) != m_publishers.end() ? Verdict::InScope : Verdict::OutOfScope;
+            }
+            break;
+
+        case PackageMatchField::PackageFamilyName:
+        case PackageMatchField::ProductCode:
+            if (!m_publishers.empty())
+            {
+                return Verdict::SystemReference;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        return Verdict::InScope;
+    }
+
+    bool SourceScopeFilter::IsIdentifierInScope(const std::string& foldedIdentifier, bool isPrefix) const
+    {
+        std::string_view identifier = foldedIdentifier;
+
+        for (std::string_view identifierNamespace : m_identifierNamespaces)
+        {
+            // The namespace itself, or an identifier within it.
+            if (identifierNamespace.substr(0, identifierNamespace.length() - 1) == identifier ||
+                identifier.substr(0, identifierNamespace.length()) == identifierNamespace)
+            {
+                return true;
+            }
+
+            // A prefix that an identifier within the namespace could start with.
+            if (isPrefix && identifierNamespace.substr(0, identifier.length()) == identifier)
+            {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    bool CanSourceMatch(const Source& source, const SearchRequest& request)
+    {
+        if (!SourceScopeFilter::IsLimitable(request))
+        {
+            return true;
+        }
+
+        if (SourceScopeFilter::ForSource(source).CanMatch(request))
+        {
+            return true;
+        }
+
+        AICLI_LOG(Repo, Verbose, << "Not searching source outside of the scope of the request: " << source.GetDetails().Name);
+        return false;
+    }
+}
@@ -0,0 +1,57 @@
+// Copyright (c) Microsoft Corporation.
+// Licensed under the MIT License.
+#pragma once
+#include "Public/winget/RepositorySource.h"
+
+#include <string>
+#include <vector>
+
+namespace AppInstaller::Repository
+{
+    // Determines whether a search request could match any package within the scope of a source.
+    // Only requests for specific identifiers or for the correlation of installed packages are limited by a scope;
+    // any other request, such as a Query that is not filtered by identifier, could match and must be sent to the source.
+    struct SourceScopeFilter
+    {
+        // Creates a filter that does not limit any request.
+        SourceScopeFilter() = default;
+
+        // Creates a filter for the scope declared for the source, using the advertised scope for any list that is not declared.
+        SourceScopeFilter(const SourceScope& declared, const SourceScope& advertised = {});
+
+        // Creates the filter for the source.
+        // The source information is only retrieved if the details do not declare the scope.
+        static SourceScopeFilter ForSource(const Source& source);
+
+        // Determines if the request is of a kind that a scope could limit.
+        static bool IsLimitable(const SearchRequest& request);
+
+        // Determines if the filter limits any request.
+        bool IsLimited() const;
+
+        // Returns false only if no package within the scope can match the request.
+        bool CanMatch(const SearchRequest& request) const;
+
+    private:
+        enum class Verdict
+        {
+            InScope,
+            OutOfScope,
+            // The value cannot be placed in the scope by itself (product codes and package family names).
+            SystemReference,
+        };
+
+        Verdict GetVerdict(const PackageMatchFilter& filter) const;
+
+        bool IsIdentifierInScope(const std::string& foldedIdentifier, bool isPrefix) const;
+
+        // The namespaces, folded and followed by a '.'.
+        std::vector<std::string> m_identifierNamespaces;
+
+        // The normalized publishers.
+        std::vector<std::string> m_publishers;
+    };
+
+    // Determines if the request could match packages in the source, based on the scope of the source.
+    bool CanSourceMatch(const Source& source, const SearchRequest& request);
+}
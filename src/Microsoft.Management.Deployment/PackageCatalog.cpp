@@ -119,26 +119,14 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         return *findPackagesResult;
     }
 
-    winrt::Microsoft::Management::Deployment::FindPackagesResult PackageCatalog::FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options)
+    winrt::Microsoft::Management::Deployment::FindPackagesResult PackageCatalog::BuildFindPackagesResult(const ::AppInstaller::Repository::SearchResult& searchResult)
     {
-        winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
         bool isTruncated = false;
         Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches{ winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>() };
-        ::AppInstaller::Repository::SearchRequest searchRequest;
 
         HRESULT hr = S_OK;
         try
         {
-            // No need to check for caller capability again since packageQuery was required in order to get the PackageCatalog object through Connect
-
-            if (FAILED(hr = PopulateSearchRequest(&searchRequest, options)))
-            {
-                return GetFindPackagesResult(hr, isTruncated, matches);
-            }
-        
-            searchRequest.MaximumResults = options.ResultLimit();
-            auto searchResult = m_source.Search(searchRequest);
-
             // Handle failures by just rethrowing the first one for now.
             // TODO: Look into updating the COM interface to enable the single source
             //       failures to flow out.
@@ -171,4 +159,84 @@ namespace winrt::Microsoft::Management::Deployment::implementation
 
         return GetFindPackagesResult(hr, isTruncated, matches);
     }
+
+    winrt::Microsoft::Management::Deployment::FindPackagesResult PackageCatalog::FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options)
+    {
+        winrt::Microsoft::Management::Deployment::FindPackagesResultStatus::Ok;
+        bool isTruncated = false;
+        Windows::Foundation::Collections::IVector<Microsoft::Management::Deployment::MatchResult> matches{ winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>() };
+        ::AppInstaller::Repository::SearchRequest searchRequest;
+
+        HRESULT hr = S_OK;
+        try
+        {
+            // No need to check for caller capability again since packageQuery was required in order to get the PackageCatalog object through Connect
+
+            if (FAILED(hr = PopulateSearchRequest(&searchRequest, options)))
+            {
+                return GetFindPackagesResult(hr, isTruncated, matches);
+            }
+        
+            searchRequest.MaximumResults = options.ResultLimit();
+            return BuildFindPackagesResult(m_source.Search(searchRequest));
+        }
+        WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+        return GetFindPackagesResult(hr, isTruncated, matches);
+    }
+
+    winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult>> PackageCatalog::FindPackagesBatchAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> options)
+    {
+        co_return FindPackagesBatch(options);
+    }
+
+    winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult> PackageCatalog::FindPackagesBatch(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> const& options)
+    {
+        // No need to check for caller capability again since packageQuery was required in order to get the PackageCatalog object through Connect
+        std::vector<winrt::Microsoft::Management::Deployment::FindPackagesResult> results(options.Size(), nullptr);
+        std::vector<::AppInstaller::Repository::SearchRequest> searchRequests;
+        std::vector<uint32_t> searchIndices;
+
+        for (uint32_t i = 0; i < options.Size(); ++i)
+        {
+            ::AppInstaller::Repository::SearchRequest searchRequest;
+            HRESULT hr = S_OK;
+            try
+            {
+                hr = PopulateSearchRequest(&searchRequest, options.GetAt(i));
+                searchRequest.MaximumResults = options.GetAt(i).ResultLimit();
+            }
+            WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+            if (FAILED(hr))
+            {
+                results[i] = GetFindPackagesResult(hr, false, winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>());
+            }
+            else
+            {
+                searchRequests.emplace_back(std::move(searchRequest));
+                searchIndices.push_back(i);
+            }
+        }
+
+        if (!searchRequests.empty())
+        {
+            std::vector<::AppInstaller::Repository::SearchResult> searchResults;
+            HRESULT hr = S_OK;
+            try
+            {
+                searchResults = m_source.SearchBatch(searchRequests);
+            }
+            WINGET_CATCH_STORE(hr, APPINSTALLER_CLI_ERROR_COMMAND_FAILED);
+
+            for (size_t i = 0; i < searchIndices.size(); ++i)
+            {
+                results[searchIndices[i]] = (FAILED(hr) ?
+                    GetFindPackagesResult(hr, false, winrt::single_threaded_vector<Microsoft::Management::Deployment::MatchResult>()) :
+                    BuildFindPackagesResult(searchResults[i]));
+            }
+        }
+
+        return winrt::single_threaded_vector<winrt::Microsoft::Management::Deployment::FindPackagesResult>(std::move(results)).GetView();
+    }
 }
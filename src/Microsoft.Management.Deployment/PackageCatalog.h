@@ -20,9 +20,13 @@ namespace winrt::Microsoft::Management::Deployment::implementation
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo Info();
         winrt::Windows::Foundation::IAsyncOperation<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesAsync(winrt::Microsoft::Management::Deployment::FindPackagesOptions options);
         winrt::Microsoft::Management::Deployment::FindPackagesResult FindPackages(winrt::Microsoft::Management::Deployment::FindPackagesOptions const& options);
+        winrt::Windows::Foundation::IAsyncOperation<winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult>> FindPackagesBatchAsync(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> options);
+        winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesResult> FindPackagesBatch(winrt::Windows::Foundation::Collections::IVectorView<winrt::Microsoft::Management::Deployment::FindPackagesOptions> const& options);
 
 #if !defined(INCLUDE_ONLY_INTERFACE_METHODS)
     private:
+        winrt::Microsoft::Management::Deployment::FindPackagesResult BuildFindPackagesResult(const ::AppInstaller::Repository::SearchResult& searchResult);
+
         winrt::Microsoft::Management::Deployment::PackageCatalogInfo m_info{ nullptr };
         ::AppInstaller::Repository::Source m_source;
         bool m_isComposite = false;
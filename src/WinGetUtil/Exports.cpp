@@ -164,6 +164,19 @@ extern "C"
     }
     CATCH_RETURN()
 
+    WINGET_UTIL_API WinGetSQLiteIndexExportForPackaging(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING targetPath) try
+    {
+        THROW_HR_IF(E_INVALIDARG, !index);
+        THROW_HR_IF(E_INVALIDARG, !targetPath);
+
+        reinterpret_cast<SQLiteIndex*>(index)->ExportForPackaging(targetPath);
+
+        return S_OK;
+    }
+    CATCH_RETURN()
+
     WINGET_UTIL_API WinGetSQLiteIndexCheckConsistency(
         WINGET_SQLITE_INDEX_HANDLE index,
         BOOL* succeeded) try
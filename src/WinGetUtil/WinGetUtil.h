@@ -77,6 +77,12 @@ extern "C"
     WINGET_UTIL_API WinGetSQLiteIndexPrepareForPackaging(
         WINGET_SQLITE_INDEX_HANDLE index);
 
+    // Writes the index as it would be after WinGetSQLiteIndexPrepareForPackaging to a new file,
+    // leaving the index itself unchanged.
+    WINGET_UTIL_API WinGetSQLiteIndexExportForPackaging(
+        WINGET_SQLITE_INDEX_HANDLE index,
+        WINGET_STRING targetPath);
+
     // Checks the index for consistency, ensuring that at a minimum all referenced rows actually exist.
     WINGET_UTIL_API WinGetSQLiteIndexCheckConsistency(
         WINGET_SQLITE_INDEX_HANDLE index,